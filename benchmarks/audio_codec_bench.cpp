@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "audio/audio_codec.hpp"
+
+namespace {
+
+constexpr size_t FRAME_SAMPLES = 480;  // 10 ms at 48 kHz
+
+std::vector<float> create_signal(size_t n) {
+    std::vector<float> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = std::sin(i * 0.01f) * 0.8f;
+    }
+    return samples;
+}
+
+void BM_Encode(benchmark::State& state) {
+    auto codec = create_audio_codec(static_cast<AudioCodecType>(state.range(0)), 48000);
+    state.SetLabel(codec->name());
+
+    auto samples = create_signal(FRAME_SAMPLES);
+    std::vector<uint8_t> payload(codec->max_encoded_size(FRAME_SAMPLES));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            codec->encode(samples.data(), samples.size(), payload.data(), payload.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAME_SAMPLES);
+}
+
+void BM_Decode(benchmark::State& state) {
+    auto codec = create_audio_codec(static_cast<AudioCodecType>(state.range(0)), 48000);
+    state.SetLabel(codec->name());
+
+    auto samples = create_signal(FRAME_SAMPLES);
+    std::vector<uint8_t> payload(codec->max_encoded_size(FRAME_SAMPLES));
+    const size_t size =
+        codec->encode(samples.data(), samples.size(), payload.data(), payload.size());
+    std::vector<float> decoded(FRAME_SAMPLES);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            codec->decode(payload.data(), size, decoded.data(), decoded.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAME_SAMPLES);
+}
+
+void codec_args(benchmark::internal::Benchmark* b) {
+    for (AudioCodecType type : {AudioCodecType::L16, AudioCodecType::Pcmu,
+                                AudioCodecType::Pcma, AudioCodecType::ImaAdpcm}) {
+        b->Arg(static_cast<int>(type));
+    }
+}
+
+#ifdef EDGE_VOX_HAVE_OPUS
+// Encode time per frame at 16 kHz speech rates; pick the complexity the board can afford
+void BM_OpusEncode(benchmark::State& state) {
+    constexpr uint32_t rate = 16000;
+    EdgeVoxOpusConfig config;
+    config.complexity = static_cast<int>(state.range(0));
+    config.bitrate = 24000;
+    auto codec = create_audio_codec(AudioCodecType::Opus, rate, config);
+
+    const size_t frame = rate * state.range(1) / 1000;
+    auto samples = create_signal(frame * 50);
+    std::vector<uint8_t> payload(codec->max_encoded_size(frame));
+
+    size_t offset = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            codec->encode(samples.data() + offset, frame, payload.data(), payload.size()));
+        offset = (offset + frame) % samples.size();
+    }
+    state.SetLabel(std::to_string(state.range(1)) + " ms");
+    state.counters["us_per_frame"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * 1e-6,
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+#endif
+
+}  // namespace
+
+BENCHMARK(BM_Encode)->Apply(codec_args);
+BENCHMARK(BM_Decode)->Apply(codec_args);
+#ifdef EDGE_VOX_HAVE_OPUS
+BENCHMARK(BM_OpusEncode)->ArgsProduct({{0, 2, 5, 8, 10}, {10, 20}});
+#endif
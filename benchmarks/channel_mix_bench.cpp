@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include "audio/channel_mix.hpp"
+
+namespace {
+
+constexpr size_t FRAMES = 480;  // 10 ms at 48 kHz
+
+std::vector<float> create_block(size_t channels) {
+    std::vector<float> samples(FRAMES * channels);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = std::sin(i * 0.01f) * 0.8f;
+    }
+    return samples;
+}
+
+// Arguments: kernel, channels
+bool setup(benchmark::State& state, PcmKernel& kernel, size_t& channels) {
+    kernel = static_cast<PcmKernel>(state.range(0));
+    channels = static_cast<size_t>(state.range(1));
+    if (!pcm_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return false;
+    }
+    state.SetLabel(std::string(pcm_kernel_name(kernel)) + "/" + std::to_string(channels) + "ch");
+    return true;
+}
+
+void BM_Deinterleave(benchmark::State& state) {
+    PcmKernel kernel;
+    size_t channels;
+    if (!setup(state, kernel, channels)) {
+        return;
+    }
+
+    const auto in = create_block(channels);
+    std::vector<float> out(FRAMES * channels);
+    for (auto _ : state) {
+        deinterleave(in.data(), FRAMES, channels, out.data(), FRAMES, kernel);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAMES);
+}
+
+void BM_Downmix(benchmark::State& state) {
+    PcmKernel kernel;
+    size_t channels;
+    if (!setup(state, kernel, channels)) {
+        return;
+    }
+
+    const auto in = create_block(channels);
+    const std::vector<float> weights(channels, 1.0f / channels);
+    std::vector<float> out(FRAMES);
+    for (auto _ : state) {
+        downmix(in.data(), FRAMES, channels, weights.data(), out.data(), kernel);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAMES);
+}
+
+void BM_SelectChannel(benchmark::State& state) {
+    PcmKernel kernel;
+    size_t channels;
+    if (!setup(state, kernel, channels)) {
+        return;
+    }
+
+    const auto in = create_block(channels);
+    std::vector<float> out(FRAMES);
+    for (auto _ : state) {
+        select_channel(in.data(), FRAMES, channels, 1, out.data(), kernel);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAMES);
+}
+
+// Every kernel at the board layouts (stereo, 4-mic array)
+void layouts(benchmark::internal::Benchmark* b) {
+    for (int64_t kernel = 0; kernel <= 3; kernel++) {
+        for (int64_t channels : {2, 4}) {
+            b->Args({kernel, channels});
+        }
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Deinterleave)->Apply(layouts);
+BENCHMARK(BM_Downmix)->Apply(layouts);
+BENCHMARK(BM_SelectChannel)->Apply(layouts);
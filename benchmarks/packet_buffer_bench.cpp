@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "net/packet_buffer.hpp"
+
+namespace {
+
+constexpr size_t PACKET_BYTES = 332;  // RTP header + 10 ms of 16 kHz PCM16
+constexpr size_t QUEUE_DEPTH = 100;
+
+// Mutex-guarded vector-of-vectors queue: the pop moves the storage out, so every push
+// allocates again
+void BM_PacketBufferPushPop(benchmark::State& state) {
+    PacketBuffer buffer(QUEUE_DEPTH);
+    const std::vector<uint8_t> packet(PACKET_BYTES, 0x5A);
+    std::vector<uint8_t> out;
+
+    for (auto _ : state) {
+        buffer.push(packet);
+        buffer.pop(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Fixed-slot SPSC queue, copying in and out
+void BM_PacketSlotBufferPushPop(benchmark::State& state) {
+    PacketSlotBuffer buffer(QUEUE_DEPTH, PACKET_BYTES);
+    const std::vector<uint8_t> packet(PACKET_BYTES, 0x5A);
+    std::vector<uint8_t> out;
+
+    for (auto _ : state) {
+        buffer.push(packet);
+        buffer.pop(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Fixed-slot SPSC queue used in place on both sides
+void BM_PacketSlotBufferInPlace(benchmark::State& state) {
+    PacketSlotBuffer buffer(QUEUE_DEPTH, PACKET_BYTES);
+
+    for (auto _ : state) {
+        uint8_t* slot = buffer.prepare();
+        slot[0] = 0x80;
+        buffer.commit(PACKET_BYTES);
+
+        size_t len = 0;
+        const uint8_t* data = buffer.front(len);
+        benchmark::DoNotOptimize(data[0]);
+        buffer.release();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_PacketBufferPushPop);
+BENCHMARK(BM_PacketSlotBufferPushPop);
+BENCHMARK(BM_PacketSlotBufferInPlace);
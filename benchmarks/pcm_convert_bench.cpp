@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include "audio/pcm_convert.hpp"
+
+namespace {
+
+constexpr size_t FRAME_SAMPLES = 480;  // 10 ms at 48 kHz
+
+// The conversion send_audio used before pcm_convert: truncating, no clamping
+void legacy_convert(const float* in, uint8_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int16_t pcm = static_cast<int16_t>(in[i] * 32767.0f);
+        out[2 * i] = (pcm >> 8) & 0xFF;
+        out[2 * i + 1] = pcm & 0xFF;
+    }
+}
+
+std::vector<float> create_signal(size_t n) {
+    std::vector<float> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = std::sin(i * 0.01f) * 0.8f;
+    }
+    return samples;
+}
+
+void BM_FloatToPcm16Legacy(benchmark::State& state) {
+    auto samples = create_signal(FRAME_SAMPLES);
+    std::vector<uint8_t> out(FRAME_SAMPLES * 2);
+
+    for (auto _ : state) {
+        legacy_convert(samples.data(), out.data(), samples.size());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAME_SAMPLES);
+}
+
+void BM_FloatToPcm16(benchmark::State& state) {
+    const auto kernel = static_cast<PcmKernel>(state.range(0));
+    const bool dithered = state.range(1) != 0;
+    if (!pcm_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    state.SetLabel(std::string(pcm_kernel_name(kernel)) + (dithered ? "+dither" : ""));
+
+    auto samples = create_signal(FRAME_SAMPLES);
+    std::vector<uint8_t> out(FRAME_SAMPLES * 2);
+    TpdfDither dither;
+
+    for (auto _ : state) {
+        float_to_pcm16be(samples.data(), out.data(), samples.size(), dithered ? &dither : nullptr,
+                         kernel);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAME_SAMPLES);
+}
+
+void BM_Pcm16ToFloat(benchmark::State& state) {
+    const auto kernel = static_cast<PcmKernel>(state.range(0));
+    if (!pcm_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    state.SetLabel(pcm_kernel_name(kernel));
+
+    auto samples = create_signal(FRAME_SAMPLES);
+    std::vector<uint8_t> pcm(FRAME_SAMPLES * 2);
+    float_to_pcm16be(samples.data(), pcm.data(), samples.size());
+    std::vector<float> out(FRAME_SAMPLES);
+
+    for (auto _ : state) {
+        pcm16be_to_float(pcm.data(), out.data(), out.size(), kernel);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAME_SAMPLES);
+}
+
+void all_kernels(benchmark::internal::Benchmark* b) {
+    for (auto kernel : {PcmKernel::Scalar, PcmKernel::Sse2, PcmKernel::Avx2, PcmKernel::Neon}) {
+        b->Args({static_cast<int64_t>(kernel), 0});
+    }
+    b->Args({static_cast<int64_t>(pcm_best_kernel()), 1});
+}
+
+}  // namespace
+
+BENCHMARK(BM_FloatToPcm16Legacy);
+BENCHMARK(BM_FloatToPcm16)->Apply(all_kernels);
+BENCHMARK(BM_Pcm16ToFloat)->DenseRange(0, 3);
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "core/pipeline.hpp"
+#include "edge_vox/audio/audio_async.hpp"
+#include "edge_vox/audio/synthetic_audio_backend.hpp"
+#include "net/rtp_streamer.hpp"
+
+namespace {
+
+// Capture -> RTP throughput without a sound card: a synthetic source running as fast as
+// possible feeds audio_async, and each iteration drains new samples into the streamer
+// (sending to a local port nobody listens on).
+void BM_CaptureToRtp(benchmark::State& state) {
+    const int sample_rate = static_cast<int>(state.range(0));
+    const size_t frame = sample_rate / 100;  // 10 ms
+
+    SyntheticAudioConfig config;
+    config.pacing = AudioPacing::AsFastAsPossible;
+
+    audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+    EdgeVoxRtpStreamer streamer;
+    if (!audio.init(-1, sample_rate) || !streamer.init("127.0.0.1", 5004, 512) ||
+        !streamer.start() || !audio.resume()) {
+        state.SkipWithError("Failed to set up the pipeline");
+        return;
+    }
+
+    std::vector<float> samples(frame);
+    for (auto _ : state) {
+        while (audio.get_available() < frame) {
+            std::this_thread::yield();
+        }
+        samples.resize(audio.read_new(frame, samples.data()));
+        streamer.send_audio(samples);
+        samples.resize(frame);
+    }
+
+    state.SetItemsProcessed(state.iterations() * frame);
+    state.counters["overruns"] = audio.get_overrun_count();
+
+    audio.pause();
+    audio.close();
+    streamer.stop();
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Capture -> RTP latency: a synthetic source paced at real time feeds the capture pipeline,
+// whose sink sends each frame. The time of an iteration is how long the newest sample of a
+// frame took from the capture callback until its packet was handed to the socket; the
+// counters add the median, 99th percentile and worst case over the run.
+void BM_CaptureToRtpLatency(benchmark::State& state) {
+    const int sample_rate = static_cast<int>(state.range(0));
+
+    SyntheticAudioConfig config;
+    config.pacing = AudioPacing::RealTime;
+
+    audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+    EdgeVoxRtpStreamer streamer;
+    EdgeVoxPipeline pipeline;
+    std::atomic<int64_t> latency_ns{0};
+    std::atomic<uint64_t> sent{0};
+
+    AudioFormat format;
+    format.sample_rate = static_cast<uint32_t>(sample_rate);
+    format.channels = 1;
+    format.frame_samples = sample_rate / 100;  // 10 ms
+    audio.set_capture_listener(
+        [&pipeline](const float* samples, size_t n) { pipeline.push(samples, n); });
+    if (!audio.init(-1, sample_rate) || !streamer.init("127.0.0.1", 5004, 512) ||
+        !streamer.start() ||
+        !pipeline.start(format,
+                        [&](const AudioFrame& frame, uint64_t) {
+                            streamer.send_audio(frame.channel(0), frame.samples);
+                            latency_ns.store(now_ns() - frame.captured_ns,
+                                             std::memory_order_relaxed);
+                            sent.fetch_add(1, std::memory_order_release);
+                        }) ||
+        !audio.resume()) {
+        state.SkipWithError("Failed to set up the pipeline");
+        return;
+    }
+
+    std::vector<double> latencies_us;
+    uint64_t seen = sent.load(std::memory_order_acquire);
+    for (auto _ : state) {
+        uint64_t current;
+        while ((current = sent.load(std::memory_order_acquire)) == seen) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        seen = current;
+        const int64_t latency = latency_ns.load(std::memory_order_relaxed);
+        latencies_us.push_back(latency / 1000.0);
+        state.SetIterationTime(latency / 1e9);
+    }
+
+    audio.pause();
+    pipeline.stop();
+    audio.close();
+    streamer.stop();
+
+    if (!latencies_us.empty()) {
+        std::sort(latencies_us.begin(), latencies_us.end());
+        state.counters["p50_us"] = latencies_us[latencies_us.size() / 2];
+        state.counters["p99_us"] = latencies_us[latencies_us.size() * 99 / 100];
+        state.counters["max_us"] = latencies_us.back();
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_CaptureToRtp)->Arg(16000)->Arg(48000)->UseRealTime();
+BENCHMARK(BM_CaptureToRtpLatency)
+    ->Arg(16000)
+    ->Arg(48000)
+    ->UseManualTime()
+    ->Iterations(300)  // One 10 ms frame each; the library would otherwise run thousands
+    ->Unit(benchmark::kMicrosecond);
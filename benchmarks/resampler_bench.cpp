@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "audio/resampler.hpp"
+
+namespace {
+
+// Items are input samples: items_per_second is how many samples of capture one core can
+// convert per second
+void BM_Resample(benchmark::State& state) {
+    const auto in_rate = static_cast<uint32_t>(state.range(0));
+    const auto out_rate = static_cast<uint32_t>(state.range(1));
+    const auto quality = static_cast<ResamplerQuality>(state.range(2));
+    const auto kernel = static_cast<PcmKernel>(state.range(3));
+    if (!pcm_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+
+    const char* names[] = {"fast", "medium", "best"};
+    state.SetLabel(std::to_string(in_rate) + "->" + std::to_string(out_rate) + " " +
+                   names[state.range(2)] + " " + pcm_kernel_name(kernel));
+
+    // One 10 ms frame per call, as in the capture pipeline
+    const size_t frame = in_rate / 100;
+    PolyphaseResampler resampler;
+    if (!resampler.configure(in_rate, out_rate, quality, 1, frame, kernel)) {
+        state.SkipWithError("unsupported ratio");
+        return;
+    }
+    std::vector<float> in(frame);
+    for (size_t i = 0; i < frame; i++) {
+        in[i] = std::sin(i * 0.01f) * 0.8f;
+    }
+    std::vector<float> out(resampler.max_output(frame));
+
+    for (auto _ : state) {
+        const size_t count = resampler.process(0, in.data(), frame, out.data());
+        benchmark::DoNotOptimize(count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frame);
+}
+
+void all_conversions(benchmark::internal::Benchmark* b) {
+    for (auto kernel : {PcmKernel::Scalar, PcmKernel::Sse2, PcmKernel::Avx2, PcmKernel::Neon}) {
+        for (int quality = 0; quality < 3; quality++) {
+            b->Args({48000, 16000, quality, static_cast<int64_t>(kernel)});
+        }
+    }
+    b->Args({44100, 16000, 1, static_cast<int64_t>(pcm_best_kernel())});
+    b->Args({16000, 48000, 1, static_cast<int64_t>(pcm_best_kernel())});
+}
+
+}  // namespace
+
+BENCHMARK(BM_Resample)->Apply(all_conversions);
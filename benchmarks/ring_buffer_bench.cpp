@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "edge_vox/audio/ring_buffer.hpp"
+
+namespace {
+
+constexpr size_t SAMPLE_RATE = 48000;
+constexpr size_t HISTORY_SAMPLES = SAMPLE_RATE * 30;  // 30 s, as used by EdgeVoxClient
+constexpr size_t CALLBACK_SAMPLES = 1024;             // SDL capture block
+constexpr size_t READ_SAMPLES = SAMPLE_RATE / 100;    // 10 ms
+
+// The capture buffer audio_async used before CaptureRingBuffer: one mutex shared by the
+// SDL callback and get()
+class MutexCaptureBuffer {
+public:
+    explicit MutexCaptureBuffer(size_t capacity) : buffer_(capacity) {}
+
+    void write(const float* samples, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (pos_ + n > buffer_.size()) {
+            const size_t n0 = buffer_.size() - pos_;
+            memcpy(&buffer_[pos_], samples, n0 * sizeof(float));
+            memcpy(&buffer_[0], samples + n0, (n - n0) * sizeof(float));
+            pos_ = (pos_ + n) % buffer_.size();
+            len_ = buffer_.size();
+        } else {
+            memcpy(&buffer_[pos_], samples, n * sizeof(float));
+            pos_ = (pos_ + n) % buffer_.size();
+            len_ = std::min(len_ + n, buffer_.size());
+        }
+    }
+
+    size_t read_latest(size_t n, float* out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        n = std::min(n, len_);
+        size_t s0 = (pos_ + buffer_.size() - n) % buffer_.size();
+        if (s0 + n > buffer_.size()) {
+            const size_t n0 = buffer_.size() - s0;
+            memcpy(out, &buffer_[s0], n0 * sizeof(float));
+            memcpy(out + n0, &buffer_[0], (n - n0) * sizeof(float));
+        } else {
+            memcpy(out, &buffer_[s0], n * sizeof(float));
+        }
+        return n;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<float> buffer_;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+};
+
+// Uncontended cost of one capture callback
+template <typename Buffer>
+void BM_CaptureWrite(benchmark::State& state) {
+    Buffer buffer(HISTORY_SAMPLES);
+    std::vector<float> block(CALLBACK_SAMPLES, 0.25f);
+
+    for (auto _ : state) {
+        buffer.write(block.data(), block.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * CALLBACK_SAMPLES);
+}
+
+// Thread 0 plays the SDL callback, the other threads poll 10 ms snapshots like the
+// streaming timer does. The reported time for thread 0 is the callback latency under
+// reader contention.
+template <typename Buffer>
+void BM_CaptureContended(benchmark::State& state) {
+    static Buffer* buffer = nullptr;
+    if (state.thread_index() == 0) {
+        buffer = new Buffer(HISTORY_SAMPLES);
+        std::vector<float> fill(HISTORY_SAMPLES, 0.1f);
+        buffer->write(fill.data(), fill.size());
+    }
+
+    std::vector<float> block(CALLBACK_SAMPLES, 0.25f);
+    std::vector<float> out(READ_SAMPLES);
+
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            buffer->write(block.data(), block.size());
+        } else {
+            benchmark::DoNotOptimize(buffer->read_latest(out.size(), out.data()));
+        }
+        benchmark::ClobberMemory();
+    }
+
+    if (state.thread_index() == 0) {
+        delete buffer;
+        buffer = nullptr;
+    }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_CaptureWrite, MutexCaptureBuffer);
+BENCHMARK_TEMPLATE(BM_CaptureWrite, CaptureRingBuffer);
+BENCHMARK_TEMPLATE(BM_CaptureContended, MutexCaptureBuffer)->Threads(2)->Threads(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CaptureContended, CaptureRingBuffer)->Threads(2)->Threads(4)->UseRealTime();
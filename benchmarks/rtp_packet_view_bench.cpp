@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "net/rtp_packet.hpp"
+#include "net/rtp_packet_view.hpp"
+
+namespace {
+
+constexpr size_t PAYLOAD_BYTES = 960;  // 10 ms of 48 kHz PCM16
+
+std::vector<uint8_t> create_packet(bool with_csrc) {
+    RtpPacket packet;
+    if (with_csrc) {
+        packet.addCsrc(0x01020304);
+        packet.addCsrc(0x05060708);
+    }
+    packet.setPayload(std::vector<uint8_t>(PAYLOAD_BYTES, 0x5A));
+    return packet.serialize();
+}
+
+// Parse and touch every header field, as a receiver would
+void BM_RtpPacketViewParse(benchmark::State& state) {
+    const auto data = create_packet(state.range(0) != 0);
+    state.SetLabel(state.range(0) ? "csrc" : "fast path");
+
+    for (auto _ : state) {
+        RtpPacketView view(data.data(), data.size());
+        benchmark::DoNotOptimize(view.sequenceNumber());
+        benchmark::DoNotOptimize(view.timestamp());
+        benchmark::DoNotOptimize(view.ssrc());
+        benchmark::DoNotOptimize(view.payload());
+        benchmark::DoNotOptimize(view.payloadSize());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// Baseline: copying the payload out, which is what a vector-based parser would have to do
+void BM_RtpPayloadCopy(benchmark::State& state) {
+    const auto data = create_packet(false);
+
+    for (auto _ : state) {
+        std::vector<uint8_t> payload(data.begin() + RTP_HEADER_SIZE, data.end());
+        benchmark::DoNotOptimize(payload.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_RtpPacketViewParse)->Arg(0)->Arg(1);
+BENCHMARK(BM_RtpPayloadCopy);
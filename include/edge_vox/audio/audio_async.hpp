@@ -28,62 +28,122 @@
 
 #include <atomic>
 #include <cstdint>
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 
+#include "edge_vox/audio/audio_backend.hpp"
+#include "edge_vox/audio/ring_buffer.hpp"
+#include "edge_vox/audio/sdl_audio_backend.hpp"
+
+//
+// Audio capture and playback (SDL by default, see AudioBackend)
 //
-// SDL Audio capture
+// Capture opens with as many channels as the device offers. Every channel is kept in a
+// planar ring for multichannel consumers (beamforming); next to it a mono ring holds the
+// channels averaged or one of them selected, for speech recognition and the existing
+// get()/read_new() readers. Both are filled straight from the device buffer by SIMD kernels.
 //
 
 class audio_async {
 public:
+    // called on the audio thread with every block of captured samples (mono, or interleaved
+    // with all channels, see set_capture_listener); must not block
+    using CaptureListener = std::function<void(const float* samples, size_t n_samples)>;
+
     audio_async(int len_ms);
+    audio_async(int len_ms, std::unique_ptr<AudioBackend> backend);
     ~audio_async();
 
+    // replace the audio backend; only allowed while no device is open
+    bool set_backend(std::unique_ptr<AudioBackend> backend);
+
     bool init(int capture_id, int sample_rate);  // Keep old function for compatibility
     bool init(int capture_id, int playback_id, int sample_rate);
+    // capture channels is a hint: the device may deliver its native count instead
+    bool init(int capture_id, int playback_id, int sample_rate, int channels);
+
+    // sample rate and channels actually delivered by the capture device (valid after init)
+    int get_sample_rate() const;
+    int get_channels() const;
+
+    // how the mono signal is made: channel < 0 averages all channels, otherwise that one
+    // channel is used. Set while paused.
+    void set_capture_mix(int channel);
 
-    // start capturing audio via the provided SDL callback
+    // start capturing audio via the backend callback
     // keep last len_ms seconds of audio in a circular buffer
     bool resume();
     bool pause();
     bool clear();
     bool close();
 
-    // callback handlers to be called by SDL
+    // hand each captured block to listener as well as the circular buffer, as the mono mix
+    // or, with all_channels, interleaved as the device delivered it; set while paused
+    void set_capture_listener(CaptureListener listener, bool all_channels = false);
+
+    // callback handlers to be called by the audio backend
     void capture_callback(uint8_t* stream, int len);
     void playback_callback(uint8_t* stream, int len);
 
     // get capture data from the circular buffer
     void get(int ms, std::vector<float>& audio);
 
+    // read up to max capture samples not returned by a previous read_new() call, so each
+    // sample is delivered exactly once. sample_index receives the absolute index of out[0],
+    // overrun the number of samples overwritten before they could be read.
+    size_t read_new(size_t max, float* out, uint64_t* sample_index = nullptr,
+                    uint64_t* overrun = nullptr);
+    size_t get_available() const;
+    uint64_t get_overrun_count() const;
+
+    // zero-copy access to the last ms of capture history (ms <= 0: whole buffer). The view
+    // points into the circular buffer; check is_view_valid() after processing it to detect
+    // whether the capture callback overwrote the data in the meantime.
+    CaptureView get_view(int ms) const;
+    bool is_view_valid(const CaptureView& view) const;
+
+    // the same for one capture channel, from the planar ring
+    CaptureView get_channel_view(int channel, int ms) const;
+    bool is_channel_view_valid(const CaptureView& view) const;
+
     // Playback control
     bool start_playback();
     bool stop_playback();
     bool is_playing() const;
-    bool play_audio(const std::vector<float>& audio);
+    bool play_audio(const std::vector<float>& audio);  // false if above the high-water mark
+    bool play_audio(const float* samples, size_t n_samples);
     void clear_playback_buffer();
     size_t get_playback_buffer_size() const;
+    void set_playback_high_water(int ms);  // limit on queued playback audio, default len_ms
 
 private:
-    SDL_AudioDeviceID m_dev_id_in = 0;
-    SDL_AudioDeviceID m_dev_id_out = 0;
+    bool has_capture() const;
+    bool has_playback() const;
+
+    std::unique_ptr<AudioBackend> m_backend;
 
     // Configuration
     int m_len_ms = 0;
     int m_sample_rate = 0;
+    int m_channels = 1;
+    int m_mix_channel = -1;
+    std::vector<float> m_mix_weights;
 
     // State tracking
     std::atomic_bool m_running;
     std::atomic_bool m_playing;
 
-    // Thread synchronization
-    std::mutex m_mutex;
+    int m_playback_high_water_ms = 0;
 
-    std::vector<float> m_capture_buffer;
-    std::vector<float> m_playback_buffer;
-    size_t m_capture_buffer_pos = 0;
-    size_t m_capture_buffer_len = 0;
+    // Written lock-free by the capture callback, read by get(): the mono mix and, with more
+    // than one capture channel, all of them
+    CaptureRingBuffer m_capture_buffer;
+    CaptureRingBuffer m_channel_buffer;
+    CaptureListener m_capture_listener;
+    bool m_listener_all_channels = false;
+    // Filled lock-free by play_audio(), drained by the playback callback
+    PlaybackRingBuffer m_playback_buffer;
 };
 
 // Return false if need to quit
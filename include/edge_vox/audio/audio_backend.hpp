@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class AudioDirection { Capture, Playback };
+
+// Stream format negotiated with a backend. Samples are always interleaved 32-bit floats.
+struct AudioBackendSpec {
+    int sample_rate{0};
+    int channels{1};
+    int frames_per_buffer{1024};
+};
+
+//
+// Source/sink of audio for audio_async. A backend owns at most one capture and one
+// playback stream and calls back into audio_async from its own audio thread, exactly
+// like an SDL audio device does.
+//
+class AudioBackend {
+public:
+    using Callback = void (*)(void* userdata, uint8_t* stream, int len);
+
+    virtual ~AudioBackend() = default;
+
+    // Open a stream. device_id follows SDL numbering (-1 selects the default device).
+    // Streams start paused. obtained receives the format actually delivered.
+    virtual bool open(AudioDirection direction, int device_id, const AudioBackendSpec& requested,
+                      AudioBackendSpec& obtained, Callback callback, void* userdata) = 0;
+    virtual void pause(AudioDirection direction, bool paused) = 0;
+    virtual void close(AudioDirection direction) = 0;
+    virtual bool is_open(AudioDirection direction) const = 0;
+
+    // Release global resources once all streams are closed
+    virtual void shutdown() {}
+
+    virtual const char* name() const = 0;
+};
+
+// How a backend without real hardware schedules its callbacks
+enum class AudioPacing {
+    RealTime,         // One buffer per buffer duration, like a sound card
+    AsFastAsPossible  // Back-to-back callbacks, for throughput benchmarks
+};
+
+//
+// Base for headless backends: a worker thread generates capture buffers through
+// fill_capture() and drains playback buffers, paced at real time or as fast as possible.
+// Derived classes must call stop_thread() in their own destructor, while fill_capture()
+// and the state it reads still exist.
+//
+class PacedAudioBackend : public AudioBackend {
+public:
+    explicit PacedAudioBackend(AudioPacing pacing);
+    ~PacedAudioBackend() override;
+
+    bool open(AudioDirection direction, int device_id, const AudioBackendSpec& requested,
+              AudioBackendSpec& obtained, Callback callback, void* userdata) override;
+    void pause(AudioDirection direction, bool paused) override;
+    void close(AudioDirection direction) override;
+    bool is_open(AudioDirection direction) const override;
+
+    // True once a finite capture source has delivered all of its samples
+    bool source_exhausted() const;
+    uint64_t captured_frames() const;
+    uint64_t played_frames() const;
+
+protected:
+    // Negotiate the capture format; called before the worker thread sees the stream
+    virtual bool prepare_capture(const AudioBackendSpec& requested, AudioBackendSpec& obtained) = 0;
+
+    // Produce frames * channels interleaved samples. Return the number of frames written;
+    // fewer than requested means the source is exhausted.
+    virtual size_t fill_capture(float* out, size_t frames) = 0;
+
+    void stop_thread();
+
+private:
+    struct Stream {
+        bool open = false;
+        std::atomic<bool> paused{true};
+        AudioBackendSpec spec;
+        Callback callback = nullptr;
+        void* userdata = nullptr;
+        std::vector<float> buffer;
+    };
+
+    Stream& stream(AudioDirection direction);
+    const Stream& stream(AudioDirection direction) const;
+    void start_thread();
+    void run();
+
+    const AudioPacing m_pacing;
+    Stream m_capture;
+    Stream m_playback;
+
+    std::mutex m_mutex;  // Guards stream open/close against the worker thread
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_exhausted{false};
+    std::atomic<uint64_t> m_captured_frames{0};
+    std::atomic<uint64_t> m_played_frames{0};
+};
@@ -1,8 +1,45 @@
 #pragma once
+#include <cstdint>
+
+// RTP payload format of the audio stream in both directions
+enum class AudioCodecType {
+    L16,       // 16-bit linear PCM, 2 bytes per sample
+    Pcmu,      // G.711 mu-law, 1 byte per sample
+    Pcma,      // G.711 A-law, 1 byte per sample
+    ImaAdpcm,  // IMA/DVI4 ADPCM (RFC 3551), 4 bits per sample plus a 4-byte header
+    Opus       // Opus (RFC 7587); only when built with libopus (EDGE_VOX_HAVE_OPUS)
+};
+
+// Filter length of the capture resampler, in taps per period of the lower rate. Longer
+// filters keep more of the band and reject aliases better, for more CPU.
+enum class ResamplerQuality {
+    Fast,    // 16 taps, passband to 0.6 of Nyquist, ~50 dB stopband
+    Medium,  // 32 taps, 0.7 of Nyquist, ~70 dB
+    Best     // 64 taps, 0.8 of Nyquist, ~90 dB
+};
+
+// Opus encoder settings; frames are EdgeVoxStreamConfig::ptime_ms long (5 to 60 ms)
+struct EdgeVoxOpusConfig {
+    uint32_t bitrate{24000};     // Bits per second; 24-32k is plenty for speech recognition
+    int complexity{5};           // 0 (fastest) to 10 (best quality)
+    bool fec{true};              // In-band FEC: each packet carries a coarse copy of the previous
+    uint32_t expected_loss{10};  // Loss in percent the FEC is tuned for
+    bool dtx{false};             // Discontinuous transmission: send nothing during silence
+};
 
 struct EdgeVoxAudioConfig {
-    uint32_t sample_rate{48000};
-    uint16_t channels{1};
+    uint32_t sample_rate{48000};  // Capture rate asked of the device
+    uint16_t channels{1};         // Channels asked of the capture device; it may deliver its
+                                  // native count
+    int capture_channel{-1};      // Channel sent as mono; -1 averages all of them
+    bool multichannel{false};     // Hand every channel to the capture pipeline, for stages
+                                  // that reduce them to mono themselves (BeamformerStage)
     uint16_t bits_per_sample{16};
     uint32_t buffer_ms{30};
-};
\ No newline at end of file
+    uint32_t frame_ms{10};        // Audio per frame in the capture pipeline
+    uint32_t stream_rate{0};      // Rate sent to the server, e.g. 16000 for a speech model;
+                                  // 0 sends at the capture rate
+    ResamplerQuality resampler_quality{ResamplerQuality::Medium};
+    AudioCodecType codec{AudioCodecType::L16};
+    EdgeVoxOpusConfig opus;
+};
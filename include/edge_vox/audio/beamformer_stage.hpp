@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "edge_vox/core/audio_stage.hpp"
+
+class Fft;
+
+struct EdgeVoxBeamformerConfig {
+    float mic_spacing_m{0.05f};  // Between neighbouring microphones of the linear array
+    float sound_speed{343.0f};   // Metres per second
+    float threshold_db{-50.0f};  // Only frames louder than this (dBFS) move the beam
+    float smoothing{0.7f};       // Share of the past in the averaged cross-spectra, 0 to 1
+    float angle_step_deg{2.0f};  // Resolution of the direction search
+};
+
+struct EdgeVoxBeamformerStats {
+    float direction_deg{0.0f};  // Beam angle from broadside, positive towards the first
+                                // microphone
+    uint64_t updates{0};        // Frames the direction was estimated from
+    uint64_t steers{0};         // Times the beam moved
+};
+
+//
+// Delay-and-sum beamformer for a uniform linear microphone array, as a capture pipeline
+// stage that turns the multichannel frames of EdgeVoxAudioConfig::multichannel capture into
+// one mono channel. The direction of the talker is estimated with GCC-PHAT: the whitened
+// cross-spectra of every microphone pair, over the 300-4000 Hz speech band, are averaged
+// over loud frames and turned back into cross-correlations, and the angle whose pair delays
+// add up to the strongest correlation wins. Each channel is then delayed by a windowed-sinc
+// fractional delay so the wavefront lines up, and the channels are averaged; a beam that
+// moves crossfades over one frame. Mono input passes through untouched.
+//
+class BeamformerStage : public AudioStage {
+public:
+    explicit BeamformerStage(const EdgeVoxBeamformerConfig& config = {});
+    ~BeamformerStage() override;
+
+    const char* name() const override {
+        return "beamform";
+    }
+
+    bool configure(AudioFormat& format) override;
+    bool process(AudioFrame& frame) override;
+    void reset() override;
+
+    // Any thread
+    EdgeVoxBeamformerStats get_stats() const;
+
+private:
+    void analyze(size_t channels, size_t n);
+    void estimate();
+    void steer(size_t angle);
+    void delay_and_sum(const std::vector<float>& filters, const std::vector<size_t>& delays,
+                       size_t n, float* out);
+
+    EdgeVoxBeamformerConfig config_;
+    AudioFormat format_;
+    bool passthrough_ = false;
+    void (*mul_add_)(float* out, const float* in, float gain, size_t n) = nullptr;
+
+    // GCC-PHAT over the last fft_size_ samples of every channel
+    std::unique_ptr<Fft> fft_;
+    size_t fft_size_ = 0;
+    size_t bins_ = 0;
+    size_t band_begin_ = 0;  // Bins of the speech band, the only ones correlated
+    size_t band_end_ = 0;
+    std::vector<float> window_;
+    std::vector<float> analysis_;     // channels x fft_size_, newest sample last
+    std::vector<float> spectrum_re_;  // channels x bins_ of the current frame
+    std::vector<float> spectrum_im_;
+    std::vector<std::pair<size_t, size_t>> pairs_;
+    std::vector<float> cross_re_;     // pairs x bins_, whitened and averaged
+    std::vector<float> cross_im_;
+    std::vector<float> correlation_;  // pairs x fft_size_, lag 0 first, negative lags last
+    std::vector<float> scratch_;      // Two windowed channels, then zeros for odd counts
+    bool averaged_ = false;
+
+    // Candidate directions and, per direction, the lag of every pair in samples
+    std::vector<float> angles_;
+    std::vector<float> pair_lags_;
+    size_t direction_ = 0;
+
+    // Per channel: FILTER_TAPS coefficients and a whole-sample delay, current and before the
+    // last move
+    std::vector<float> filters_;
+    std::vector<size_t> delays_;
+    std::vector<float> previous_filters_;
+    std::vector<size_t> previous_delays_;
+    bool crossfade_ = false;
+
+    // Per channel: history_ samples of the past followed by the frame being processed
+    std::vector<float> lines_;
+    size_t history_ = 0;
+    std::vector<float> fade_;
+    uint64_t next_sequence_ = 0;
+
+    std::atomic<float> direction_deg_{0.0f};
+    std::atomic<uint64_t> updates_{0};
+    std::atomic<uint64_t> steers_{0};
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "edge_vox/audio/audio_backend.hpp"
+
+struct FileAudioConfig {
+    enum class Format {
+        Wav,       // RIFF/WAVE, 16-bit PCM or 32-bit float; rate and channels from the header
+        RawS16LE,  // Headerless signed 16-bit little-endian PCM
+        RawF32LE   // Headerless 32-bit little-endian float
+    };
+
+    std::string path;
+    Format format{Format::Wav};
+    int sample_rate{16000};  // Raw formats only
+    int channels{1};         // Raw formats only
+    AudioPacing pacing{AudioPacing::RealTime};
+    bool loop{false};
+};
+
+//
+// Headless capture source replaying a WAV or raw PCM recording. The whole file is decoded
+// when the capture stream is opened so the audio thread never touches the filesystem.
+// The stream runs at the file's sample rate and channel count, like a device opened with
+// its native layout. Playback streams are accepted and discarded.
+//
+class FileAudioBackend : public PacedAudioBackend {
+public:
+    explicit FileAudioBackend(FileAudioConfig config);
+    ~FileAudioBackend() override;
+
+    const char* name() const override {
+        return "file";
+    }
+
+    // Decode a file into interleaved floats; exposed for tools and tests
+    static bool load(const FileAudioConfig& config, std::vector<float>& samples, int& sample_rate,
+                     int& channels);
+
+protected:
+    bool prepare_capture(const AudioBackendSpec& requested, AudioBackendSpec& obtained) override;
+    size_t fill_capture(float* out, size_t frames) override;
+
+private:
+    const FileAudioConfig m_config;
+    std::vector<float> m_samples;
+    int m_channels = 1;
+    size_t m_position = 0;
+};
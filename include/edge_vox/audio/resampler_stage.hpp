@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "edge_vox/audio/audio_config.hpp"
+#include "edge_vox/core/audio_stage.hpp"
+
+class PolyphaseResampler;
+
+//
+// Converts the frames of a capture pipeline to another sample rate with a streaming
+// polyphase FIR, every channel on its own. The output frames must cover the same time as the
+// input ones in a whole number of samples (10 ms frames always do). The filter state carries
+// over from frame to frame and starts from silence again after a frame was dropped.
+//
+class ResamplerStage : public AudioStage {
+public:
+    explicit ResamplerStage(uint32_t output_rate,
+                            ResamplerQuality quality = ResamplerQuality::Medium);
+    ~ResamplerStage() override;
+
+    const char* name() const override {
+        return "resample";
+    }
+
+    bool configure(AudioFormat& format) override;
+    size_t max_frame_samples() const override;
+    bool process(AudioFrame& frame) override;
+    void reset() override;
+
+private:
+    uint32_t output_rate_;
+    ResamplerQuality quality_;
+    AudioFormat input_;
+    AudioFormat output_;
+    std::unique_ptr<PolyphaseResampler> resampler_;
+    uint64_t next_sequence_ = 0;  // Of the frame that would follow the last one
+};
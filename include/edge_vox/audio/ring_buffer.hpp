@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+//
+// Zero-copy view into a CaptureRingBuffer. The samples may wrap around the end of the ring,
+// so they are exposed as up to two contiguous pieces: first[0..first_len) followed by
+// second[0..second_len). The view stays usable only while CaptureRingBuffer::validate()
+// returns true for it.
+//
+struct CaptureView {
+    const float* first = nullptr;
+    size_t first_len = 0;
+    const float* second = nullptr;
+    size_t second_len = 0;
+    uint64_t sample_index = 0;  // Absolute index of the first sample
+
+    size_t size() const {
+        return first_len + second_len;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
+
+//
+// Single-producer / single-consumer ring buffer holding the most recent audio samples.
+//
+// The producer (the real-time audio callback) never blocks and never waits for a reader:
+// once the ring is full the oldest samples are overwritten. Readers copy out without
+// locking and check afterwards that the producer did not overwrite what they copied.
+//
+// A ring may hold several channels, stored planar: every channel has its own plane of
+// capacity() samples and they all share one write index, so a sample index means the same
+// frame on every channel.
+//
+class CaptureRingBuffer {
+public:
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    CaptureRingBuffer() = default;
+    explicit CaptureRingBuffer(size_t min_capacity) {
+        reset(min_capacity);
+    }
+
+    CaptureRingBuffer(const CaptureRingBuffer&) = delete;
+    CaptureRingBuffer& operator=(const CaptureRingBuffer&) = delete;
+
+    // Allocate storage for at least min_capacity samples per channel (rounded up to a power
+    // of two). Not thread safe: call only while the producer is stopped.
+    void reset(size_t min_capacity, size_t channels = 1) {
+        size_t capacity = 1;
+        while (capacity < min_capacity) {
+            capacity <<= 1;
+        }
+
+        buffer_.reset(new float[capacity * channels]());
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        channels_ = channels;
+
+        head_.store(0, std::memory_order_relaxed);
+        reserved_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cursor_ = 0;
+        overrun_ = 0;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    size_t channels() const {
+        return channels_;
+    }
+
+    // Producer: append samples to a one-channel ring, overwriting the oldest ones when full.
+    // Wait-free.
+    void write(const float* samples, size_t n) {
+        write_with(n, [samples](float* dst, size_t, size_t offset, size_t count) {
+            memcpy(dst, samples + offset, count * sizeof(float));
+        });
+    }
+
+    // Producer: append n frames that fill() stores straight into the ring, e.g. by
+    // deinterleaving a capture block. fill(dst, stride, offset, count) is called for each
+    // contiguous run (at most two) and must write frames [offset, offset + count) of the
+    // block, channel c to dst + c * stride. Frames that can't be retained are skipped.
+    template <typename Fill>
+    void write_with(size_t n, Fill&& fill) {
+        if (capacity_ == 0 || n == 0) {
+            return;
+        }
+
+        uint64_t head = head_.load(std::memory_order_relaxed);
+
+        // Only the last capacity_ samples can be retained
+        size_t offset = 0;
+        if (n > capacity_) {
+            head += n - capacity_;
+            offset = n - capacity_;
+            n = capacity_;
+        }
+
+        // Announce the slots about to be overwritten before touching them
+        reserved_.store(head + n, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t pos = head & mask_;
+        const size_t n0 = std::min(n, capacity_ - pos);
+        fill(&buffer_[pos], capacity_, offset, n0);
+        if (n > n0) {
+            fill(&buffer_[0], capacity_, offset + n0, n - n0);
+        }
+
+        head_.store(head + n, std::memory_order_release);
+    }
+
+    // Total number of samples ever written (absolute index of the next sample)
+    uint64_t write_index() const {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    // Number of samples currently retained
+    size_t size() const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        return head - oldest_index(head);
+    }
+
+    // Consumer: drop all retained samples
+    void clear() {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Consumer: copy up to n of the most recent samples of a channel into out (oldest
+    // first). Returns the number of samples copied.
+    size_t read_latest(size_t n, float* out, size_t channel = 0) const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        n = std::min<uint64_t>(n, head - oldest_index(head));
+        return copy_out(head - n, n, out, channel);
+    }
+
+    // Consumer: view up to n of the most recent samples of a channel without copying them.
+    // Call validate() after using the data to find out whether the producer overwrote it.
+    CaptureView view_latest(size_t n, size_t channel = 0) const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        n = std::min<uint64_t>(n, head - oldest_index(head));
+
+        CaptureView view;
+        if (n == 0) {
+            return view;
+        }
+
+        const uint64_t begin = head - n;
+        const size_t pos = begin & mask_;
+        const float* plane = &buffer_[channel * capacity_];
+        view.first = plane + pos;
+        view.first_len = std::min(n, capacity_ - pos);
+        view.second = plane;
+        view.second_len = n - view.first_len;
+        view.sample_index = begin;
+        return view;
+    }
+
+    // Consumer: true if no sample of view has been overwritten since view_latest()
+    bool validate(const CaptureView& view) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = reserved_.load(std::memory_order_relaxed);
+        return reserved <= view.sample_index + capacity_;
+    }
+
+    // Consumer: copy up to max samples of the first channel that were not returned by a
+    // previous read_new(). sample_index receives the absolute index of out[0]; overrun
+    // receives the number of samples that were overwritten before they could be read.
+    // Returns the sample count.
+    size_t read_new(size_t max, float* out, uint64_t* sample_index = nullptr,
+                    uint64_t* overrun = nullptr) {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t lapped = head > capacity_ ? head - capacity_ : 0;
+
+        // Samples skipped by clear() are not an overrun, samples lost to the producer are
+        const uint64_t from = std::max(cursor_, tail_.load(std::memory_order_acquire));
+        uint64_t lost = lapped > from ? lapped - from : 0;
+        const uint64_t begin = std::max(cursor_, oldest_index(head));
+
+        const size_t n = std::min<uint64_t>(max, head - begin);
+        const size_t copied = copy_out(begin, n, out);
+        lost += n - copied;
+
+        cursor_ = begin + n;
+        overrun_ += lost;
+
+        if (sample_index) {
+            *sample_index = begin + (n - copied);
+        }
+        if (overrun) {
+            *overrun = lost;
+        }
+
+        return copied;
+    }
+
+    // Consumer: number of samples available to read_new()
+    size_t available() const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        return head - std::max(cursor_, oldest_index(head));
+    }
+
+    // Consumer: total number of samples lost to overruns since reset()
+    uint64_t overrun_count() const {
+        return overrun_;
+    }
+
+private:
+    uint64_t oldest_index(uint64_t head) const {
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        const uint64_t lapped = head > capacity_ ? head - capacity_ : 0;
+        return std::max(tail, lapped);
+    }
+
+    // Copy samples [begin, begin + n) into out. Samples the producer overwrote while we
+    // were copying are dropped from the front; returns the number of valid samples.
+    size_t copy_out(uint64_t begin, size_t n, float* out, size_t channel = 0) const {
+        if (n == 0) {
+            return 0;
+        }
+
+        const float* plane = &buffer_[channel * capacity_];
+        const size_t pos = begin & mask_;
+        const size_t n0 = std::min(n, capacity_ - pos);
+        memcpy(out, plane + pos, n0 * sizeof(float));
+        memcpy(out + n0, plane, (n - n0) * sizeof(float));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = reserved_.load(std::memory_order_relaxed);
+        const uint64_t valid_from = reserved > capacity_ ? reserved - capacity_ : 0;
+
+        if (valid_from > begin) {
+            const uint64_t lost = valid_from - begin;
+            if (lost >= n) {
+                return 0;
+            }
+            memmove(out, out + lost, (n - lost) * sizeof(float));
+            n -= lost;
+        }
+
+        return n;
+    }
+
+    std::unique_ptr<float[]> buffer_;  // Channel c at buffer_[c * capacity_]
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    size_t channels_ = 1;
+
+    // Producer-owned: committed write index and the index being written up to
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> reserved_{0};
+
+    // Consumer-owned: oldest index still considered valid (moved forward by clear()) and
+    // the read_new() cursor
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+    uint64_t cursor_ = 0;
+    uint64_t overrun_ = 0;
+};
+
+//
+// Fixed-capacity single-producer / single-consumer FIFO of audio samples.
+//
+// Unlike CaptureRingBuffer nothing is overwritten: write() refuses audio that does not fit
+// below the high-water mark, so the consumer (the playback callback) pops in constant time
+// no matter how much audio is queued.
+//
+class PlaybackRingBuffer {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = CaptureRingBuffer::CACHE_LINE_SIZE;
+
+    PlaybackRingBuffer() = default;
+    explicit PlaybackRingBuffer(size_t min_capacity) {
+        reset(min_capacity);
+    }
+
+    PlaybackRingBuffer(const PlaybackRingBuffer&) = delete;
+    PlaybackRingBuffer& operator=(const PlaybackRingBuffer&) = delete;
+
+    // Allocate storage for at least min_capacity samples (rounded up to a power of two).
+    // Not thread safe: call only while neither side is running.
+    void reset(size_t min_capacity) {
+        size_t capacity = 1;
+        while (capacity < min_capacity) {
+            capacity <<= 1;
+        }
+
+        buffer_.reset(new float[capacity]());
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        high_water_.store(capacity, std::memory_order_relaxed);
+
+        write_.store(0, std::memory_order_relaxed);
+        read_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // Maximum number of samples write() may queue (clamped to the capacity)
+    void set_high_water(size_t samples) {
+        high_water_.store(std::min(samples, capacity_), std::memory_order_relaxed);
+    }
+
+    size_t high_water() const {
+        return high_water_.load(std::memory_order_relaxed);
+    }
+
+    // Producer: queue all n samples, or none if that would exceed the high-water mark
+    bool write(const float* samples, size_t n) {
+        const uint64_t write = write_.load(std::memory_order_relaxed);
+        const uint64_t read = read_.load(std::memory_order_acquire);
+
+        if (write - read + n > high_water_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        const size_t pos = write & mask_;
+        const size_t n0 = std::min(n, capacity_ - pos);
+        memcpy(&buffer_[pos], samples, n0 * sizeof(float));
+        memcpy(&buffer_[0], samples + n0, (n - n0) * sizeof(float));
+
+        write_.store(write + n, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: pop up to n samples into out. Returns the number of samples popped.
+    size_t read(float* out, size_t n) {
+        uint64_t read = read_.load(std::memory_order_acquire);
+        const uint64_t write = write_.load(std::memory_order_acquire);
+
+        n = std::min<uint64_t>(n, write - read);
+        if (n == 0) {
+            return 0;
+        }
+
+        const size_t pos = read & mask_;
+        const size_t n0 = std::min(n, capacity_ - pos);
+        memcpy(out, &buffer_[pos], n0 * sizeof(float));
+        memcpy(out + n0, &buffer_[0], (n - n0) * sizeof(float));
+
+        // A concurrent clear() invalidates what we just copied
+        if (!read_.compare_exchange_strong(read, read + n, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        return n;
+    }
+
+    // Number of samples queued
+    size_t size() const {
+        const uint64_t read = read_.load(std::memory_order_acquire);
+        const uint64_t write = write_.load(std::memory_order_acquire);
+        return write - read;
+    }
+
+    // Drop all queued samples. Safe to call from the producer side while the consumer runs.
+    void clear() {
+        const uint64_t write = write_.load(std::memory_order_acquire);
+        uint64_t read = read_.load(std::memory_order_relaxed);
+        while (read < write && !read_.compare_exchange_weak(read, write, std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+        }
+    }
+
+private:
+    std::unique_ptr<float[]> buffer_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    std::atomic<size_t> high_water_{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read_{0};
+};
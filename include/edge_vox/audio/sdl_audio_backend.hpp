@@ -0,0 +1,33 @@
+#pragma once
+
+#include <SDL.h>
+#include <SDL_audio.h>
+
+#include "edge_vox/audio/audio_backend.hpp"
+
+//
+// AudioBackend on top of SDL audio devices (the default for audio_async)
+//
+class SdlAudioBackend : public AudioBackend {
+public:
+    SdlAudioBackend() = default;
+    ~SdlAudioBackend() override;
+
+    bool open(AudioDirection direction, int device_id, const AudioBackendSpec& requested,
+              AudioBackendSpec& obtained, Callback callback, void* userdata) override;
+    void pause(AudioDirection direction, bool paused) override;
+    void close(AudioDirection direction) override;
+    bool is_open(AudioDirection direction) const override;
+    void shutdown() override;
+
+    const char* name() const override {
+        return "sdl";
+    }
+
+private:
+    bool init_sdl();
+
+    bool m_sdl_initialized = false;
+    SDL_AudioDeviceID m_dev_id_in = 0;
+    SDL_AudioDeviceID m_dev_id_out = 0;
+};
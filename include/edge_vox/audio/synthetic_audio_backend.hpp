@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "edge_vox/audio/audio_backend.hpp"
+
+struct SyntheticAudioConfig {
+    enum class Waveform { Sine, WhiteNoise, Silence };
+
+    Waveform waveform{Waveform::Sine};
+    float frequency{440.0f};  // Sine only
+    float amplitude{0.5f};
+    uint32_t seed{1};  // WhiteNoise only, for reproducible runs
+    AudioPacing pacing{AudioPacing::RealTime};
+};
+
+//
+// Headless capture source generating a tone or noise at the requested sample rate.
+// Playback streams are accepted and discarded.
+//
+class SyntheticAudioBackend : public PacedAudioBackend {
+public:
+    explicit SyntheticAudioBackend(SyntheticAudioConfig config);
+    ~SyntheticAudioBackend() override;
+
+    const char* name() const override {
+        return "synthetic";
+    }
+
+protected:
+    bool prepare_capture(const AudioBackendSpec& requested, AudioBackendSpec& obtained) override;
+    size_t fill_capture(float* out, size_t frames) override;
+
+private:
+    const SyntheticAudioConfig m_config;
+    AudioBackendSpec m_spec;
+    double m_phase = 0.0;
+    std::minstd_rand m_rng;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "edge_vox/core/audio_stage.hpp"
+
+struct EdgeVoxVadConfig {
+    float threshold_db{-50.0f};  // Frames quieter than this (dBFS) are never speech
+    float snr_db{9.0f};          // ... nor those less than this much above the noise floor
+    float max_zcr{0.35f};        // Zero crossings per sample above which a frame is noise;
+                                 // white noise sits around 0.5, voiced speech far below
+    uint32_t hangover_ms{300};   // Keep sending this long after the last speech frame
+    uint32_t preroll_ms{100};    // Audio sent ahead of each detected onset
+    bool band_energy{false};     // Also require min_band_ratio of the energy in 300-3400 Hz
+    float min_band_ratio{0.3f};
+};
+
+struct EdgeVoxVadStats {
+    uint64_t speech_frames{0};   // Frames passed on, hangover and pre-roll included
+    uint64_t silent_frames{0};   // Frames suppressed
+    uint64_t talkspurts{0};      // Onsets, each starting with a marked RTP packet
+    float noise_floor_db{0.0f};  // Current noise estimate
+};
+
+//
+// Voice activity detection with silence suppression (DTX), as a capture pipeline stage.
+// Decides per frame from its energy against a fixed threshold and an adaptive noise floor,
+// its zero-crossing rate and optionally its share of speech-band energy. Silent frames are
+// dropped, so nothing is sent and the RTP clock skips them; the first frame of every
+// talkspurt carries the pre-roll and starts a new talkspurt at the transport (marker bit).
+// Looks at the first channel only.
+//
+class VoiceActivityStage : public AudioStage {
+public:
+    explicit VoiceActivityStage(const EdgeVoxVadConfig& config = {});
+
+    const char* name() const override {
+        return "vad";
+    }
+
+    bool configure(AudioFormat& format) override;
+    size_t max_frame_samples() const override;
+    bool process(AudioFrame& frame) override;
+    void reset() override;
+
+    // Decision for the last frame processed
+    bool is_speech() const {
+        return speaking_;
+    }
+
+    // Any thread
+    EdgeVoxVadStats get_stats() const;
+
+private:
+    bool is_speech_frame(const float* samples, size_t count);
+    float band_pass(const float* samples, size_t count);
+    void store_preroll(const AudioFrame& frame);
+    void prepend_preroll(AudioFrame& frame);
+
+    EdgeVoxVadConfig config_;
+    AudioFormat format_;
+    uint32_t hangover_frames_ = 0;
+    uint32_t preroll_frames_ = 0;
+
+    // Speech-band biquad (RBJ band-pass) and its state
+    float b0_ = 0.0f, b2_ = 0.0f, a1_ = 0.0f, a2_ = 0.0f;
+    float x1_ = 0.0f, x2_ = 0.0f, y1_ = 0.0f, y2_ = 0.0f;
+
+    float noise_db_ = 0.0f;
+    float noise_rise_db_ = 0.0f;  // Per frame
+    bool first_frame_ = true;
+    bool speaking_ = false;
+    uint32_t hangover_ = 0;
+
+    // Last preroll_frames_ suppressed frames, every channel, oldest at preroll_head_
+    std::vector<float> preroll_;
+    size_t preroll_head_ = 0;
+    size_t preroll_count_ = 0;
+    uint64_t preroll_next_ = 0;  // Sequence number of the frame that would follow them
+
+    std::atomic<uint64_t> speech_frames_{0};
+    std::atomic<uint64_t> silent_frames_{0};
+    std::atomic<uint64_t> talkspurts_{0};
+    std::atomic<float> noise_floor_db_{0.0f};
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Format of the frames flowing between two pipeline stages
+struct AudioFormat {
+    uint32_t sample_rate{48000};
+    uint16_t channels{1};
+    size_t frame_samples{480};  // Per channel; every frame has exactly this many
+};
+
+//
+// One block of audio on its way from capture to the network. Channels are planar: channel c
+// starts at channel(c) and holds samples values. Frames are allocated once, large enough for
+// every stage of the pipeline, and reused.
+//
+struct AudioFrame {
+    uint64_t sequence{0};         // Frame number since the pipeline started, gaps included
+    int64_t captured_ns{0};       // Steady clock when the last sample was captured
+    uint32_t sample_rate{0};
+    uint16_t channels{0};
+    size_t samples{0};            // Per channel
+    size_t stride{0};             // Distance between channels in data
+    bool talkspurt_start{false};  // First frame after a silence the transport didn't send
+    std::vector<float> data;
+
+    float* channel(size_t c) {
+        return data.data() + c * stride;
+    }
+    const float* channel(size_t c) const {
+        return data.data() + c * stride;
+    }
+};
+
+//
+// A processing step of the capture pipeline (DSP, VAD, ...). Stages work on frames in place
+// and may change their format, as long as they say so in configure(). process() runs on the
+// thread the stage is bound to and must not block.
+//
+class AudioStage {
+public:
+    virtual ~AudioStage() = default;
+
+    virtual const char* name() const = 0;
+
+    // Called before the pipeline starts with the format of the incoming frames; update it to
+    // the format going out. Return false to refuse the format.
+    virtual bool configure(AudioFormat& format) {
+        (void)format;
+        return true;
+    }
+
+    // Largest frame the stage writes, per channel, if more than the output format says
+    virtual size_t max_frame_samples() const {
+        return 0;
+    }
+
+    // Transform the frame in place. Return false to drop it; later stages never see it and
+    // the transport skips its duration. A frame may grow past frame_samples to bring back
+    // audio of frames dropped just before it: it still ends where its sequence number says.
+    virtual bool process(AudioFrame& frame) = 0;
+
+    // Forget any state carried between frames; called on every start
+    virtual void reset() {}
+};
+
+// Where a stage runs
+struct AudioStageBinding {
+    bool own_thread{false};     // Give the stage a worker thread fed through its own queue;
+                                // otherwise it runs on the thread of the stage before it
+    uint32_t queue_frames{32};  // Depth of that queue; frames that don't fit are dropped
+};
@@ -3,8 +3,13 @@
 #include <string>
 
 #include "edge_vox/audio/audio_config.hpp"
+#include "edge_vox/core/audio_stage.hpp"
+#include "edge_vox/core/pipeline_stats.hpp"
+#include "edge_vox/net/rtp_stats.hpp"
 #include "edge_vox/net/stream_config.hpp"
 
+class AudioBackend;
+
 class EdgeVoxClient {
 public:
     EdgeVoxClient();
@@ -20,10 +25,33 @@ public:
     void stop_audio_stream();
     bool is_streaming() const;
 
+    // Audio from the server (e.g. TTS), received as RTP on stream_config.receive_port and
+    // played back through the audio device. Requires a connection.
+    bool start_receiving();
+    void stop_receiving();
+    bool is_receiving() const;
+    EdgeVoxRtpReceiveStats get_receive_stats() const;
+
+    // Loss, jitter and round-trip time from the RTCP reports exchanged while connected
+    EdgeVoxRtcpStats get_rtcp_stats() const;
+
+    // Queueing, drops and wake-to-send latency of the thread that sends captured audio
+    EdgeVoxSenderStats get_sender_stats() const;
+
+    // Processing between capture and the sender thread. Stages run in the order added, on the
+    // audio thread or a thread of their own; they must leave mono audio at the capture rate.
+    // Throws while streaming.
+    void add_audio_stage(std::unique_ptr<AudioStage> stage, const AudioStageBinding& binding = {});
+    EdgeVoxPipelineStats get_pipeline_stats() const;
+
     // Configuration
     void set_audio_config(const EdgeVoxAudioConfig& config);
     void set_stream_config(const EdgeVoxStreamConfig& config);
 
+    // Replace the SDL audio devices, e.g. with a FileAudioBackend or SyntheticAudioBackend
+    // for headless runs. Must be called before connect().
+    void set_audio_backend(std::unique_ptr<AudioBackend> backend);
+
     // Status callbacks
     using StatusCallback = std::function<void(const std::string& status)>;
     void set_status_callback(StatusCallback callback);
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One stage of the capture pipeline
+struct EdgeVoxStageStats {
+    std::string name;
+    uint64_t frames{0};           // Frames processed
+    uint64_t dropped{0};          // Frames the stage chose to drop
+    uint64_t overflows{0};        // Frames lost to a full input queue (own thread only)
+    uint32_t queue_depth{0};      // Frames waiting in its input queue
+    uint32_t max_queue_depth{0};  // Most frames that ever waited there
+    double avg_process_us{0.0};   // Time spent in process() per frame
+    double max_process_us{0.0};
+};
+
+// Capture -> DSP -> transport, in stage order
+struct EdgeVoxPipelineStats {
+    uint64_t frames{0};     // Frames cut from captured audio
+    uint64_t delivered{0};  // Frames that reached the transport
+    std::vector<EdgeVoxStageStats> stages;
+};
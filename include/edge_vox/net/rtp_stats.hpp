@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Counters of the inbound RTP audio path
+struct EdgeVoxRtpReceiveStats {
+    uint64_t packets{0};           // Valid RTP packets received
+    uint64_t bytes{0};             // Datagram bytes, headers included
+    uint64_t syscalls{0};          // recvmmsg calls that returned packets
+    uint64_t invalid{0};           // Datagrams dropped as malformed or truncated
+    uint64_t foreign{0};           // Packets of neither the codec's nor the parity payload type
+    uint64_t lost{0};              // Packets missing from the sequence number space
+    uint64_t out_of_order{0};      // Late or duplicate packets, dropped
+    uint64_t samples{0};           // Samples handed to playback, concealment included
+    uint64_t playback_drops{0};    // Packets the playback buffer had no room for
+    uint64_t fec_recovered{0};     // Lost packets rebuilt from in-band FEC (Opus)
+    uint64_t parity_packets{0};    // XOR parity packets received, not counted in packets
+    uint64_t parity_bytes{0};      // Their datagram bytes: the FEC overhead
+    uint64_t parity_recovered{0};  // Lost packets rebuilt from parity
+
+    // Jitter buffer state, zero when it is disabled
+    uint64_t jitter_depth{0};     // Frames buffered ahead of the playout point
+    uint32_t target_delay_ms{0};  // Adaptive playout delay
+    double jitter_ms{0.0};        // Interarrival jitter estimate
+    uint64_t concealed{0};        // Frames synthesized for lost or late packets
+};
+
+// RTCP view of both directions, refreshed as reports are exchanged with the server
+struct EdgeVoxRtcpStats {
+    uint64_t reports_sent{0};      // Compound SR/RR packets sent
+    uint64_t reports_received{0};  // SR/RR packets received from the server
+    uint64_t invalid{0};           // Malformed RTCP datagrams
+    uint64_t nack_requests{0};     // Sequence numbers the server asked to have resent
+
+    // Outbound audio, from the server's reception reports about our SSRC
+    double rtt_ms{0.0};                 // Round-trip time from LSR/DLSR, 0 until measured
+    double remote_fraction_lost{0.0};   // 0..1 over the server's last report interval
+    int64_t remote_cumulative_lost{0};  // Packets lost since the stream started
+    double remote_jitter_ms{0.0};       // Interarrival jitter seen by the server
+
+    // Inbound audio, as measured here and reported to the server
+    double fraction_lost{0.0};
+    int64_t cumulative_lost{0};
+    double jitter_ms{0.0};
+};
+
+// Dedicated sender thread between audio capture and the RTP streamer
+struct EdgeVoxSenderStats {
+    static constexpr size_t HISTOGRAM_SIZE = 24;
+
+    uint64_t chunks{0};           // Queued chunks handed to the streamer
+    uint64_t samples{0};          // Samples in them
+    uint64_t wakeups{0};          // Times the thread woke up to find work
+    uint64_t dropped_chunks{0};   // Chunks dropped by the queue's drop policy
+    uint64_t dropped_samples{0};  // Samples in them; the RTP clock skips over these
+    uint64_t max_queued{0};       // Most samples waiting at once
+    uint64_t max_latency_us{0};
+    bool realtime{false};  // Running under SCHED_FIFO
+    bool pinned{false};    // Bound to the requested CPU
+    // latency_us[n]: chunks sent within [2^(n-1), 2^n) us of being queued; 0 is under 1 us
+    std::array<uint64_t, HISTOGRAM_SIZE> latency_us{};
+};
@@ -5,6 +5,22 @@ struct EdgeVoxStreamConfig {
     std::string server_ip;
     uint16_t rtp_port{5004};
     uint16_t control_port{1883};
-    uint32_t packet_size{512};
+    uint16_t receive_port{5006};  // Local port for RTP audio from the server
+    uint32_t packet_size{512};  // Payload byte budget, used when ptime_ms is 0
+    uint32_t ptime_ms{10};      // Audio per RTP packet (10/20/40/60 ms)
+    uint32_t mtu{1500};         // Upper bound for a whole datagram including IP/UDP headers
+    uint32_t batch_packets{0};  // Packets per sendmmsg/GSO syscall; 0 or 1 sends one at a time
+    bool udp_gso{false};        // Use UDP_SEGMENT offload for batches when the kernel has it
+    uint32_t fec_group{0};       // Media packets per XOR parity packet, both ways; 0 disables
+    uint32_t fec_interleave{1};  // Spread each group over every n-th packet to survive bursts
+    uint32_t rtx_history_ms{0};       // Resend packets the server NACKs over RTCP; 0 disables
+    uint32_t rtx_max_bitrate{64000};  // Cap on retransmissions, bits per second
+    uint32_t sender_queue_ms{200};    // Capture the sender thread may fall behind by, then
+    bool sender_drop_oldest{true};    // skip queued audio (true) or refuse new audio (false)
+    int sender_priority{0};           // SCHED_FIFO priority of the sender thread; 0 for none
+    int sender_cpu{-1};               // CPU to pin the sender thread to; -1 for any
+    uint32_t jitter_min_ms{20};   // Playout delay range of the receive jitter buffer;
+    uint32_t jitter_max_ms{200};  // a maximum of 0 plays packets as they arrive
+    uint32_t rtcp_interval_ms{5000};  // SR/RR on rtp_port + 1 and receive_port + 1; 0 disables
     std::string control_topic{"status/server"};
 };
\ No newline at end of file
@@ -22,19 +22,34 @@
 
 #include "edge_vox/audio/audio_async.hpp"
 
-audio_async::audio_async(int len_ms) {
+#include "audio/channel_mix.hpp"
+
+audio_async::audio_async(int len_ms) : audio_async(len_ms, std::make_unique<SdlAudioBackend>()) {}
+
+audio_async::audio_async(int len_ms, std::unique_ptr<AudioBackend> backend)
+    : m_backend(std::move(backend)) {
     m_len_ms = len_ms;
+    m_playback_high_water_ms = len_ms;
 
     m_running = false;
+    m_playing = false;
 }
 
 audio_async::~audio_async() {
-    if (m_dev_id_in) {
-        SDL_CloseAudioDevice(m_dev_id_in);
+    if (m_backend) {
+        m_backend->close(AudioDirection::Capture);
+        m_backend->close(AudioDirection::Playback);
     }
-    if (m_dev_id_out) {
-        SDL_CloseAudioDevice(m_dev_id_out);
+}
+
+bool audio_async::set_backend(std::unique_ptr<AudioBackend> backend) {
+    if (has_capture() || has_playback()) {
+        fprintf(stderr, "%s: can't replace the backend while devices are open\n", __func__);
+        return false;
     }
+
+    m_backend = std::move(backend);
+    return true;
 }
 
 bool audio_async::init(int capture_id, int sample_rate) {
@@ -43,128 +58,81 @@ bool audio_async::init(int capture_id, int sample_rate) {
 }
 
 bool audio_async::init(int capture_id, int playback_id, int sample_rate) {
-    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+    return init(capture_id, playback_id, sample_rate, 1);
+}
 
-    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+bool audio_async::init(int capture_id, int playback_id, int sample_rate, int channels) {
+    if (!m_backend) {
+        fprintf(stderr, "%s: no audio backend!\n", __func__);
         return false;
     }
 
-    SDL_SetHintWithPriority(SDL_HINT_AUDIO_RESAMPLING_MODE, "medium", SDL_HINT_OVERRIDE);
+    AudioBackendSpec requested;
+    requested.sample_rate = sample_rate;
+    requested.channels = std::max(channels, 1);
+    requested.frames_per_buffer = 1024;
 
-    // List capture devices
-    {
-        int nDevices = SDL_GetNumAudioDevices(SDL_TRUE);
-        fprintf(stderr, "%s: found %d capture devices:\n", __func__, nDevices);
-        for (int i = 0; i < nDevices; i++) {
-            fprintf(stderr, "%s:    - Capture device #%d: '%s'\n", __func__, i,
-                    SDL_GetAudioDeviceName(i, SDL_TRUE));
-        }
-    }
-
-    // List playback devices
-    {
-        int nDevices = SDL_GetNumAudioDevices(SDL_FALSE);
-        fprintf(stderr, "%s: found %d playback devices:\n", __func__, nDevices);
-        for (int i = 0; i < nDevices; i++) {
-            fprintf(stderr, "%s:    - Playback device #%d: '%s'\n", __func__, i,
-                    SDL_GetAudioDeviceName(i, SDL_FALSE));
-        }
-    }
-
-    SDL_AudioSpec capture_spec_requested;
-    SDL_AudioSpec capture_spec_obtained;
-    SDL_AudioSpec playback_spec_requested;
-    SDL_AudioSpec playback_spec_obtained;
-
-    SDL_zero(capture_spec_requested);
-    SDL_zero(capture_spec_obtained);
-    SDL_zero(playback_spec_requested);
-    SDL_zero(playback_spec_obtained);
-
-    // Configure capture spec
-    capture_spec_requested.freq = sample_rate;
-    capture_spec_requested.format = AUDIO_F32;
-    capture_spec_requested.channels = 1;
-    capture_spec_requested.samples = 1024;
-    capture_spec_requested.callback = [](void *userdata, uint8_t *stream, int len) {
-        audio_async *audio = (audio_async *)userdata;
-        audio->capture_callback(stream, len);
-    };
-    capture_spec_requested.userdata = this;
-
-    // Configure playback spec
-    playback_spec_requested.freq = sample_rate;
-    playback_spec_requested.format = AUDIO_F32;
-    playback_spec_requested.channels = 1;
-    playback_spec_requested.samples = 1024;
-    playback_spec_requested.callback = [](void *userdata, uint8_t *stream, int len) {
-        audio_async *audio = (audio_async *)userdata;
-        audio->playback_callback(stream, len);
-    };
-    playback_spec_requested.userdata = this;
+    AudioBackendSpec capture_obtained;
+    AudioBackendSpec playback_obtained;
 
     // Open capture device
-    if (capture_id >= 0) {
-        fprintf(stderr, "%s: attempt to open capture device %d : '%s' ...\n", __func__, capture_id,
-                SDL_GetAudioDeviceName(capture_id, SDL_TRUE));
-        m_dev_id_in = SDL_OpenAudioDevice(SDL_GetAudioDeviceName(capture_id, SDL_TRUE), SDL_TRUE,
-                                          &capture_spec_requested, &capture_spec_obtained, 0);
-    } else {
-        fprintf(stderr, "%s: attempt to open default capture device ...\n", __func__);
-        m_dev_id_in = SDL_OpenAudioDevice(nullptr, SDL_TRUE, &capture_spec_requested,
-                                          &capture_spec_obtained, 0);
-    }
-
-    if (!m_dev_id_in) {
-        fprintf(stderr, "%s: couldn't open an audio device for capture: %s!\n", __func__,
-                SDL_GetError());
+    if (!m_backend->open(
+            AudioDirection::Capture, capture_id, requested, capture_obtained,
+            [](void *userdata, uint8_t *stream, int len) {
+                static_cast<audio_async *>(userdata)->capture_callback(stream, len);
+            },
+            this)) {
+        fprintf(stderr, "%s: couldn't open an audio device for capture!\n", __func__);
         return false;
     }
 
+    // Play back mono at the rate we capture at
+    requested.sample_rate = capture_obtained.sample_rate;
+    requested.channels = 1;
+
     // Open playback device
-    if (playback_id >= 0) {
-        fprintf(stderr, "%s: attempt to open playback device %d : '%s' ...\n", __func__,
-                playback_id, SDL_GetAudioDeviceName(playback_id, SDL_FALSE));
-        m_dev_id_out =
-            SDL_OpenAudioDevice(SDL_GetAudioDeviceName(playback_id, SDL_FALSE), SDL_FALSE,
-                                &playback_spec_requested, &playback_spec_obtained, 0);
-    } else {
-        fprintf(stderr, "%s: attempt to open default playback device ...\n", __func__);
-        m_dev_id_out = SDL_OpenAudioDevice(nullptr, SDL_FALSE, &playback_spec_requested,
-                                           &playback_spec_obtained, 0);
-    }
-
-    if (!m_dev_id_out) {
-        fprintf(stderr, "%s: couldn't open an audio device for playback: %s!\n", __func__,
-                SDL_GetError());
+    if (!m_backend->open(
+            AudioDirection::Playback, playback_id, requested, playback_obtained,
+            [](void *userdata, uint8_t *stream, int len) {
+                static_cast<audio_async *>(userdata)->playback_callback(stream, len);
+            },
+            this)) {
+        fprintf(stderr, "%s: couldn't open an audio device for playback!\n", __func__);
         // Close capture device since we failed
-        if (m_dev_id_in) {
-            SDL_CloseAudioDevice(m_dev_id_in);
-            m_dev_id_in = 0;
-        }
+        m_backend->close(AudioDirection::Capture);
         return false;
     }
 
-    m_sample_rate = capture_spec_obtained.freq;
-    m_capture_buffer.resize((m_sample_rate * m_len_ms) / 1000);
-    m_playback_buffer.reserve(m_sample_rate);  // Reserve 1 second worth of samples
+    fprintf(stderr, "%s: %s backend capturing %d channels at %d Hz\n", __func__,
+            m_backend->name(), capture_obtained.channels, capture_obtained.sample_rate);
+
+    m_sample_rate = capture_obtained.sample_rate;
+    m_channels = capture_obtained.channels;
+    m_mix_weights.assign(m_channels, 1.0f / m_channels);
+    m_capture_buffer.reset((m_sample_rate * m_len_ms) / 1000);
+    m_channel_buffer.reset(m_channels > 1 ? (m_sample_rate * m_len_ms) / 1000 : 0, m_channels);
+    m_playback_buffer.reset((m_sample_rate * m_len_ms) / 1000);
+    set_playback_high_water(m_playback_high_water_ms);
 
     return true;
 }
 
-bool audio_async::resume() {
-    bool success = true;
+int audio_async::get_sample_rate() const {
+    return m_sample_rate;
+}
 
-    if (m_dev_id_in) {
-        SDL_PauseAudioDevice(m_dev_id_in, 0);
-    }
+int audio_async::get_channels() const {
+    return m_channels;
+}
 
-    if (m_dev_id_out) {
-        SDL_PauseAudioDevice(m_dev_id_out, 0);
-    }
+void audio_async::set_capture_mix(int channel) {
+    m_mix_channel = channel < m_channels ? channel : -1;
+}
+
+bool audio_async::resume() {
+    bool success = true;
 
-    if (!m_dev_id_in && !m_dev_id_out) {
+    if (!has_capture() && !has_playback()) {
         fprintf(stderr, "%s: no audio devices available\n", __func__);
         success = false;
     }
@@ -174,22 +142,32 @@ bool audio_async::resume() {
         // Still return true since this isn't a failure
     }
 
+    // Mark running before unpausing so the first callback isn't dropped
     m_running = true;
+
+    if (has_capture()) {
+        m_backend->pause(AudioDirection::Capture, false);
+    }
+
+    if (has_playback()) {
+        m_backend->pause(AudioDirection::Playback, false);
+    }
+
     return success;
 }
 
 bool audio_async::pause() {
     bool success = true;
 
-    if (m_dev_id_in) {
-        SDL_PauseAudioDevice(m_dev_id_in, 1);
+    if (has_capture()) {
+        m_backend->pause(AudioDirection::Capture, true);
     }
 
-    if (m_dev_id_out) {
-        SDL_PauseAudioDevice(m_dev_id_out, 1);
+    if (has_playback()) {
+        m_backend->pause(AudioDirection::Playback, true);
     }
 
-    if (!m_dev_id_in && !m_dev_id_out) {
+    if (!has_capture() && !has_playback()) {
         fprintf(stderr, "%s: no audio devices available\n", __func__);
         success = false;
     }
@@ -205,7 +183,7 @@ bool audio_async::pause() {
 }
 
 bool audio_async::clear() {
-    if (!m_dev_id_in) {
+    if (!has_capture()) {
         fprintf(stderr, "%s: no audio device to clear!\n", __func__);
         return false;
     }
@@ -215,76 +193,71 @@ bool audio_async::clear() {
         return false;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-
-        m_capture_buffer_pos = 0;
-        m_capture_buffer_len = 0;
-    }
+    m_capture_buffer.clear();
 
     return true;
 }
 
 bool audio_async::close() {
-    if (!m_dev_id_in && !m_dev_id_out) {
+    if (!has_capture() && !has_playback()) {
         fprintf(stderr, "%s: no audio devices to close!\n", __func__);
         return false;
     }
 
-    if (m_dev_id_in) {
-        SDL_CloseAudioDevice(m_dev_id_in);
-        m_dev_id_in = 0;
-    }
-
-    if (m_dev_id_out) {
-        SDL_CloseAudioDevice(m_dev_id_out);
-        m_dev_id_out = 0;
-    }
-
-    SDL_QuitSubSystem(SDL_INIT_AUDIO);
-    SDL_Quit();
+    m_backend->close(AudioDirection::Capture);
+    m_backend->close(AudioDirection::Playback);
+    m_backend->shutdown();
 
     return true;
 }
 
-// callback to be called by SDL
+// callback to be called by the audio backend
 void audio_async::capture_callback(uint8_t *stream, int len) {
     if (!m_running) {
         return;
     }
 
-    size_t n_samples = len / sizeof(float);
-
-    if (n_samples > m_capture_buffer.size()) {
-        n_samples = m_capture_buffer.size();
-
-        stream += (len - (n_samples * sizeof(float)));
+    // Lock-free: never block the real-time audio thread behind a reader
+    const auto *samples = reinterpret_cast<const float *>(stream);
+    if (m_channels == 1) {
+        m_capture_buffer.write(samples, len / sizeof(float));
+        if (m_capture_listener) {
+            m_capture_listener(samples, len / sizeof(float));
+        }
+        return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-
-        if (m_capture_buffer_pos + n_samples > m_capture_buffer.size()) {
-            const size_t n0 = m_capture_buffer.size() - m_capture_buffer_pos;
-
-            memcpy(&m_capture_buffer[m_capture_buffer_pos], stream, n0 * sizeof(float));
-            memcpy(&m_capture_buffer[0], stream + n0 * sizeof(float),
-                   (n_samples - n0) * sizeof(float));
-
-            m_capture_buffer_pos = (m_capture_buffer_pos + n_samples) % m_capture_buffer.size();
-            m_capture_buffer_len = m_capture_buffer.size();
+    // Deinterleave and mix straight into the rings; the mono listener reads the mix there
+    const size_t channels = m_channels;
+    const size_t frames = len / (sizeof(float) * channels);
+    m_channel_buffer.write_with(
+        frames, [&](float *dst, size_t stride, size_t offset, size_t count) {
+            deinterleave(samples + offset * channels, count, channels, dst, stride);
+        });
+    m_capture_buffer.write_with(frames, [&](float *dst, size_t, size_t offset, size_t count) {
+        const float *block = samples + offset * channels;
+        if (m_mix_channel >= 0) {
+            select_channel(block, count, channels, m_mix_channel, dst);
         } else {
-            memcpy(&m_capture_buffer[m_capture_buffer_pos], stream, n_samples * sizeof(float));
-
-            m_capture_buffer_pos = (m_capture_buffer_pos + n_samples) % m_capture_buffer.size();
-            m_capture_buffer_len =
-                std::min(m_capture_buffer_len + n_samples, m_capture_buffer.size());
+            downmix(block, count, channels, m_mix_weights.data(), dst);
+        }
+        if (m_capture_listener && !m_listener_all_channels) {
+            m_capture_listener(dst, count);
         }
+    });
+
+    if (m_capture_listener && m_listener_all_channels) {
+        m_capture_listener(samples, frames * channels);
     }
 }
 
+void audio_async::set_capture_listener(CaptureListener listener, bool all_channels) {
+    m_capture_listener = std::move(listener);
+    m_listener_all_channels = all_channels;
+}
+
 void audio_async::get(int ms, std::vector<float> &result) {
-    if (!m_dev_id_in) {
+    if (!has_capture()) {
         fprintf(stderr, "%s: no audio device to get audio from!\n", __func__);
         return;
     }
@@ -294,94 +267,139 @@ void audio_async::get(int ms, std::vector<float> &result) {
         return;
     }
 
-    result.clear();
+    if (ms <= 0) {
+        ms = m_len_ms;
+    }
 
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t n_samples =
+        std::min((static_cast<size_t>(m_sample_rate) * ms) / 1000, m_capture_buffer.size());
 
-        if (ms <= 0) {
-            ms = m_len_ms;
-        }
+    result.resize(n_samples);
+    result.resize(m_capture_buffer.read_latest(n_samples, result.data()));
+}
 
-        size_t n_samples = (m_sample_rate * ms) / 1000;
-        if (n_samples > m_capture_buffer_len) {
-            n_samples = m_capture_buffer_len;
-        }
+CaptureView audio_async::get_view(int ms) const {
+    if (!has_capture() || !m_running) {
+        return CaptureView();
+    }
 
-        result.resize(n_samples);
+    if (ms <= 0) {
+        ms = m_len_ms;
+    }
 
-        signed long long s0 = m_capture_buffer_pos - n_samples;
-        if (s0 < 0) {
-            s0 += m_capture_buffer.size();
-        }
+    return m_capture_buffer.view_latest((static_cast<size_t>(m_sample_rate) * ms) / 1000);
+}
 
-        if (s0 + n_samples > m_capture_buffer.size()) {
-            const size_t n0 = m_capture_buffer.size() - s0;
+bool audio_async::is_view_valid(const CaptureView &view) const {
+    return m_capture_buffer.validate(view);
+}
 
-            memcpy(result.data(), &m_capture_buffer[s0], n0 * sizeof(float));
-            memcpy(&result[n0], &m_capture_buffer[0], (n_samples - n0) * sizeof(float));
-        } else {
-            memcpy(result.data(), &m_capture_buffer[s0], n_samples * sizeof(float));
-        }
+CaptureView audio_async::get_channel_view(int channel, int ms) const {
+    if (m_channels == 1) {
+        return channel == 0 ? get_view(ms) : CaptureView();
+    }
+    if (!has_capture() || !m_running || channel < 0 || channel >= m_channels) {
+        return CaptureView();
     }
+
+    if (ms <= 0) {
+        ms = m_len_ms;
+    }
+
+    return m_channel_buffer.view_latest((static_cast<size_t>(m_sample_rate) * ms) / 1000,
+                                        channel);
 }
 
-void audio_async::playback_callback(uint8_t *stream, int len) {
-    if (!m_running || m_playback_buffer.empty()) {
-        // Fill with silence if no data
-        memset(stream, 0, len);
-        return;
+bool audio_async::is_channel_view_valid(const CaptureView &view) const {
+    return m_channels == 1 ? m_capture_buffer.validate(view) : m_channel_buffer.validate(view);
+}
+
+size_t audio_async::read_new(size_t max, float *out, uint64_t *sample_index, uint64_t *overrun) {
+    if (!has_capture() || !m_running) {
+        return 0;
     }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capture_buffer.read_new(max, out, sample_index, overrun);
+}
+
+size_t audio_async::get_available() const {
+    return m_capture_buffer.available();
+}
+
+uint64_t audio_async::get_overrun_count() const {
+    return m_capture_buffer.overrun_count();
+}
+
+void audio_async::playback_callback(uint8_t *stream, int len) {
     size_t samples_needed = len / sizeof(float);
-    size_t samples_to_copy = std::min(samples_needed, m_playback_buffer.size());
+    size_t samples_copied = 0;
 
-    // Copy available samples
-    memcpy(stream, m_playback_buffer.data(), samples_to_copy * sizeof(float));
+    // Playback runs with the capture stream (resume) or on its own (start_playback)
+    if (m_running || m_playing) {
+        samples_copied = m_playback_buffer.read(reinterpret_cast<float *>(stream), samples_needed);
+    }
 
     // Fill remaining with silence if we run out of data
-    if (samples_to_copy < samples_needed) {
-        memset(stream + (samples_to_copy * sizeof(float)), 0,
-               (samples_needed - samples_to_copy) * sizeof(float));
+    if (samples_copied < samples_needed) {
+        memset(stream + (samples_copied * sizeof(float)), 0,
+               (samples_needed - samples_copied) * sizeof(float));
     }
-
-    // Remove used samples from buffer
-    m_playback_buffer.erase(m_playback_buffer.begin(), m_playback_buffer.begin() + samples_to_copy);
 }
 
 bool audio_async::play_audio(const std::vector<float> &audio) {
-    if (!m_dev_id_out) {
+    return play_audio(audio.data(), audio.size());
+}
+
+bool audio_async::play_audio(const float *samples, size_t n_samples) {
+    if (!has_playback()) {
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_playback_buffer.insert(m_playback_buffer.end(), audio.begin(), audio.end());
-    return true;
+    return m_playback_buffer.write(samples, n_samples);
+}
+
+void audio_async::clear_playback_buffer() {
+    m_playback_buffer.clear();
+}
+
+size_t audio_async::get_playback_buffer_size() const {
+    return m_playback_buffer.size();
+}
+
+void audio_async::set_playback_high_water(int ms) {
+    m_playback_high_water_ms = ms;
+    m_playback_buffer.set_high_water((static_cast<size_t>(m_sample_rate) * ms) / 1000);
 }
 
 bool audio_async::start_playback() {
-    if (!m_dev_id_out) {
+    if (!has_playback()) {
         fprintf(stderr, "%s: no playback device available\n", __func__);
         return false;
     }
 
-    SDL_PauseAudioDevice(m_dev_id_out, 0);
+    m_backend->pause(AudioDirection::Playback, false);
     m_playing = true;
     return true;
 }
 
 bool audio_async::stop_playback() {
-    if (!m_dev_id_out) {
+    if (!has_playback()) {
         fprintf(stderr, "%s: no playback device available\n", __func__);
         return false;
     }
 
-    SDL_PauseAudioDevice(m_dev_id_out, 1);
+    m_backend->pause(AudioDirection::Playback, true);
     m_playing = false;
     return true;
 }
 
 bool audio_async::is_playing() const {
-    return m_dev_id_out != 0 && m_playing;
-}
\ No newline at end of file
+    return has_playback() && m_playing;
+}
+bool audio_async::has_capture() const {
+    return m_backend && m_backend->is_open(AudioDirection::Capture);
+}
+
+bool audio_async::has_playback() const {
+    return m_backend && m_backend->is_open(AudioDirection::Playback);
+}
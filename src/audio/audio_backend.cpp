@@ -0,0 +1,167 @@
+#include "edge_vox/audio/audio_backend.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+PacedAudioBackend::PacedAudioBackend(AudioPacing pacing) : m_pacing(pacing) {}
+
+PacedAudioBackend::~PacedAudioBackend() {
+    stop_thread();  // Normally stopped already by the derived class
+}
+
+PacedAudioBackend::Stream& PacedAudioBackend::stream(AudioDirection direction) {
+    return direction == AudioDirection::Capture ? m_capture : m_playback;
+}
+
+const PacedAudioBackend::Stream& PacedAudioBackend::stream(AudioDirection direction) const {
+    return direction == AudioDirection::Capture ? m_capture : m_playback;
+}
+
+bool PacedAudioBackend::open(AudioDirection direction, int /*device_id*/,
+                             const AudioBackendSpec& requested, AudioBackendSpec& obtained,
+                             Callback callback, void* userdata) {
+    if (!callback || requested.frames_per_buffer <= 0) {
+        return false;
+    }
+
+    obtained = requested;
+    if (direction == AudioDirection::Capture) {
+        if (!prepare_capture(requested, obtained)) {
+            fprintf(stderr, "%s: %s backend couldn't open capture stream\n", __func__, name());
+            return false;
+        }
+        m_exhausted = false;
+    }
+
+    if (obtained.sample_rate <= 0 || obtained.channels <= 0) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Stream& s = stream(direction);
+        s.open = true;
+        s.paused = true;
+        s.spec = obtained;
+        s.callback = callback;
+        s.userdata = userdata;
+        s.buffer.assign(static_cast<size_t>(obtained.frames_per_buffer) * obtained.channels, 0.0f);
+    }
+
+    fprintf(stderr, "%s: %s backend opened %s stream: %d Hz, %d channels\n", __func__, name(),
+            direction == AudioDirection::Capture ? "capture" : "playback", obtained.sample_rate,
+            obtained.channels);
+
+    start_thread();
+    return true;
+}
+
+void PacedAudioBackend::pause(AudioDirection direction, bool paused) {
+    stream(direction).paused = paused;
+}
+
+void PacedAudioBackend::close(AudioDirection direction) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Stream& s = stream(direction);
+        s.open = false;
+        s.paused = true;
+        s.callback = nullptr;
+        s.userdata = nullptr;
+    }
+
+    if (!m_capture.open && !m_playback.open) {
+        stop_thread();
+    }
+}
+
+bool PacedAudioBackend::is_open(AudioDirection direction) const {
+    return stream(direction).open;
+}
+
+bool PacedAudioBackend::source_exhausted() const {
+    return m_exhausted;
+}
+
+uint64_t PacedAudioBackend::captured_frames() const {
+    return m_captured_frames;
+}
+
+uint64_t PacedAudioBackend::played_frames() const {
+    return m_played_frames;
+}
+
+void PacedAudioBackend::start_thread() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+
+    m_thread = std::thread(&PacedAudioBackend::run, this);
+}
+
+void PacedAudioBackend::stop_thread() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void PacedAudioBackend::run() {
+    using clock = std::chrono::steady_clock;
+
+    auto next = clock::now();
+
+    while (m_running) {
+        // Poll at 1ms while both streams are idle
+        std::chrono::nanoseconds period = std::chrono::milliseconds(1);
+        bool active = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_playback.open && !m_playback.paused) {
+                const AudioBackendSpec& spec = m_playback.spec;
+                m_playback.callback(m_playback.userdata,
+                                    reinterpret_cast<uint8_t*>(m_playback.buffer.data()),
+                                    m_playback.buffer.size() * sizeof(float));
+                m_played_frames += spec.frames_per_buffer;
+
+                period = std::chrono::nanoseconds(1000000000LL * spec.frames_per_buffer /
+                                                  spec.sample_rate);
+                active = true;
+            }
+
+            if (m_capture.open && !m_capture.paused && !m_exhausted) {
+                const AudioBackendSpec& spec = m_capture.spec;
+                const size_t frames = fill_capture(m_capture.buffer.data(), spec.frames_per_buffer);
+                if (frames < static_cast<size_t>(spec.frames_per_buffer)) {
+                    m_exhausted = true;
+                }
+
+                if (frames > 0) {
+                    m_capture.callback(m_capture.userdata,
+                                       reinterpret_cast<uint8_t*>(m_capture.buffer.data()),
+                                       frames * spec.channels * sizeof(float));
+                    m_captured_frames += frames;
+                }
+
+                // The capture clock wins when both streams run
+                period = std::chrono::nanoseconds(1000000000LL * spec.frames_per_buffer /
+                                                  spec.sample_rate);
+                active = true;
+            }
+        }
+
+        if (m_pacing == AudioPacing::AsFastAsPossible && active) {
+            continue;
+        }
+
+        // Don't try to catch up in a burst after a stall
+        const auto now = clock::now();
+        next = std::max(next + period, now - period);
+        std::this_thread::sleep_until(next);
+    }
+}
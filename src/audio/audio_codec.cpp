@@ -0,0 +1,434 @@
+#include "audio/audio_codec.hpp"
+
+#include <algorithm>
+
+#include "audio/pcm_convert.hpp"
+
+#ifdef EDGE_VOX_HAVE_OPUS
+#include "audio/opus_codec.hpp"
+#endif
+
+namespace {
+constexpr uint8_t PT_PCMU = 0;  // RFC 3551 static payload types
+constexpr uint8_t PT_PCMA = 8;
+constexpr uint8_t PT_L16 = 11;  // What the server has always received, at any rate
+constexpr uint8_t PT_DYNAMIC_PCMU = 96;
+constexpr uint8_t PT_DYNAMIC_PCMA = 97;
+constexpr uint8_t PT_DYNAMIC_DVI4 = 98;
+
+constexpr size_t DVI4_HEADER_SIZE = 4;  // Predicted value (16), step index (8), reserved (8)
+constexpr size_t QUANTIZE_BLOCK = 256;  // Samples converted to int16 per pass
+
+constexpr float PCM_INV_SCALE = 1.0f / 32768.0f;
+
+//
+// G.711 tables, built once. Encoding indexes by the top 14 (mu-law) or 13 (A-law) bits of
+// the linear sample, decoding by the code byte, so both directions are a single load.
+//
+struct G711Tables {
+    uint8_t ulaw_encode[1 << 14];
+    uint8_t alaw_encode[1 << 13];
+    float ulaw_decode[256];
+    float alaw_decode[256];
+
+    G711Tables() {
+        for (int i = 0; i < (1 << 14); i++) {
+            ulaw_encode[i] = linear_to_ulaw(static_cast<int16_t>(i << 2));
+        }
+        for (int i = 0; i < (1 << 13); i++) {
+            alaw_encode[i] = linear_to_alaw(static_cast<int16_t>(i << 3));
+        }
+        for (int c = 0; c < 256; c++) {
+            ulaw_decode[c] = ulaw_to_linear(static_cast<uint8_t>(c)) * PCM_INV_SCALE;
+            alaw_decode[c] = alaw_to_linear(static_cast<uint8_t>(c)) * PCM_INV_SCALE;
+        }
+    }
+
+    static int segment(int value, const int* ends) {
+        int seg = 0;
+        while (seg < 8 && value > ends[seg]) {
+            seg++;
+        }
+        return seg;
+    }
+
+    // ITU-T G.711 reference algorithms (as in the public domain Sun implementation)
+    static uint8_t linear_to_ulaw(int16_t pcm) {
+        static const int ends[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+        int value = pcm >> 2;
+        int mask = 0xFF;
+        if (value < 0) {
+            value = -value;
+            mask = 0x7F;
+        }
+        value = std::min(value, 8159) + (0x84 >> 2);
+
+        const int seg = segment(value, ends);
+        if (seg >= 8) {
+            return static_cast<uint8_t>(0x7F ^ mask);
+        }
+        return static_cast<uint8_t>(((seg << 4) | ((value >> (seg + 1)) & 0x0F)) ^ mask);
+    }
+
+    static int16_t ulaw_to_linear(uint8_t code) {
+        code = ~code;
+        int t = ((code & 0x0F) << 3) + 0x84;
+        t <<= (code & 0x70) >> 4;
+        return static_cast<int16_t>((code & 0x80) ? (0x84 - t) : (t - 0x84));
+    }
+
+    static uint8_t linear_to_alaw(int16_t pcm) {
+        static const int ends[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+        int value = pcm >> 3;
+        int mask = 0xD5;
+        if (value < 0) {
+            value = -value - 1;
+            mask = 0x55;
+        }
+
+        const int seg = segment(value, ends);
+        if (seg >= 8) {
+            return static_cast<uint8_t>(0x7F ^ mask);
+        }
+        const int quant = seg < 2 ? (value >> 1) & 0x0F : (value >> seg) & 0x0F;
+        return static_cast<uint8_t>(((seg << 4) | quant) ^ mask);
+    }
+
+    static int16_t alaw_to_linear(uint8_t code) {
+        code ^= 0x55;
+        int t = (code & 0x0F) << 4;
+        const int seg = (code & 0x70) >> 4;
+        if (seg == 0) {
+            t += 8;
+        } else {
+            t = (t + 0x108) << (seg - 1);
+        }
+        return static_cast<int16_t>((code & 0x80) ? t : -t);
+    }
+};
+
+const G711Tables& g711_tables() {
+    static const G711Tables tables;
+    return tables;
+}
+
+// IMA ADPCM step sizes and index adjustments
+const int16_t IMA_STEPS[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+const int8_t IMA_INDEX_ADJUST[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+class L16Codec : public AudioCodec {
+public:
+    explicit L16Codec(uint32_t clock_rate) : AudioCodec(clock_rate) {}
+
+    const char* name() const override {
+        return "L16";
+    }
+    AudioCodecType type() const override {
+        return AudioCodecType::L16;
+    }
+    uint8_t payload_type() const override {
+        return PT_L16;
+    }
+
+    size_t max_encoded_size(size_t samples) const override {
+        return samples * sizeof(int16_t);
+    }
+    size_t max_decoded_samples(size_t bytes) const override {
+        return bytes / sizeof(int16_t);
+    }
+    size_t payload_samples(const uint8_t*, size_t bytes) const override {
+        return bytes % sizeof(int16_t) == 0 ? bytes / sizeof(int16_t) : 0;
+    }
+
+    size_t encode(const float* in, size_t samples, uint8_t* out, size_t capacity) override {
+        const size_t size = samples * sizeof(int16_t);
+        if (size == 0 || size > capacity) {
+            return 0;
+        }
+        float_to_pcm16be(in, out, samples, dither_ ? &tpdf_ : nullptr);
+        return size;
+    }
+
+    size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) override {
+        const size_t samples = bytes / sizeof(int16_t);
+        if (bytes == 0 || bytes % sizeof(int16_t) != 0 || samples > capacity) {
+            return 0;
+        }
+        pcm16be_to_float(in, out, samples);
+        return samples;
+    }
+
+private:
+    TpdfDither tpdf_;
+};
+
+// Shared by G.711 and ADPCM: quantize to int16 in blocks, with optional dither
+class QuantizingCodec : public AudioCodec {
+protected:
+    using AudioCodec::AudioCodec;
+
+    // Calls emit(const uint8_t* pcm16be, size_t count, size_t offset) per block. Quantizing
+    // goes through the SIMD kernels of pcm_convert, so rounding and saturation match L16.
+    template <typename Emit>
+    void quantize_blocks(const float* in, size_t samples, Emit&& emit) {
+        uint8_t pcm[QUANTIZE_BLOCK * sizeof(int16_t)];
+        for (size_t i = 0; i < samples; i += QUANTIZE_BLOCK) {
+            const size_t n = std::min(samples - i, QUANTIZE_BLOCK);
+            float_to_pcm16be(in + i, pcm, n, dither_ ? &tpdf_ : nullptr);
+            emit(pcm, n, i);
+        }
+    }
+
+    static uint16_t sample_bits(const uint8_t* pcm, size_t i) {
+        return static_cast<uint16_t>(pcm[2 * i] << 8 | pcm[2 * i + 1]);
+    }
+
+private:
+    TpdfDither tpdf_;
+};
+
+class G711Codec : public QuantizingCodec {
+public:
+    G711Codec(uint32_t clock_rate, bool alaw)
+        : QuantizingCodec(clock_rate), alaw_(alaw), tables_(g711_tables()) {}
+
+    const char* name() const override {
+        return alaw_ ? "PCMA" : "PCMU";
+    }
+    AudioCodecType type() const override {
+        return alaw_ ? AudioCodecType::Pcma : AudioCodecType::Pcmu;
+    }
+    uint8_t payload_type() const override {
+        if (clock_rate_ == 8000) {
+            return alaw_ ? PT_PCMA : PT_PCMU;
+        }
+        return alaw_ ? PT_DYNAMIC_PCMA : PT_DYNAMIC_PCMU;
+    }
+
+    size_t max_encoded_size(size_t samples) const override {
+        return samples;
+    }
+    size_t max_decoded_samples(size_t bytes) const override {
+        return bytes;
+    }
+
+    size_t encode(const float* in, size_t samples, uint8_t* out, size_t capacity) override {
+        if (samples == 0 || samples > capacity) {
+            return 0;
+        }
+
+        // Tables and flag in locals: stores through uint8_t* could alias any member
+        const uint8_t* table = alaw_ ? tables_.alaw_encode : tables_.ulaw_encode;
+        const int shift = alaw_ ? 3 : 2;
+        quantize_blocks(in, samples, [&](const uint8_t* pcm, size_t n, size_t offset) {
+            uint8_t* dst = out + offset;
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = table[sample_bits(pcm, i) >> shift];
+            }
+        });
+        return samples;
+    }
+
+    size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) override {
+        if (bytes == 0 || bytes > capacity) {
+            return 0;
+        }
+
+        const float* table = alaw_ ? tables_.alaw_decode : tables_.ulaw_decode;
+        for (size_t i = 0; i < bytes; i++) {
+            out[i] = table[in[i]];
+        }
+        return bytes;
+    }
+
+private:
+    const bool alaw_;
+    const G711Tables& tables_;
+};
+
+//
+// IMA ADPCM in the RTP DVI4 layout (RFC 3551 section 4.5.1): each payload starts with the
+// predictor state, so every packet decodes on its own, followed by two samples per octet,
+// first sample in the high nibble.
+//
+class ImaAdpcmCodec : public QuantizingCodec {
+public:
+    explicit ImaAdpcmCodec(uint32_t clock_rate) : QuantizingCodec(clock_rate) {}
+
+    const char* name() const override {
+        return "DVI4";
+    }
+    AudioCodecType type() const override {
+        return AudioCodecType::ImaAdpcm;
+    }
+    uint8_t payload_type() const override {
+        switch (clock_rate_) {
+            case 8000:
+                return 5;
+            case 16000:
+                return 6;
+            case 11025:
+                return 16;
+            case 22050:
+                return 17;
+            default:
+                return PT_DYNAMIC_DVI4;
+        }
+    }
+
+    bool supports_frame(size_t samples) const override {
+        return samples > 0 && samples % 2 == 0;  // Two samples per octet
+    }
+
+    size_t max_encoded_size(size_t samples) const override {
+        return DVI4_HEADER_SIZE + (samples + 1) / 2;
+    }
+    size_t max_decoded_samples(size_t bytes) const override {
+        return bytes > DVI4_HEADER_SIZE ? (bytes - DVI4_HEADER_SIZE) * 2 : 0;
+    }
+
+    size_t encode(const float* in, size_t samples, uint8_t* out, size_t capacity) override {
+        const size_t size = max_encoded_size(samples);
+        if (!supports_frame(samples) || size > capacity) {
+            return 0;
+        }
+
+        out[0] = static_cast<uint8_t>(static_cast<uint16_t>(predicted_) >> 8);
+        out[1] = static_cast<uint8_t>(predicted_ & 0xFF);
+        out[2] = static_cast<uint8_t>(index_);
+        out[3] = 0;
+
+        uint8_t* dst = out + DVI4_HEADER_SIZE;
+        quantize_blocks(in, samples, [&](const uint8_t* pcm, size_t n, size_t) {
+            // Blocks are even-sized, so the nibble pairs never straddle two blocks
+            for (size_t i = 0; i < n; i += 2) {
+                const uint8_t high = encode_sample(static_cast<int16_t>(sample_bits(pcm, i)));
+                const uint8_t low = encode_sample(static_cast<int16_t>(sample_bits(pcm, i + 1)));
+                *dst++ = static_cast<uint8_t>(high << 4 | low);
+            }
+        });
+        return size;
+    }
+
+    size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) override {
+        const size_t samples = max_decoded_samples(bytes);
+        if (samples == 0 || samples > capacity || in[2] > 88) {
+            return 0;
+        }
+
+        int predicted = static_cast<int16_t>(in[0] << 8 | in[1]);
+        int index = in[2];
+        for (size_t i = 0; i < samples / 2; i++) {
+            const uint8_t byte = in[DVI4_HEADER_SIZE + i];
+            out[2 * i] = decode_sample(byte >> 4, predicted, index) * PCM_INV_SCALE;
+            out[2 * i + 1] = decode_sample(byte & 0x0F, predicted, index) * PCM_INV_SCALE;
+        }
+        return samples;
+    }
+
+    void reset() override {
+        predicted_ = 0;
+        index_ = 0;
+    }
+
+private:
+    uint8_t encode_sample(int16_t sample) {
+        int step = IMA_STEPS[index_];
+        int diff = sample - predicted_;
+        uint8_t code = 0;
+        if (diff < 0) {
+            code = 8;
+            diff = -diff;
+        }
+
+        // Successive approximation of diff / step in three bits, tracking the decoder's
+        // reconstruction so both sides stay in lockstep
+        int delta = step >> 3;
+        if (diff >= step) {
+            code |= 4;
+            diff -= step;
+            delta += step;
+        }
+        step >>= 1;
+        if (diff >= step) {
+            code |= 2;
+            diff -= step;
+            delta += step;
+        }
+        step >>= 1;
+        if (diff >= step) {
+            code |= 1;
+            delta += step;
+        }
+
+        predicted_ += (code & 8) ? -delta : delta;
+        predicted_ = std::min(std::max(predicted_, -32768), 32767);
+        index_ = std::min(std::max(index_ + IMA_INDEX_ADJUST[code & 7], 0), 88);
+        return code;
+    }
+
+    static int decode_sample(uint8_t code, int& predicted, int& index) {
+        const int step = IMA_STEPS[index];
+        int delta = step >> 3;
+        if (code & 4) {
+            delta += step;
+        }
+        if (code & 2) {
+            delta += step >> 1;
+        }
+        if (code & 1) {
+            delta += step >> 2;
+        }
+
+        predicted += (code & 8) ? -delta : delta;
+        predicted = std::min(std::max(predicted, -32768), 32767);
+        index = std::min(std::max(index + IMA_INDEX_ADJUST[code & 7], 0), 88);
+        return predicted;
+    }
+
+    int predicted_ = 0;
+    int index_ = 0;
+};
+}  // namespace
+
+std::unique_ptr<AudioCodec> create_audio_codec(AudioCodecType type, uint32_t clock_rate,
+                                               const EdgeVoxOpusConfig& opus) {
+    if (clock_rate == 0) {
+        return nullptr;
+    }
+
+    switch (type) {
+        case AudioCodecType::L16:
+            return std::make_unique<L16Codec>(clock_rate);
+        case AudioCodecType::Pcmu:
+            return std::make_unique<G711Codec>(clock_rate, false);
+        case AudioCodecType::Pcma:
+            return std::make_unique<G711Codec>(clock_rate, true);
+        case AudioCodecType::ImaAdpcm:
+            return std::make_unique<ImaAdpcmCodec>(clock_rate);
+        case AudioCodecType::Opus:
+#ifdef EDGE_VOX_HAVE_OPUS
+            return create_opus_codec(clock_rate, opus);
+#else
+            (void)opus;
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+uint32_t audio_codec_rtp_clock_rate(AudioCodecType type, uint32_t sample_rate) {
+    return type == AudioCodecType::Opus ? OPUS_RTP_CLOCK_RATE : sample_rate;
+}
+
+size_t audio_codec_bytes_per_sample(AudioCodecType type) {
+    // Opus adapts to the payload capacity it is given, so one byte is only a framing bound
+    return type == AudioCodecType::L16 ? sizeof(int16_t) : 1;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "edge_vox/audio/audio_config.hpp"
+
+namespace {
+constexpr uint32_t OPUS_RTP_CLOCK_RATE = 48000;  // RFC 7587, whatever the audio rate
+}  // namespace
+
+//
+// RTP payload codec. Encodes float samples in [-1, 1) into caller-provided buffers and back;
+// nothing allocates after construction. A codec may keep state between frames (ADPCM does),
+// so use one instance per stream and direction.
+//
+class AudioCodec {
+public:
+    virtual ~AudioCodec() = default;
+
+    virtual const char* name() const = 0;
+    virtual AudioCodecType type() const = 0;
+
+    // RTP payload type: the static RFC 3551 type where one exists for this clock rate,
+    // otherwise a dynamic one (96 and up)
+    virtual uint8_t payload_type() const = 0;
+
+    // Sample rate of the audio going in and out
+    uint32_t clock_rate() const {
+        return clock_rate_;
+    }
+
+    // Rate of the RTP timestamp clock: the sample rate, except for Opus (always 48 kHz).
+    // A multiple of clock_rate().
+    virtual uint32_t rtp_clock_rate() const {
+        return clock_rate_;
+    }
+
+    // Whether encode() takes frames of this many samples
+    virtual bool supports_frame(size_t samples) const {
+        return samples > 0;
+    }
+
+    // Upper bound of encode() output for a frame of samples, and of decode() output for a
+    // payload of bytes
+    virtual size_t max_encoded_size(size_t samples) const = 0;
+    virtual size_t max_decoded_samples(size_t bytes) const = 0;
+
+    // Samples a payload decodes to, from its size or header alone; 0 if it is malformed.
+    // Lets a jitter buffer place packets on the timeline before decoding them.
+    virtual size_t payload_samples(const uint8_t* /*in*/, size_t bytes) const {
+        return max_decoded_samples(bytes);
+    }
+
+    // Encode one frame. Returns the payload length, or 0 if capacity is too small or the
+    // frame size isn't supported.
+    virtual size_t encode(const float* in, size_t samples, uint8_t* out, size_t capacity) = 0;
+
+    // True if an encoded payload only marks silence (DTX) and needn't be sent
+    virtual bool is_silence(size_t /*encoded_bytes*/) const {
+        return false;
+    }
+
+    // Decode one payload. Returns the number of samples, or 0 if the payload is malformed or
+    // out can't hold it.
+    virtual size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) = 0;
+
+    // Recover the samples of the packet before this one from redundancy carried in it (Opus
+    // in-band FEC). Returns the number of samples, 0 if the codec or payload has none.
+    virtual size_t decode_fec(const uint8_t* /*in*/, size_t /*bytes*/, float* /*out*/,
+                              size_t /*samples*/) {
+        return 0;
+    }
+
+    // TPDF dither before quantizing to 16 bits
+    void set_dither(bool enabled) {
+        dither_ = enabled;
+    }
+
+    // Forget inter-frame state, e.g. when a stream restarts
+    virtual void reset() {}
+
+protected:
+    explicit AudioCodec(uint32_t clock_rate) : clock_rate_(clock_rate) {}
+
+    const uint32_t clock_rate_;
+    bool dither_ = false;
+};
+
+// Create a codec for a stream at clock_rate samples per second. Returns null if the codec
+// isn't available in this build (Opus without libopus) or doesn't support the rate.
+std::unique_ptr<AudioCodec> create_audio_codec(AudioCodecType type, uint32_t clock_rate,
+                                               const EdgeVoxOpusConfig& opus = {});
+
+// RTP timestamp rate of a stream with this codec and sample rate
+uint32_t audio_codec_rtp_clock_rate(AudioCodecType type, uint32_t sample_rate);
+
+// Bytes per sample to budget for when sizing frames against the MTU (rounded up)
+size_t audio_codec_bytes_per_sample(AudioCodecType type);
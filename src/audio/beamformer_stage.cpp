@@ -0,0 +1,376 @@
+#include "edge_vox/audio/beamformer_stage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "audio/fft.hpp"
+#include "audio/frame_features.hpp"
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+constexpr size_t FILTER_TAPS = 16;  // Fractional delay filter length; even
+constexpr size_t FILTER_CENTER = FILTER_TAPS / 2 - 1;
+constexpr size_t MIN_FFT_SIZE = 64;
+constexpr float BAND_LOW_HZ = 300.0f;    // Where speech carries its energy; bins outside
+constexpr float BAND_HIGH_HZ = 4000.0f;  // it are mostly noise, which whitening blows up
+constexpr float PI = 3.14159265358979f;
+
+// out[i] += gain * in[i]
+void mul_add_scalar(float* out, const float* in, float gain, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] += gain * in[i];
+    }
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+void mul_add_sse2(float* out, const float* in, float gain, size_t n) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i,
+                      _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(g, _mm_loadu_ps(in + i))));
+    }
+    for (; i < n; i++) {
+        out[i] += gain * in[i];
+    }
+}
+
+__attribute__((target("avx2"))) void mul_add_avx2(float* out, const float* in, float gain,
+                                                  size_t n) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i),
+                                                _mm256_mul_ps(g, _mm256_loadu_ps(in + i))));
+    }
+    for (; i < n; i++) {
+        out[i] += gain * in[i];
+    }
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+void mul_add_neon(float* out, const float* in, float gain, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(out + i, vfmaq_n_f32(vld1q_f32(out + i), vld1q_f32(in + i), gain));
+    }
+    for (; i < n; i++) {
+        out[i] += gain * in[i];
+    }
+}
+#endif
+
+float sinc(float x) {
+    return std::abs(x) < 1e-6f ? 1.0f : std::sin(PI * x) / (PI * x);
+}
+
+// Correlation at a fractional lag, negative lags wrapping around to the end. Cubic
+// (Catmull-Rom) between samples: at 16 kHz a pair is only a few samples apart end to end,
+// and a straight line between them would pull every peak towards a whole lag.
+float correlation_at(const float* correlation, size_t size, float lag) {
+    const float pos = lag < 0.0f ? lag + size : lag;
+    const size_t i = static_cast<size_t>(pos);
+    const float t = pos - i;
+    const size_t mask = size - 1;
+    const float p0 = correlation[(i - 1) & mask];
+    const float p1 = correlation[i & mask];
+    const float p2 = correlation[(i + 1) & mask];
+    const float p3 = correlation[(i + 2) & mask];
+    const float a = 3.0f * (p1 - p2) + p3 - p0;
+    const float b = 2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3;
+    return p1 + 0.5f * t * (p2 - p0 + t * (b + t * a));
+}
+}  // namespace
+
+BeamformerStage::BeamformerStage(const EdgeVoxBeamformerConfig& config)
+    : config_(config), fft_(std::make_unique<Fft>()) {}
+
+BeamformerStage::~BeamformerStage() = default;
+
+bool BeamformerStage::configure(AudioFormat& format) {
+    format_ = format;
+    passthrough_ = format.channels < 2;
+    if (passthrough_) {
+        return true;
+    }
+
+    if (config_.mic_spacing_m <= 0.0f || config_.sound_speed <= 0.0f ||
+        config_.angle_step_deg <= 0.0f || config_.smoothing < 0.0f ||
+        config_.smoothing >= 1.0f) {
+        return false;
+    }
+
+    // Analysis windows of at least two frames, so the correlation has room for every lag
+    const size_t channels = format.channels;
+    fft_size_ = MIN_FFT_SIZE;
+    while (fft_size_ < 2 * format.frame_samples) {
+        fft_size_ <<= 1;
+    }
+    const float max_delay = (channels - 1) * config_.mic_spacing_m / config_.sound_speed *
+                            format.sample_rate;  // End to end, in samples
+    if (max_delay >= fft_size_ / 2 - 1 || !fft_->configure(fft_size_)) {
+        return false;
+    }
+    bins_ = fft_size_ / 2 + 1;
+    const float bin_hz = static_cast<float>(format.sample_rate) / fft_size_;
+    band_begin_ = static_cast<size_t>(std::ceil(BAND_LOW_HZ / bin_hz));
+    band_end_ = std::min(bins_, static_cast<size_t>(BAND_HIGH_HZ / bin_hz) + 1);
+    mul_add_ = simd_select(pcm_best_kernel(), mul_add_scalar, EDGE_VOX_X86_KERNEL(mul_add_sse2),
+                           EDGE_VOX_X86_KERNEL(mul_add_avx2), EDGE_VOX_NEON_KERNEL(mul_add_neon));
+
+    window_.resize(fft_size_);
+    for (size_t i = 0; i < fft_size_; i++) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * PI * i / fft_size_);
+    }
+
+    // Rows come in twos, as the real pair transforms fill them; an odd last one stays spare
+    pairs_.clear();
+    for (size_t i = 0; i < channels; i++) {
+        for (size_t j = i + 1; j < channels; j++) {
+            pairs_.emplace_back(i, j);
+        }
+    }
+    const size_t channel_rows = (channels + 1) / 2 * 2;
+    const size_t pair_rows = (pairs_.size() + 1) / 2 * 2;
+    analysis_.assign(channels * fft_size_, 0.0f);
+    spectrum_re_.assign(channel_rows * bins_, 0.0f);
+    spectrum_im_.assign(channel_rows * bins_, 0.0f);
+    cross_re_.assign(pair_rows * bins_, 0.0f);
+    cross_im_.assign(pair_rows * bins_, 0.0f);
+    correlation_.assign(pair_rows * fft_size_, 0.0f);
+    scratch_.assign(2 * fft_size_, 0.0f);
+
+    angles_.clear();
+    for (float angle = -90.0f; angle <= 90.0f + 1e-3f; angle += config_.angle_step_deg) {
+        angles_.push_back(angle);
+    }
+    pair_lags_.resize(angles_.size() * pairs_.size());
+    for (size_t a = 0; a < angles_.size(); a++) {
+        const float per_mic = std::sin(angles_[a] * PI / 180.0f) * config_.mic_spacing_m /
+                              config_.sound_speed * format.sample_rate;
+        for (size_t p = 0; p < pairs_.size(); p++) {
+            const float mics = static_cast<float>(pairs_[p].first) - pairs_[p].second;
+            pair_lags_[a * pairs_.size() + p] = mics * per_mic;
+        }
+    }
+
+    filters_.assign(channels * FILTER_TAPS, 0.0f);
+    delays_.assign(channels, 0);
+    previous_filters_ = filters_;
+    previous_delays_ = delays_;
+    history_ = static_cast<size_t>(std::ceil(max_delay)) + FILTER_TAPS;
+    lines_.assign(channels * (history_ + format.frame_samples), 0.0f);
+    fade_.assign(format.frame_samples, 0.0f);
+
+    format.channels = 1;
+    reset();
+    return true;
+}
+
+void BeamformerStage::reset() {
+    if (passthrough_ || angles_.empty()) {
+        return;
+    }
+
+    std::fill(analysis_.begin(), analysis_.end(), 0.0f);
+    std::fill(lines_.begin(), lines_.end(), 0.0f);
+    std::fill(cross_re_.begin(), cross_re_.end(), 0.0f);
+    std::fill(cross_im_.begin(), cross_im_.end(), 0.0f);
+    averaged_ = false;
+    next_sequence_ = 0;
+
+    steer(angles_.size() / 2);  // Broadside
+    crossfade_ = false;
+    updates_ = 0;
+    steers_ = 0;
+}
+
+bool BeamformerStage::process(AudioFrame& frame) {
+    if (passthrough_) {
+        return true;
+    }
+
+    // Audio that doesn't follow on from the last frame starts the delay lines over
+    const size_t frame_samples = format_.frame_samples;
+    const size_t chunks = (frame.samples + frame_samples - 1) / frame_samples;
+    if (frame.sequence + 1 != next_sequence_ + chunks) {
+        std::fill(lines_.begin(), lines_.end(), 0.0f);
+        std::fill(analysis_.begin(), analysis_.end(), 0.0f);
+    }
+    next_sequence_ = frame.sequence + 1;
+
+    // One frame length at a time, the mono result replacing the first channel as it goes
+    const size_t channels = format_.channels;
+    const size_t line = history_ + frame_samples;
+    for (size_t offset = 0; offset < frame.samples; offset += frame_samples) {
+        const size_t n = std::min(frame_samples, frame.samples - offset);
+        for (size_t c = 0; c < channels; c++) {
+            std::memcpy(&lines_[c * line + history_], frame.channel(c) + offset,
+                        n * sizeof(float));
+        }
+        analyze(channels, n);
+
+        float* out = frame.channel(0) + offset;
+        if (crossfade_) {
+            delay_and_sum(previous_filters_, previous_delays_, n, fade_.data());
+            delay_and_sum(filters_, delays_, n, out);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = fade_[i] + (out[i] - fade_[i]) * (i + 1) / n;
+            }
+            crossfade_ = false;
+        } else {
+            delay_and_sum(filters_, delays_, n, out);
+        }
+
+        for (size_t c = 0; c < channels; c++) {
+            float* history = &lines_[c * line];
+            std::memmove(history, history + n, history_ * sizeof(float));
+        }
+    }
+
+    frame.channels = 1;
+    return true;
+}
+
+EdgeVoxBeamformerStats BeamformerStage::get_stats() const {
+    EdgeVoxBeamformerStats stats;
+    stats.direction_deg = direction_deg_.load(std::memory_order_relaxed);
+    stats.updates = updates_.load(std::memory_order_relaxed);
+    stats.steers = steers_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Slide the n new samples of every channel into the analysis window and, for a whole frame
+// loud enough, estimate the direction again
+void BeamformerStage::analyze(size_t channels, size_t n) {
+    const size_t line = history_ + format_.frame_samples;
+    for (size_t c = 0; c < channels; c++) {
+        float* window = &analysis_[c * fft_size_];
+        std::memmove(window, window + n, (fft_size_ - n) * sizeof(float));
+        std::memcpy(window + fft_size_ - n, &lines_[c * line + history_], n * sizeof(float));
+    }
+
+    if (n != format_.frame_samples) {
+        return;
+    }
+    const float energy = frame_features(&lines_[history_], n).energy;
+    if (energy > 0.0f && 10.0f * std::log10(energy) >= config_.threshold_db) {
+        estimate();
+    }
+}
+
+void BeamformerStage::estimate() {
+    const size_t channels = format_.channels;
+    float* x = scratch_.data();
+    float* y = x + fft_size_;
+    for (size_t c = 0; c < channels; c += 2) {
+        for (size_t i = 0; i < fft_size_; i++) {
+            x[i] = analysis_[c * fft_size_ + i] * window_[i];
+            y[i] = c + 1 < channels ? analysis_[(c + 1) * fft_size_ + i] * window_[i] : 0.0f;
+        }
+        fft_->forward_real_pair(x, y, &spectrum_re_[c * bins_], &spectrum_im_[c * bins_],
+                                &spectrum_re_[(c + 1) * bins_], &spectrum_im_[(c + 1) * bins_]);
+    }
+
+    // PHAT: only the phase of each cross-spectrum bin counts, so every frequency of the
+    // speech band weighs the same and the correlation peaks sharply at the pair's delay
+    const float keep = averaged_ ? config_.smoothing : 0.0f;
+    for (size_t p = 0; p < pairs_.size(); p++) {
+        const float* ar = &spectrum_re_[pairs_[p].first * bins_];
+        const float* ai = &spectrum_im_[pairs_[p].first * bins_];
+        const float* br = &spectrum_re_[pairs_[p].second * bins_];
+        const float* bi = &spectrum_im_[pairs_[p].second * bins_];
+        float* cr = &cross_re_[p * bins_];
+        float* ci = &cross_im_[p * bins_];
+        for (size_t k = band_begin_; k < band_end_; k++) {
+            float re = ar[k] * br[k] + ai[k] * bi[k];
+            float im = ai[k] * br[k] - ar[k] * bi[k];
+            const float magnitude = std::sqrt(re * re + im * im);
+            if (magnitude > 1e-20f) {
+                re /= magnitude;
+                im /= magnitude;
+            } else {
+                re = im = 0.0f;
+            }
+            cr[k] = keep * cr[k] + (1.0f - keep) * re;
+            ci[k] = keep * ci[k] + (1.0f - keep) * im;
+        }
+    }
+    averaged_ = true;
+
+    for (size_t p = 0; p < pairs_.size(); p += 2) {
+        fft_->inverse_real_pair(&cross_re_[p * bins_], &cross_im_[p * bins_],
+                                &cross_re_[(p + 1) * bins_], &cross_im_[(p + 1) * bins_],
+                                &correlation_[p * fft_size_], &correlation_[(p + 1) * fft_size_]);
+    }
+
+    // Steered response power: the direction whose pair delays line up the most correlation
+    size_t best = direction_;
+    float best_power = -1e30f;
+    for (size_t a = 0; a < angles_.size(); a++) {
+        float power = 0.0f;
+        for (size_t p = 0; p < pairs_.size(); p++) {
+            power += correlation_at(&correlation_[p * fft_size_], fft_size_,
+                                    pair_lags_[a * pairs_.size() + p]);
+        }
+        if (power > best_power) {
+            best_power = power;
+            best = a;
+        }
+    }
+
+    updates_.fetch_add(1, std::memory_order_relaxed);
+    if (best != direction_) {
+        steer(best);
+    }
+}
+
+// Delays that line up a wavefront from angles_[angle] on every channel: a channel the sound
+// reaches later is delayed less. Each filter is a Hann-windowed sinc centred on its
+// fractional delay and includes the 1 / channels of the average.
+void BeamformerStage::steer(size_t angle) {
+    std::swap(filters_, previous_filters_);
+    std::swap(delays_, previous_delays_);
+    crossfade_ = true;
+
+    const size_t channels = format_.channels;
+    const float per_mic = std::sin(angles_[angle] * PI / 180.0f) * config_.mic_spacing_m /
+                          config_.sound_speed * format_.sample_rate;
+    const float latest = std::max(0.0f, (channels - 1) * per_mic);
+    for (size_t m = 0; m < channels; m++) {
+        const float delay = std::max(0.0f, latest - m * per_mic);
+        const float whole = std::floor(delay);
+        const float frac = delay - whole;
+
+        float* filter = &filters_[m * FILTER_TAPS];
+        float sum = 0.0f;
+        for (size_t k = 0; k < FILTER_TAPS; k++) {
+            const float x = static_cast<float>(k) - FILTER_CENTER - frac;
+            filter[k] = sinc(x) * (0.5f + 0.5f * std::cos(PI * x / (FILTER_TAPS / 2)));
+            sum += filter[k];
+        }
+        for (size_t k = 0; k < FILTER_TAPS; k++) {
+            filter[k] /= sum * channels;
+        }
+        delays_[m] = static_cast<size_t>(whole);
+    }
+
+    direction_ = angle;
+    direction_deg_.store(angles_[angle], std::memory_order_relaxed);
+    steers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// out[i] = sum over channels m and taps k of filters[m][k] * x_m[i - delays[m] - k]
+void BeamformerStage::delay_and_sum(const std::vector<float>& filters,
+                                    const std::vector<size_t>& delays, size_t n, float* out) {
+    std::fill(out, out + n, 0.0f);
+    const size_t line = history_ + format_.frame_samples;
+    for (size_t m = 0; m < format_.channels; m++) {
+        const float* x = &lines_[m * line + history_ - delays[m]];
+        for (size_t k = 0; k < FILTER_TAPS; k++) {
+            mul_add_(out, x - k, filters[m * FILTER_TAPS + k], n);
+        }
+    }
+}
@@ -0,0 +1,355 @@
+#include "audio/channel_mix.hpp"
+
+#include <cstring>
+
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+// Scalar loops from frame i on; the SIMD kernels finish their tails with them
+
+void deinterleave_from(size_t i, const float* in, size_t frames, size_t channels, float* out,
+                       size_t stride) {
+    for (size_t c = 0; c < channels; c++) {
+        float* dst = out + c * stride;
+        for (size_t k = i; k < frames; k++) {
+            dst[k] = in[k * channels + c];
+        }
+    }
+}
+
+void downmix_from(size_t i, const float* in, size_t frames, size_t channels,
+                  const float* weights, float* out) {
+    for (; i < frames; i++) {
+        float sum = 0.0f;
+        for (size_t c = 0; c < channels; c++) {
+            sum += weights[c] * in[i * channels + c];
+        }
+        out[i] = sum;
+    }
+}
+
+void select_from(size_t i, const float* in, size_t frames, size_t channels, size_t channel,
+                 float* out) {
+    for (; i < frames; i++) {
+        out[i] = in[i * channels + channel];
+    }
+}
+
+void deinterleave_scalar(const float* in, size_t frames, size_t channels, float* out,
+                         size_t stride) {
+    deinterleave_from(0, in, frames, channels, out, stride);
+}
+
+void downmix_scalar(const float* in, size_t frames, size_t channels, const float* weights,
+                    float* out) {
+    downmix_from(0, in, frames, channels, weights, out);
+}
+
+void select_scalar(const float* in, size_t frames, size_t channels, size_t channel,
+                   float* out) {
+    select_from(0, in, frames, channels, channel, out);
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+// Four frames of stereo into a left and a right vector
+inline void split2_sse2(const float* in, __m128& left, __m128& right) {
+    const __m128 a = _mm_loadu_ps(in);
+    const __m128 b = _mm_loadu_ps(in + 4);
+    left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+// Four frames of four channels into one vector per channel
+inline void split4_sse2(const float* in, __m128& c0, __m128& c1, __m128& c2, __m128& c3) {
+    c0 = _mm_loadu_ps(in);
+    c1 = _mm_loadu_ps(in + 4);
+    c2 = _mm_loadu_ps(in + 8);
+    c3 = _mm_loadu_ps(in + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+}
+
+// Channel C of four frames of four channels
+template <int C>
+inline __m128 pick4_sse2(const float* in) {
+    const __m128 front = _mm_shuffle_ps(_mm_loadu_ps(in), _mm_loadu_ps(in + 4),
+                                        _MM_SHUFFLE(C, C, C, C));
+    const __m128 back = _mm_shuffle_ps(_mm_loadu_ps(in + 8), _mm_loadu_ps(in + 12),
+                                       _MM_SHUFFLE(C, C, C, C));
+    return _mm_shuffle_ps(front, back, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+template <int C>
+size_t select4_sse2(const float* in, size_t frames, float* out) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        _mm_storeu_ps(out + i, pick4_sse2<C>(in + 4 * i));
+    }
+    return i;
+}
+
+size_t deinterleave_sse2_body(const float* in, size_t frames, size_t channels, float* out,
+                              size_t stride) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 left, right;
+            split2_sse2(in + 2 * i, left, right);
+            _mm_storeu_ps(out + i, left);
+            _mm_storeu_ps(out + stride + i, right);
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 c0, c1, c2, c3;
+            split4_sse2(in + 4 * i, c0, c1, c2, c3);
+            _mm_storeu_ps(out + i, c0);
+            _mm_storeu_ps(out + stride + i, c1);
+            _mm_storeu_ps(out + 2 * stride + i, c2);
+            _mm_storeu_ps(out + 3 * stride + i, c3);
+        }
+    }
+    return i;
+}
+
+void deinterleave_sse2(const float* in, size_t frames, size_t channels, float* out,
+                       size_t stride) {
+    const size_t i = deinterleave_sse2_body(in, frames, channels, out, stride);
+    deinterleave_from(i, in, frames, channels, out, stride);
+}
+
+size_t downmix_sse2_body(const float* in, size_t frames, size_t channels, const float* weights,
+                         float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        const __m128 w0 = _mm_set1_ps(weights[0]);
+        const __m128 w1 = _mm_set1_ps(weights[1]);
+        for (; i + 4 <= frames; i += 4) {
+            __m128 left, right;
+            split2_sse2(in + 2 * i, left, right);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(left, w0), _mm_mul_ps(right, w1)));
+        }
+    } else if (channels == 4) {
+        const __m128 w0 = _mm_set1_ps(weights[0]);
+        const __m128 w1 = _mm_set1_ps(weights[1]);
+        const __m128 w2 = _mm_set1_ps(weights[2]);
+        const __m128 w3 = _mm_set1_ps(weights[3]);
+        for (; i + 4 <= frames; i += 4) {
+            __m128 c0, c1, c2, c3;
+            split4_sse2(in + 4 * i, c0, c1, c2, c3);
+            const __m128 front = _mm_add_ps(_mm_mul_ps(c0, w0), _mm_mul_ps(c1, w1));
+            const __m128 back = _mm_add_ps(_mm_mul_ps(c2, w2), _mm_mul_ps(c3, w3));
+            _mm_storeu_ps(out + i, _mm_add_ps(front, back));
+        }
+    }
+    return i;
+}
+
+void downmix_sse2(const float* in, size_t frames, size_t channels, const float* weights,
+                  float* out) {
+    const size_t i = downmix_sse2_body(in, frames, channels, weights, out);
+    downmix_from(i, in, frames, channels, weights, out);
+}
+
+size_t select_sse2_body(const float* in, size_t frames, size_t channels, size_t channel,
+                        float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 left, right;
+            split2_sse2(in + 2 * i, left, right);
+            _mm_storeu_ps(out + i, channel == 0 ? left : right);
+        }
+    } else if (channels == 4) {
+        switch (channel) {
+            case 0:
+                return select4_sse2<0>(in, frames, out);
+            case 1:
+                return select4_sse2<1>(in, frames, out);
+            case 2:
+                return select4_sse2<2>(in, frames, out);
+            default:
+                return select4_sse2<3>(in, frames, out);
+        }
+    }
+    return i;
+}
+
+void select_sse2(const float* in, size_t frames, size_t channels, size_t channel, float* out) {
+    const size_t i = select_sse2_body(in, frames, channels, channel, out);
+    select_from(i, in, frames, channels, channel, out);
+}
+
+// Eight frames of stereo into a left and a right vector. AVX2 only speeds up stereo; four
+// channels take the SSE2 transpose, which is as wide as one frame. The stereo tails run
+// scalar rather than through the SSE2 bodies, which aren't VEX encoded and would pay for
+// the dirty upper halves of the ymm registers.
+__attribute__((target("avx2"))) inline void split2_avx2(const float* in, __m256& left,
+                                                        __m256& right) {
+    const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256 lo = _mm256_permutevar8x32_ps(_mm256_loadu_ps(in), order);
+    const __m256 hi = _mm256_permutevar8x32_ps(_mm256_loadu_ps(in + 8), order);
+    left = _mm256_permute2f128_ps(lo, hi, 0x20);
+    right = _mm256_permute2f128_ps(lo, hi, 0x31);
+}
+
+__attribute__((target("avx2"))) void deinterleave_avx2(const float* in, size_t frames,
+                                                       size_t channels, float* out,
+                                                       size_t stride) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            __m256 left, right;
+            split2_avx2(in + 2 * i, left, right);
+            _mm256_storeu_ps(out + i, left);
+            _mm256_storeu_ps(out + stride + i, right);
+        }
+    } else {
+        i = deinterleave_sse2_body(in, frames, channels, out, stride);
+    }
+    deinterleave_from(i, in, frames, channels, out, stride);
+}
+
+__attribute__((target("avx2"))) void downmix_avx2(const float* in, size_t frames,
+                                                  size_t channels, const float* weights,
+                                                  float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        const __m256 w0 = _mm256_set1_ps(weights[0]);
+        const __m256 w1 = _mm256_set1_ps(weights[1]);
+        for (; i + 8 <= frames; i += 8) {
+            __m256 left, right;
+            split2_avx2(in + 2 * i, left, right);
+            _mm256_storeu_ps(out + i,
+                             _mm256_add_ps(_mm256_mul_ps(left, w0), _mm256_mul_ps(right, w1)));
+        }
+    } else {
+        i = downmix_sse2_body(in, frames, channels, weights, out);
+    }
+    downmix_from(i, in, frames, channels, weights, out);
+}
+
+__attribute__((target("avx2"))) void select_avx2(const float* in, size_t frames,
+                                                 size_t channels, size_t channel, float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 8 <= frames; i += 8) {
+            __m256 left, right;
+            split2_avx2(in + 2 * i, left, right);
+            _mm256_storeu_ps(out + i, channel == 0 ? left : right);
+        }
+    } else {
+        i = select_sse2_body(in, frames, channels, channel, out);
+    }
+    select_from(i, in, frames, channels, channel, out);
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+// vld2q/vld4q deinterleave on load
+void deinterleave_neon(const float* in, size_t frames, size_t channels, float* out,
+                       size_t stride) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x2_t v = vld2q_f32(in + 2 * i);
+            vst1q_f32(out + i, v.val[0]);
+            vst1q_f32(out + stride + i, v.val[1]);
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x4_t v = vld4q_f32(in + 4 * i);
+            for (size_t c = 0; c < 4; c++) {
+                vst1q_f32(out + c * stride + i, v.val[c]);
+            }
+        }
+    }
+    deinterleave_from(i, in, frames, channels, out, stride);
+}
+
+void downmix_neon(const float* in, size_t frames, size_t channels, const float* weights,
+                  float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x2_t v = vld2q_f32(in + 2 * i);
+            vst1q_f32(out + i, vaddq_f32(vmulq_n_f32(v.val[0], weights[0]),
+                                         vmulq_n_f32(v.val[1], weights[1])));
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            const float32x4x4_t v = vld4q_f32(in + 4 * i);
+            const float32x4_t front = vaddq_f32(vmulq_n_f32(v.val[0], weights[0]),
+                                                vmulq_n_f32(v.val[1], weights[1]));
+            const float32x4_t back = vaddq_f32(vmulq_n_f32(v.val[2], weights[2]),
+                                               vmulq_n_f32(v.val[3], weights[3]));
+            vst1q_f32(out + i, vaddq_f32(front, back));
+        }
+    }
+    downmix_from(i, in, frames, channels, weights, out);
+}
+
+void select_neon(const float* in, size_t frames, size_t channels, size_t channel, float* out) {
+    size_t i = 0;
+    if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) {
+            vst1q_f32(out + i, vld2q_f32(in + 2 * i).val[channel]);
+        }
+    } else if (channels == 4) {
+        for (; i + 4 <= frames; i += 4) {
+            vst1q_f32(out + i, vld4q_f32(in + 4 * i).val[channel]);
+        }
+    }
+    select_from(i, in, frames, channels, channel, out);
+}
+#endif
+}  // namespace
+
+void deinterleave(const float* in, size_t frames, size_t channels, float* out, size_t stride) {
+    deinterleave(in, frames, channels, out, stride, pcm_best_kernel());
+}
+
+void deinterleave(const float* in, size_t frames, size_t channels, float* out, size_t stride,
+                  PcmKernel kernel) {
+    if (channels == 1) {
+        if (frames > 0) {
+            std::memcpy(out, in, frames * sizeof(float));
+        }
+        return;
+    }
+    const auto deinterleave_kernel = simd_select(kernel, deinterleave_scalar,
+                                                 EDGE_VOX_X86_KERNEL(deinterleave_sse2),
+                                                 EDGE_VOX_X86_KERNEL(deinterleave_avx2),
+                                                 EDGE_VOX_NEON_KERNEL(deinterleave_neon));
+    deinterleave_kernel(in, frames, channels, out, stride);
+}
+
+void downmix(const float* in, size_t frames, size_t channels, const float* weights,
+             float* out) {
+    downmix(in, frames, channels, weights, out, pcm_best_kernel());
+}
+
+void downmix(const float* in, size_t frames, size_t channels, const float* weights, float* out,
+             PcmKernel kernel) {
+    const auto downmix_kernel =
+        simd_select(kernel, downmix_scalar, EDGE_VOX_X86_KERNEL(downmix_sse2),
+                    EDGE_VOX_X86_KERNEL(downmix_avx2), EDGE_VOX_NEON_KERNEL(downmix_neon));
+    downmix_kernel(in, frames, channels, weights, out);
+}
+
+void select_channel(const float* in, size_t frames, size_t channels, size_t channel,
+                    float* out) {
+    select_channel(in, frames, channels, channel, out, pcm_best_kernel());
+}
+
+void select_channel(const float* in, size_t frames, size_t channels, size_t channel,
+                    float* out, PcmKernel kernel) {
+    if (channels == 1) {
+        if (frames > 0) {
+            std::memcpy(out, in, frames * sizeof(float));
+        }
+        return;
+    }
+    const auto select_kernel =
+        simd_select(kernel, select_scalar, EDGE_VOX_X86_KERNEL(select_sse2),
+                    EDGE_VOX_X86_KERNEL(select_avx2), EDGE_VOX_NEON_KERNEL(select_neon));
+    select_kernel(in, frames, channels, channel, out);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+#include "audio/pcm_convert.hpp"
+
+//
+// Kernels between the interleaved blocks a capture device delivers and what the rest of the
+// client works on: planes for multichannel processing, or one mono signal. Stereo and 4-mic
+// arrays are split by shuffles on x86, a 4x4 transpose for four channels and eight stereo
+// frames at a time under AVX2, and by the vld2q/vld4q structure loads on NEON; any other
+// channel count runs the scalar loop.
+//
+
+// Split frames of interleaved audio into planes: sample c of frame i goes to
+// out[c * stride + i]
+void deinterleave(const float* in, size_t frames, size_t channels, float* out, size_t stride);
+void deinterleave(const float* in, size_t frames, size_t channels, float* out, size_t stride,
+                  PcmKernel kernel);
+
+// Weighted sum of the channels of every frame: out[i] = sum of weights[c] * sample c
+void downmix(const float* in, size_t frames, size_t channels, const float* weights,
+             float* out);
+void downmix(const float* in, size_t frames, size_t channels, const float* weights, float* out,
+             PcmKernel kernel);
+
+// One channel of every frame: out[i] = sample channel of frame i
+void select_channel(const float* in, size_t frames, size_t channels, size_t channel,
+                    float* out);
+void select_channel(const float* in, size_t frames, size_t channels, size_t channel,
+                    float* out, PcmKernel kernel);
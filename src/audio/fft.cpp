@@ -0,0 +1,226 @@
+#include "audio/fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+// One stage: every block of 2 * half values combines its two halves, the second one turned
+// by the twiddles w[j] = exp(-pi i j / half)
+void stage_scalar(float* re, float* im, const float* w_re, const float* w_im, size_t size,
+                  size_t half) {
+    for (size_t b = 0; b < size; b += 2 * half) {
+        for (size_t j = 0; j < half; j++) {
+            const size_t top = b + j;
+            const size_t bottom = top + half;
+            const float tr = re[bottom] * w_re[j] - im[bottom] * w_im[j];
+            const float ti = re[bottom] * w_im[j] + im[bottom] * w_re[j];
+            re[bottom] = re[top] - tr;
+            im[bottom] = im[top] - ti;
+            re[top] += tr;
+            im[top] += ti;
+        }
+    }
+}
+
+// The first two stages at once: their twiddles are 1 and -i, so no multiplications
+void radix4_first_stages(float* re, float* im, size_t size) {
+    for (size_t b = 0; b < size; b += 4) {
+        const float r0 = re[b] + re[b + 1], i0 = im[b] + im[b + 1];
+        const float r1 = re[b] - re[b + 1], i1 = im[b] - im[b + 1];
+        const float r2 = re[b + 2] + re[b + 3], i2 = im[b + 2] + im[b + 3];
+        const float r3 = re[b + 2] - re[b + 3], i3 = im[b + 2] - im[b + 3];
+        re[b] = r0 + r2;
+        im[b] = i0 + i2;
+        re[b + 2] = r0 - r2;
+        im[b + 2] = i0 - i2;
+        re[b + 1] = r1 + i3;  // -i * (r3 + i i3) = i3 - i r3
+        im[b + 1] = i1 - r3;
+        re[b + 3] = r1 - i3;
+        im[b + 3] = i1 + r3;
+    }
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+// Four butterflies of a stage with half >= 4
+inline void butterflies_sse2(float* re, float* im, const float* w_re, const float* w_im,
+                             size_t half) {
+    const __m128 wr = _mm_loadu_ps(w_re);
+    const __m128 wi = _mm_loadu_ps(w_im);
+    const __m128 br = _mm_loadu_ps(re + half);
+    const __m128 bi = _mm_loadu_ps(im + half);
+    const __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+    const __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+    const __m128 ar = _mm_loadu_ps(re);
+    const __m128 ai = _mm_loadu_ps(im);
+    _mm_storeu_ps(re + half, _mm_sub_ps(ar, tr));
+    _mm_storeu_ps(im + half, _mm_sub_ps(ai, ti));
+    _mm_storeu_ps(re, _mm_add_ps(ar, tr));
+    _mm_storeu_ps(im, _mm_add_ps(ai, ti));
+}
+
+void stage_sse2(float* re, float* im, const float* w_re, const float* w_im, size_t size,
+                size_t half) {
+    for (size_t b = 0; b < size; b += 2 * half) {
+        for (size_t j = 0; j < half; j += 4) {
+            butterflies_sse2(re + b + j, im + b + j, w_re + j, w_im + j, half);
+        }
+    }
+}
+
+// Inlined here the four-wide butterflies of the half == 4 stage are VEX encoded as well
+__attribute__((target("avx2"))) void stage_avx2(float* re, float* im, const float* w_re,
+                                                const float* w_im, size_t size, size_t half) {
+    if (half < 8) {
+        for (size_t b = 0; b < size; b += 2 * half) {
+            butterflies_sse2(re + b, im + b, w_re, w_im, half);
+        }
+        return;
+    }
+
+    for (size_t b = 0; b < size; b += 2 * half) {
+        for (size_t j = 0; j < half; j += 8) {
+            float* top_re = re + b + j;
+            float* top_im = im + b + j;
+            const __m256 wr = _mm256_loadu_ps(w_re + j);
+            const __m256 wi = _mm256_loadu_ps(w_im + j);
+            const __m256 br = _mm256_loadu_ps(top_re + half);
+            const __m256 bi = _mm256_loadu_ps(top_im + half);
+            const __m256 tr = _mm256_sub_ps(_mm256_mul_ps(br, wr), _mm256_mul_ps(bi, wi));
+            const __m256 ti = _mm256_add_ps(_mm256_mul_ps(br, wi), _mm256_mul_ps(bi, wr));
+            const __m256 ar = _mm256_loadu_ps(top_re);
+            const __m256 ai = _mm256_loadu_ps(top_im);
+            _mm256_storeu_ps(top_re + half, _mm256_sub_ps(ar, tr));
+            _mm256_storeu_ps(top_im + half, _mm256_sub_ps(ai, ti));
+            _mm256_storeu_ps(top_re, _mm256_add_ps(ar, tr));
+            _mm256_storeu_ps(top_im, _mm256_add_ps(ai, ti));
+        }
+    }
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+void stage_neon(float* re, float* im, const float* w_re, const float* w_im, size_t size,
+                size_t half) {
+    for (size_t b = 0; b < size; b += 2 * half) {
+        for (size_t j = 0; j < half; j += 4) {
+            float* top_re = re + b + j;
+            float* top_im = im + b + j;
+            const float32x4_t wr = vld1q_f32(w_re + j);
+            const float32x4_t wi = vld1q_f32(w_im + j);
+            const float32x4_t br = vld1q_f32(top_re + half);
+            const float32x4_t bi = vld1q_f32(top_im + half);
+            const float32x4_t tr = vfmsq_f32(vmulq_f32(br, wr), bi, wi);
+            const float32x4_t ti = vfmaq_f32(vmulq_f32(br, wi), bi, wr);
+            const float32x4_t ar = vld1q_f32(top_re);
+            const float32x4_t ai = vld1q_f32(top_im);
+            vst1q_f32(top_re + half, vsubq_f32(ar, tr));
+            vst1q_f32(top_im + half, vsubq_f32(ai, ti));
+            vst1q_f32(top_re, vaddq_f32(ar, tr));
+            vst1q_f32(top_im, vaddq_f32(ai, ti));
+        }
+    }
+}
+#endif
+}  // namespace
+
+bool Fft::configure(size_t size, PcmKernel kernel) {
+    if (size < 2 || (size & (size - 1)) != 0 || size > UINT32_MAX) {
+        return false;
+    }
+    size_ = size;
+
+    stage_ = simd_select(kernel, stage_scalar, EDGE_VOX_X86_KERNEL(stage_sse2),
+                         EDGE_VOX_X86_KERNEL(stage_avx2), EDGE_VOX_NEON_KERNEL(stage_neon));
+
+    size_t bits = 0;
+    while ((size_t{1} << bits) < size) {
+        bits++;
+    }
+    swaps_.clear();
+    for (size_t i = 0; i < size; i++) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        if (i < reversed) {
+            swaps_.push_back(static_cast<uint32_t>(i));
+            swaps_.push_back(static_cast<uint32_t>(reversed));
+        }
+    }
+
+    const double pi = 3.14159265358979323846;
+    w_re_.assign(size, 0.0f);
+    w_im_.assign(size, 0.0f);
+    for (size_t half = 1; half < size; half <<= 1) {
+        for (size_t j = 0; j < half; j++) {
+            const double angle = -pi * static_cast<double>(j) / static_cast<double>(half);
+            w_re_[half + j] = static_cast<float>(std::cos(angle));
+            w_im_[half + j] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    re_.assign(size, 0.0f);
+    im_.assign(size, 0.0f);
+    return true;
+}
+
+void Fft::forward(float* re, float* im) const {
+    for (size_t i = 0; i < swaps_.size(); i += 2) {
+        std::swap(re[swaps_[i]], re[swaps_[i + 1]]);
+        std::swap(im[swaps_[i]], im[swaps_[i + 1]]);
+    }
+
+    if (size_ == 2) {
+        stage_scalar(re, im, &w_re_[1], &w_im_[1], size_, 1);
+        return;
+    }
+
+    // Every later stage combines halves of at least four, a whole vector
+    radix4_first_stages(re, im, size_);
+    for (size_t half = 4; half < size_; half <<= 1) {
+        stage_(re, im, &w_re_[half], &w_im_[half], size_, half);
+    }
+}
+
+void Fft::forward_real_pair(const float* x, const float* y, float* x_re, float* x_im,
+                            float* y_re, float* y_im) {
+    std::copy(x, x + size_, re_.begin());
+    std::copy(y, y + size_, im_.begin());
+    forward(re_.data(), im_.data());
+
+    // Z = X + iY with X and Y conjugate symmetric: X[k] = (Z[k] + conj(Z[-k])) / 2 and
+    // Y[k] = (Z[k] - conj(Z[-k])) / 2i
+    for (size_t k = 0; k <= size_ / 2; k++) {
+        const size_t mirror = (size_ - k) & (size_ - 1);
+        const float zr = re_[k];
+        const float zi = im_[k];
+        const float mr = re_[mirror];
+        const float mi = im_[mirror];
+        x_re[k] = 0.5f * (zr + mr);
+        x_im[k] = 0.5f * (zi - mi);
+        y_re[k] = 0.5f * (zi + mi);
+        y_im[k] = 0.5f * (mr - zr);
+    }
+}
+
+void Fft::inverse_real_pair(const float* a_re, const float* a_im, const float* b_re,
+                            const float* b_im, float* a, float* b) {
+    // Z = A + iB over the whole circle; both inverses are real, so they come back as the real
+    // and imaginary part of one transform
+    const size_t half = size_ / 2;
+    for (size_t k = 0; k <= half; k++) {
+        re_[k] = a_re[k] - b_im[k];
+        im_[k] = a_im[k] + b_re[k];
+    }
+    for (size_t k = half + 1; k < size_; k++) {
+        const size_t m = size_ - k;
+        re_[k] = a_re[m] + b_im[m];
+        im_[k] = b_re[m] - a_im[m];
+    }
+    inverse(re_.data(), im_.data());
+    std::copy(re_.begin(), re_.end(), a);
+    std::copy(im_.begin(), im_.end(), b);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio/pcm_convert.hpp"
+
+//
+// Radix-2 complex FFT of a power-of-two size, in place on split real and imaginary arrays so
+// the butterflies of a stage are plain vector multiplies and adds, four or eight at a time,
+// with no shuffling of interleaved pairs. Real signals go through in pairs, one as the real
+// and one as the imaginary part of a single transform. Sizes and twiddles are set up once in
+// configure(); transforms don't allocate.
+//
+class Fft {
+public:
+    // size must be a power of two, at least 2
+    bool configure(size_t size, PcmKernel kernel = pcm_best_kernel());
+
+    size_t size() const {
+        return size_;
+    }
+
+    // X[k] = sum over n of x[n] * exp(-2 pi i k n / size)
+    void forward(float* re, float* im) const;
+
+    // Unscaled: inverse(forward(x)) gives size * x
+    void inverse(float* re, float* im) const {
+        forward(im, re);  // Swapping real and imaginary parts conjugates both ways
+    }
+
+    // Spectra of two real signals of size samples, bins 0 to size / 2 of each
+    void forward_real_pair(const float* x, const float* y, float* x_re, float* x_im, float* y_re,
+                           float* y_im);
+
+    // Two real signals back from bins 0 to size / 2 of their spectra; unscaled like inverse()
+    void inverse_real_pair(const float* a_re, const float* a_im, const float* b_re,
+                           const float* b_im, float* a, float* b);
+
+private:
+    using StageFn = void (*)(float* re, float* im, const float* w_re, const float* w_im,
+                             size_t size, size_t half);
+
+    size_t size_ = 0;
+    StageFn stage_ = nullptr;      // Stages combining halves of 4 and more
+    std::vector<uint32_t> swaps_;  // Index pairs exchanged by the bit-reversal permutation
+    std::vector<float> w_re_;      // Twiddles of the stage combining halves of h at [h, 2h)
+    std::vector<float> w_im_;
+    std::vector<float> re_;        // Scratch for the real pair transforms
+    std::vector<float> im_;
+};
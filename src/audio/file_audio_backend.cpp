@@ -0,0 +1,176 @@
+#include "edge_vox/audio/file_audio_backend.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+// WAVE format tags
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t read_le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void decode_s16le(const uint8_t* data, size_t count, std::vector<float>& samples) {
+    samples.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<int16_t>(read_le16(data + i * 2)) / 32768.0f;
+    }
+}
+
+void decode_f32le(const uint8_t* data, size_t count, std::vector<float>& samples) {
+    samples.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t bits = read_le32(data + i * 4);
+        memcpy(&samples[i], &bits, sizeof(float));
+    }
+}
+
+bool parse_wav(const std::vector<uint8_t>& file, std::vector<float>& samples, int& sample_rate,
+               int& channels) {
+    if (file.size() < 12 || memcmp(file.data(), "RIFF", 4) != 0 ||
+        memcmp(file.data() + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", __func__);
+        return false;
+    }
+
+    uint16_t format = 0;
+    uint16_t bits_per_sample = 0;
+    bool have_fmt = false;
+
+    // Walk the chunk list; chunks are word aligned
+    size_t pos = 12;
+    while (pos + 8 <= file.size()) {
+        const uint8_t* chunk = file.data() + pos;
+        const uint32_t chunk_size = read_le32(chunk + 4);
+        const size_t body = pos + 8;
+        const size_t body_size = std::min<size_t>(chunk_size, file.size() - body);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && body_size >= 16) {
+            format = read_le16(file.data() + body);
+            channels = read_le16(file.data() + body + 2);
+            sample_rate = static_cast<int>(read_le32(file.data() + body + 4));
+            bits_per_sample = read_le16(file.data() + body + 14);
+
+            // The real format tag of an extensible header is the start of its sub-format GUID
+            if (format == WAVE_FORMAT_EXTENSIBLE && body_size >= 26) {
+                format = read_le16(file.data() + body + 24);
+            }
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt || channels <= 0 || sample_rate <= 0) {
+                fprintf(stderr, "%s: data chunk before a valid fmt chunk\n", __func__);
+                return false;
+            }
+
+            if (format == WAVE_FORMAT_PCM && bits_per_sample == 16) {
+                decode_s16le(file.data() + body, body_size / 2, samples);
+            } else if (format == WAVE_FORMAT_IEEE_FLOAT && bits_per_sample == 32) {
+                decode_f32le(file.data() + body, body_size / 4, samples);
+            } else {
+                fprintf(stderr, "%s: unsupported WAVE format %u with %u bits per sample\n",
+                        __func__, format, bits_per_sample);
+                return false;
+            }
+
+            // Drop a trailing partial frame
+            samples.resize(samples.size() - samples.size() % channels);
+            return true;
+        }
+
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+
+    fprintf(stderr, "%s: no data chunk found\n", __func__);
+    return false;
+}
+}  // namespace
+
+FileAudioBackend::FileAudioBackend(FileAudioConfig config)
+    : PacedAudioBackend(config.pacing), m_config(std::move(config)) {}
+
+FileAudioBackend::~FileAudioBackend() {
+    stop_thread();
+}
+
+bool FileAudioBackend::load(const FileAudioConfig& config, std::vector<float>& samples,
+                            int& sample_rate, int& channels) {
+    std::ifstream stream(config.path, std::ios::binary);
+    if (!stream) {
+        fprintf(stderr, "%s: couldn't open '%s'\n", __func__, config.path.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(stream)),
+                              std::istreambuf_iterator<char>());
+
+    switch (config.format) {
+        case FileAudioConfig::Format::Wav:
+            return parse_wav(file, samples, sample_rate, channels);
+        case FileAudioConfig::Format::RawS16LE:
+            decode_s16le(file.data(), file.size() / 2, samples);
+            break;
+        case FileAudioConfig::Format::RawF32LE:
+            decode_f32le(file.data(), file.size() / 4, samples);
+            break;
+    }
+
+    if (config.sample_rate <= 0 || config.channels <= 0) {
+        return false;
+    }
+
+    sample_rate = config.sample_rate;
+    channels = config.channels;
+    samples.resize(samples.size() - samples.size() % channels);
+    return true;
+}
+
+bool FileAudioBackend::prepare_capture(const AudioBackendSpec& requested,
+                                       AudioBackendSpec& obtained) {
+    int sample_rate = 0;
+    int channels = 0;
+    if (!load(m_config, m_samples, sample_rate, channels)) {
+        return false;
+    }
+
+    // The file's layout as is, like a device opened with its native channel count
+    obtained = requested;
+    obtained.sample_rate = sample_rate;
+    obtained.channels = channels;
+
+    m_channels = channels;
+    m_position = 0;
+    return true;
+}
+
+size_t FileAudioBackend::fill_capture(float* out, size_t frames) {
+    const size_t total_frames = m_samples.size() / m_channels;
+    size_t written = 0;
+
+    while (written < frames && total_frames > 0) {
+        if (m_position >= total_frames) {
+            if (!m_config.loop) {
+                break;
+            }
+            m_position = 0;
+        }
+
+        const size_t n = std::min(frames - written, total_frames - m_position);
+        std::copy_n(&m_samples[m_position * m_channels], n * m_channels,
+                    out + written * m_channels);
+        m_position += n;
+        written += n;
+    }
+
+    return written;
+}
@@ -0,0 +1,124 @@
+#include "audio/frame_features.hpp"
+
+#include <cmath>
+
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+using FeaturesFn = FrameFeatures (*)(const float* x, size_t n);
+
+// Energy from sample i on and crossings between the pairs ending at sample j on
+void features_tail(const float* x, size_t i, size_t j, size_t n, float& sum,
+                   uint32_t& crossings) {
+    for (; i < n; i++) {
+        sum += x[i] * x[i];
+    }
+    for (j = j > 0 ? j : 1; j < n; j++) {
+        crossings += std::signbit(x[j]) != std::signbit(x[j - 1]);
+    }
+}
+
+FrameFeatures features_scalar(const float* x, size_t n) {
+    float sum = 0.0f;
+    uint32_t crossings = 0;
+    features_tail(x, 0, 1, n, sum, crossings);
+    return {n > 0 ? sum / n : 0.0f, crossings};
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+FrameFeatures features_sse2(const float* x, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128 a = _mm_loadu_ps(x + i);
+        const __m128 b = _mm_loadu_ps(x + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+
+    // Sign bits of each sample against those of the one before it
+    uint32_t crossings = 0;
+    size_t j = 1;
+    for (; j + 4 <= n; j += 4) {
+        const int flips =
+            _mm_movemask_ps(_mm_loadu_ps(x + j)) ^ _mm_movemask_ps(_mm_loadu_ps(x + j - 1));
+        crossings += __builtin_popcount(static_cast<unsigned>(flips));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    features_tail(x, i, j, n, sum, crossings);
+    return {n > 0 ? sum / n : 0.0f, crossings};
+}
+
+__attribute__((target("avx2"))) FrameFeatures features_avx2(const float* x, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256 a = _mm256_loadu_ps(x + i);
+        const __m256 b = _mm256_loadu_ps(x + i + 8);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(a, a));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(b, b));
+    }
+
+    uint32_t crossings = 0;
+    size_t j = 1;
+    for (; j + 8 <= n; j += 8) {
+        const int flips = _mm256_movemask_ps(_mm256_loadu_ps(x + j)) ^
+                          _mm256_movemask_ps(_mm256_loadu_ps(x + j - 1));
+        crossings += __builtin_popcount(static_cast<unsigned>(flips));
+    }
+
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    const __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, half);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    features_tail(x, i, j, n, sum, crossings);
+    return {n > 0 ? sum / n : 0.0f, crossings};
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+FrameFeatures features_neon(const float* x, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t a = vld1q_f32(x + i);
+        const float32x4_t b = vld1q_f32(x + i + 4);
+        acc0 = vfmaq_f32(acc0, a, a);
+        acc1 = vfmaq_f32(acc1, b, b);
+    }
+
+    uint32x4_t flips = vdupq_n_u32(0);
+    size_t j = 1;
+    for (; j + 4 <= n; j += 4) {
+        const uint32x4_t cur = vshrq_n_u32(vreinterpretq_u32_f32(vld1q_f32(x + j)), 31);
+        const uint32x4_t prev = vshrq_n_u32(vreinterpretq_u32_f32(vld1q_f32(x + j - 1)), 31);
+        flips = vaddq_u32(flips, veorq_u32(cur, prev));
+    }
+
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    uint32_t crossings = vaddvq_u32(flips);
+    features_tail(x, i, j, n, sum, crossings);
+    return {n > 0 ? sum / n : 0.0f, crossings};
+}
+#endif
+
+FeaturesFn features_kernel(PcmKernel kernel) {
+    return simd_select(kernel, features_scalar, EDGE_VOX_X86_KERNEL(features_sse2),
+                       EDGE_VOX_X86_KERNEL(features_avx2), EDGE_VOX_NEON_KERNEL(features_neon));
+}
+}  // namespace
+
+FrameFeatures frame_features(const float* samples, size_t n) {
+    return frame_features(samples, n, pcm_best_kernel());
+}
+
+FrameFeatures frame_features(const float* samples, size_t n, PcmKernel kernel) {
+    return features_kernel(kernel)(samples, n);
+}
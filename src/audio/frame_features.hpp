@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "audio/pcm_convert.hpp"
+
+// Per-frame measurements for voice activity detection
+struct FrameFeatures {
+    float energy{0.0f};     // Mean square, 1.0 for a full-scale square wave
+    uint32_t crossings{0};  // Sign changes between neighbouring samples
+};
+
+// Mean square and zero crossings of n samples. A crossing is a sign bit that differs from the
+// one of the sample before, so -0.0 counts as negative.
+FrameFeatures frame_features(const float* samples, size_t n);
+FrameFeatures frame_features(const float* samples, size_t n, PcmKernel kernel);
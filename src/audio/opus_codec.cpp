@@ -0,0 +1,162 @@
+#include "audio/opus_codec.hpp"
+
+#include <opus.h>
+
+#include <algorithm>
+
+namespace {
+constexpr uint8_t PT_OPUS = 111;             // Dynamic payload type most SDP offers use for Opus
+constexpr size_t OPUS_MAX_FRAME = 1275;      // Largest coded 20 ms frame (RFC 6716)
+constexpr uint32_t OPUS_MAX_PACKET_MS = 60;  // Longer packets are rejected by decode()
+
+// Frame durations Opus can code, in tenths of a millisecond
+constexpr uint32_t OPUS_FRAME_TENTHS_MS[] = {25, 50, 100, 200, 400, 600};
+
+class OpusCodec : public AudioCodec {
+public:
+    OpusCodec(uint32_t clock_rate, const EdgeVoxOpusConfig& config)
+        : AudioCodec(clock_rate), config_(config) {}
+
+    ~OpusCodec() override {
+        if (encoder_) {
+            opus_encoder_destroy(encoder_);
+        }
+        if (decoder_) {
+            opus_decoder_destroy(decoder_);
+        }
+    }
+
+    bool init() {
+        int error = OPUS_OK;
+        encoder_ = opus_encoder_create(static_cast<opus_int32>(clock_rate_), 1,
+                                       OPUS_APPLICATION_VOIP, &error);
+        if (error != OPUS_OK) {
+            return false;
+        }
+
+        decoder_ = opus_decoder_create(static_cast<opus_int32>(clock_rate_), 1, &error);
+        if (error != OPUS_OK) {
+            return false;
+        }
+
+        // FEC is only added when the encoder expects loss
+        const int loss = static_cast<int>(std::min<uint32_t>(config_.expected_loss, 100));
+        return opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(config_.bitrate)) == OPUS_OK &&
+               opus_encoder_ctl(encoder_, OPUS_SET_COMPLEXITY(config_.complexity)) == OPUS_OK &&
+               opus_encoder_ctl(encoder_, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)) == OPUS_OK &&
+               opus_encoder_ctl(encoder_, OPUS_SET_INBAND_FEC(config_.fec ? 1 : 0)) == OPUS_OK &&
+               opus_encoder_ctl(encoder_, OPUS_SET_PACKET_LOSS_PERC(loss)) == OPUS_OK &&
+               opus_encoder_ctl(encoder_, OPUS_SET_DTX(config_.dtx ? 1 : 0)) == OPUS_OK;
+    }
+
+    const char* name() const override {
+        return "opus";
+    }
+    AudioCodecType type() const override {
+        return AudioCodecType::Opus;
+    }
+    uint8_t payload_type() const override {
+        return PT_OPUS;
+    }
+    uint32_t rtp_clock_rate() const override {
+        return OPUS_RTP_CLOCK_RATE;
+    }
+
+    bool supports_frame(size_t samples) const override {
+        for (uint32_t tenths : OPUS_FRAME_TENTHS_MS) {
+            if (samples * 10000 == static_cast<size_t>(clock_rate_) * tenths) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Packets over 20 ms hold several frames
+    size_t max_encoded_size(size_t samples) const override {
+        const size_t frame_20ms = clock_rate_ / 50;
+        return OPUS_MAX_FRAME * std::max<size_t>(1, (samples + frame_20ms - 1) / frame_20ms);
+    }
+    size_t max_decoded_samples(size_t) const override {
+        return static_cast<size_t>(clock_rate_) * OPUS_MAX_PACKET_MS / 1000;
+    }
+    size_t payload_samples(const uint8_t* in, size_t bytes) const override {
+        if (bytes == 0) {
+            return 0;
+        }
+        const int samples = opus_packet_get_nb_samples(in, static_cast<opus_int32>(bytes),
+                                                       static_cast<opus_int32>(clock_rate_));
+        return samples > 0 && static_cast<size_t>(samples) <= max_decoded_samples(bytes)
+                   ? static_cast<size_t>(samples)
+                   : 0;
+    }
+
+    // The encoder lowers its rate for the frame if capacity is tight, so the result always fits
+    size_t encode(const float* in, size_t samples, uint8_t* out, size_t capacity) override {
+        if (!supports_frame(samples) || capacity == 0) {
+            return 0;
+        }
+
+        const size_t limit = std::min(capacity, max_encoded_size(samples));
+        const opus_int32 size = opus_encode_float(encoder_, in, static_cast<int>(samples), out,
+                                                  static_cast<opus_int32>(limit));
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    // With DTX the encoder emits a bare TOC byte (or two) for every frame of silence
+    bool is_silence(size_t encoded_bytes) const override {
+        return config_.dtx && encoded_bytes <= 2;
+    }
+
+    size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) override {
+        if (bytes == 0) {
+            return 0;
+        }
+
+        const int samples = opus_decode_float(decoder_, in, static_cast<opus_int32>(bytes), out,
+                                              static_cast<int>(capacity), 0);
+        return samples > 0 ? static_cast<size_t>(samples) : 0;
+    }
+
+    // Decoding with the FEC flag yields the previous frame, which must be exactly samples long.
+    // Call it before decode() of the same packet so the decoder state stays in order.
+    size_t decode_fec(const uint8_t* in, size_t bytes, float* out, size_t samples) override {
+        if (!config_.fec || bytes == 0 || !supports_frame(samples)) {
+            return 0;
+        }
+
+        const int recovered = opus_decode_float(decoder_, in, static_cast<opus_int32>(bytes),
+                                                out, static_cast<int>(samples), 1);
+        return recovered > 0 ? static_cast<size_t>(recovered) : 0;
+    }
+
+    void reset() override {
+        opus_encoder_ctl(encoder_, OPUS_RESET_STATE);
+        opus_decoder_ctl(decoder_, OPUS_RESET_STATE);
+    }
+
+private:
+    const EdgeVoxOpusConfig config_;
+    OpusEncoder* encoder_ = nullptr;
+    OpusDecoder* decoder_ = nullptr;
+};
+}  // namespace
+
+std::unique_ptr<AudioCodec> create_opus_codec(uint32_t clock_rate,
+                                              const EdgeVoxOpusConfig& config) {
+    switch (clock_rate) {
+        case 8000:
+        case 12000:
+        case 16000:
+        case 24000:
+        case 48000:
+            break;
+        default:
+            return nullptr;
+    }
+
+    auto codec = std::make_unique<OpusCodec>(clock_rate, config);
+    if (!codec->init()) {
+        return nullptr;
+    }
+    return codec;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <memory>
+
+#include "audio/audio_codec.hpp"
+
+// Opus encoder and decoder pair (libopus). Only built when CMake finds libopus, which defines
+// EDGE_VOX_HAVE_OPUS. clock_rate must be one Opus supports: 8, 12, 16, 24 or 48 kHz.
+std::unique_ptr<AudioCodec> create_opus_codec(uint32_t clock_rate,
+                                              const EdgeVoxOpusConfig& config);
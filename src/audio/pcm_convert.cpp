@@ -0,0 +1,272 @@
+#include "audio/pcm_convert.hpp"
+
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+constexpr float PCM_SCALE = 32767.0f;
+constexpr float PCM_INV_SCALE = 1.0f / 32768.0f;
+constexpr float PCM_MIN = -32768.0f;
+constexpr float PCM_MAX = 32767.0f;
+
+// Adding and subtracting 1.5 * 2^23 rounds to nearest-even, like cvtps2dq/fcvtns, without a
+// libm call
+constexpr float ROUND_MAGIC = 12582912.0f;
+
+// Dither is generated in blocks so the vector kernels only see plain arrays
+constexpr size_t DITHER_BLOCK = 256;
+
+using EncodeFn = void (*)(const float* in, const float* dither, uint8_t* out, size_t n);
+using DecodeFn = void (*)(const uint8_t* in, float* out, size_t n);
+
+inline void encode_one(float v, uint8_t* out) {
+    v = v > PCM_MIN ? v : PCM_MIN;
+    v = v < PCM_MAX ? v : PCM_MAX;
+
+    const int16_t pcm = static_cast<int16_t>((v + ROUND_MAGIC) - ROUND_MAGIC);
+    out[0] = static_cast<uint8_t>((pcm >> 8) & 0xFF);
+    out[1] = static_cast<uint8_t>(pcm & 0xFF);
+}
+
+// Reference implementation, also used for the tails of the vector kernels. NaN saturates to
+// the negative limit, like the SSE min/max sequence.
+void encode_scalar(const float* in, const float* dither, uint8_t* out, size_t n) {
+    if (dither) {
+        for (size_t i = 0; i < n; i++) {
+            encode_one(in[i] * PCM_SCALE + dither[i], out + 2 * i);
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            encode_one(in[i] * PCM_SCALE, out + 2 * i);
+        }
+    }
+}
+
+void decode_scalar(const uint8_t* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const int16_t pcm = static_cast<int16_t>((in[2 * i] << 8) | in[2 * i + 1]);
+        out[i] = pcm * PCM_INV_SCALE;
+    }
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+void encode_sse2(const float* in, const float* dither, uint8_t* out, size_t n) {
+    const __m128 scale = _mm_set1_ps(PCM_SCALE);
+    const __m128 lo = _mm_set1_ps(PCM_MIN);
+    const __m128 hi = _mm_set1_ps(PCM_MAX);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), scale);
+        if (dither) {
+            a = _mm_add_ps(a, _mm_loadu_ps(dither + i));
+            b = _mm_add_ps(b, _mm_loadu_ps(dither + i + 4));
+        }
+        a = _mm_min_ps(_mm_max_ps(a, lo), hi);
+        b = _mm_min_ps(_mm_max_ps(b, lo), hi);
+
+        __m128i pcm = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        pcm = _mm_or_si128(_mm_slli_epi16(pcm, 8), _mm_srli_epi16(pcm, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), pcm);
+    }
+
+    encode_scalar(in + i, dither ? dither + i : nullptr, out + 2 * i, n - i);
+}
+
+void decode_sse2(const uint8_t* in, float* out, size_t n) {
+    const __m128 scale = _mm_set1_ps(PCM_INV_SCALE);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i pcm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        pcm = _mm_or_si128(_mm_slli_epi16(pcm, 8), _mm_srli_epi16(pcm, 8));
+
+        // Sign-extend by placing each int16 in the top half of an int32
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(pcm, pcm), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(pcm, pcm), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    decode_scalar(in + 2 * i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) void encode_avx2(const float* in, const float* dither,
+                                                 uint8_t* out, size_t n) {
+    const __m256 scale = _mm256_set1_ps(PCM_SCALE);
+    const __m256 lo = _mm256_set1_ps(PCM_MIN);
+    const __m256 hi = _mm256_set1_ps(PCM_MAX);
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale);
+        if (dither) {
+            a = _mm256_add_ps(a, _mm256_loadu_ps(dither + i));
+            b = _mm256_add_ps(b, _mm256_loadu_ps(dither + i + 8));
+        }
+        a = _mm256_min_ps(_mm256_max_ps(a, lo), hi);
+        b = _mm256_min_ps(_mm256_max_ps(b, lo), hi);
+
+        // packs works per 128-bit lane; restore sample order before the byte swap
+        __m256i pcm = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        pcm = _mm256_permute4x64_epi64(pcm, _MM_SHUFFLE(3, 1, 2, 0));
+        pcm = _mm256_shuffle_epi8(pcm, swap);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), pcm);
+    }
+
+    // The tail runs legacy-SSE code; avoid the AVX-SSE transition penalty
+    _mm256_zeroupper();
+    encode_sse2(in + i, dither ? dither + i : nullptr, out + 2 * i, n - i);
+}
+
+__attribute__((target("avx2"))) void decode_avx2(const uint8_t* in, float* out, size_t n) {
+    const __m256 scale = _mm256_set1_ps(PCM_INV_SCALE);
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i pcm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+        pcm = _mm256_shuffle_epi8(pcm, swap);
+
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(pcm));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(pcm, 1));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+
+    _mm256_zeroupper();
+    decode_sse2(in + 2 * i, out + i, n - i);
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+void encode_neon(const float* in, const float* dither, uint8_t* out, size_t n) {
+    const float32x4_t scale = vdupq_n_f32(PCM_SCALE);
+    const float32x4_t lo = vdupq_n_f32(PCM_MIN);
+    const float32x4_t hi = vdupq_n_f32(PCM_MAX);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vmulq_f32(vld1q_f32(in + i), scale);
+        float32x4_t b = vmulq_f32(vld1q_f32(in + i + 4), scale);
+        if (dither) {
+            a = vaddq_f32(a, vld1q_f32(dither + i));
+            b = vaddq_f32(b, vld1q_f32(dither + i + 4));
+        }
+        // The "nm" variants return the number when the other operand is NaN
+        a = vminnmq_f32(vmaxnmq_f32(a, lo), hi);
+        b = vminnmq_f32(vmaxnmq_f32(b, lo), hi);
+
+        const int16x8_t pcm =
+            vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+        vst1q_u8(out + 2 * i, vrev16q_u8(vreinterpretq_u8_s16(pcm)));
+    }
+
+    encode_scalar(in + i, dither ? dither + i : nullptr, out + 2 * i, n - i);
+}
+
+void decode_neon(const uint8_t* in, float* out, size_t n) {
+    const float32x4_t scale = vdupq_n_f32(PCM_INV_SCALE);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t pcm = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(in + 2 * i)));
+        const int32x4_t lo = vmovl_s16(vget_low_s16(pcm));
+        const int32x4_t hi = vmovl_high_s16(pcm);
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(lo), scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+    }
+
+    decode_scalar(in + 2 * i, out + i, n - i);
+}
+#endif
+
+EncodeFn encoder(PcmKernel kernel) {
+    return simd_select(kernel, encode_scalar, EDGE_VOX_X86_KERNEL(encode_sse2),
+                       EDGE_VOX_X86_KERNEL(encode_avx2), EDGE_VOX_NEON_KERNEL(encode_neon));
+}
+
+DecodeFn decoder(PcmKernel kernel) {
+    return simd_select(kernel, decode_scalar, EDGE_VOX_X86_KERNEL(decode_sse2),
+                       EDGE_VOX_X86_KERNEL(decode_avx2), EDGE_VOX_NEON_KERNEL(decode_neon));
+}
+
+PcmKernel detect_kernel() {
+#if defined(EDGE_VOX_SIMD_X86)
+    return __builtin_cpu_supports("avx2") ? PcmKernel::Avx2 : PcmKernel::Sse2;
+#elif defined(EDGE_VOX_SIMD_NEON)
+    return PcmKernel::Neon;
+#else
+    return PcmKernel::Scalar;
+#endif
+}
+}  // namespace
+
+PcmKernel pcm_best_kernel() {
+    static const PcmKernel best = detect_kernel();
+    return best;
+}
+
+bool pcm_kernel_supported(PcmKernel kernel) {
+    switch (kernel) {
+        case PcmKernel::Scalar:
+            return true;
+#ifdef EDGE_VOX_SIMD_X86
+        case PcmKernel::Sse2:
+            return true;
+        case PcmKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef EDGE_VOX_SIMD_NEON
+        case PcmKernel::Neon:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* pcm_kernel_name(PcmKernel kernel) {
+    switch (kernel) {
+        case PcmKernel::Sse2:
+            return "sse2";
+        case PcmKernel::Avx2:
+            return "avx2";
+        case PcmKernel::Neon:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
+
+void float_to_pcm16be(const float* in, uint8_t* out, size_t n, TpdfDither* dither) {
+    float_to_pcm16be(in, out, n, dither, pcm_best_kernel());
+}
+
+void float_to_pcm16be(const float* in, uint8_t* out, size_t n, TpdfDither* dither,
+                      PcmKernel kernel) {
+    const EncodeFn encode = encoder(kernel);
+    if (!dither) {
+        encode(in, nullptr, out, n);
+        return;
+    }
+
+    float noise[DITHER_BLOCK];
+    for (size_t i = 0; i < n; i += DITHER_BLOCK) {
+        const size_t count = n - i < DITHER_BLOCK ? n - i : DITHER_BLOCK;
+        dither->fill(noise, count);
+        encode(in + i, noise, out + 2 * i, count);
+    }
+}
+
+void pcm16be_to_float(const uint8_t* in, float* out, size_t n) {
+    pcm16be_to_float(in, out, n, pcm_best_kernel());
+}
+
+void pcm16be_to_float(const uint8_t* in, float* out, size_t n, PcmKernel kernel) {
+    decoder(kernel)(in, out, n);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Instruction set used by the conversion kernels
+enum class PcmKernel { Scalar, Sse2, Avx2, Neon };
+
+// Fastest kernel the running CPU supports, detected once
+PcmKernel pcm_best_kernel();
+bool pcm_kernel_supported(PcmKernel kernel);
+const char* pcm_kernel_name(PcmKernel kernel);
+
+//
+// Triangular (TPDF) dither of +/-1 LSB. Eight independent xorshift32 generators run side by
+// side so the fill loop vectorizes; each 32-bit draw is split into the two uniform halves
+// that sum to the triangular distribution. Reproducible for a given seed.
+//
+class TpdfDither {
+public:
+    static constexpr size_t LANES = 8;
+
+    explicit TpdfDither(uint32_t seed = 1) {
+        for (size_t l = 0; l < LANES; l++) {
+            // Distinct, nonzero start for every lane
+            state_[l] = (seed + static_cast<uint32_t>(l)) * 2654435761u | 1u;
+        }
+    }
+
+    // Fill out with n dither values in LSB units, in [-1, 1)
+    void fill(float* out, size_t n) {
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t l = 0; l < LANES; l++) {
+                out[i + l] = next(l);
+            }
+        }
+        for (size_t l = 0; i < n; i++, l++) {
+            out[i] = next(l);
+        }
+    }
+
+private:
+    float next(size_t lane) {
+        uint32_t x = state_[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state_[lane] = x;
+        return static_cast<float>(static_cast<int32_t>((x & 0xFFFF) + (x >> 16))) *
+                   (1.0f / 65536.0f) -
+               1.0f;
+    }
+
+    uint32_t state_[LANES];
+};
+
+// Scale by 32767, optionally dither, round to nearest, saturate to int16 and store big-endian
+// (network order), all in one pass. out must hold 2 * n bytes.
+void float_to_pcm16be(const float* in, uint8_t* out, size_t n, TpdfDither* dither = nullptr);
+void float_to_pcm16be(const float* in, uint8_t* out, size_t n, TpdfDither* dither,
+                      PcmKernel kernel);
+
+// Big-endian int16 to float in [-1, 1)
+void pcm16be_to_float(const uint8_t* in, float* out, size_t n);
+void pcm16be_to_float(const uint8_t* in, float* out, size_t n, PcmKernel kernel);
@@ -0,0 +1,220 @@
+#include "audio/resampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include "audio/simd_dispatch.hpp"
+
+namespace {
+// Filter design per quality: taps per period of the lower rate and the Kaiser window beta
+struct FilterDesign {
+    size_t taps;
+    double beta;
+};
+
+FilterDesign filter_design(ResamplerQuality quality) {
+    switch (quality) {
+        case ResamplerQuality::Fast:
+            return {16, 5.0};
+        case ResamplerQuality::Best:
+            return {64, 9.0};
+        default:
+            return {32, 7.0};
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > sum * 1e-12; k++) {
+        const double half = x / (2.0 * k);
+        term *= half * half;
+        sum += term;
+    }
+    return sum;
+}
+
+float dot_scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef EDGE_VOX_SIMD_X86
+float dot_sse2(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2"))) float dot_avx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0,
+                             _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(
+            acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_add_ps(acc0,
+                             _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        i += 8;
+    }
+
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    const __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, half);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+float dot_neon(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+#endif
+
+}  // namespace
+
+bool PolyphaseResampler::configure(uint32_t in_rate, uint32_t out_rate,
+                                   ResamplerQuality quality, uint16_t channels,
+                                   size_t max_input, PcmKernel kernel) {
+    if (in_rate == 0 || out_rate == 0 || channels == 0 || max_input == 0) {
+        return false;
+    }
+    const uint32_t divisor = std::gcd(in_rate, out_rate);
+    if (out_rate / divisor > MAX_PHASES) {
+        return false;
+    }
+    up_ = out_rate / divisor;
+    down_ = in_rate / divisor;
+    max_input_ = max_input;
+    dot_ = simd_select(kernel, dot_scalar, EDGE_VOX_X86_KERNEL(dot_sse2),
+                       EDGE_VOX_X86_KERNEL(dot_avx2), EDGE_VOX_NEON_KERNEL(dot_neon));
+
+    // Same rate: passed through as is
+    if (up_ == down_) {
+        taps_ = 1;
+        phases_.assign(1, 1.0f);
+        history_.clear();
+        offset_.assign(channels, 0);
+        work_.clear();
+        return true;
+    }
+
+    // The filter runs at in_rate * up_ and spans taps periods of the lower rate, which is
+    // max(up_, down_) samples of it; each phase gets taps_ of them
+    const FilterDesign design = filter_design(quality);
+    const uint32_t period = std::max(up_, down_);
+    taps_ = design.taps * ((down_ + up_ - 1) / up_);
+    const size_t length = taps_ * up_;
+
+    // Kaiser's estimate of the transition band for this length and attenuation, in cycles
+    // per sample of the lower rate; the cutoff sits in its middle so the stopband starts at
+    // the lower Nyquist frequency
+    const double attenuation = design.beta / 0.1102 + 8.7;
+    const double transition = (attenuation - 7.95) / (14.36 * design.taps);
+    const double cutoff = (0.5 - transition / 2.0) / period;
+
+    const double pi = 3.14159265358979323846;
+    const double centre = (length - 1) / 2.0;
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        const double t = i - centre;
+        const double x = 2.0 * pi * cutoff * t;
+        const double sinc = t == 0.0 ? 1.0 : std::sin(x) / x;
+        const double r = 2.0 * t / (length - 1);
+        const double window = bessel_i0(design.beta * std::sqrt(std::max(0.0, 1.0 - r * r))) /
+                              bessel_i0(design.beta);
+        prototype[i] = sinc * window;
+        sum += prototype[i];
+    }
+
+    // Each phase j * up_ + p, reversed, with unity gain at DC on average
+    phases_.assign(length, 0.0f);
+    for (uint32_t p = 0; p < up_; p++) {
+        for (size_t j = 0; j < taps_; j++) {
+            phases_[p * taps_ + (taps_ - 1 - j)] =
+                static_cast<float>(prototype[j * up_ + p] * up_ / sum);
+        }
+    }
+
+    history_.assign(static_cast<size_t>(channels) * (taps_ - 1), 0.0f);
+    offset_.assign(channels, 0);
+    work_.assign(taps_ - 1 + max_input, 0.0f);
+    return true;
+}
+
+size_t PolyphaseResampler::process(size_t channel, const float* in, size_t n, float* out) {
+    if (channel >= offset_.size() || n > max_input_) {
+        return 0;
+    }
+
+    if (up_ == down_) {
+        std::memcpy(out, in, n * sizeof(float));
+        return n;
+    }
+
+    // Input and history side by side, so every dot product reads one contiguous run
+    const size_t keep = taps_ - 1;
+    float* history = history_.data() + channel * keep;
+    std::memcpy(work_.data(), history, keep * sizeof(float));
+    std::memcpy(work_.data() + keep, in, n * sizeof(float));
+
+    // Output k sits at time t, up_ per input sample: it needs inputs up to t / up_ and phase
+    // t % up_ of the filter
+    uint64_t t = offset_[channel];
+    const uint64_t end = static_cast<uint64_t>(n) * up_;
+    size_t count = 0;
+    for (; t < end; t += down_) {
+        const auto index = static_cast<size_t>(t / up_);
+        const float* phase = &phases_[(t % up_) * taps_];
+        out[count++] = dot_(phase, work_.data() + index, taps_);
+    }
+    offset_[channel] = t - end;
+
+    std::memcpy(history, work_.data() + n, keep * sizeof(float));
+    return count;
+}
+
+void PolyphaseResampler::reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    std::fill(offset_.begin(), offset_.end(), 0);
+}
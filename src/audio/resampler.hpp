@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio/pcm_convert.hpp"
+#include "edge_vox/audio/audio_config.hpp"
+
+//
+// Streaming polyphase FIR resampler for a rational ratio out_rate / in_rate = up / down.
+// A Kaiser-windowed sinc is designed once for the lower of the two Nyquist rates and split
+// into up phases; every output sample is one dot product of a phase with the latest input,
+// the only vectorized step. History and the position between input samples are kept per
+// channel, so blocks of any size give the same output as one long one.
+//
+class PolyphaseResampler {
+public:
+    // Largest up the filter bank is built for; rates whose ratio doesn't reduce below it are
+    // refused
+    static constexpr uint32_t MAX_PHASES = 1024;
+
+    // max_input is the most samples one process() call may pass
+    bool configure(uint32_t in_rate, uint32_t out_rate, ResamplerQuality quality,
+                   uint16_t channels, size_t max_input, PcmKernel kernel = pcm_best_kernel());
+
+    // Resample n (at most max_input) samples of one channel into out, which needs room for
+    // max_output(n). Returns the number written.
+    size_t process(size_t channel, const float* in, size_t n, float* out);
+
+    // Back to silence before the next sample
+    void reset();
+
+    size_t max_output(size_t n) const {
+        return (n * up_ + down_ - 1) / down_ + 1;
+    }
+
+    uint32_t up() const {
+        return up_;
+    }
+    uint32_t down() const {
+        return down_;
+    }
+    size_t taps() const {  // Per phase
+        return taps_;
+    }
+
+private:
+    uint32_t up_ = 1;
+    uint32_t down_ = 1;
+    size_t taps_ = 0;
+    size_t max_input_ = 0;
+    float (*dot_)(const float* a, const float* b, size_t n) = nullptr;
+
+    std::vector<float> phases_;     // up_ x taps_, each reversed to run along the input
+    std::vector<float> history_;    // channels x (taps_ - 1) latest input, oldest first
+    std::vector<uint64_t> offset_;  // Per channel: time of the next output past the last
+                                    // block, in 1/up_ of an input sample
+    std::vector<float> work_;       // History followed by the block being processed
+};
@@ -0,0 +1,71 @@
+#include "edge_vox/audio/resampler_stage.hpp"
+
+#include <algorithm>
+
+#include "audio/resampler.hpp"
+
+namespace {
+constexpr size_t MAX_INPUT_FRAMES = 16;  // Longest frame resampled, e.g. one carrying VAD
+                                         // pre-roll; older audio in front of it is dropped
+}  // namespace
+
+ResamplerStage::ResamplerStage(uint32_t output_rate, ResamplerQuality quality)
+    : output_rate_(output_rate),
+      quality_(quality),
+      resampler_(std::make_unique<PolyphaseResampler>()) {}
+
+ResamplerStage::~ResamplerStage() = default;
+
+bool ResamplerStage::configure(AudioFormat& format) {
+    if (!resampler_->configure(format.sample_rate, output_rate_, quality_, format.channels,
+                               MAX_INPUT_FRAMES * format.frame_samples)) {
+        return false;
+    }
+
+    // Every frame must come out the same length, so frames stay aligned with their sequence
+    const uint64_t scaled = static_cast<uint64_t>(format.frame_samples) * resampler_->up();
+    if (scaled % resampler_->down() != 0) {
+        return false;
+    }
+
+    input_ = format;
+    format.sample_rate = output_rate_;
+    format.frame_samples = static_cast<size_t>(scaled / resampler_->down());
+    output_ = format;
+    return true;
+}
+
+size_t ResamplerStage::max_frame_samples() const {
+    return MAX_INPUT_FRAMES * output_.frame_samples;
+}
+
+bool ResamplerStage::process(AudioFrame& frame) {
+    if (input_.sample_rate == output_rate_) {
+        return true;
+    }
+
+    // Whole input frames only, the newest MAX_INPUT_FRAMES of them
+    const size_t frame_in = input_.frame_samples;
+    const size_t frames = std::min(frame.samples / frame_in, MAX_INPUT_FRAMES);
+    const size_t n = frames * frame_in;
+    const size_t first = frame.samples - n;
+
+    // Audio that doesn't follow on from the last frame starts the filter over
+    if (frame.sequence + 1 != next_sequence_ + frames) {
+        resampler_->reset();
+    }
+    next_sequence_ = frame.sequence + 1;
+
+    size_t count = 0;
+    for (size_t c = 0; c < frame.channels; c++) {
+        count = resampler_->process(c, frame.channel(c) + first, n, frame.channel(c));
+    }
+    frame.sample_rate = output_rate_;
+    frame.samples = count;
+    return count > 0;
+}
+
+void ResamplerStage::reset() {
+    resampler_->reset();
+    next_sequence_ = 0;
+}
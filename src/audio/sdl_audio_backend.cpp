@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023-2024 GGerganov (Pulled from whisper.cpp project)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "edge_vox/audio/sdl_audio_backend.hpp"
+
+SdlAudioBackend::~SdlAudioBackend() {
+    close(AudioDirection::Capture);
+    close(AudioDirection::Playback);
+}
+
+bool SdlAudioBackend::init_sdl() {
+    if (m_sdl_initialized) {
+        return true;
+    }
+
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetHintWithPriority(SDL_HINT_AUDIO_RESAMPLING_MODE, "medium", SDL_HINT_OVERRIDE);
+
+    // List capture devices
+    {
+        int nDevices = SDL_GetNumAudioDevices(SDL_TRUE);
+        fprintf(stderr, "%s: found %d capture devices:\n", __func__, nDevices);
+        for (int i = 0; i < nDevices; i++) {
+            fprintf(stderr, "%s:    - Capture device #%d: '%s'\n", __func__, i,
+                    SDL_GetAudioDeviceName(i, SDL_TRUE));
+        }
+    }
+
+    // List playback devices
+    {
+        int nDevices = SDL_GetNumAudioDevices(SDL_FALSE);
+        fprintf(stderr, "%s: found %d playback devices:\n", __func__, nDevices);
+        for (int i = 0; i < nDevices; i++) {
+            fprintf(stderr, "%s:    - Playback device #%d: '%s'\n", __func__, i,
+                    SDL_GetAudioDeviceName(i, SDL_FALSE));
+        }
+    }
+
+    m_sdl_initialized = true;
+    return true;
+}
+
+bool SdlAudioBackend::open(AudioDirection direction, int device_id,
+                           const AudioBackendSpec &requested, AudioBackendSpec &obtained,
+                           Callback callback, void *userdata) {
+    if (!init_sdl()) {
+        return false;
+    }
+
+    const int is_capture = direction == AudioDirection::Capture ? SDL_TRUE : SDL_FALSE;
+    const char *kind = is_capture ? "capture" : "playback";
+
+    SDL_AudioSpec spec_requested;
+    SDL_AudioSpec spec_obtained;
+
+    SDL_zero(spec_requested);
+    SDL_zero(spec_obtained);
+
+    spec_requested.freq = requested.sample_rate;
+    spec_requested.format = AUDIO_F32;
+    spec_requested.channels = requested.channels;
+    spec_requested.samples = requested.frames_per_buffer;
+    spec_requested.callback = callback;
+    spec_requested.userdata = userdata;
+
+    // Capture takes the device's own channel layout: audio_async deinterleaves and mixes it
+    // faster than SDL's generic channel conversion
+    const int allowed_changes = is_capture ? SDL_AUDIO_ALLOW_CHANNELS_CHANGE : 0;
+
+    SDL_AudioDeviceID dev_id = 0;
+    if (device_id >= 0) {
+        fprintf(stderr, "%s: attempt to open %s device %d : '%s' ...\n", __func__, kind, device_id,
+                SDL_GetAudioDeviceName(device_id, is_capture));
+        dev_id = SDL_OpenAudioDevice(SDL_GetAudioDeviceName(device_id, is_capture), is_capture,
+                                     &spec_requested, &spec_obtained, allowed_changes);
+    } else {
+        fprintf(stderr, "%s: attempt to open default %s device ...\n", __func__, kind);
+        dev_id = SDL_OpenAudioDevice(nullptr, is_capture, &spec_requested, &spec_obtained,
+                                     allowed_changes);
+    }
+
+    if (!dev_id) {
+        fprintf(stderr, "%s: couldn't open an audio device for %s: %s!\n", __func__, kind,
+                SDL_GetError());
+        return false;
+    }
+
+    obtained.sample_rate = spec_obtained.freq;
+    obtained.channels = spec_obtained.channels;
+    obtained.frames_per_buffer = spec_obtained.samples;
+
+    if (is_capture) {
+        m_dev_id_in = dev_id;
+    } else {
+        m_dev_id_out = dev_id;
+    }
+
+    return true;
+}
+
+void SdlAudioBackend::pause(AudioDirection direction, bool paused) {
+    SDL_AudioDeviceID dev_id = direction == AudioDirection::Capture ? m_dev_id_in : m_dev_id_out;
+    if (dev_id) {
+        SDL_PauseAudioDevice(dev_id, paused ? 1 : 0);
+    }
+}
+
+void SdlAudioBackend::close(AudioDirection direction) {
+    SDL_AudioDeviceID &dev_id =
+        direction == AudioDirection::Capture ? m_dev_id_in : m_dev_id_out;
+    if (dev_id) {
+        SDL_CloseAudioDevice(dev_id);
+        dev_id = 0;
+    }
+}
+
+bool SdlAudioBackend::is_open(AudioDirection direction) const {
+    return (direction == AudioDirection::Capture ? m_dev_id_in : m_dev_id_out) != 0;
+}
+
+void SdlAudioBackend::shutdown() {
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDL_Quit();
+    m_sdl_initialized = false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "audio/pcm_convert.hpp"
+
+//
+// Instruction set detection and run-time kernel selection for the vectorized audio routines.
+// A source file with SIMD kernels includes this instead of the intrinsics headers, builds its
+// SSE2 and AVX2 variants under EDGE_VOX_SIMD_X86 and its NEON variant under EDGE_VOX_SIMD_NEON,
+// and picks one per call or per configure() with simd_select().
+//
+#if defined(__x86_64__) || defined(__i386__)
+#define EDGE_VOX_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define EDGE_VOX_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// A variant that only exists on one architecture, or nullptr when building for another
+#ifdef EDGE_VOX_SIMD_X86
+#define EDGE_VOX_X86_KERNEL(fn) fn
+#else
+#define EDGE_VOX_X86_KERNEL(fn) nullptr
+#endif
+
+#ifdef EDGE_VOX_SIMD_NEON
+#define EDGE_VOX_NEON_KERNEL(fn) fn
+#else
+#define EDGE_VOX_NEON_KERNEL(fn) nullptr
+#endif
+
+template <typename T>
+struct SimdSameType {
+    using type = T;
+};
+
+// The variant of a routine for kernel, or the scalar one when the CPU lacks that instruction
+// set or the variant isn't built for this architecture
+template <typename Fn>
+Fn simd_select(PcmKernel kernel, Fn scalar, typename SimdSameType<Fn>::type sse2,
+               typename SimdSameType<Fn>::type avx2, typename SimdSameType<Fn>::type neon) {
+    Fn chosen = nullptr;
+    switch (pcm_kernel_supported(kernel) ? kernel : PcmKernel::Scalar) {
+        case PcmKernel::Sse2:
+            chosen = sse2;
+            break;
+        case PcmKernel::Avx2:
+            chosen = avx2;
+            break;
+        case PcmKernel::Neon:
+            chosen = neon;
+            break;
+        default:
+            break;
+    }
+    return chosen ? chosen : scalar;
+}
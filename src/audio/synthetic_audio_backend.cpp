@@ -0,0 +1,58 @@
+#include "edge_vox/audio/synthetic_audio_backend.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SyntheticAudioBackend::SyntheticAudioBackend(SyntheticAudioConfig config)
+    : PacedAudioBackend(config.pacing), m_config(config), m_rng(config.seed) {}
+
+SyntheticAudioBackend::~SyntheticAudioBackend() {
+    stop_thread();
+}
+
+bool SyntheticAudioBackend::prepare_capture(const AudioBackendSpec& requested,
+                                            AudioBackendSpec& obtained) {
+    if (requested.sample_rate <= 0 || requested.channels <= 0) {
+        return false;
+    }
+
+    obtained = requested;
+    m_spec = obtained;
+    m_phase = 0.0;
+    m_rng.seed(m_config.seed);
+    return true;
+}
+
+size_t SyntheticAudioBackend::fill_capture(float* out, size_t frames) {
+    const size_t channels = m_spec.channels;
+
+    switch (m_config.waveform) {
+        case SyntheticAudioConfig::Waveform::Sine: {
+            const double step = 2.0 * M_PI * m_config.frequency / m_spec.sample_rate;
+            for (size_t i = 0; i < frames; i++) {
+                const float value = m_config.amplitude * static_cast<float>(std::sin(m_phase));
+                for (size_t c = 0; c < channels; c++) {
+                    out[i * channels + c] = value;
+                }
+                m_phase += step;
+                if (m_phase >= 2.0 * M_PI) {
+                    m_phase -= 2.0 * M_PI;
+                }
+            }
+            break;
+        }
+        case SyntheticAudioConfig::Waveform::WhiteNoise: {
+            std::uniform_real_distribution<float> dis(-m_config.amplitude, m_config.amplitude);
+            for (size_t i = 0; i < frames * channels; i++) {
+                out[i] = dis(m_rng);
+            }
+            break;
+        }
+        case SyntheticAudioConfig::Waveform::Silence:
+            std::fill(out, out + frames * channels, 0.0f);
+            break;
+    }
+
+    // Synthetic sources never run dry
+    return frames;
+}
@@ -0,0 +1,197 @@
+#include "edge_vox/audio/voice_activity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "audio/frame_features.hpp"
+
+namespace {
+constexpr float SILENCE_DB = -100.0f;        // Energy of digital silence, instead of -inf
+constexpr float NOISE_RISE_DB_PER_S = 6.0f;  // How fast the noise floor follows louder noise
+constexpr float BAND_LOW_HZ = 300.0f;        // Telephone band, where speech has most energy
+constexpr float BAND_HIGH_HZ = 3400.0f;
+
+// Frames covering at least ms of audio
+uint32_t frames_for(uint32_t ms, const AudioFormat& format) {
+    const uint64_t samples = static_cast<uint64_t>(format.sample_rate) * ms / 1000;
+    return static_cast<uint32_t>((samples + format.frame_samples - 1) / format.frame_samples);
+}
+}  // namespace
+
+VoiceActivityStage::VoiceActivityStage(const EdgeVoxVadConfig& config) : config_(config) {}
+
+bool VoiceActivityStage::configure(AudioFormat& format) {
+    if (config_.band_energy && format.sample_rate < 2 * BAND_HIGH_HZ) {
+        return false;
+    }
+
+    format_ = format;
+    hangover_frames_ = frames_for(config_.hangover_ms, format);
+    preroll_frames_ = frames_for(config_.preroll_ms, format);
+    preroll_.assign(static_cast<size_t>(preroll_frames_) * format.channels * format.frame_samples,
+                    0.0f);
+    noise_rise_db_ = NOISE_RISE_DB_PER_S * format.frame_samples / format.sample_rate;
+
+    // Band-pass around the geometric centre of the band, bandwidth in octaves (RBJ cookbook)
+    const float pi = 3.14159265358979f;
+    const float w0 = 2.0f * pi * std::sqrt(BAND_LOW_HZ * BAND_HIGH_HZ) / format.sample_rate;
+    const float octaves = std::log2(BAND_HIGH_HZ / BAND_LOW_HZ);
+    const float alpha =
+        std::sin(w0) * std::sinh(std::log(2.0f) / 2.0f * octaves * w0 / std::sin(w0));
+    const float a0 = 1.0f + alpha;
+    b0_ = alpha / a0;
+    b2_ = -alpha / a0;
+    a1_ = -2.0f * std::cos(w0) / a0;
+    a2_ = (1.0f - alpha) / a0;
+    return true;
+}
+
+size_t VoiceActivityStage::max_frame_samples() const {
+    return (preroll_frames_ + 1) * format_.frame_samples;
+}
+
+void VoiceActivityStage::reset() {
+    x1_ = x2_ = y1_ = y2_ = 0.0f;
+    noise_db_ = 0.0f;
+    first_frame_ = true;
+    speaking_ = false;
+    hangover_ = 0;
+    preroll_head_ = 0;
+    preroll_count_ = 0;
+
+    speech_frames_ = 0;
+    silent_frames_ = 0;
+    talkspurts_ = 0;
+    noise_floor_db_ = 0.0f;
+}
+
+bool VoiceActivityStage::process(AudioFrame& frame) {
+    if (is_speech_frame(frame.channel(0), frame.samples)) {
+        hangover_ = hangover_frames_;
+        if (!speaking_) {
+            speaking_ = true;
+            prepend_preroll(frame);
+            frame.talkspurt_start = true;
+            talkspurts_.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else if (speaking_) {
+        if (hangover_ > 0) {
+            hangover_--;
+        } else {
+            speaking_ = false;
+        }
+    }
+
+    if (!speaking_) {
+        store_preroll(frame);
+        silent_frames_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    speech_frames_.fetch_add(frame.samples / format_.frame_samples, std::memory_order_relaxed);
+    return true;
+}
+
+EdgeVoxVadStats VoiceActivityStage::get_stats() const {
+    EdgeVoxVadStats stats;
+    stats.speech_frames = speech_frames_.load(std::memory_order_relaxed);
+    stats.silent_frames = silent_frames_.load(std::memory_order_relaxed);
+    stats.talkspurts = talkspurts_.load(std::memory_order_relaxed);
+    stats.noise_floor_db = noise_floor_db_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool VoiceActivityStage::is_speech_frame(const float* samples, size_t count) {
+    if (count == 0) {
+        return false;
+    }
+
+    const FrameFeatures features = frame_features(samples, count);
+    const float energy_db =
+        features.energy > 0.0f ? std::max(10.0f * std::log10(features.energy), SILENCE_DB)
+                               : SILENCE_DB;
+
+    // The floor drops to any quieter frame at once and creeps up towards louder ones, so
+    // steady noise turns into silence after a while but pauses between words keep it low
+    if (first_frame_ || energy_db < noise_db_) {
+        noise_db_ = energy_db;
+    } else {
+        noise_db_ = std::min(energy_db, noise_db_ + noise_rise_db_);
+    }
+    first_frame_ = false;
+    noise_floor_db_.store(noise_db_, std::memory_order_relaxed);
+
+    // The filter runs on every frame so its state stays continuous
+    const float band = config_.band_energy ? band_pass(samples, count) : 0.0f;
+
+    const float zcr = static_cast<float>(features.crossings) / count;
+    return energy_db >= config_.threshold_db && energy_db >= noise_db_ + config_.snr_db &&
+           zcr <= config_.max_zcr &&
+           (!config_.band_energy || band >= config_.min_band_ratio * features.energy);
+}
+
+// Mean square of the frame after the speech band-pass
+float VoiceActivityStage::band_pass(const float* samples, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        const float x = samples[i];
+        const float y = b0_ * x + b2_ * x2_ - a1_ * y1_ - a2_ * y2_;
+        x2_ = x1_;
+        x1_ = x;
+        y2_ = y1_;
+        y1_ = y;
+        sum += y * y;
+    }
+    return sum / count;
+}
+
+void VoiceActivityStage::store_preroll(const AudioFrame& frame) {
+    if (preroll_frames_ == 0 || frame.samples != format_.frame_samples) {
+        return;
+    }
+
+    // Only frames that follow each other can be sent back to back
+    if (preroll_count_ > 0 && frame.sequence != preroll_next_) {
+        preroll_count_ = 0;
+        preroll_head_ = 0;
+    }
+
+    size_t slot = (preroll_head_ + preroll_count_) % preroll_frames_;
+    if (preroll_count_ == preroll_frames_) {
+        slot = preroll_head_;
+        preroll_head_ = (preroll_head_ + 1) % preroll_frames_;
+    } else {
+        preroll_count_++;
+    }
+
+    const size_t frame_size = format_.frame_samples;
+    float* dst = &preroll_[slot * format_.channels * frame_size];
+    for (size_t c = 0; c < format_.channels; c++) {
+        std::memcpy(dst + c * frame_size, frame.channel(c), frame_size * sizeof(float));
+    }
+    preroll_next_ = frame.sequence + 1;
+}
+
+void VoiceActivityStage::prepend_preroll(AudioFrame& frame) {
+    const size_t frame_size = format_.frame_samples;
+    const size_t count = frame.sequence == preroll_next_ ? preroll_count_ : 0;
+    const size_t head = preroll_head_;
+    preroll_count_ = 0;
+    preroll_head_ = 0;
+    if (count == 0 || frame.samples != frame_size) {
+        return;
+    }
+
+    // Move the frame back and put the stored frames in front of it, oldest first
+    for (size_t c = 0; c < format_.channels; c++) {
+        float* out = frame.channel(c);
+        std::memmove(out + count * frame_size, out, frame_size * sizeof(float));
+        for (size_t k = 0; k < count; k++) {
+            const size_t slot = (head + k) % preroll_frames_;
+            const float* src = &preroll_[(slot * format_.channels + c) * frame_size];
+            std::memcpy(out + k * frame_size, src, frame_size * sizeof(float));
+        }
+    }
+    frame.samples += count * frame_size;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "edge_vox/core/audio_stage.hpp"
+
+//
+// Single-producer / single-consumer queue of audio frames between two pipeline threads.
+//
+// Same scheme as PacketSlotBuffer: every frame is allocated at construction, the producer
+// fills the next free one in place between prepare() and commit(), the consumer works on the
+// oldest one between front() and release(). Nothing locks or allocates once it is built.
+//
+class AudioFrameQueue {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Frames hold up to channels planes of max_samples each
+    AudioFrameQueue(size_t capacity, uint16_t channels, size_t max_samples)
+        : capacity_(capacity > 0 ? capacity : 1), frames_(new AudioFrame[capacity_]) {
+        for (size_t i = 0; i < capacity_; i++) {
+            frames_[i].stride = max_samples;
+            frames_[i].data.resize(static_cast<size_t>(channels) * max_samples);
+        }
+    }
+
+    AudioFrameQueue(const AudioFrameQueue&) = delete;
+    AudioFrameQueue& operator=(const AudioFrameQueue&) = delete;
+
+    // Producer: borrow the next free frame, or nullptr when full
+    AudioFrame* prepare() {
+        const uint64_t write = write_.load(std::memory_order_relaxed);
+        if (write - cached_read_ >= capacity_) {
+            cached_read_ = read_.load(std::memory_order_acquire);
+            if (write - cached_read_ >= capacity_) {
+                return nullptr;
+            }
+        }
+        return &frames_[write % capacity_];
+    }
+
+    // Producer: publish the frame returned by prepare()
+    void commit() {
+        write_.store(write_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Producer: queue a copy of frame; false when full or it doesn't fit the slots
+    bool push(const AudioFrame& frame) {
+        AudioFrame* slot = prepare();
+        if (slot == nullptr || frame.samples > slot->stride ||
+            static_cast<size_t>(frame.channels) * slot->stride > slot->data.size()) {
+            return false;
+        }
+
+        slot->sequence = frame.sequence;
+        slot->captured_ns = frame.captured_ns;
+        slot->sample_rate = frame.sample_rate;
+        slot->channels = frame.channels;
+        slot->samples = frame.samples;
+        slot->talkspurt_start = frame.talkspurt_start;
+        for (size_t c = 0; c < frame.channels; c++) {
+            std::memcpy(slot->channel(c), frame.channel(c), frame.samples * sizeof(float));
+        }
+        commit();
+        return true;
+    }
+
+    // Consumer: borrow the oldest frame, or nullptr when empty. It may be modified in place.
+    AudioFrame* front() {
+        const uint64_t read = read_.load(std::memory_order_relaxed);
+        if (read == cached_write_) {
+            cached_write_ = write_.load(std::memory_order_acquire);
+            if (read == cached_write_) {
+                return nullptr;
+            }
+        }
+        return &frames_[read % capacity_];
+    }
+
+    // Consumer: free the frame returned by front()
+    void release() {
+        read_.store(read_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const {
+        const uint64_t read = read_.load(std::memory_order_acquire);
+        return static_cast<size_t>(write_.load(std::memory_order_acquire) - read);
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // Consumer: drop every queued frame
+    void clear() {
+        cached_write_ = write_.load(std::memory_order_acquire);
+        read_.store(cached_write_, std::memory_order_release);
+    }
+
+private:
+    const size_t capacity_;
+    std::unique_ptr<AudioFrame[]> frames_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_{0};
+    uint64_t cached_read_ = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read_{0};
+    uint64_t cached_write_ = 0;
+};
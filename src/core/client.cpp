@@ -4,32 +4,23 @@
 #include <stdexcept>
 #include <thread>
 
+#include "../audio/audio_codec.hpp"
+#include "../core/pipeline.hpp"
 #include "../net/control_client.hpp"
+#include "../net/rtcp_session.hpp"
+#include "../net/rtp_receiver.hpp"
 #include "../net/rtp_streamer.hpp"
+#include "../net/sender_thread.hpp"
 #include "edge_vox/audio/audio_async.hpp"
+#include "edge_vox/audio/resampler_stage.hpp"
 
 class EdgeVoxClient::Impl {
 public:
-    Impl() : is_connected_(false), is_streaming_(false), audio_(30 * 1000) {  // 30 second buffer
-
-        // This will run in your audio worker thread from SDL
-        audio_process_timer_ = SDL_AddTimer(
-            10,
-            [](Uint32 interval, void* param) -> Uint32 {
-                auto* self = static_cast<Impl*>(param);
-
-                if (self->is_streaming_ && self->rtp_streamer_.is_active()) {
-                    std::vector<float> samples;
-                    self->audio_.get(10, samples);  // Get last 10ms of audio
-                    if (!samples.empty()) {
-                        self->rtp_streamer_.send_audio(samples);
-                    }
-                }
-
-                return interval;
-            },
-            this);
-
+    Impl()
+        : audio_(30 * 1000),  // 30 second buffer
+          is_connected_(false),
+          is_streaming_(false),
+          is_receiving_(false) {
         // Set up control client callback
         control_.set_status_callback([this](const std::string& status) {
             if (status_callback_) {
@@ -39,9 +30,7 @@ public:
     }
 
     ~Impl() {
-        if (audio_process_timer_) {
-            SDL_RemoveTimer(audio_process_timer_);
-        }
+        stop_audio_stream();  // Capture must stop before the sender it feeds goes away
     }
 
     bool connect(const std::string& server_ip, uint16_t port) {
@@ -62,7 +51,36 @@ public:
             }
 
             // Initialize audio
-            if (!audio_.init(-1, audio_config_.sample_rate)) {
+            if (!audio_.init(-1, -1, audio_config_.sample_rate, audio_config_.channels)) {
+                control_.disconnect();
+                return false;
+            }
+            audio_.set_capture_mix(audio_config_.capture_channel);
+
+            // Resample what the device actually delivers to the rate the server wants, and
+            // frame and batch the stream at that rate
+            if (!pipeline_.set_output_stage(
+                    stream_rate() != static_cast<uint32_t>(audio_.get_sample_rate())
+                        ? std::make_unique<ResamplerStage>(stream_rate(),
+                                                           audio_config_.resampler_quality)
+                        : nullptr)) {
+                audio_.close();
+                control_.disconnect();
+                return false;
+            }
+            if (!rtp_streamer_.set_packetization(stream_rate(), stream_config_.ptime_ms,
+                                                 stream_config_.mtu) ||
+                !rtp_streamer_.set_codec(audio_config_.codec, audio_config_.opus) ||
+                !rtp_streamer_.set_fec(fec_config()) ||
+                !rtp_streamer_.set_retransmission(rtx_config()) ||
+                !rtp_streamer_.set_batching(stream_config_.batch_packets, stream_config_.udp_gso)) {
+                audio_.close();
+                control_.disconnect();
+                return false;
+            }
+
+            if (stream_config_.rtcp_interval_ms > 0 && !start_rtcp(server_ip)) {
+                audio_.close();
                 control_.disconnect();
                 return false;
             }
@@ -90,8 +108,17 @@ public:
             return false;
         }
 
+        // Capture -> stages -> sender thread -> streamer. Each captured sample is sent once;
+        // the RTP clock skips whatever a stage or queue drops on the way.
+        if (!start_pipeline()) {
+            rtp_streamer_.stop();
+            return false;
+        }
+
         audio_.clear();
         if (!audio_.resume()) {
+            pipeline_.stop();
+            sender_.stop();
             rtp_streamer_.stop();
             return false;
         }
@@ -106,15 +133,102 @@ public:
         }
 
         audio_.pause();
+        if (is_receiving_) {
+            audio_.start_playback();  // pause() stops both directions
+        }
+        pipeline_.stop();
+        sender_.stop();
         rtp_streamer_.stop();
         is_streaming_ = false;
     }
 
+    bool start_receiving() {
+        if (!is_connected_) {
+            return false;
+        }
+
+        if (is_receiving_) {
+            return true;
+        }
+
+        if (!rtp_receiver_.init(stream_config_.receive_port)) {
+            return false;
+        }
+
+        JitterBufferConfig jitter;
+        jitter.sample_rate = audio_.get_sample_rate();
+        jitter.min_delay_ms = stream_config_.jitter_min_ms;
+        jitter.max_delay_ms = stream_config_.jitter_max_ms;
+        rtp_receiver_.set_clock_rate(audio_.get_sample_rate());
+        rtp_receiver_.set_codec(audio_config_.codec, audio_config_.opus);
+        rtp_receiver_.set_jitter_buffer(stream_config_.jitter_max_ms > 0, jitter);
+        rtp_receiver_.set_fec(stream_config_.fec_group > 0);
+        rtp_receiver_.set_audio_callback([this](const float* samples, size_t count) {
+            return audio_.play_audio(samples, count);
+        });
+
+        if (!audio_.start_playback()) {
+            return false;
+        }
+
+        if (!rtp_receiver_.start()) {
+            if (!is_streaming_) {
+                audio_.stop_playback();
+            }
+            return false;
+        }
+        rtcp_.set_receive_clock_rate(rtp_receiver_.rtp_clock_rate());
+
+        is_receiving_ = true;
+        return true;
+    }
+
+    void stop_receiving() {
+        if (!is_receiving_) {
+            return;
+        }
+
+        rtp_receiver_.stop();
+        audio_.clear_playback_buffer();
+        if (!is_streaming_) {
+            audio_.stop_playback();
+        }
+        is_receiving_ = false;
+    }
+
+    bool is_receiving() const {
+        return is_receiving_;
+    }
+
+    EdgeVoxRtpReceiveStats get_receive_stats() const {
+        return rtp_receiver_.get_stats();
+    }
+
+    EdgeVoxRtcpStats get_rtcp_stats() const {
+        return rtcp_.get_stats();
+    }
+
+    EdgeVoxSenderStats get_sender_stats() const {
+        return sender_.get_stats();
+    }
+
+    EdgeVoxPipelineStats get_pipeline_stats() const {
+        return pipeline_.get_stats();
+    }
+
+    void add_audio_stage(std::unique_ptr<AudioStage> stage, const AudioStageBinding& binding) {
+        if (is_streaming_ || !pipeline_.add_stage(std::move(stage), binding)) {
+            throw std::runtime_error("Cannot add an audio stage while streaming");
+        }
+    }
+
     void disconnect() {
         if (!is_connected_) {
             return;
         }
+        stop_receiving();
         stop_audio_stream();
+        rtcp_.stop();
         control_.disconnect();
         is_connected_ = false;
     }
@@ -141,15 +255,117 @@ public:
         stream_config_ = config;
     }
 
+    void set_audio_backend(std::unique_ptr<AudioBackend> backend) {
+        if (is_connected_) {
+            throw std::runtime_error("Cannot change audio backend while connected");
+        }
+        if (!audio_.set_backend(std::move(backend))) {
+            throw std::runtime_error("Cannot change audio backend while audio devices are open");
+        }
+    }
+
     void set_status_callback(EdgeVoxClient::StatusCallback callback) {
         status_callback_ = std::move(callback);
     }
 
 private:
+    RtpFecConfig fec_config() const {
+        RtpFecConfig config;
+        config.group_size = stream_config_.fec_group;
+        config.interleave = stream_config_.fec_interleave;
+        return config;
+    }
+
+    bool start_pipeline() {
+        // Every channel the device delivers when a stage mixes them down, otherwise the mono mix
+        const bool all_channels = audio_config_.multichannel && audio_.get_channels() > 1;
+
+        AudioFormat format;
+        format.sample_rate = audio_.get_sample_rate();
+        format.channels = all_channels ? static_cast<uint16_t>(audio_.get_channels()) : 1;
+        format.frame_samples = format.sample_rate * audio_config_.frame_ms / 1000;
+
+        // Captured blocks enter the pipeline on the audio thread; it ignores them while not
+        // streaming
+        audio_.set_capture_listener(
+            [this](const float* samples, size_t count) { pipeline_.push(samples, count); },
+            all_channels);
+
+        if (!pipeline_.start(format, [this](const AudioFrame& frame, uint64_t skipped) {
+                sender_.push(frame.channel(0), frame.samples, skipped, frame.talkspurt_start);
+            })) {
+            return false;
+        }
+
+        // The streamer is set up for mono at the stream rate
+        const AudioFormat output = pipeline_.output_format();
+        if (output.sample_rate != stream_rate() || output.channels != 1 ||
+            !sender_.start(sender_config(output.sample_rate),
+                           [this](const float* samples, size_t count, uint64_t gap,
+                                  bool talkspurt) {
+                               if (gap > 0) {
+                                   rtp_streamer_.skip_samples(static_cast<uint32_t>(gap));
+                               }
+                               if (talkspurt) {
+                                   rtp_streamer_.start_talkspurt();
+                               }
+                               rtp_streamer_.send_audio(samples, count);
+                           })) {
+            pipeline_.stop();
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t stream_rate() const {
+        return audio_config_.stream_rate > 0 ? audio_config_.stream_rate
+                                             : static_cast<uint32_t>(audio_.get_sample_rate());
+    }
+
+    SenderThreadConfig sender_config(uint32_t sample_rate) const {
+        SenderThreadConfig config;
+        config.sample_rate = sample_rate;
+        config.queue_ms = stream_config_.sender_queue_ms;
+        config.drop_policy = stream_config_.sender_drop_oldest ? SenderDropPolicy::Oldest
+                                                               : SenderDropPolicy::Newest;
+        config.priority = stream_config_.sender_priority;
+        config.cpu = stream_config_.sender_cpu;
+        return config;
+    }
+
+    RtpRtxConfig rtx_config() const {
+        RtpRtxConfig config;
+        config.history_ms = stream_config_.rtx_history_ms;
+        config.max_bitrate = stream_config_.rtx_max_bitrate;
+        return config;
+    }
+
+    // RTCP runs next to both RTP ports (RFC 3550 port + 1 convention)
+    bool start_rtcp(const std::string& server_ip) {
+        if (!rtcp_.init(server_ip, stream_config_.rtp_port + 1, stream_config_.receive_port + 1)) {
+            return false;
+        }
+
+        rtcp_.set_send_clock_rate(audio_codec_rtp_clock_rate(audio_config_.codec, stream_rate()));
+        rtcp_.set_interval(stream_config_.rtcp_interval_ms);
+        rtcp_.set_sender_source(
+            [this](RtcpSenderInfo& info) { return rtp_streamer_.get_sender_info(info); });
+        rtcp_.set_report_source([this](RtcpReportBlock& block) {
+            return is_receiving_ && rtp_receiver_.get_report_block(block);
+        });
+        rtcp_.set_nack_handler([this](uint32_t media_ssrc, const uint16_t* seqs, size_t count) {
+            rtp_streamer_.handle_nack(media_ssrc, seqs, count);
+        });
+        return rtcp_.start();
+    }
+
     audio_async audio_;
     EdgeVoxRtpStreamer rtp_streamer_;
+    EdgeVoxRtpReceiver rtp_receiver_;
+    EdgeVoxRtcpSession rtcp_;
     EdgeVoxControlClient control_;
-    SDL_TimerID audio_process_timer_;
+    EdgeVoxPipeline pipeline_;
+    EdgeVoxSenderThread sender_;
 
     EdgeVoxAudioConfig audio_config_;
     EdgeVoxStreamConfig stream_config_;
@@ -157,6 +373,7 @@ private:
 
     std::atomic<bool> is_connected_;
     std::atomic<bool> is_streaming_;
+    std::atomic<bool> is_receiving_;
 };
 
 EdgeVoxClient::EdgeVoxClient() : pimpl_(std::make_unique<Impl>()) {}
@@ -186,6 +403,39 @@ bool EdgeVoxClient::is_streaming() const {
     return pimpl_->is_streaming();
 }
 
+bool EdgeVoxClient::start_receiving() {
+    return pimpl_->start_receiving();
+}
+
+void EdgeVoxClient::stop_receiving() {
+    pimpl_->stop_receiving();
+}
+
+bool EdgeVoxClient::is_receiving() const {
+    return pimpl_->is_receiving();
+}
+
+EdgeVoxRtpReceiveStats EdgeVoxClient::get_receive_stats() const {
+    return pimpl_->get_receive_stats();
+}
+
+EdgeVoxRtcpStats EdgeVoxClient::get_rtcp_stats() const {
+    return pimpl_->get_rtcp_stats();
+}
+
+EdgeVoxSenderStats EdgeVoxClient::get_sender_stats() const {
+    return pimpl_->get_sender_stats();
+}
+
+EdgeVoxPipelineStats EdgeVoxClient::get_pipeline_stats() const {
+    return pimpl_->get_pipeline_stats();
+}
+
+void EdgeVoxClient::add_audio_stage(std::unique_ptr<AudioStage> stage,
+                                    const AudioStageBinding& binding) {
+    pimpl_->add_audio_stage(std::move(stage), binding);
+}
+
 void EdgeVoxClient::set_audio_config(const EdgeVoxAudioConfig& config) {
     pimpl_->set_audio_config(config);
 }
@@ -194,6 +444,10 @@ void EdgeVoxClient::set_stream_config(const EdgeVoxStreamConfig& config) {
     pimpl_->set_stream_config(config);
 }
 
+void EdgeVoxClient::set_audio_backend(std::unique_ptr<AudioBackend> backend) {
+    pimpl_->set_audio_backend(std::move(backend));
+}
+
 void EdgeVoxClient::set_status_callback(StatusCallback callback) {
     pimpl_->set_status_callback(std::move(callback));
 }
@@ -0,0 +1,427 @@
+#include "core/pipeline.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio/channel_mix.hpp"
+#include "core/audio_frame_queue.hpp"
+
+namespace {
+constexpr int POLL_TIMEOUT_MS = 100;  // How quickly a worker notices stop() on its own
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
+
+class EdgeVoxPipeline::Impl {
+public:
+    Impl() : active_(false), running_(false) {}
+
+    ~Impl() {
+        stop();
+    }
+
+    bool add_stage(std::unique_ptr<AudioStage> stage, const AudioStageBinding& binding) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (active_ || !stage) {
+            return false;
+        }
+
+        auto entry = std::make_unique<Stage>();
+        entry->stage = std::move(stage);
+        entry->binding = binding;
+        stages_.insert(stages_.end() - (has_output_stage_ ? 1 : 0), std::move(entry));
+        return true;
+    }
+
+    bool set_output_stage(std::unique_ptr<AudioStage> stage) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (active_) {
+            return false;
+        }
+
+        workers_.clear();
+        if (has_output_stage_) {
+            stages_.pop_back();
+            has_output_stage_ = false;
+        }
+        if (stage) {
+            auto entry = std::make_unique<Stage>();
+            entry->stage = std::move(stage);
+            stages_.push_back(std::move(entry));
+            has_output_stage_ = true;
+        }
+        return true;
+    }
+
+    void clear_stages() {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (!active_) {
+            workers_.clear();
+            stages_.clear();
+            has_output_stage_ = false;
+        }
+    }
+
+    size_t stage_count() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return stages_.size();
+    }
+
+    bool start(const AudioFormat& format, FrameSink sink) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (active_) {
+            return true;
+        }
+        if (!sink || format.sample_rate == 0 || format.channels == 0 ||
+            format.frame_samples == 0) {
+            return false;
+        }
+
+        // Walk the formats through the chain to size frames for the largest of them
+        AudioFormat current = format;
+        uint16_t max_channels = format.channels;
+        size_t max_samples = format.frame_samples;
+        for (auto& entry : stages_) {
+            entry->stage->reset();
+            if (!entry->stage->configure(current) || current.sample_rate == 0 ||
+                current.channels == 0 || current.frame_samples == 0) {
+                return false;
+            }
+            max_channels = std::max(max_channels, current.channels);
+            max_samples = std::max({max_samples, current.frame_samples,
+                                    entry->stage->max_frame_samples()});
+        }
+
+        input_format_ = format;
+        output_format_ = current;
+        sink_ = std::move(sink);
+
+        source_frame_.stride = max_samples;
+        source_frame_.data.assign(static_cast<size_t>(max_channels) * max_samples, 0.0f);
+        if (!build_workers(max_channels, max_samples)) {
+            workers_.clear();
+            return false;
+        }
+
+        for (auto& entry : stages_) {
+            entry->frames = 0;
+            entry->dropped = 0;
+            entry->overflows = 0;
+            entry->process_ns = 0;
+            entry->max_process_ns = 0;
+        }
+        source_frames_ = 0;
+        delivered_ = 0;
+        fill_ = 0;
+        next_sequence_ = 0;
+        sent_until_ = 0;
+
+        running_ = true;
+        for (size_t w = 0; w < workers_.size(); w++) {
+            if (workers_[w]->queue) {
+                workers_[w]->thread = std::thread(&Impl::run_worker, this, w);
+            }
+        }
+        active_ = true;
+        return true;
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        active_ = false;
+        running_ = false;
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                wake(*worker);
+                worker->thread.join();
+            }
+        }
+    }
+
+    bool is_active() const {
+        return active_;
+    }
+
+    AudioFormat output_format() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        return output_format_;
+    }
+
+    void push(const float* samples, size_t count) {
+        if (!active_) {
+            return;
+        }
+
+        const size_t channels = input_format_.channels;
+        size_t remaining = count / channels;
+        while (remaining > 0) {
+            const size_t n = std::min(remaining, input_format_.frame_samples - fill_);
+            deinterleave(samples, n, channels, source_frame_.channel(0) + fill_,
+                         source_frame_.stride);
+            fill_ += n;
+            samples += n * channels;
+            remaining -= n;
+
+            if (fill_ == input_format_.frame_samples) {
+                source_frame_.sequence = next_sequence_++;
+                source_frame_.captured_ns = now_ns();
+                source_frame_.sample_rate = input_format_.sample_rate;
+                source_frame_.channels = input_format_.channels;
+                source_frame_.samples = input_format_.frame_samples;
+                source_frame_.talkspurt_start = false;
+                source_frames_.fetch_add(1, std::memory_order_relaxed);
+                fill_ = 0;
+                deliver(source_frame_, 0);
+            }
+        }
+    }
+
+    EdgeVoxPipelineStats get_stats() const {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        EdgeVoxPipelineStats stats;
+        stats.frames = source_frames_.load(std::memory_order_relaxed);
+        stats.delivered = delivered_.load(std::memory_order_relaxed);
+        stats.stages.resize(stages_.size());
+
+        for (size_t i = 0; i < stages_.size(); i++) {
+            const Stage& entry = *stages_[i];
+            EdgeVoxStageStats& out = stats.stages[i];
+            out.name = entry.stage->name();
+            out.frames = entry.frames.load(std::memory_order_relaxed);
+            out.dropped = entry.dropped.load(std::memory_order_relaxed);
+            out.overflows = entry.overflows.load(std::memory_order_relaxed);
+            if (out.frames > 0) {
+                out.avg_process_us =
+                    entry.process_ns.load(std::memory_order_relaxed) / 1000.0 / out.frames;
+            }
+            out.max_process_us = entry.max_process_ns.load(std::memory_order_relaxed) / 1000.0;
+        }
+
+        // Queue depth belongs to the stage at the head of each worker
+        for (const auto& worker : workers_) {
+            if (worker->queue && worker->first < stats.stages.size()) {
+                EdgeVoxStageStats& out = stats.stages[worker->first];
+                out.queue_depth = static_cast<uint32_t>(worker->queue->size());
+                out.max_queue_depth = worker->max_depth.load(std::memory_order_relaxed);
+            }
+        }
+        return stats;
+    }
+
+private:
+    struct Stage {
+        std::unique_ptr<AudioStage> stage;
+        AudioStageBinding binding;
+        // Written by the thread the stage runs on only
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> overflows{0};
+        std::atomic<uint64_t> process_ns{0};
+        std::atomic<uint64_t> max_process_ns{0};
+    };
+
+    // A run of stages [first, end) sharing one thread. Without a queue they run on the
+    // capture thread.
+    struct Worker {
+        size_t first = 0;
+        size_t end = 0;
+        std::unique_ptr<AudioFrameQueue> queue;
+        int event_fd = -1;
+        std::thread thread;
+        std::atomic<uint32_t> max_depth{0};
+
+        ~Worker() {
+            if (event_fd >= 0) {
+                close(event_fd);
+            }
+        }
+    };
+
+    bool build_workers(uint16_t channels, size_t max_samples) {
+        workers_.clear();
+        if (stages_.empty() || stages_.front()->binding.own_thread) {
+            workers_.push_back(std::make_unique<Worker>());  // Capture thread, no stages
+        }
+
+        for (size_t i = 0; i < stages_.size(); i++) {
+            const AudioStageBinding& binding = stages_[i]->binding;
+            if (i == 0 || binding.own_thread) {
+                auto worker = std::make_unique<Worker>();
+                worker->first = i;
+                if (binding.own_thread) {
+                    worker->queue = std::make_unique<AudioFrameQueue>(binding.queue_frames,
+                                                                      channels, max_samples);
+                    worker->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                    if (worker->event_fd < 0) {
+                        return false;
+                    }
+                }
+                workers_.push_back(std::move(worker));
+            }
+            workers_.back()->end = i + 1;
+        }
+        return true;
+    }
+
+    void wake(Worker& worker) {
+        const uint64_t one = 1;
+        if (worker.event_fd >= 0) {
+            [[maybe_unused]] const ssize_t written = write(worker.event_fd, &one, sizeof(one));
+        }
+    }
+
+    // Hand a frame to worker w: queue it for its thread, or run it right here if it has none
+    void deliver(AudioFrame& frame, size_t w) {
+        if (w == workers_.size()) {
+            to_sink(frame);
+            return;
+        }
+
+        Worker& worker = *workers_[w];
+        if (!worker.queue) {
+            run(frame, w);
+            return;
+        }
+
+        if (!worker.queue->push(frame)) {
+            stages_[worker.first]->overflows.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const auto depth = static_cast<uint32_t>(worker.queue->size());
+        if (depth > worker.max_depth.load(std::memory_order_relaxed)) {
+            worker.max_depth.store(depth, std::memory_order_relaxed);
+        }
+        wake(worker);
+    }
+
+    void run(AudioFrame& frame, size_t w) {
+        const Worker& worker = *workers_[w];
+        for (size_t i = worker.first; i < worker.end; i++) {
+            Stage& entry = *stages_[i];
+            const int64_t begin = now_ns();
+            const bool keep = entry.stage->process(frame);
+            const auto elapsed = static_cast<uint64_t>(std::max<int64_t>(now_ns() - begin, 0));
+
+            entry.frames.fetch_add(1, std::memory_order_relaxed);
+            entry.process_ns.fetch_add(elapsed, std::memory_order_relaxed);
+            if (elapsed > entry.max_process_ns.load(std::memory_order_relaxed)) {
+                entry.max_process_ns.store(elapsed, std::memory_order_relaxed);
+            }
+            if (!keep) {
+                entry.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        deliver(frame, w + 1);
+    }
+
+    // Last thread only. Frame n ends at sample (n + 1) * frame_samples of the output, however
+    // long it is; whatever lies between it and the end of the last frame sent was dropped.
+    void to_sink(const AudioFrame& frame) {
+        const uint64_t end = (frame.sequence + 1) * output_format_.frame_samples;
+        const uint64_t begin = end - std::min<uint64_t>(frame.samples, end);
+        const uint64_t skipped = begin > sent_until_ ? begin - sent_until_ : 0;
+        sent_until_ = end;
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        sink_(frame, skipped);
+    }
+
+    void run_worker(size_t w) {
+        Worker& worker = *workers_[w];
+        while (running_) {
+            pollfd fd{worker.event_fd, POLLIN, 0};
+            if (poll(&fd, 1, POLL_TIMEOUT_MS) <= 0 || !(fd.revents & POLLIN)) {
+                continue;
+            }
+
+            uint64_t events = 0;
+            [[maybe_unused]] const ssize_t size = read(worker.event_fd, &events, sizeof(events));
+            while (running_) {
+                AudioFrame* frame = worker.queue->front();
+                if (frame == nullptr) {
+                    break;
+                }
+                run(*frame, w);
+                worker.queue->release();
+            }
+        }
+    }
+
+    // Guards the stage list and workers against start/stop/get_stats on other threads
+    mutable std::mutex config_mutex_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+    bool has_output_stage_{false};  // The last of stages_ was set by set_output_stage()
+    std::vector<std::unique_ptr<Worker>> workers_;
+    AudioFormat input_format_;
+    AudioFormat output_format_;
+    FrameSink sink_;
+    std::atomic<bool> active_;
+    std::atomic<bool> running_;
+
+    // Capture thread only
+    AudioFrame source_frame_;
+    size_t fill_{0};
+    uint64_t next_sequence_{0};
+
+    // Thread of the last stage only: output sample position the transport has reached
+    uint64_t sent_until_{0};
+
+    std::atomic<uint64_t> source_frames_{0};
+    std::atomic<uint64_t> delivered_{0};
+};
+
+EdgeVoxPipeline::EdgeVoxPipeline() : pimpl_(std::make_unique<Impl>()) {}
+EdgeVoxPipeline::~EdgeVoxPipeline() = default;
+
+bool EdgeVoxPipeline::add_stage(std::unique_ptr<AudioStage> stage,
+                                const AudioStageBinding& binding) {
+    return pimpl_->add_stage(std::move(stage), binding);
+}
+
+bool EdgeVoxPipeline::set_output_stage(std::unique_ptr<AudioStage> stage) {
+    return pimpl_->set_output_stage(std::move(stage));
+}
+
+void EdgeVoxPipeline::clear_stages() {
+    pimpl_->clear_stages();
+}
+
+size_t EdgeVoxPipeline::stage_count() const {
+    return pimpl_->stage_count();
+}
+
+bool EdgeVoxPipeline::start(const AudioFormat& format, FrameSink sink) {
+    return pimpl_->start(format, std::move(sink));
+}
+
+void EdgeVoxPipeline::stop() {
+    pimpl_->stop();
+}
+
+bool EdgeVoxPipeline::is_active() const {
+    return pimpl_->is_active();
+}
+
+AudioFormat EdgeVoxPipeline::output_format() const {
+    return pimpl_->output_format();
+}
+
+void EdgeVoxPipeline::push(const float* samples, size_t count) {
+    pimpl_->push(samples, count);
+}
+
+EdgeVoxPipelineStats EdgeVoxPipeline::get_stats() const {
+    return pimpl_->get_stats();
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "edge_vox/core/audio_stage.hpp"
+#include "edge_vox/core/pipeline_stats.hpp"
+
+//
+// Capture pipeline: source -> DSP stages -> transport sink. push() cuts captured audio into
+// fixed frames (the source), the stages process them in order, and the sink hands the result
+// to the transport. Stages run on the capture thread unless bound to a thread of their own,
+// in which case a preallocated lock-free frame queue feeds them; later stages share that
+// thread until the next one with its own. Every stage publishes frame counts, queue depth and
+// processing time.
+//
+class EdgeVoxPipeline {
+public:
+    // Runs on the thread of the last stage. skipped is the number of samples (per channel, in
+    // the output format) dropped just before this frame, for the transport clock to skip.
+    using FrameSink = std::function<void(const AudioFrame& frame, uint64_t skipped)>;
+
+    EdgeVoxPipeline();
+    ~EdgeVoxPipeline();
+
+    // Append a stage; only while stopped
+    bool add_stage(std::unique_ptr<AudioStage> stage, const AudioStageBinding& binding = {});
+    // Stage that stays behind every added one, on the thread of the stage before it, e.g. the
+    // conversion to the format the transport wants. Replaces the previous one; nullptr removes
+    // it. Only while stopped.
+    bool set_output_stage(std::unique_ptr<AudioStage> stage);
+    void clear_stages();  // Output stage included
+    size_t stage_count() const;
+
+    // Configure the stages for input frames of format and start their threads. Fails if a
+    // stage refuses the format or a thread can't be started.
+    bool start(const AudioFormat& format, FrameSink sink);
+    void stop();  // Drops whatever is still queued
+    bool is_active() const;
+
+    // Format the sink receives; valid after start()
+    AudioFormat output_format() const;
+
+    // Source, capture thread only: samples interleaved by the input format's channels. Never
+    // blocks or allocates.
+    void push(const float* samples, size_t count);
+
+    EdgeVoxPipelineStats get_stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
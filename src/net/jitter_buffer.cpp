@@ -0,0 +1,311 @@
+#include "net/jitter_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "audio/audio_codec.hpp"
+
+namespace {
+constexpr size_t MAX_CONCEALED_FRAMES = 5;    // Underrun this long: stop and rebuffer
+constexpr float CONCEAL_DECAY = 0.5f;         // Gain applied per concealed frame
+constexpr size_t SHRINK_COOLDOWN = 10;        // Frames between two skipped frames
+constexpr size_t BOOST_DECAY_FRAMES = 50;     // Clean frames before the late boost shrinks
+constexpr double JITTER_SAFETY_FACTOR = 3.0;  // Target delay margin over the jitter estimate
+constexpr size_t MAX_CAPACITY = 32768;        // Half the sequence space, so deltas stay signed
+}  // namespace
+
+JitterBuffer::JitterBuffer(AudioCodec& codec, const JitterBufferConfig& config)
+    : codec_(codec), config_(config) {
+    size_t capacity = 2;
+    while (capacity < std::min(config_.capacity, MAX_CAPACITY)) {
+        capacity *= 2;
+    }
+    config_.capacity = capacity;
+    mask_ = capacity - 1;
+    config_.max_delay_ms = std::max(config_.max_delay_ms, config_.min_delay_ms);
+
+    slots_.resize(config_.capacity);
+    for (auto& s : slots_) {
+        s.payload.resize(config_.max_payload_size);
+    }
+    last_frame_.reserve(config_.max_frame_samples);
+
+    reset();
+}
+
+void JitterBuffer::reset() {
+    resync();
+    frame_samples_ = 0;
+    jitter_ = 0.0;
+    late_boost_ms_ = 0;
+    stats_ = JitterBufferStats();
+    target_ms_ = config_.min_delay_ms;
+}
+
+void JitterBuffer::resync() {
+    for (auto& s : slots_) {
+        s.filled = false;
+    }
+    last_frame_.clear();
+    codec_.reset();  // The next packet may start an unrelated stream
+    started_ = false;
+    playing_ = false;
+    have_transit_ = false;  // The new stream has an unrelated timestamp base
+    clean_frames_ = 0;
+    shrink_cooldown_ = 0;
+    conceal_gain_ = 1.0f;
+    consecutive_concealed_ = 0;
+}
+
+bool JitterBuffer::insert(uint16_t seq, uint32_t timestamp, const uint8_t* payload, size_t bytes,
+                          uint64_t arrival_us) {
+    if (bytes == 0 || bytes > config_.max_payload_size) {
+        return false;
+    }
+    const size_t count = codec_.payload_samples(payload, bytes);
+    if (count == 0 || count > config_.max_frame_samples) {
+        return false;
+    }
+
+    int16_t delta = static_cast<int16_t>(seq - next_seq_);
+    const int capacity = static_cast<int>(slots_.size());
+    if (started_ && (delta >= capacity || delta < -capacity)) {
+        // Too far from the playout point to be jitter: the sender restarted or we stalled
+        stats_.overflow++;
+        resync();
+    }
+
+    if (!started_) {
+        started_ = true;
+        next_seq_ = seq;
+        highest_seq_ = seq;
+        play_ts_ = timestamp;
+        frame_samples_ = count;
+        delta = 0;
+    }
+
+    update_jitter(timestamp, arrival_us);
+
+    // Still buffering: an earlier packet arriving out of order just moves the start back
+    if (delta < 0 && !playing_) {
+        next_seq_ = seq;
+        delta = 0;
+    }
+
+    if (delta < 0) {
+        stats_.late++;
+        late_boost_ms_ = std::min(late_boost_ms_ + frame_ms(), config_.max_delay_ms);
+        clean_frames_ = 0;
+        update_target();
+        return false;
+    }
+
+    if (has(seq)) {
+        return false;  // Duplicate
+    }
+
+    Slot& s = slot(seq);
+    s.filled = true;
+    s.seq = seq;
+    s.timestamp = timestamp;
+    s.count = count;
+    s.bytes = bytes;
+    std::copy(payload, payload + bytes, s.payload.begin());
+
+    if (static_cast<int16_t>(seq - highest_seq_) > 0) {
+        highest_seq_ = seq;
+    }
+
+    update_target();
+    return true;
+}
+
+size_t JitterBuffer::pop(float* out, size_t max) {
+    if (!started_ || max == 0) {
+        return 0;
+    }
+
+    const size_t buffered_ms = depth() * frame_ms();
+    if (!playing_) {
+        if (buffered_ms < target_ms_ || !has(next_seq_)) {
+            return 0;
+        }
+        playing_ = true;
+        consecutive_concealed_ = 0;
+        play_ts_ = slot(next_seq_).timestamp;
+    }
+
+    // Running deeper than needed: skip a frame to bring the delay down
+    if (shrink_cooldown_ > 0) {
+        shrink_cooldown_--;
+    } else if (buffered_ms > target_ms_ + 2 * frame_ms() && has(next_seq_)) {
+        Slot& s = slot(next_seq_);
+        s.filled = false;
+        play_ts_ = s.timestamp + static_cast<uint32_t>(s.count);
+        next_seq_++;
+        stats_.discarded++;
+        shrink_cooldown_ = SHRINK_COOLDOWN;
+    }
+
+    if (has(next_seq_)) {
+        Slot& s = slot(next_seq_);
+
+        // Timestamp gap before this packet (DTX): play silence until it is due
+        const int32_t gap = static_cast<int32_t>(s.timestamp - play_ts_);
+        if (gap > 0) {
+            const size_t n = std::min({static_cast<size_t>(gap), frame_samples_, max});
+            std::fill(out, out + n, 0.0f);
+            play_ts_ += static_cast<uint32_t>(n);
+            return n;
+        }
+
+        return play(s, out, max);
+    }
+
+    // Newer packets arrived, so this one is lost rather than late. The FEC of the next packet
+    // may still hold it.
+    if (static_cast<int16_t>(highest_seq_ - next_seq_) > 0) {
+        next_seq_++;
+        if (has(next_seq_)) {
+            const size_t n = recover(slot(next_seq_), out, max);
+            if (n > 0) {
+                return n;
+            }
+        }
+        stats_.lost++;
+        return conceal(out, max);
+    }
+
+    // Underrun: conceal while waiting for the packet, which grows the delay by a frame
+    if (consecutive_concealed_ >= MAX_CONCEALED_FRAMES) {
+        playing_ = false;
+        return 0;
+    }
+    return conceal(out, max);
+}
+
+size_t JitterBuffer::play(Slot& s, float* out, size_t max) {
+    s.filled = false;
+    next_seq_++;
+
+    const size_t n = codec_.decode(s.payload.data(), s.bytes, out, max);
+    if (n == 0) {
+        // The codec rejected it after all: conceal in its place
+        play_ts_ = s.timestamp;
+        return conceal(out, max);
+    }
+
+    play_ts_ = s.timestamp + static_cast<uint32_t>(s.count);
+    stats_.played++;
+    return deliver(out, n);
+}
+
+size_t JitterBuffer::recover(const Slot& next, float* out, size_t max) {
+    // The lost frame runs up to the timestamp of the next one
+    const uint32_t samples = next.timestamp - play_ts_;
+    if (samples == 0 || samples > max || samples > config_.max_frame_samples) {
+        return 0;
+    }
+
+    const size_t n = codec_.decode_fec(next.payload.data(), next.bytes, out, samples);
+    if (n == 0) {
+        return 0;
+    }
+
+    play_ts_ += static_cast<uint32_t>(n);
+    stats_.fec_recovered++;
+    return deliver(out, n);
+}
+
+// Common tail of a frame decoded from a packet or its FEC
+size_t JitterBuffer::deliver(float* out, size_t n) {
+    // Fade back in from the concealment gain instead of jumping to full level
+    if (consecutive_concealed_ > 0) {
+        const float start = conceal_gain_;
+        for (size_t i = 0; i < n; i++) {
+            out[i] *= start + (1.0f - start) * static_cast<float>(i) / n;
+        }
+    }
+
+    last_frame_.assign(out, out + n);
+    conceal_gain_ = 1.0f;
+    consecutive_concealed_ = 0;
+
+    // Relax the late-packet margin after a run of clean playout
+    if (++clean_frames_ >= BOOST_DECAY_FRAMES && late_boost_ms_ > 0) {
+        late_boost_ms_ -= std::min(late_boost_ms_, frame_ms());
+        clean_frames_ = 0;
+        update_target();
+    }
+
+    return n;
+}
+
+size_t JitterBuffer::conceal(float* out, size_t max) {
+    const size_t n = std::min(frame_samples_, max);
+
+    if (last_frame_.empty()) {
+        std::fill(out, out + n, 0.0f);
+    } else {
+        // Repeat the last frame, fading out across it
+        const float start = conceal_gain_;
+        const float end = conceal_gain_ * CONCEAL_DECAY;
+        for (size_t i = 0; i < n; i++) {
+            const float gain = start + (end - start) * static_cast<float>(i) / n;
+            out[i] = last_frame_[i % last_frame_.size()] * gain;
+        }
+        conceal_gain_ = end;
+    }
+
+    play_ts_ += static_cast<uint32_t>(n);
+    consecutive_concealed_++;
+    clean_frames_ = 0;
+    stats_.concealed++;
+    return n;
+}
+
+size_t JitterBuffer::depth() const {
+    if (!started_) {
+        return 0;
+    }
+
+    const int16_t frames = static_cast<int16_t>(highest_seq_ - next_seq_ + 1);
+    return frames > 0 ? static_cast<size_t>(frames) : 0;
+}
+
+uint32_t JitterBuffer::frame_ms() const {
+    if (frame_samples_ == 0 || config_.sample_rate == 0) {
+        return 1;
+    }
+    return std::max<uint32_t>(1, frame_samples_ * 1000 / config_.sample_rate);
+}
+
+void JitterBuffer::update_jitter(uint32_t timestamp, uint64_t arrival_us) {
+    // Relative transit time in timestamp units; unsigned arithmetic keeps it wrap-safe
+    const uint32_t arrival = static_cast<uint32_t>(arrival_us * config_.sample_rate / 1000000);
+    const int64_t transit = static_cast<uint32_t>(arrival - timestamp);
+
+    if (have_transit_) {
+        const int32_t d = static_cast<int32_t>(static_cast<uint32_t>(transit - last_transit_));
+        jitter_ += (std::abs(static_cast<double>(d)) - jitter_) / 16.0;
+    }
+    have_transit_ = true;
+    last_transit_ = transit;
+}
+
+void JitterBuffer::update_target() {
+    const double jitter_ms = jitter_ * 1000.0 / config_.sample_rate;
+    const uint32_t base =
+        frame_ms() + static_cast<uint32_t>(std::ceil(JITTER_SAFETY_FACTOR * jitter_ms));
+    target_ms_ = std::min(std::max(base, config_.min_delay_ms) + late_boost_ms_,
+                          config_.max_delay_ms);
+}
+
+JitterBufferStats JitterBuffer::stats() const {
+    JitterBufferStats stats = stats_;
+    stats.depth = depth();
+    stats.target_delay_ms = target_ms_;
+    stats.jitter_ms = jitter_ * 1000.0 / config_.sample_rate;
+    return stats;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class AudioCodec;
+
+struct JitterBufferConfig {
+    uint32_t sample_rate{16000};     // Rate of the decoded audio and of the timestamps passed in
+    uint32_t min_delay_ms{20};       // Target delay never drops below this
+    uint32_t max_delay_ms{200};      // ... nor grows above this
+    size_t capacity{64};             // Packets held for reordering, rounded up to a power of two
+    size_t max_frame_samples{2048};  // Payloads decoding to more are rejected
+    size_t max_payload_size{1500};   // Larger payloads are rejected
+};
+
+struct JitterBufferStats {
+    size_t depth{0};              // Frames between the playout point and the newest packet
+    uint32_t target_delay_ms{0};  // Current adaptive playout delay
+    double jitter_ms{0.0};        // RFC 3550 interarrival jitter estimate
+    uint64_t played{0};           // Frames decoded from received packets
+    uint64_t fec_recovered{0};    // Lost frames rebuilt from FEC in the packet after them
+    uint64_t late{0};             // Packets that arrived after their playout time
+    uint64_t lost{0};             // Packets never received, concealed
+    uint64_t concealed{0};        // Frames synthesized by loss concealment
+    uint64_t discarded{0};        // Frames skipped to shrink the delay
+    uint64_t overflow{0};         // Packets dropped because they were too far ahead
+};
+
+//
+// Adaptive jitter buffer for encoded audio payloads. Packets are slotted by RTP sequence
+// number and only decoded when they are played, strictly in sequence order, so a decoder
+// that keeps state between frames (Opus) never sees a late or reordered packet. Playout
+// follows the RTP timestamp timeline: gaps in the timestamps (discontinuous transmission)
+// play as silence. A missing packet is rebuilt from the FEC of the packet after it when that
+// one is already here and the codec carries FEC, otherwise it is concealed by repeating the
+// last frame with a fade. The target delay follows the measured interarrival jitter, grows
+// on late packets and is reduced by skipping frames when the buffer runs deep.
+//
+// Not thread safe: insert() and pop() must be called from the same thread, pop() once per
+// frame duration. The codec is used from that thread too and must outlive the buffer.
+//
+class JitterBuffer {
+public:
+    explicit JitterBuffer(AudioCodec& codec,
+                          const JitterBufferConfig& config = JitterBufferConfig());
+
+    // Store an encoded payload. timestamp is on the sample clock of config.sample_rate,
+    // arrival_us the local arrival time in microseconds on any monotonic clock. Returns false
+    // if the packet was late, malformed, too large or too far ahead.
+    bool insert(uint16_t seq, uint32_t timestamp, const uint8_t* payload, size_t bytes,
+                uint64_t arrival_us);
+
+    // Decode the next frame into out (room for max samples). Returns the number of samples
+    // written, 0 while (re)buffering.
+    size_t pop(float* out, size_t max);
+
+    // Samples per frame, learned from the first packet (0 before that)
+    size_t frame_samples() const {
+        return frame_samples_;
+    }
+
+    JitterBufferStats stats() const;
+    void reset();
+
+private:
+    struct Slot {
+        bool filled = false;
+        uint16_t seq = 0;
+        uint32_t timestamp = 0;
+        size_t count = 0;  // Samples the payload decodes to
+        std::vector<uint8_t> payload;
+        size_t bytes = 0;
+    };
+
+    // The slot count divides 65536, so neighbouring sequence numbers never share a slot
+    // across the wrap
+    Slot& slot(uint16_t seq) {
+        return slots_[seq & mask_];
+    }
+    bool has(uint16_t seq) const {
+        const Slot& s = slots_[seq & mask_];
+        return s.filled && s.seq == seq;
+    }
+
+    void resync();
+    size_t depth() const;
+    uint32_t frame_ms() const;
+    void update_jitter(uint32_t timestamp, uint64_t arrival_us);
+    void update_target();
+    size_t conceal(float* out, size_t max);
+    size_t play(Slot& s, float* out, size_t max);
+    size_t recover(const Slot& next, float* out, size_t max);
+    size_t deliver(float* out, size_t n);
+
+    AudioCodec& codec_;
+    JitterBufferConfig config_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    std::vector<float> last_frame_;  // Source for concealment
+
+    size_t frame_samples_ = 0;
+    bool started_ = false;   // First packet seen
+    bool playing_ = false;   // Past the initial buffering
+    uint16_t next_seq_ = 0;  // Next sequence number to play
+    uint16_t highest_seq_ = 0;
+    uint32_t play_ts_ = 0;  // RTP timestamp of the next sample to play
+
+    // Jitter estimate (RFC 3550 A.8) in timestamp units
+    bool have_transit_ = false;
+    int64_t last_transit_ = 0;
+    double jitter_ = 0.0;
+
+    uint32_t target_ms_ = 0;
+    uint32_t late_boost_ms_ = 0;  // Added on late packets, decays while playout is clean
+    size_t clean_frames_ = 0;
+    size_t shrink_cooldown_ = 0;
+    float conceal_gain_ = 1.0f;
+    size_t consecutive_concealed_ = 0;
+
+    JitterBufferStats stats_;
+};
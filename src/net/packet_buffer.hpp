@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -83,4 +86,162 @@ private:
     size_t packet_count_;
     std::vector<std::vector<uint8_t>> buffer_;
     mutable std::mutex mutex_;
-};
\ No newline at end of file
+};
+
+//
+// Single-producer / single-consumer packet FIFO with preallocated fixed-size slots.
+//
+// All slots live in one slab sized at construction, so queueing a packet never allocates
+// and never locks. Both sides can work in place: the producer borrows the next free slot
+// with prepare() and publishes it with commit(); the consumer reads the oldest packet
+// through front() and frees it with release().
+//
+class PacketSlotBuffer {
+public:
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    PacketSlotBuffer(size_t capacity = 100, size_t max_packet_size = 1500)
+        : capacity_(capacity > 0 ? capacity : 1),
+          max_packet_size_(max_packet_size),
+          slab_(new uint8_t[capacity_ * max_packet_size_]),
+          sizes_(new size_t[capacity_]()) {}
+
+    PacketSlotBuffer(const PacketSlotBuffer&) = delete;
+    PacketSlotBuffer& operator=(const PacketSlotBuffer&) = delete;
+
+    // Producer: borrow the next free slot (max_packet_size() bytes), or nullptr when full.
+    // Nothing is visible to the consumer until commit().
+    uint8_t* prepare() {
+        const uint64_t write = write_.load(std::memory_order_relaxed);
+        if (write - cached_read_ >= capacity_) {
+            cached_read_ = read_.load(std::memory_order_acquire);
+            if (write - cached_read_ >= capacity_) {
+                return nullptr;
+            }
+        }
+        return slot(write);
+    }
+
+    // Producer: publish the slot returned by prepare() holding len bytes
+    bool commit(size_t len) {
+        if (len > max_packet_size_) {
+            return false;
+        }
+
+        const uint64_t write = write_.load(std::memory_order_relaxed);
+        sizes_[write % capacity_] = len;
+        write_.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer: build a packet in place. fill(uint8_t* slot, size_t max) returns the number of
+    // bytes written, or 0 to abandon the slot.
+    template <typename Fill>
+    bool emplace(Fill&& fill) {
+        uint8_t* data = prepare();
+        if (data == nullptr) {
+            return false;
+        }
+
+        const size_t len = fill(data, max_packet_size_);
+        return len > 0 && commit(len);
+    }
+
+    bool push(const uint8_t* data, size_t len) {
+        if (len > max_packet_size_) {
+            return false;
+        }
+
+        uint8_t* dst = prepare();
+        if (dst == nullptr) {
+            return false;
+        }
+
+        std::memcpy(dst, data, len);
+        return commit(len);
+    }
+
+    bool push(const std::vector<uint8_t>& packet) {
+        return push(packet.data(), packet.size());
+    }
+
+    // Consumer: borrow the oldest packet, or nullptr when empty. The bytes stay valid until
+    // release().
+    const uint8_t* front(size_t& len) {
+        const uint64_t read = read_.load(std::memory_order_relaxed);
+        if (read == cached_write_) {
+            cached_write_ = write_.load(std::memory_order_acquire);
+            if (read == cached_write_) {
+                return nullptr;
+            }
+        }
+
+        len = sizes_[read % capacity_];
+        return slot(read);
+    }
+
+    // Consumer: free the packet returned by front()
+    void release() {
+        read_.store(read_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: copy the oldest packet out. The vector only reallocates if it has never held
+    // a packet this large.
+    bool pop(std::vector<uint8_t>& packet) {
+        size_t len = 0;
+        const uint8_t* data = front(len);
+        if (data == nullptr) {
+            return false;
+        }
+
+        packet.assign(data, data + len);
+        release();
+        return true;
+    }
+
+    size_t size() const {
+        const uint64_t read = read_.load(std::memory_order_acquire);
+        return static_cast<size_t>(write_.load(std::memory_order_acquire) - read);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool full() const {
+        return size() >= capacity_;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    size_t max_packet_size() const {
+        return max_packet_size_;
+    }
+
+    // Consumer: drop every queued packet. The slots are kept.
+    void clear() {
+        cached_write_ = write_.load(std::memory_order_acquire);
+        read_.store(cached_write_, std::memory_order_release);
+    }
+
+private:
+    uint8_t* slot(uint64_t index) const {
+        return &slab_[(index % capacity_) * max_packet_size_];
+    }
+
+    const size_t capacity_;
+    const size_t max_packet_size_;
+    std::unique_ptr<uint8_t[]> slab_;
+    std::unique_ptr<size_t[]> sizes_;
+
+    // Producer-owned: next slot to fill and its last view of the consumer index
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_{0};
+    uint64_t cached_read_ = 0;
+
+    // Consumer-owned: next slot to read and its last view of the producer index
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read_{0};
+    uint64_t cached_write_ = 0;
+};
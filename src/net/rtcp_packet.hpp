@@ -0,0 +1,289 @@
+#pragma once
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace {
+// RTCP packet types (RFC 3550 section 12.1)
+constexpr uint8_t RTCP_SR = 200;
+constexpr uint8_t RTCP_RR = 201;
+constexpr uint8_t RTCP_SDES = 202;
+constexpr uint8_t RTCP_BYE = 203;
+constexpr uint8_t RTCP_RTPFB = 205;  // Transport layer feedback (RFC 4585 section 6.2)
+
+constexpr uint8_t RTCP_FMT_NACK = 1;  // Generic NACK, in the count field of RTPFB
+
+constexpr uint8_t RTCP_SDES_CNAME = 1;
+constexpr size_t RTCP_HEADER_SIZE = 4;
+constexpr size_t RTCP_SENDER_INFO_SIZE = 20;
+constexpr size_t RTCP_REPORT_BLOCK_SIZE = 24;
+constexpr size_t RTCP_MAX_REPORT_BLOCKS = 31;  // 5-bit report count
+
+// Seconds between the NTP epoch (1900) and the Unix epoch (1970)
+constexpr uint64_t NTP_UNIX_OFFSET = 2208988800ULL;
+}  // namespace
+
+// Sender information of an SR
+struct RtcpSenderInfo {
+    uint32_t ssrc = 0;
+    uint64_t ntp_timestamp = 0;  // 32.32 fixed point seconds since 1900
+    uint32_t rtp_timestamp = 0;  // Same instant on the RTP clock
+    uint32_t packet_count = 0;
+    uint32_t octet_count = 0;  // Payload bytes, headers excluded
+};
+
+// Reception report about one source (RFC 3550 section 6.4.1)
+struct RtcpReportBlock {
+    uint32_t ssrc = 0;            // Source the report is about
+    uint8_t fraction_lost = 0;    // Lost since the previous report, in 1/256
+    int32_t cumulative_lost = 0;  // 24-bit signed on the wire
+    uint32_t highest_seq = 0;     // Extended highest sequence number received
+    uint32_t jitter = 0;          // Interarrival jitter in timestamp units
+    uint32_t lsr = 0;             // Middle 32 bits of the last SR's NTP timestamp
+    uint32_t dlsr = 0;            // Delay since that SR, in 1/65536 s
+};
+
+// One SR or RR taken from a compound packet
+struct RtcpReport {
+    uint32_t ssrc = 0;
+    bool has_sender_info = false;  // True for an SR
+    RtcpSenderInfo sender;
+    size_t block_count = 0;
+    RtcpReportBlock blocks[RTCP_MAX_REPORT_BLOCKS];
+};
+
+// Current wall clock as a 32.32 NTP timestamp
+inline uint64_t rtcpNtpNow() {
+    const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count();
+    const uint64_t seconds = static_cast<uint64_t>(us / 1000000) + NTP_UNIX_OFFSET;
+    const uint64_t fraction = (static_cast<uint64_t>(us % 1000000) << 32) / 1000000;
+    return (seconds << 32) | fraction;
+}
+
+// The 16.16 "compact" NTP form used by LSR/DLSR
+inline uint32_t rtcpNtpMiddle(uint64_t ntp) {
+    return static_cast<uint32_t>(ntp >> 16);
+}
+
+//
+// Appends RTCP packets to a caller-provided buffer to form a compound packet. Every add
+// method returns false, leaving the buffer unchanged, if the packet doesn't fit.
+//
+class RtcpWriter {
+public:
+    RtcpWriter(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {}
+
+    bool addSenderReport(const RtcpSenderInfo& info, const RtcpReportBlock* blocks,
+                         size_t count) {
+        count = std::min(count, RTCP_MAX_REPORT_BLOCKS);
+        const size_t length =
+            RTCP_HEADER_SIZE + 4 + RTCP_SENDER_INFO_SIZE + count * RTCP_REPORT_BLOCK_SIZE;
+        if (size_ + length > capacity_) {
+            return false;
+        }
+
+        uint8_t* p = writeHeader(count, RTCP_SR, length);
+        p = put32(p, info.ssrc);
+        p = put32(p, static_cast<uint32_t>(info.ntp_timestamp >> 32));
+        p = put32(p, static_cast<uint32_t>(info.ntp_timestamp));
+        p = put32(p, info.rtp_timestamp);
+        p = put32(p, info.packet_count);
+        p = put32(p, info.octet_count);
+        writeBlocks(p, blocks, count);
+
+        size_ += length;
+        return true;
+    }
+
+    bool addReceiverReport(uint32_t ssrc, const RtcpReportBlock* blocks, size_t count) {
+        count = std::min(count, RTCP_MAX_REPORT_BLOCKS);
+        const size_t length = RTCP_HEADER_SIZE + 4 + count * RTCP_REPORT_BLOCK_SIZE;
+        if (size_ + length > capacity_) {
+            return false;
+        }
+
+        uint8_t* p = writeHeader(count, RTCP_RR, length);
+        p = put32(p, ssrc);
+        writeBlocks(p, blocks, count);
+
+        size_ += length;
+        return true;
+    }
+
+    // SDES chunk with only the CNAME item, which every compound packet must carry
+    bool addCname(uint32_t ssrc, const std::string& cname) {
+        const size_t name_length = std::min<size_t>(cname.size(), 255);
+
+        // SSRC, item type and length, text, then at least one null octet up to a word boundary
+        const size_t chunk = (4 + 2 + name_length + 4) & ~size_t{3};
+        const size_t length = RTCP_HEADER_SIZE + chunk;
+        if (size_ + length > capacity_) {
+            return false;
+        }
+
+        uint8_t* p = writeHeader(1, RTCP_SDES, length);
+        std::memset(p, 0, chunk);
+        p = put32(p, ssrc);
+        p[0] = RTCP_SDES_CNAME;
+        p[1] = static_cast<uint8_t>(name_length);
+        std::memcpy(p + 2, cname.data(), name_length);
+
+        size_ += length;
+        return true;
+    }
+
+    bool addBye(uint32_t ssrc) {
+        const size_t length = RTCP_HEADER_SIZE + 4;
+        if (size_ + length > capacity_) {
+            return false;
+        }
+
+        put32(writeHeader(1, RTCP_BYE, length), ssrc);
+        size_ += length;
+        return true;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    uint8_t* writeHeader(size_t count, uint8_t type, size_t length) {
+        uint8_t* p = buffer_ + size_;
+        p[0] = static_cast<uint8_t>(0x80 | count);  // Version 2, no padding
+        p[1] = type;
+        const uint16_t words = htons(static_cast<uint16_t>(length / 4 - 1));
+        std::memcpy(p + 2, &words, sizeof(words));
+        return p + RTCP_HEADER_SIZE;
+    }
+
+    static uint8_t* put32(uint8_t* p, uint32_t value) {
+        const uint32_t word = htonl(value);
+        std::memcpy(p, &word, sizeof(word));
+        return p + sizeof(word);
+    }
+
+    static void writeBlocks(uint8_t* p, const RtcpReportBlock* blocks, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            const RtcpReportBlock& b = blocks[i];
+            const int32_t lost = std::min(std::max(b.cumulative_lost, -0x800000), 0x7FFFFF);
+            p = put32(p, b.ssrc);
+            p = put32(p, (static_cast<uint32_t>(b.fraction_lost) << 24) |
+                             (static_cast<uint32_t>(lost) & 0xFFFFFF));
+            p = put32(p, b.highest_seq);
+            p = put32(p, b.jitter);
+            p = put32(p, b.lsr);
+            p = put32(p, b.dlsr);
+        }
+    }
+
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+//
+// Walks a compound RTCP packet and calls on_report(const RtcpReport&) for every SR and RR,
+// and on_nack(uint32_t media_ssrc, uint16_t seq) for every sequence number a generic NACK
+// asks for. Other packet types are skipped. Returns false if the compound packet is
+// malformed; reports before the malformed part have already been delivered.
+//
+template <typename OnReport, typename OnNack>
+bool rtcpParseCompound(const uint8_t* data, size_t size, OnReport&& on_report,
+                       OnNack&& on_nack) {
+    auto get32 = [](const uint8_t* p) {
+        uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return ntohl(word);
+    };
+
+    if (size < RTCP_HEADER_SIZE) {
+        return false;
+    }
+
+    RtcpReport report;
+    while (size > 0) {
+        if (size < RTCP_HEADER_SIZE || (data[0] >> 6) != 2) {
+            return false;
+        }
+
+        const size_t count = data[0] & 0x1F;
+        const uint8_t type = data[1];
+        const size_t length = (static_cast<size_t>(data[2] << 8 | data[3]) + 1) * 4;
+        if (length > size) {
+            return false;
+        }
+
+        if (type == RTCP_SR || type == RTCP_RR) {
+            const size_t info = type == RTCP_SR ? RTCP_SENDER_INFO_SIZE : 0;
+            if (length < RTCP_HEADER_SIZE + 4 + info + count * RTCP_REPORT_BLOCK_SIZE) {
+                return false;
+            }
+
+            const uint8_t* p = data + RTCP_HEADER_SIZE;
+            report.ssrc = get32(p);
+            report.has_sender_info = type == RTCP_SR;
+            p += 4;
+
+            if (report.has_sender_info) {
+                report.sender.ssrc = report.ssrc;
+                report.sender.ntp_timestamp =
+                    static_cast<uint64_t>(get32(p)) << 32 | get32(p + 4);
+                report.sender.rtp_timestamp = get32(p + 8);
+                report.sender.packet_count = get32(p + 12);
+                report.sender.octet_count = get32(p + 16);
+                p += RTCP_SENDER_INFO_SIZE;
+            }
+
+            report.block_count = count;
+            for (size_t i = 0; i < count; i++, p += RTCP_REPORT_BLOCK_SIZE) {
+                RtcpReportBlock& b = report.blocks[i];
+                const uint32_t loss = get32(p + 4);
+                b.ssrc = get32(p);
+                b.fraction_lost = static_cast<uint8_t>(loss >> 24);
+                b.cumulative_lost = static_cast<int32_t>(loss << 8) >> 8;  // Sign-extend 24 bits
+                b.highest_seq = get32(p + 8);
+                b.jitter = get32(p + 12);
+                b.lsr = get32(p + 16);
+                b.dlsr = get32(p + 20);
+            }
+
+            on_report(static_cast<const RtcpReport&>(report));
+        } else if (type == RTCP_RTPFB && count == RTCP_FMT_NACK) {
+            if (length < RTCP_HEADER_SIZE + 8) {
+                return false;
+            }
+
+            const uint32_t media_ssrc = get32(data + RTCP_HEADER_SIZE + 4);
+            for (size_t offset = RTCP_HEADER_SIZE + 8; offset + 4 <= length; offset += 4) {
+                const uint32_t fci = get32(data + offset);
+                const auto pid = static_cast<uint16_t>(fci >> 16);
+                on_nack(media_ssrc, pid);
+                for (uint16_t bit = 0; bit < 16; bit++) {
+                    if (fci & (1u << bit)) {
+                        on_nack(media_ssrc, static_cast<uint16_t>(pid + bit + 1));
+                    }
+                }
+            }
+        }
+
+        data += length;
+        size -= length;
+    }
+
+    return true;
+}
+
+template <typename OnReport>
+bool rtcpParseCompound(const uint8_t* data, size_t size, OnReport&& on_report) {
+    return rtcpParseCompound(data, size, std::forward<OnReport>(on_report),
+                             [](uint32_t, uint16_t) {});
+}
@@ -0,0 +1,405 @@
+#include "net/rtcp_session.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr uint32_t DEFAULT_INTERVAL_MS = 5000;  // RFC 3550 minimum report interval
+constexpr int POLL_TIMEOUT_MS = 100;            // How quickly the thread notices stop()
+constexpr size_t MAX_RTCP_SIZE = 1500;
+constexpr uint32_t MAX_RTT_UNITS = 60 << 16;  // Ignore RTTs over a minute as bogus
+}  // namespace
+
+class EdgeVoxRtcpSession::Impl {
+public:
+    Impl() : socket_(-1), active_(false), running_(false) {
+        send_buffer_.resize(MAX_RTCP_SIZE);
+        receive_buffer_.resize(MAX_RTCP_SIZE);
+
+        char host[64] = {};
+        gethostname(host, sizeof(host) - 1);
+        cname_ = std::string("edge-vox@") + host;
+    }
+
+    ~Impl() {
+        stop();
+        close_socket();
+    }
+
+    bool init(const std::string& host, uint16_t port, uint16_t local_port) {
+        if (active_) {
+            return false;
+        }
+        close_socket();
+
+        memset(&dest_addr_, 0, sizeof(dest_addr_));
+        dest_addr_.sin_family = AF_INET;
+        dest_addr_.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &dest_addr_.sin_addr) <= 0) {
+            return false;
+        }
+
+        socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_ < 0) {
+            return false;
+        }
+
+        int optval = 1;
+        setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_port = htons(local_port);
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(socket_, (struct sockaddr*)&local, sizeof(local)) < 0) {
+            close_socket();
+            return false;
+        }
+
+        socklen_t len = sizeof(local);
+        getsockname(socket_, (struct sockaddr*)&local, &len);
+        local_port_ = ntohs(local.sin_port);
+        return true;
+    }
+
+    void set_sender_source(SenderInfoSource source) {
+        sender_source_ = std::move(source);
+    }
+
+    void set_report_source(ReportBlockSource source) {
+        report_source_ = std::move(source);
+    }
+
+    void set_nack_handler(NackHandler handler) {
+        nack_handler_ = std::move(handler);
+    }
+
+    void set_send_clock_rate(uint32_t clock_rate) {
+        if (clock_rate > 0) {
+            send_clock_rate_ = clock_rate;
+        }
+    }
+
+    void set_receive_clock_rate(uint32_t clock_rate) {
+        if (clock_rate > 0) {
+            receive_clock_rate_.store(clock_rate, std::memory_order_relaxed);
+        }
+    }
+
+    void set_interval(uint32_t interval_ms) {
+        if (interval_ms > 0) {
+            interval_ms_ = interval_ms;
+        }
+    }
+
+    bool start() {
+        if (active_) {
+            return true;
+        }
+        if (socket_ < 0) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_ = EdgeVoxRtcpStats();
+        }
+        have_remote_sr_ = false;
+        running_ = true;
+        thread_ = std::thread(&Impl::run, this);
+        active_ = true;
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        if (active_) {
+            send_bye();
+        }
+        active_ = false;
+    }
+
+    bool is_active() const {
+        return active_;
+    }
+
+    uint16_t local_port() const {
+        return local_port_;
+    }
+
+    EdgeVoxRtcpStats get_stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+
+private:
+    void close_socket() {
+        if (socket_ >= 0) {
+            close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    void run() {
+        using clock = std::chrono::steady_clock;
+
+        std::mt19937 random(std::random_device{}());
+        std::uniform_real_distribution<double> spread(0.5, 1.5);
+
+        // The first report goes out after half an interval, as RFC 3550 suggests
+        auto next_report =
+            clock::now() + std::chrono::milliseconds(static_cast<int64_t>(interval_ms_ / 2));
+
+        while (running_) {
+            const auto now = clock::now();
+            if (now >= next_report) {
+                send_report();
+                const auto interval = std::chrono::duration<double, std::milli>(
+                    interval_ms_ * spread(random));
+                next_report = now + std::chrono::duration_cast<clock::duration>(interval);
+            }
+
+            const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                next_report - clock::now());
+            pollfd fd{socket_, POLLIN, 0};
+            const int timeout =
+                static_cast<int>(std::min<int64_t>(std::max<int64_t>(wait.count(), 0),
+                                                   POLL_TIMEOUT_MS));
+            if (poll(&fd, 1, timeout) <= 0 || !(fd.revents & POLLIN)) {
+                continue;
+            }
+
+            const ssize_t size =
+                recv(socket_, receive_buffer_.data(), receive_buffer_.size(), MSG_DONTWAIT);
+            if (size > 0) {
+                handle_datagram(receive_buffer_.data(), static_cast<size_t>(size));
+            }
+        }
+    }
+
+    void send_report() {
+        RtcpSenderInfo info;
+        const bool sending = sender_source_ && sender_source_(info);
+        ssrc_ = info.ssrc;
+
+        RtcpReportBlock block;
+        size_t blocks = 0;
+        if (report_source_ && report_source_(block)) {
+            add_lsr(block);
+            blocks = 1;
+            record_local(block);
+        }
+
+        RtcpWriter writer(send_buffer_.data(), send_buffer_.size());
+        if (sending) {
+            writer.addSenderReport(info, &block, blocks);
+        } else {
+            writer.addReceiverReport(ssrc_, &block, blocks);
+        }
+        writer.addCname(ssrc_, cname_);
+
+        if (send(writer.size())) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.reports_sent++;
+        }
+    }
+
+    void send_bye() {
+        if (socket_ < 0) {
+            return;
+        }
+
+        RtcpWriter writer(send_buffer_.data(), send_buffer_.size());
+        writer.addReceiverReport(ssrc_, nullptr, 0);
+        writer.addBye(ssrc_);
+        send(writer.size());
+    }
+
+    bool send(size_t size) {
+        const ssize_t sent = sendto(socket_, send_buffer_.data(), size, 0,
+                                    (struct sockaddr*)&dest_addr_, sizeof(dest_addr_));
+        return sent == static_cast<ssize_t>(size);
+    }
+
+    // LSR/DLSR let the server compute its round-trip time to us
+    void add_lsr(RtcpReportBlock& block) const {
+        if (!have_remote_sr_ || block.ssrc != remote_ssrc_) {
+            return;
+        }
+
+        block.lsr = remote_lsr_;
+        block.dlsr = rtcpNtpMiddle(rtcpNtpNow()) - remote_sr_arrival_;
+    }
+
+    void handle_datagram(const uint8_t* data, size_t size) {
+        const uint32_t arrival = rtcpNtpMiddle(rtcpNtpNow());
+
+        const bool valid = rtcpParseCompound(
+            data, size,
+            [&](const RtcpReport& report) {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                stats_.reports_received++;
+
+                if (report.has_sender_info) {
+                    have_remote_sr_ = true;
+                    remote_ssrc_ = report.ssrc;
+                    remote_lsr_ = rtcpNtpMiddle(report.sender.ntp_timestamp);
+                    remote_sr_arrival_ = arrival;
+                }
+
+                for (size_t i = 0; i < report.block_count; i++) {
+                    if (report.blocks[i].ssrc == ssrc_) {
+                        record_remote(report.blocks[i], arrival);
+                    }
+                }
+            },
+            [&](uint32_t media_ssrc, uint16_t seq) {
+                if (!nack_seqs_.empty() && media_ssrc != nack_ssrc_) {
+                    deliver_nacks();
+                }
+                nack_ssrc_ = media_ssrc;
+                nack_seqs_.push_back(seq);
+            });
+        deliver_nacks();
+
+        if (!valid) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.invalid++;
+        }
+    }
+
+    // Hand the sequence numbers collected for one media SSRC to the handler
+    void deliver_nacks() {
+        if (nack_seqs_.empty()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.nack_requests += nack_seqs_.size();
+        }
+        if (nack_handler_) {
+            nack_handler_(nack_ssrc_, nack_seqs_.data(), nack_seqs_.size());
+        }
+        nack_seqs_.clear();
+    }
+
+    // Server's view of our stream; stats_mutex_ is held
+    void record_remote(const RtcpReportBlock& block, uint32_t arrival) {
+        stats_.remote_fraction_lost = block.fraction_lost / 256.0;
+        stats_.remote_cumulative_lost = block.cumulative_lost;
+        stats_.remote_jitter_ms = block.jitter * 1000.0 / send_clock_rate_;
+
+        // RTT = A - LSR - DLSR, all in 1/65536 s (RFC 3550 section 6.4.1)
+        if (block.lsr != 0) {
+            const uint32_t rtt = arrival - block.lsr - block.dlsr;
+            if (rtt < MAX_RTT_UNITS) {
+                stats_.rtt_ms = rtt * 1000.0 / 65536.0;
+            }
+        }
+    }
+
+    void record_local(const RtcpReportBlock& block) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.fraction_lost = block.fraction_lost / 256.0;
+        stats_.cumulative_lost = block.cumulative_lost;
+        stats_.jitter_ms =
+            block.jitter * 1000.0 / receive_clock_rate_.load(std::memory_order_relaxed);
+    }
+
+    int socket_;
+    uint16_t local_port_{0};
+    struct sockaddr_in dest_addr_;
+    std::atomic<bool> active_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::string cname_;
+
+    SenderInfoSource sender_source_;
+    ReportBlockSource report_source_;
+    NackHandler nack_handler_;
+    uint32_t send_clock_rate_{48000};
+    std::atomic<uint32_t> receive_clock_rate_{48000};
+    uint32_t interval_ms_{DEFAULT_INTERVAL_MS};
+
+    // Session thread only (and stop() after it has joined)
+    std::vector<uint8_t> send_buffer_;
+    std::vector<uint8_t> receive_buffer_;
+    uint32_t ssrc_{0};
+    bool have_remote_sr_{false};
+    uint32_t remote_ssrc_{0};
+    uint32_t remote_lsr_{0};
+    uint32_t remote_sr_arrival_{0};
+    uint32_t nack_ssrc_{0};
+    std::vector<uint16_t> nack_seqs_;
+
+    mutable std::mutex stats_mutex_;
+    EdgeVoxRtcpStats stats_;
+};
+
+EdgeVoxRtcpSession::EdgeVoxRtcpSession() : pimpl_(std::make_unique<Impl>()) {}
+EdgeVoxRtcpSession::~EdgeVoxRtcpSession() = default;
+
+bool EdgeVoxRtcpSession::init(const std::string& host, uint16_t port, uint16_t local_port) {
+    return pimpl_->init(host, port, local_port);
+}
+
+void EdgeVoxRtcpSession::set_sender_source(SenderInfoSource source) {
+    pimpl_->set_sender_source(std::move(source));
+}
+
+void EdgeVoxRtcpSession::set_report_source(ReportBlockSource source) {
+    pimpl_->set_report_source(std::move(source));
+}
+
+void EdgeVoxRtcpSession::set_nack_handler(NackHandler handler) {
+    pimpl_->set_nack_handler(std::move(handler));
+}
+
+void EdgeVoxRtcpSession::set_send_clock_rate(uint32_t clock_rate) {
+    pimpl_->set_send_clock_rate(clock_rate);
+}
+
+void EdgeVoxRtcpSession::set_receive_clock_rate(uint32_t clock_rate) {
+    pimpl_->set_receive_clock_rate(clock_rate);
+}
+
+void EdgeVoxRtcpSession::set_interval(uint32_t interval_ms) {
+    pimpl_->set_interval(interval_ms);
+}
+
+bool EdgeVoxRtcpSession::start() {
+    return pimpl_->start();
+}
+
+void EdgeVoxRtcpSession::stop() {
+    pimpl_->stop();
+}
+
+bool EdgeVoxRtcpSession::is_active() const {
+    return pimpl_->is_active();
+}
+
+uint16_t EdgeVoxRtcpSession::local_port() const {
+    return pimpl_->local_port();
+}
+
+EdgeVoxRtcpStats EdgeVoxRtcpSession::get_stats() const {
+    return pimpl_->get_stats();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "edge_vox/net/rtp_stats.hpp"
+#include "rtcp_packet.hpp"
+
+//
+// RTCP companion of an RTP session (RFC 3550 section 6). Sends a compound SR or RR with an
+// SDES CNAME every interval, parses the reports that come back and derives round-trip time,
+// loss and jitter for both directions.
+//
+class EdgeVoxRtcpSession {
+public:
+    // Fill in the sender information; return false while no RTP has been sent, which turns
+    // the report into an RR. ssrc must be set either way.
+    using SenderInfoSource = std::function<bool(RtcpSenderInfo& info)>;
+    // Fill in a reception report about the inbound stream; return false if there is none
+    using ReportBlockSource = std::function<bool(RtcpReportBlock& block)>;
+    // Generic NACK from the server: resend seqs of media_ssrc. Called on the session thread.
+    using NackHandler =
+        std::function<void(uint32_t media_ssrc, const uint16_t* seqs, size_t count)>;
+
+    EdgeVoxRtcpSession();
+    ~EdgeVoxRtcpSession();
+
+    // Send reports to host:port and receive on local_port (0 picks a free port)
+    bool init(const std::string& host, uint16_t port, uint16_t local_port = 0);
+    // Set before start()
+    void set_sender_source(SenderInfoSource source);
+    void set_report_source(ReportBlockSource source);
+    void set_nack_handler(NackHandler handler);
+    void set_send_clock_rate(uint32_t clock_rate);  // RTP clock of our stream, for jitter in ms
+    void set_interval(uint32_t interval_ms);        // Randomized by +/-50% per RFC 3550
+    // RTP clock of the inbound stream the report source describes; may change at any time,
+    // as the receiver is started and stopped
+    void set_receive_clock_rate(uint32_t clock_rate);
+    bool start();
+    void stop();  // Sends a BYE
+    bool is_active() const;
+    uint16_t local_port() const;
+    EdgeVoxRtcpStats get_stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
@@ -0,0 +1,313 @@
+#include "rtp_fec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "rtp_packet.hpp"
+
+namespace {
+uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void write_u16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+void write_u32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+void xor_into(uint8_t* dst, const uint8_t* src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+uint16_t mask_bit(uint16_t offset) {
+    return static_cast<uint16_t>(0x8000u >> offset);
+}
+}  // namespace
+
+RtpFecEncoder::RtpFecEncoder() {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    ssrc_ = std::uniform_int_distribution<uint32_t>()(gen);
+    parity_seq_ = std::uniform_int_distribution<uint16_t>()(gen);
+}
+
+bool RtpFecEncoder::configure(const RtpFecConfig& config) {
+    if (config.group_size > 0 &&
+        (config.interleave == 0 || (config.group_size - 1) * config.interleave >= FEC_MASK_BITS)) {
+        return false;
+    }
+
+    config_ = config;
+    groups_.assign(config.group_size > 0 ? config.interleave : 0, Group());
+    reset();
+    return true;
+}
+
+void RtpFecEncoder::reset() {
+    for (Group& group : groups_) {
+        group = Group();
+    }
+    position_ = 0;
+}
+
+void RtpFecEncoder::accumulate(Group& group, const uint8_t* data, size_t len, size_t offset) {
+    if (group.payload.size() < offset + len) {
+        group.payload.resize(offset + len, 0);
+    }
+    xor_into(group.payload.data() + offset, data, len);
+}
+
+size_t RtpFecEncoder::add(const uint8_t* header, size_t header_len, const uint8_t* payload,
+                          size_t payload_len) {
+    if (!enabled() || header_len < RTP_HEADER_SIZE) {
+        return 0;
+    }
+
+    const size_t interleave = config_.interleave;
+    Group& group = groups_[position_ % interleave];
+    const size_t index = (position_ / interleave) % config_.group_size;
+    position_++;
+
+    const uint16_t seq = read_u16(header + 2);
+    if (index == 0) {
+        group = Group();
+        group.base_seq = seq;
+    }
+
+    // The streamer numbers packets consecutively, so this only trips if the caller skips some
+    const uint16_t offset = static_cast<uint16_t>(seq - group.base_seq);
+    if (offset >= FEC_MASK_BITS) {
+        return 0;
+    }
+
+    const size_t length = header_len + payload_len - RTP_HEADER_SIZE;
+    group.mask |= mask_bit(offset);
+    group.bits[0] ^= header[0];
+    group.bits[1] ^= header[1];
+    group.timestamp ^= read_u32(header + 4);
+    group.length ^= static_cast<uint16_t>(length);
+    group.max_length = std::max(group.max_length, length);
+    accumulate(group, header + RTP_HEADER_SIZE, header_len - RTP_HEADER_SIZE, 0);
+    accumulate(group, payload, payload_len, header_len - RTP_HEADER_SIZE);
+    stats_.media_packets++;
+
+    if (index + 1 < config_.group_size) {
+        return 0;
+    }
+    return write_parity(group, header);
+}
+
+size_t RtpFecEncoder::write_parity(const Group& group, const uint8_t* media_header) {
+    const size_t size = RTP_HEADER_SIZE + FEC_OVERHEAD_BYTES + group.max_length;
+    parity_.resize(size);
+    uint8_t* out = parity_.data();
+
+    // RTP header of the FEC stream: timestamp of the media packet completing the group, our
+    // own payload type, sequence number and SSRC
+    out[0] = RTP_VERSION << 6;
+    out[1] = config_.payload_type & 0x7F;
+    write_u16(out + 2, parity_seq_++);
+    memcpy(out + 4, media_header + 4, 4);
+    write_u32(out + 8, ssrc_);
+    out += RTP_HEADER_SIZE;
+
+    // FEC header: E and L clear, then the recovery fields
+    out[0] = group.bits[0] & 0x3F;
+    out[1] = group.bits[1];
+    write_u16(out + 2, group.base_seq);
+    write_u32(out + 4, group.timestamp);
+    write_u16(out + 8, group.length);
+    out += FEC_HEADER_SIZE;
+
+    // Level 0 header, then the XOR of the payloads padded with zeros to the longest
+    write_u16(out, static_cast<uint16_t>(group.max_length));
+    write_u16(out + 2, group.mask);
+    out += FEC_LEVEL_HEADER_SIZE;
+    memcpy(out, group.payload.data(), group.max_length);
+
+    stats_.parity_packets++;
+    stats_.parity_bytes += size;
+    return size;
+}
+
+RtpFecDecoder::RtpFecDecoder() : history_(HISTORY), pending_(MAX_PENDING) {
+    for (Media& media : history_) {
+        media.data.resize(MAX_PACKET);
+    }
+    recovered_.resize(MAX_PACKET);
+}
+
+void RtpFecDecoder::reset() {
+    for (Media& media : history_) {
+        media.valid = false;
+    }
+    for (Parity& parity : pending_) {
+        parity.valid = false;
+    }
+}
+
+const RtpFecDecoder::Media* RtpFecDecoder::find(uint16_t seq) const {
+    const Media& media = history_[seq % HISTORY];
+    return media.valid && media.seq == seq ? &media : nullptr;
+}
+
+void RtpFecDecoder::store(const uint8_t* data, size_t len) {
+    const uint16_t seq = read_u16(data + 2);
+    Media& media = history_[seq % HISTORY];
+    media.valid = true;
+    media.seq = seq;
+    media.len = len;
+    memcpy(media.data.data(), data, len);
+}
+
+size_t RtpFecDecoder::add_media(const uint8_t* data, size_t len) {
+    if (len < RTP_HEADER_SIZE || len > MAX_PACKET) {
+        return 0;
+    }
+    store(data, len);
+    media_ssrc_ = read_u32(data + 8);
+    stats_.media_packets++;
+
+    // At most one group covers this packet; see if it was the second to last one missing
+    const uint16_t seq = read_u16(data + 2);
+    for (Parity& parity : pending_) {
+        const uint16_t offset = static_cast<uint16_t>(seq - parity.base_seq);
+        if (!parity.valid || offset >= FEC_MASK_BITS || !(parity.mask & mask_bit(offset))) {
+            continue;
+        }
+
+        size_t recovered_len = 0;
+        const Attempt attempt = try_recover(parity, recovered_len);
+        if (attempt != Attempt::Waiting) {
+            parity.valid = false;
+        }
+        return recovered_len;
+    }
+    return 0;
+}
+
+size_t RtpFecDecoder::add_parity(const uint8_t* data, size_t len) {
+    constexpr size_t headers = RTP_HEADER_SIZE + FEC_OVERHEAD_BYTES;
+    if (len < headers || len > MAX_PACKET) {
+        return 0;
+    }
+
+    // Only level 0 with the short mask is produced by RtpFecEncoder
+    const uint8_t* fec = data + RTP_HEADER_SIZE;
+    if (fec[0] & 0xC0) {
+        return 0;
+    }
+
+    stats_.parity_packets++;
+    stats_.parity_bytes += len;
+
+    const uint16_t mask = read_u16(fec + FEC_HEADER_SIZE + 2);
+    if (mask == 0 || read_u16(fec + FEC_HEADER_SIZE) > len - headers) {
+        return 0;
+    }
+
+    Parity* slot = nullptr;
+    for (Parity& parity : pending_) {
+        if (!parity.valid) {
+            slot = &parity;
+            break;
+        }
+    }
+    if (!slot) {
+        // Full of parity whose groups lost two or more packets: give one up
+        std::rotate(pending_.begin(), pending_.begin() + 1, pending_.end());
+        slot = &pending_.back();
+        stats_.unrecoverable++;
+    }
+
+    slot->valid = true;
+    slot->base_seq = read_u16(fec + 2);
+    slot->mask = mask;
+    slot->len = len;
+    slot->data.assign(data, data + len);
+
+    size_t recovered_len = 0;
+    if (try_recover(*slot, recovered_len) != Attempt::Waiting) {
+        slot->valid = false;
+    }
+    return recovered_len;
+}
+
+RtpFecDecoder::Attempt RtpFecDecoder::try_recover(const Parity& parity, size_t& recovered_len) {
+    recovered_len = 0;
+
+    uint16_t missing_seq = 0;
+    size_t missing = 0;
+    for (uint16_t offset = 0; offset < FEC_MASK_BITS; offset++) {
+        const uint16_t seq = static_cast<uint16_t>(parity.base_seq + offset);
+        if ((parity.mask & mask_bit(offset)) && !find(seq)) {
+            missing_seq = seq;
+            missing++;
+        }
+    }
+    if (missing == 0) {
+        return Attempt::Done;
+    }
+    if (missing > 1) {
+        return Attempt::Waiting;
+    }
+
+    // Start from the parity's recovery fields and cancel out every packet that did arrive
+    const uint8_t* fec = parity.data.data() + RTP_HEADER_SIZE;
+    const uint8_t* level = fec + FEC_HEADER_SIZE;
+    const size_t protected_len = read_u16(level);
+
+    uint8_t bits[2] = {fec[0], fec[1]};
+    uint32_t timestamp = read_u32(fec + 4);
+    uint16_t length = read_u16(fec + 8);
+    uint8_t* payload = recovered_.data() + RTP_HEADER_SIZE;
+    memcpy(payload, level + FEC_LEVEL_HEADER_SIZE, protected_len);
+
+    for (uint16_t offset = 0; offset < FEC_MASK_BITS; offset++) {
+        const uint16_t seq = static_cast<uint16_t>(parity.base_seq + offset);
+        const Media* media = (parity.mask & mask_bit(offset)) ? find(seq) : nullptr;
+        if (!media) {
+            continue;
+        }
+        const size_t media_len = media->len - RTP_HEADER_SIZE;
+        bits[0] ^= media->data[0];
+        bits[1] ^= media->data[1];
+        timestamp ^= read_u32(media->data.data() + 4);
+        length ^= static_cast<uint16_t>(media_len);
+        xor_into(payload, media->data.data() + RTP_HEADER_SIZE,
+                 std::min(media_len, protected_len));
+    }
+
+    // A length beyond what the parity covers means the group doesn't match this parity
+    if (length > protected_len) {
+        stats_.unrecoverable++;
+        return Attempt::Done;
+    }
+
+    uint8_t* header = recovered_.data();
+    header[0] = static_cast<uint8_t>((RTP_VERSION << 6) | (bits[0] & 0x3F));
+    header[1] = bits[1];
+    write_u16(header + 2, missing_seq);
+    write_u32(header + 4, timestamp);
+    write_u32(header + 8, media_ssrc_);
+
+    recovered_len = RTP_HEADER_SIZE + length;
+    store(recovered_.data(), recovered_len);
+    stats_.recovered++;
+    return Attempt::Recovered;
+}
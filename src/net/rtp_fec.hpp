@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+// RFC 5109 FEC header (10) and level 0 header with the short 16-bit mask (4)
+constexpr size_t FEC_HEADER_SIZE = 10;
+constexpr size_t FEC_LEVEL_HEADER_SIZE = 4;
+constexpr size_t FEC_OVERHEAD_BYTES = FEC_HEADER_SIZE + FEC_LEVEL_HEADER_SIZE;
+constexpr size_t FEC_MASK_BITS = 16;  // Protected packets lie within 16 sequence numbers
+constexpr uint8_t FEC_DEFAULT_PAYLOAD_TYPE = 127;
+}  // namespace
+
+struct RtpFecConfig {
+    size_t group_size{0};  // Media packets per parity packet; 0 disables FEC
+    size_t interleave{1};  // Protect every n-th packet, so a burst of n losses is recoverable
+    uint8_t payload_type{FEC_DEFAULT_PAYLOAD_TYPE};
+};
+
+struct RtpFecStats {
+    uint64_t media_packets{0};   // Media packets covered
+    uint64_t parity_packets{0};  // Parity packets sent or received
+    uint64_t parity_bytes{0};    // Their size including RTP headers: the bandwidth overhead
+    uint64_t recovered{0};       // Receiver: media packets rebuilt from parity
+    uint64_t unrecoverable{0};   // Receiver: parity dropped with two or more packets missing
+};
+
+//
+// XOR parity FEC after RFC 5109. Media packets are grouped group_size at a time, each group
+// taking every interleave-th packet, and one parity packet carries the XOR of each group's
+// headers and payloads. A receiver holding the parity and all but one packet of a group can
+// rebuild the missing one without a round trip.
+//
+// Parity packets form a separate RTP stream (RFC 5109 section 9.1): their own SSRC, payload
+// type and sequence numbers, timestamped on the media clock. The media stream's sequence
+// space and RTCP statistics stay untouched, and receivers without FEC drop the unknown
+// payload type. Neither class is thread safe.
+//
+class RtpFecEncoder {
+public:
+    RtpFecEncoder();  // Picks a random SSRC and initial sequence number
+
+    // Fails unless a group fits in the 16-bit mask: (group_size - 1) * interleave < 16
+    bool configure(const RtpFecConfig& config);
+    bool enabled() const {
+        return config_.group_size > 0;
+    }
+
+    // Add an outgoing media packet, passed as header and payload. When it completes a group,
+    // the parity packet is written to parity() and its length returned; otherwise 0.
+    size_t add(const uint8_t* header, size_t header_len, const uint8_t* payload,
+               size_t payload_len);
+
+    const uint8_t* parity() const {
+        return parity_.data();
+    }
+
+    uint32_t ssrc() const {
+        return ssrc_;
+    }
+
+    // Drop partial groups, e.g. when the stream stops
+    void reset();
+
+    const RtpFecStats& stats() const {
+        return stats_;
+    }
+
+private:
+    struct Group {
+        uint16_t base_seq = 0;
+        uint16_t mask = 0;
+        uint8_t bits[2] = {};  // XOR of P/X/CC and M/PT
+        uint32_t timestamp = 0;
+        uint16_t length = 0;  // XOR of the lengths after the fixed header
+        size_t max_length = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    void accumulate(Group& group, const uint8_t* data, size_t len, size_t offset);
+    size_t write_parity(const Group& group, const uint8_t* media_header);
+
+    RtpFecConfig config_;
+    std::vector<Group> groups_;
+    std::vector<uint8_t> parity_;
+    uint64_t position_ = 0;  // Media packets added since the last reset
+    uint32_t ssrc_;
+    uint16_t parity_seq_;
+    RtpFecStats stats_;
+};
+
+class RtpFecDecoder {
+public:
+    static constexpr size_t HISTORY = 64;      // Media packets kept for recovery
+    static constexpr size_t MAX_PENDING = 16;  // Parity packets waiting for more media
+    static constexpr size_t MAX_PACKET = 1500;
+
+    RtpFecDecoder();
+
+    // Remember a received media packet for later recoveries. If it leaves a single packet
+    // missing from a group whose parity is pending, that packet is rebuilt into recovered()
+    // and its length returned; otherwise 0.
+    size_t add_media(const uint8_t* data, size_t len);
+
+    // Handle a parity packet. Returns the length of a media packet rebuilt into recovered(),
+    // or 0 if nothing was missing or too much was (then the parity waits for late packets).
+    size_t add_parity(const uint8_t* data, size_t len);
+
+    const uint8_t* recovered() const {
+        return recovered_.data();
+    }
+
+    void reset();
+
+    const RtpFecStats& stats() const {
+        return stats_;
+    }
+
+private:
+    struct Media {
+        bool valid = false;
+        uint16_t seq = 0;
+        size_t len = 0;
+        std::vector<uint8_t> data;
+    };
+
+    struct Parity {
+        bool valid = false;
+        uint16_t base_seq = 0;
+        uint16_t mask = 0;
+        size_t len = 0;
+        std::vector<uint8_t> data;
+    };
+
+    enum class Attempt { Done, Recovered, Waiting };
+
+    const Media* find(uint16_t seq) const;
+    void store(const uint8_t* data, size_t len);
+    Attempt try_recover(const Parity& parity, size_t& recovered_len);
+
+    std::vector<Media> history_;
+    std::vector<Parity> pending_;
+    std::vector<uint8_t> recovered_;
+    uint32_t media_ssrc_ = 0;  // Given to rebuilt packets; parity carries its own SSRC
+    RtpFecStats stats_;
+};
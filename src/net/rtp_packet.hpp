@@ -1,7 +1,10 @@
 #pragma once
 
+#include <arpa/inet.h>
+
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <random>
 #include <vector>
 
@@ -9,6 +12,9 @@ namespace {
 // RTP version (2 bits): This implementation uses RTP version 2
 constexpr uint8_t RTP_VERSION = 2;
 
+// Fixed part of the RTP header, without CSRCs
+constexpr size_t RTP_HEADER_SIZE = 12;
+
 // Default values for RTP
 constexpr uint8_t AUDIO_PAYLOAD_TYPE = 11;  // Dynamic payload type for audio
 constexpr uint32_t SAMPLING_RATE = 48000;   // Default sampling rate
@@ -45,45 +51,52 @@ public:
     }
 
     std::vector<uint8_t> serialize() const {
-        std::vector<uint8_t> packet;
-
-        // Reserve space for the header and payload
-        packet.reserve(12 + header_.csrcList.size() * 4 + payload_.size());
-
-        // First byte
-        uint8_t firstByte = (header_.version << 6) | (header_.padding << 5) |
-                            (header_.extension << 4) | (header_.csrcCount & 0x0F);
-        packet.push_back(firstByte);
-
-        // Second byte
-        uint8_t secondByte = (header_.marker << 7) | (header_.payloadType & 0x7F);
-        packet.push_back(secondByte);
+        std::vector<uint8_t> packet(headerSize() + payload_.size());
+        serializeInto(packet.data(), packet.size());
+        return packet;
+    }
 
-        // Sequence number (network byte order)
-        packet.push_back((header_.sequenceNumber >> 8) & 0xFF);
-        packet.push_back(header_.sequenceNumber & 0xFF);
+    // Header length including the CSRC list
+    size_t headerSize() const {
+        return RTP_HEADER_SIZE + header_.csrcList.size() * sizeof(uint32_t);
+    }
 
-        // Timestamp (network byte order)
-        for (int i = 3; i >= 0; --i) {
-            packet.push_back((header_.timestamp >> (i * 8)) & 0xFF);
+    // Write header and payload into buffer. Returns the packet length, or 0 if it doesn't fit.
+    size_t serializeInto(uint8_t* buffer, size_t capacity) const {
+        const size_t size = headerSize() + payload_.size();
+        if (capacity < size) {
+            return 0;
         }
 
-        // SSRC (network byte order)
-        for (int i = 3; i >= 0; --i) {
-            packet.push_back((header_.ssrc >> (i * 8)) & 0xFF);
+        const size_t offset = writeHeader(buffer);
+        if (!payload_.empty()) {
+            memcpy(buffer + offset, payload_.data(), payload_.size());
         }
+        return size;
+    }
 
-        // Add CSRC list if present
+    // Write the header (headerSize() bytes) as 32-bit big-endian words, so the send path can
+    // encode the payload straight after it. Returns the header length.
+    size_t writeHeader(uint8_t* buffer) const {
+        const uint32_t first = (static_cast<uint32_t>(header_.version) << 30) |
+                               (static_cast<uint32_t>(header_.padding) << 29) |
+                               (static_cast<uint32_t>(header_.extension) << 28) |
+                               (static_cast<uint32_t>(header_.csrcCount & 0x0F) << 24) |
+                               (static_cast<uint32_t>(header_.marker) << 23) |
+                               (static_cast<uint32_t>(header_.payloadType & 0x7F) << 16) |
+                               header_.sequenceNumber;
+
+        const uint32_t words[3] = {htonl(first), htonl(header_.timestamp), htonl(header_.ssrc)};
+        memcpy(buffer, words, sizeof(words));
+
+        size_t offset = sizeof(words);
         for (uint32_t csrc : header_.csrcList) {
-            for (int i = 3; i >= 0; --i) {
-                packet.push_back((csrc >> (i * 8)) & 0xFF);
-            }
+            const uint32_t word = htonl(csrc);
+            memcpy(buffer + offset, &word, sizeof(word));
+            offset += sizeof(word);
         }
 
-        // Add payload
-        packet.insert(packet.end(), payload_.begin(), payload_.end());
-
-        return packet;
+        return offset;
     }
 
     void incrementSequenceNumber() {
@@ -98,6 +111,10 @@ public:
         header_.marker = marker;
     }
 
+    void setPayloadType(uint8_t payload_type) {
+        header_.payloadType = payload_type & 0x7F;
+    }
+
     void addCsrc(uint32_t csrc) {
         header_.csrcList.push_back(csrc);
         header_.csrcCount = static_cast<uint8_t>(header_.csrcList.size());
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <arpa/inet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rtp_packet.hpp"
+
+//
+// Read-only view over a received RTP packet (RFC 3550 section 5.1). parse() validates the
+// header, CSRC list, header extension and padding in place; accessors then decode fields
+// straight from the buffer. Nothing is copied or allocated, so the view is only valid while
+// the buffer it was parsed from is.
+//
+class RtpPacketView {
+public:
+    enum class Error {
+        None,
+        TooShort,            // Less than the 12-byte fixed header
+        BadVersion,          // Not RTP version 2
+        CsrcTruncated,       // CSRC list runs past the end
+        ExtensionTruncated,  // Extension header or data runs past the end
+        BadPadding           // Padding count of 0 or larger than the payload
+    };
+
+    RtpPacketView() = default;
+
+    RtpPacketView(const uint8_t* data, size_t size) {
+        parse(data, size);
+    }
+
+    bool parse(const uint8_t* data, size_t size) {
+        data_ = data;
+        size_ = size;
+        payload_offset_ = 0;
+        payload_size_ = 0;
+        extension_offset_ = 0;
+        extension_size_ = 0;
+        padding_size_ = 0;
+
+        if (!data || size < RTP_HEADER_SIZE) {
+            return fail(Error::TooShort);
+        }
+        if ((data[0] >> 6) != RTP_VERSION) {
+            return fail(Error::BadVersion);
+        }
+
+        // Fast path: no CSRCs, extension or padding, which is every packet we send
+        if ((data[0] & 0x3F) == 0) {
+            payload_offset_ = RTP_HEADER_SIZE;
+            payload_size_ = size - RTP_HEADER_SIZE;
+            error_ = Error::None;
+            return true;
+        }
+
+        size_t offset = RTP_HEADER_SIZE + csrcCount() * sizeof(uint32_t);
+        if (offset > size) {
+            return fail(Error::CsrcTruncated);
+        }
+
+        if (extension()) {
+            // 16-bit profile, 16-bit length in 32-bit words, then the data
+            if (offset + 4 > size) {
+                return fail(Error::ExtensionTruncated);
+            }
+            const size_t words = read16(offset + 2);
+            extension_offset_ = offset + 4;
+            extension_size_ = words * sizeof(uint32_t);
+            offset = extension_offset_ + extension_size_;
+            if (offset > size) {
+                return fail(Error::ExtensionTruncated);
+            }
+        }
+
+        size_t end = size;
+        if (padding()) {
+            // The last octet counts the padding octets, itself included
+            padding_size_ = data[size - 1];
+            if (padding_size_ == 0 || padding_size_ > size - offset) {
+                return fail(Error::BadPadding);
+            }
+            end -= padding_size_;
+        }
+
+        payload_offset_ = offset;
+        payload_size_ = end - offset;
+        error_ = Error::None;
+        return true;
+    }
+
+    bool valid() const {
+        return error_ == Error::None;
+    }
+
+    Error error() const {
+        return error_;
+    }
+
+    // Header fields; only meaningful when valid()
+    uint8_t version() const {
+        return data_[0] >> 6;
+    }
+    bool padding() const {
+        return (data_[0] >> 5) & 0x01;
+    }
+    bool extension() const {
+        return (data_[0] >> 4) & 0x01;
+    }
+    uint8_t csrcCount() const {
+        return data_[0] & 0x0F;
+    }
+    bool marker() const {
+        return (data_[1] >> 7) & 0x01;
+    }
+    uint8_t payloadType() const {
+        return data_[1] & 0x7F;
+    }
+    uint16_t sequenceNumber() const {
+        return read16(2);
+    }
+    uint32_t timestamp() const {
+        return read32(4);
+    }
+    uint32_t ssrc() const {
+        return read32(8);
+    }
+    uint32_t csrc(size_t index) const {
+        return read32(RTP_HEADER_SIZE + index * sizeof(uint32_t));
+    }
+
+    // Extension profile and data (without its 4-byte header); empty without extension
+    uint16_t extensionProfile() const {
+        return extension_offset_ ? read16(extension_offset_ - 4) : 0;
+    }
+    const uint8_t* extensionData() const {
+        return extension_offset_ ? data_ + extension_offset_ : nullptr;
+    }
+    size_t extensionSize() const {
+        return extension_size_;
+    }
+
+    // Payload without header, extension and padding
+    const uint8_t* payload() const {
+        return data_ + payload_offset_;
+    }
+    size_t payloadSize() const {
+        return payload_size_;
+    }
+    size_t paddingSize() const {
+        return padding_size_;
+    }
+
+    const uint8_t* data() const {
+        return data_;
+    }
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    bool fail(Error error) {
+        error_ = error;
+        return false;
+    }
+
+    uint16_t read16(size_t offset) const {
+        uint16_t value;
+        memcpy(&value, data_ + offset, sizeof(value));
+        return ntohs(value);
+    }
+
+    uint32_t read32(size_t offset) const {
+        uint32_t value;
+        memcpy(&value, data_ + offset, sizeof(value));
+        return ntohl(value);
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t payload_offset_ = 0;
+    size_t payload_size_ = 0;
+    size_t extension_offset_ = 0;
+    size_t extension_size_ = 0;
+    size_t padding_size_ = 0;
+    Error error_ = Error::TooShort;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+// IPv4 (20) + UDP (8) + RTP fixed header (12)
+constexpr uint32_t RTP_OVERHEAD_BYTES = 20 + 8 + 12;
+}  // namespace
+
+//
+// Splits a continuous sample stream into fixed-size RTP frames.
+//
+// The frame size comes from a packet time (ptime) or, when ptime is 0, from a payload byte
+// budget, and is capped so that no datagram exceeds the path MTU. Samples that don't fill
+// a whole frame are kept until the next push().
+//
+class RtpPacketizer {
+public:
+    RtpPacketizer() {
+        configure(48000, 0, 512, 1500);
+    }
+
+    // Returns false if the configuration can't produce a non-empty frame
+    bool configure(uint32_t sample_rate, uint32_t ptime_ms, uint32_t payload_bytes, uint32_t mtu,
+                   uint32_t bytes_per_sample = sizeof(int16_t)) {
+        if (sample_rate == 0 || bytes_per_sample == 0 || mtu <= RTP_OVERHEAD_BYTES) {
+            return false;
+        }
+
+        size_t frame = ptime_ms > 0 ? static_cast<size_t>(sample_rate) * ptime_ms / 1000
+                                    : payload_bytes / bytes_per_sample;
+
+        const size_t max_frame = (mtu - RTP_OVERHEAD_BYTES) / bytes_per_sample;
+        mtu_limited_ = frame > max_frame;
+        frame = std::min(frame, max_frame);
+
+        if (frame == 0) {
+            return false;
+        }
+
+        frame_samples_ = frame;
+        pending_.clear();
+        pending_.reserve(frame);
+        return true;
+    }
+
+    size_t frame_samples() const {
+        return frame_samples_;
+    }
+
+    // True if the requested ptime/byte budget had to be shrunk to fit the MTU
+    bool mtu_limited() const {
+        return mtu_limited_;
+    }
+
+    // Samples waiting for a full frame
+    size_t pending() const {
+        return pending_.size();
+    }
+
+    // Append samples and call emit(const float* frame, size_t count) for every complete frame.
+    // Whole frames are passed straight from the input without copying. Returns the number of
+    // frames emitted.
+    template <typename Emit>
+    size_t push(const float* samples, size_t n, Emit&& emit) {
+        size_t frames = 0;
+
+        // Complete a partially filled frame first
+        if (!pending_.empty()) {
+            const size_t take = std::min(n, frame_samples_ - pending_.size());
+            pending_.insert(pending_.end(), samples, samples + take);
+            samples += take;
+            n -= take;
+
+            if (pending_.size() < frame_samples_) {
+                return 0;
+            }
+
+            emit(pending_.data(), pending_.size());
+            pending_.clear();
+            frames++;
+        }
+
+        while (n >= frame_samples_) {
+            emit(samples, frame_samples_);
+            samples += frame_samples_;
+            n -= frame_samples_;
+            frames++;
+        }
+
+        pending_.insert(pending_.end(), samples, samples + n);
+        return frames;
+    }
+
+    // Drop any partial frame
+    void reset() {
+        pending_.clear();
+    }
+
+private:
+    size_t frame_samples_ = 0;
+    bool mtu_limited_ = false;
+    std::vector<float> pending_;
+};
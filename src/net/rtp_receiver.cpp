@@ -0,0 +1,608 @@
+#include "net/rtp_receiver.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "audio/audio_codec.hpp"
+#include "packet_buffer.hpp"
+#include "rtp_fec.hpp"
+#include "rtp_packet.hpp"
+#include "rtp_packet_view.hpp"
+#include "rtp_source_stats.hpp"
+
+namespace {
+constexpr size_t RECEIVE_BATCH = 16;            // Datagrams per recvmmsg call
+constexpr size_t MAX_DATAGRAM_SIZE = 2048;      // Larger datagrams are dropped as truncated
+constexpr int RECEIVE_TIMEOUT_MS = 100;         // How quickly the thread notices stop()
+constexpr int SOCKET_RECEIVE_BUFFER = 1 << 18;  // Absorb bursts while the thread is busy
+constexpr size_t ARRIVAL_PREFIX = sizeof(uint64_t);  // Arrival time ahead of each queued datagram
+constexpr int IDLE_POLL_MS = 5;                      // Playout tick before the frame size is known
+
+uint64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}  // namespace
+
+class EdgeVoxRtpReceiver::Impl {
+public:
+    Impl() : socket_(-1), active_(false), running_(false), jitter_enabled_(false) {
+        buffers_.resize(RECEIVE_BATCH * MAX_DATAGRAM_SIZE);
+        iovecs_.resize(RECEIVE_BATCH);
+        messages_.resize(RECEIVE_BATCH);
+
+        for (size_t i = 0; i < RECEIVE_BATCH; i++) {
+            iovecs_[i].iov_base = &buffers_[i * MAX_DATAGRAM_SIZE];
+            iovecs_[i].iov_len = MAX_DATAGRAM_SIZE;
+        }
+    }
+
+    ~Impl() {
+        stop();
+        close_socket();
+    }
+
+    bool init(uint16_t port, const std::string& bind_address) {
+        if (active_) {
+            return false;
+        }
+        close_socket();
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) <= 0) {
+            return false;
+        }
+
+        socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_ < 0) {
+            return false;
+        }
+
+        int optval = 1;
+        setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+        int rcvbuf = SOCKET_RECEIVE_BUFFER;
+        setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        timeval timeout{0, RECEIVE_TIMEOUT_MS * 1000};
+        if (setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+            bind(socket_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            close_socket();
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        getsockname(socket_, (struct sockaddr*)&addr, &len);
+        port_ = ntohs(addr.sin_port);
+        return true;
+    }
+
+    void set_audio_callback(AudioCallback callback) {
+        callback_ = std::move(callback);
+    }
+
+    void set_jitter_buffer(bool enabled, const JitterBufferConfig& config) {
+        if (active_) {
+            return;
+        }
+
+        jitter_enabled_ = enabled;
+        jitter_config_ = config;
+    }
+
+    void set_clock_rate(uint32_t clock_rate) {
+        if (!active_ && clock_rate > 0) {
+            clock_rate_ = clock_rate;
+        }
+    }
+
+    void set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus) {
+        if (!active_) {
+            codec_type_ = codec;
+            opus_config_ = opus;
+        }
+    }
+
+    void set_fec(bool enabled, uint8_t payload_type) {
+        if (!active_) {
+            fec_enabled_ = enabled;
+            fec_payload_type_ = payload_type & 0x7F;
+        }
+    }
+
+    bool start() {
+        if (active_) {
+            return true;
+        }
+        if (socket_ < 0) {
+            return false;
+        }
+
+        codec_ = create_audio_codec(codec_type_, clock_rate_, opus_config_);
+        if (!codec_) {
+            return false;
+        }
+        samples_.resize(codec_->max_decoded_samples(MAX_DATAGRAM_SIZE));
+        recovered_.resize(samples_.size());
+        timestamp_scale_ = codec_->rtp_clock_rate() / clock_rate_;
+        payload_type_ = codec_->payload_type();
+
+        have_sequence_ = false;
+        previous_samples_ = 0;
+        fec_.reset();
+        source_stats_.reset(codec_->rtp_clock_rate());
+        running_ = true;
+        if (jitter_enabled_) {
+            // A full datagram of the codec's payload must fit in one slot
+            jitter_config_.max_frame_samples =
+                std::max(jitter_config_.max_frame_samples, samples_.size());
+            jitter_config_.max_payload_size = MAX_DATAGRAM_SIZE;
+            jitter_ = std::make_unique<JitterBuffer>(*codec_, jitter_config_);
+            queue_ = std::make_unique<PacketSlotBuffer>(jitter_config_.capacity * 2,
+                                                        ARRIVAL_PREFIX + MAX_DATAGRAM_SIZE);
+            frame_.resize(jitter_config_.max_frame_samples);
+            playout_thread_ = std::thread(&Impl::run_playout, this);
+        }
+        thread_ = std::thread(&Impl::run, this);
+        active_ = true;
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (playout_thread_.joinable()) {
+            playout_thread_.join();
+        }
+        active_ = false;
+    }
+
+    bool is_active() const {
+        return active_;
+    }
+
+    uint16_t port() const {
+        return port_;
+    }
+
+    uint32_t rtp_clock_rate() const {
+        return source_stats_.clock_rate();
+    }
+
+    EdgeVoxRtpReceiveStats get_stats() const {
+        EdgeVoxRtpReceiveStats stats;
+        stats.packets = packets_;
+        stats.bytes = bytes_;
+        stats.syscalls = syscalls_;
+        stats.invalid = invalid_;
+        stats.foreign = foreign_;
+        stats.lost = lost_;
+        stats.out_of_order = out_of_order_;
+        stats.samples = samples_decoded_;
+        stats.playback_drops = playback_drops_;
+        stats.fec_recovered = fec_recovered_;
+        stats.parity_packets = parity_packets_;
+        stats.parity_bytes = parity_bytes_;
+        stats.parity_recovered = parity_recovered_;
+
+        if (jitter_enabled_) {
+            std::lock_guard<std::mutex> lock(jitter_stats_mutex_);
+            stats.lost = jitter_stats_.lost;
+            stats.out_of_order = jitter_stats_.late;
+            stats.fec_recovered = jitter_stats_.fec_recovered;
+            stats.jitter_depth = jitter_stats_.depth;
+            stats.target_delay_ms = jitter_stats_.target_delay_ms;
+            stats.jitter_ms = jitter_stats_.jitter_ms;
+            stats.concealed = jitter_stats_.concealed;
+        }
+        return stats;
+    }
+
+    bool get_report_block(RtcpReportBlock& block) {
+        return source_stats_.report(block);
+    }
+
+private:
+    void close_socket() {
+        if (socket_ >= 0) {
+            close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    void run() {
+        while (running_) {
+            for (size_t i = 0; i < RECEIVE_BATCH; i++) {
+                messages_[i].msg_hdr = msghdr{};
+                messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+                messages_[i].msg_hdr.msg_iovlen = 1;
+                messages_[i].msg_len = 0;
+            }
+
+            // Block for the first datagram, then take whatever else is already queued
+            int count = recvmmsg(socket_, messages_.data(), RECEIVE_BATCH, MSG_WAITFORONE,
+                                 nullptr);
+            if (count <= 0) {
+                // Timeout (EAGAIN) or EINTR: check running_ and try again
+                continue;
+            }
+
+            syscalls_++;
+            for (int i = 0; i < count; i++) {
+                const mmsghdr& message = messages_[i];
+                if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                    invalid_++;
+                    continue;
+                }
+                const uint8_t* data = &buffers_[i * MAX_DATAGRAM_SIZE];
+                if (jitter_enabled_) {
+                    enqueue_datagram(data, message.msg_len);
+                } else {
+                    handle_datagram(data, message.msg_len);
+                }
+            }
+        }
+    }
+
+    // Hand a datagram to the playout thread, prefixed with its arrival time
+    void enqueue_datagram(const uint8_t* data, size_t size) {
+        const uint64_t arrival = now_us();
+        const bool queued = queue_->emplace([&](uint8_t* slot, size_t) {
+            std::memcpy(slot, &arrival, ARRIVAL_PREFIX);
+            std::memcpy(slot + ARRIVAL_PREFIX, data, size);
+            return ARRIVAL_PREFIX + size;
+        });
+
+        if (!queued) {
+            playback_drops_++;
+        }
+    }
+
+    // Feed queued packets into the jitter buffer and play one frame per frame duration
+    void run_playout() {
+        using clock = std::chrono::steady_clock;
+
+        auto next = clock::now();
+
+        while (running_) {
+            size_t len = 0;
+            while (const uint8_t* datagram = queue_->front(len)) {
+                uint64_t arrival;
+                std::memcpy(&arrival, datagram, ARRIVAL_PREFIX);
+                buffer_datagram(datagram + ARRIVAL_PREFIX, len - ARRIVAL_PREFIX, arrival);
+                queue_->release();
+            }
+
+            const size_t count = jitter_->pop(frame_.data(), frame_.size());
+            samples_decoded_ += count;
+            if (count > 0 && callback_ && !callback_(frame_.data(), count)) {
+                playback_drops_++;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(jitter_stats_mutex_);
+                jitter_stats_ = jitter_->stats();
+            }
+
+            std::chrono::nanoseconds period = std::chrono::milliseconds(IDLE_POLL_MS);
+            if (jitter_->frame_samples() > 0) {
+                period = std::chrono::nanoseconds(1000000000LL * jitter_->frame_samples() /
+                                                  jitter_config_.sample_rate);
+            }
+
+            // Don't try to catch up in a burst after a stall
+            const auto now = clock::now();
+            next = std::max(next + period, now - period);
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void buffer_datagram(const uint8_t* data, size_t size, uint64_t arrival_us) {
+        RtpPacketView packet(data, size);
+        if (!packet.valid()) {
+            invalid_++;
+            return;
+        }
+        if (!is_media(packet) && !is_parity(packet)) {
+            foreign_++;  // Another stream, such as RTX or parity we weren't told about
+            return;
+        }
+
+        const size_t repaired = add_to_fec(packet, data, size);
+        if (!is_parity(packet)) {
+            buffer_packet(packet, size, arrival_us, false);
+        }
+        if (repaired > 0) {
+            buffer_packet(RtpPacketView(fec_.recovered(), repaired), repaired, arrival_us, true);
+        }
+    }
+
+    // A packet rebuilt from parity goes to the jitter buffer like any other but, as RTCP
+    // reports loss before repair, stays out of the reception statistics. The payload is only
+    // decoded at playout, in sequence order; so is Opus FEC for a packet lost before it.
+    void buffer_packet(const RtpPacketView& packet, size_t size, uint64_t arrival_us,
+                       bool repaired) {
+        if (codec_->payload_samples(packet.payload(), packet.payloadSize()) == 0) {
+            invalid_++;
+            return;
+        }
+
+        if (repaired) {
+            parity_recovered_++;
+        } else {
+            packets_++;
+            bytes_ += size;
+            source_stats_.update(packet.ssrc(), packet.sequenceNumber(), packet.timestamp(),
+                                 arrival_us);
+        }
+
+        // The jitter buffer runs on the sample clock. When that is slower than the RTP clock
+        // (Opus below 48 kHz) the scaled timestamp jumps once per RTP wrap, every 25 hours
+        // or so, and the jitter buffer resyncs.
+        jitter_->insert(packet.sequenceNumber(), packet.timestamp() / timestamp_scale_,
+                        packet.payload(), packet.payloadSize(), arrival_us);
+    }
+
+    void handle_datagram(const uint8_t* data, size_t size) {
+        RtpPacketView packet(data, size);
+        if (!packet.valid()) {
+            invalid_++;
+            return;
+        }
+        if (!is_media(packet) && !is_parity(packet)) {
+            foreign_++;  // Another stream, such as RTX or parity we weren't told about
+            return;
+        }
+
+        const size_t repaired = add_to_fec(packet, data, size);
+        if (!is_parity(packet)) {
+            handle_packet(packet, size, false);
+        }
+        if (repaired > 0) {
+            handle_packet(RtpPacketView(fec_.recovered(), repaired), repaired, true);
+        }
+    }
+
+    // Without a jitter buffer a rebuilt packet is usually behind the newest one already
+    // played and gets dropped; it only helps when a group's last packet is lost
+    void handle_packet(const RtpPacketView& packet, size_t size, bool repaired) {
+        if (codec_->payload_samples(packet.payload(), packet.payloadSize()) == 0) {
+            invalid_++;
+            return;
+        }
+
+        if (repaired) {
+            parity_recovered_++;
+        } else {
+            packets_++;
+            bytes_ += size;
+            source_stats_.update(packet.ssrc(), packet.sequenceNumber(), packet.timestamp(),
+                                 now_us());
+        }
+
+        // Late packets never reach the decoder, which keeps state from one packet to the next
+        uint16_t missing = 0;
+        if (!accept_sequence(packet, missing)) {
+            out_of_order_++;
+            return;
+        }
+
+        const size_t recovered = missing == 1 ? recover_previous(packet) : 0;
+        const size_t count = decode(packet);
+        if (count == 0) {
+            invalid_++;
+            return;
+        }
+
+        if (recovered > 0) {
+            samples_decoded_ += recovered;
+            fec_recovered_++;
+            if (callback_ && !callback_(recovered_.data(), recovered)) {
+                playback_drops_++;
+            }
+        }
+
+        samples_decoded_ += count;
+
+        if (callback_ && !callback_(samples_.data(), count)) {
+            playback_drops_++;
+        }
+    }
+
+    bool is_media(const RtpPacketView& packet) const {
+        return packet.payloadType() == payload_type_;
+    }
+
+    // Parity travels on an SSRC of its own, so the payload type is all that identifies it
+    bool is_parity(const RtpPacketView& packet) const {
+        return fec_enabled_ && packet.payloadType() == fec_payload_type_;
+    }
+
+    // Pass a packet to the FEC decoder: parity, or media it keeps for later repairs. Returns
+    // the length of a packet this let it rebuild into fec_.recovered(), 0 if none.
+    size_t add_to_fec(const RtpPacketView& packet, const uint8_t* data, size_t size) {
+        if (!fec_enabled_) {
+            return 0;
+        }
+        if (!is_parity(packet)) {
+            return fec_.add_media(data, size);
+        }
+
+        parity_packets_++;
+        parity_bytes_ += size;
+        return fec_.add_parity(data, size);
+    }
+
+    // Decode the payload into samples_; 0 if it is malformed
+    size_t decode(const RtpPacketView& packet) {
+        const size_t count = codec_->decode(packet.payload(), packet.payloadSize(),
+                                            samples_.data(), samples_.size());
+        if (count > 0) {
+            previous_samples_ = count;
+        }
+        return count;
+    }
+
+    // The packet just before this one was lost: rebuild it into recovered_ from the FEC this
+    // one carries, assuming it was as long as the last packet. Must run before decode() of the
+    // same packet. Returns the number of samples, 0 if nothing was recovered.
+    size_t recover_previous(const RtpPacketView& packet) {
+        if (previous_samples_ == 0) {
+            return 0;
+        }
+        return codec_->decode_fec(packet.payload(), packet.payloadSize(), recovered_.data(),
+                                  std::min(previous_samples_, recovered_.size()));
+    }
+
+    // Play packets in arrival order, dropping any that arrive behind the newest one. missing
+    // is set to the number of packets skipped since the newest.
+    bool accept_sequence(const RtpPacketView& packet, uint16_t& missing) {
+        const uint16_t seq = packet.sequenceNumber();
+        missing = 0;
+        if (!have_sequence_ || packet.ssrc() != ssrc_) {
+            have_sequence_ = true;
+            ssrc_ = packet.ssrc();
+            highest_seq_ = seq;
+            previous_samples_ = 0;  // A new stream: nothing to size FEC recovery by
+            return true;
+        }
+
+        const int16_t delta = static_cast<int16_t>(seq - highest_seq_);
+        if (delta <= 0) {
+            return false;
+        }
+
+        missing = static_cast<uint16_t>(delta - 1);
+        lost_ += missing;
+        highest_seq_ = seq;
+        return true;
+    }
+
+    int socket_;
+    uint16_t port_{0};
+    std::atomic<bool> active_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::thread playout_thread_;
+    AudioCallback callback_;
+    std::atomic<bool> jitter_enabled_;
+    JitterBufferConfig jitter_config_;
+    uint32_t clock_rate_{SAMPLING_RATE};
+    AudioCodecType codec_type_{AudioCodecType::L16};
+    EdgeVoxOpusConfig opus_config_;
+    bool fec_enabled_{false};
+    uint8_t fec_payload_type_{FEC_DEFAULT_PAYLOAD_TYPE};
+    RtpSourceStats source_stats_;  // Updated by whichever thread parses packets
+
+    // Receive thread only (codec_ belongs to the playout thread with the jitter buffer)
+    std::vector<uint8_t> buffers_;
+    std::vector<struct iovec> iovecs_;
+    std::vector<struct mmsghdr> messages_;
+    std::unique_ptr<AudioCodec> codec_;
+    uint8_t payload_type_{0};      // The codec's; anything else but parity is dropped
+    uint32_t timestamp_scale_{1};  // RTP clock ticks per sample
+    std::vector<float> samples_;
+
+    // Parsing thread: the receive thread, or the playout thread with the jitter buffer
+    std::vector<float> recovered_;
+    RtpFecDecoder fec_;
+    size_t previous_samples_{0};
+    bool have_sequence_{false};
+    uint32_t ssrc_{0};
+    uint16_t highest_seq_{0};
+
+    // Shared between the receive and playout threads
+    std::unique_ptr<PacketSlotBuffer> queue_;
+
+    // Playout thread only
+    std::unique_ptr<JitterBuffer> jitter_;
+    std::vector<float> frame_;
+
+    mutable std::mutex jitter_stats_mutex_;
+    JitterBufferStats jitter_stats_;
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> syscalls_{0};
+    std::atomic<uint64_t> invalid_{0};
+    std::atomic<uint64_t> foreign_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> out_of_order_{0};
+    std::atomic<uint64_t> samples_decoded_{0};
+    std::atomic<uint64_t> playback_drops_{0};
+    std::atomic<uint64_t> fec_recovered_{0};
+    std::atomic<uint64_t> parity_packets_{0};
+    std::atomic<uint64_t> parity_bytes_{0};
+    std::atomic<uint64_t> parity_recovered_{0};
+};
+
+EdgeVoxRtpReceiver::EdgeVoxRtpReceiver() : pimpl_(std::make_unique<Impl>()) {}
+EdgeVoxRtpReceiver::~EdgeVoxRtpReceiver() = default;
+
+bool EdgeVoxRtpReceiver::init(uint16_t port, const std::string& bind_address) {
+    return pimpl_->init(port, bind_address);
+}
+
+void EdgeVoxRtpReceiver::set_audio_callback(AudioCallback callback) {
+    pimpl_->set_audio_callback(std::move(callback));
+}
+
+void EdgeVoxRtpReceiver::set_jitter_buffer(bool enabled, const JitterBufferConfig& config) {
+    pimpl_->set_jitter_buffer(enabled, config);
+}
+
+void EdgeVoxRtpReceiver::set_clock_rate(uint32_t clock_rate) {
+    pimpl_->set_clock_rate(clock_rate);
+}
+
+void EdgeVoxRtpReceiver::set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus) {
+    pimpl_->set_codec(codec, opus);
+}
+
+void EdgeVoxRtpReceiver::set_fec(bool enabled, uint8_t payload_type) {
+    pimpl_->set_fec(enabled, payload_type);
+}
+
+bool EdgeVoxRtpReceiver::start() {
+    return pimpl_->start();
+}
+
+void EdgeVoxRtpReceiver::stop() {
+    pimpl_->stop();
+}
+
+bool EdgeVoxRtpReceiver::is_active() const {
+    return pimpl_->is_active();
+}
+
+uint16_t EdgeVoxRtpReceiver::port() const {
+    return pimpl_->port();
+}
+
+uint32_t EdgeVoxRtpReceiver::rtp_clock_rate() const {
+    return pimpl_->rtp_clock_rate();
+}
+
+EdgeVoxRtpReceiveStats EdgeVoxRtpReceiver::get_stats() const {
+    return pimpl_->get_stats();
+}
+
+bool EdgeVoxRtpReceiver::get_report_block(RtcpReportBlock& block) {
+    return pimpl_->get_report_block(block);
+}
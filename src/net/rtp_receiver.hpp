@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "edge_vox/audio/audio_config.hpp"
+#include "edge_vox/net/rtp_stats.hpp"
+#include "jitter_buffer.hpp"
+#include "rtcp_packet.hpp"
+#include "rtp_fec.hpp"
+
+class EdgeVoxRtpReceiver {
+public:
+    // Called with audio decoded to float: once per packet on the receive thread, or
+    // once per frame on the playout thread when the jitter buffer is enabled. Return false if
+    // the samples couldn't be queued for playback.
+    using AudioCallback = std::function<bool(const float* samples, size_t count)>;
+
+    EdgeVoxRtpReceiver();
+    ~EdgeVoxRtpReceiver();
+
+    // Bind the UDP socket; port 0 picks a free port (see port())
+    bool init(uint16_t port, const std::string& bind_address = "0.0.0.0");
+    void set_audio_callback(AudioCallback callback);  // Set before start()
+
+    // Reorder packets and pace playout through an adaptive jitter buffer instead of playing
+    // them as they arrive. Set before start().
+    void set_jitter_buffer(bool enabled, const JitterBufferConfig& config = JitterBufferConfig());
+    void set_clock_rate(uint32_t clock_rate);  // RTP clock for jitter statistics, before start()
+    // Payload format, L16 by default; before start(). Packets of any payload type but the
+    // codec's (or the parity's, see set_fec()) are dropped. With Opus, a single lost packet is
+    // rebuilt from the FEC in the next one when opus.fec is set.
+    void set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus = {});
+    // Take packets of payload_type as RFC 5109 parity (see RtpFecEncoder) and rebuild single
+    // losses per group from them. Needs the jitter buffer to be of much use. Before start().
+    void set_fec(bool enabled, uint8_t payload_type = FEC_DEFAULT_PAYLOAD_TYPE);
+    bool start();
+    void stop();
+    bool is_active() const;
+    uint16_t port() const;
+    EdgeVoxRtpReceiveStats get_stats() const;
+
+    // RTCP reception report about the current source; false before the first packet. Each call
+    // starts a new loss interval, so call it from one RTCP thread only.
+    bool get_report_block(RtcpReportBlock& block);
+    // RTP clock of the codec, the unit of the report block jitter; valid after start()
+    uint32_t rtp_clock_rate() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
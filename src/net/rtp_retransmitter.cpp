@@ -0,0 +1,135 @@
+#include "rtp_retransmitter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "rtp_packet.hpp"
+
+namespace {
+constexpr uint32_t RTX_BURST_MS = 100;  // Bucket depth: what may go out back to back
+}  // namespace
+
+RtpRetransmitter::RtpRetransmitter() {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    ssrc_ = std::uniform_int_distribution<uint32_t>()(gen);
+    seq_ = std::uniform_int_distribution<uint16_t>()(gen);
+}
+
+bool RtpRetransmitter::configure(const RtpRtxConfig& config, uint32_t frame_us,
+                                 size_t max_packet) {
+    if (config.history_ms == 0) {
+        config_ = config;
+        history_.clear();
+        return true;
+    }
+    if (frame_us == 0 || config.max_bitrate == 0 || max_packet <= RTP_HEADER_SIZE) {
+        return false;
+    }
+
+    // Round up, so a full history_ms is always held
+    const uint64_t history_us = uint64_t{config.history_ms} * 1000;
+    const size_t slots = static_cast<size_t>(
+        std::min<uint64_t>((history_us + frame_us - 1) / frame_us, RTX_MAX_HISTORY));
+
+    config_ = config;
+    max_packet_ = max_packet;
+    history_.assign(slots, Entry());
+    for (Entry& entry : history_) {
+        entry.data.resize(max_packet);
+    }
+    reset();
+    return true;
+}
+
+void RtpRetransmitter::reset() {
+    for (Entry& entry : history_) {
+        entry.valid = false;
+    }
+    tokens_ = 0.0;
+    refilled_us_ = 0;
+}
+
+void RtpRetransmitter::store(const uint8_t* header, size_t header_len, const uint8_t* payload,
+                             size_t payload_len, uint64_t now_us) {
+    if (!enabled() || header_len + payload_len > max_packet_) {
+        return;
+    }
+
+    const auto seq = static_cast<uint16_t>(header[2] << 8 | header[3]);
+    Entry& entry = history_[seq % history_.size()];
+    entry.valid = true;
+    entry.seq = seq;
+    entry.sent_us = now_us;
+    entry.len = header_len + payload_len;
+    memcpy(entry.data.data(), header, header_len);
+    memcpy(entry.data.data() + header_len, payload, payload_len);
+}
+
+bool RtpRetransmitter::take_tokens(size_t bytes, uint64_t now_us) {
+    const double rate = config_.max_bitrate / 8.0 / 1e6;  // Bytes per microsecond
+    const double depth = std::max(rate * RTX_BURST_MS * 1000, static_cast<double>(max_packet_));
+    if (refilled_us_ == 0) {
+        tokens_ = depth;
+    } else if (now_us > refilled_us_) {
+        tokens_ = std::min(depth, tokens_ + (now_us - refilled_us_) * rate);
+    }
+    refilled_us_ = std::max(refilled_us_, now_us);
+
+    if (tokens_ < bytes) {
+        return false;
+    }
+    tokens_ -= bytes;
+    return true;
+}
+
+size_t RtpRetransmitter::retransmit(uint16_t seq, uint64_t now_us, uint8_t* out,
+                                    size_t capacity) {
+    if (!enabled()) {
+        return 0;
+    }
+    stats_.requested++;
+
+    const Entry& entry = history_[seq % history_.size()];
+    if (!entry.valid || entry.seq != seq ||
+        now_us - entry.sent_us > uint64_t{config_.history_ms} * 1000) {
+        stats_.missing++;
+        return 0;
+    }
+
+    // The original header with our payload type, sequence number and SSRC; CSRCs and the
+    // header extension stay in place ahead of the original sequence number (RFC 4588
+    // section 4)
+    const uint8_t* original = entry.data.data();
+    size_t header_len = RTP_HEADER_SIZE + (original[0] & 0x0F) * 4;
+    if ((original[0] & 0x10) && header_len + 4 <= entry.len) {
+        header_len += 4 + 4 * (original[header_len + 2] << 8 | original[header_len + 3]);
+    }
+    const size_t size = entry.len + RTX_HEADER_SIZE;
+    if (size > capacity || header_len > entry.len) {
+        stats_.missing++;
+        return 0;
+    }
+    if (!take_tokens(size, now_us)) {
+        stats_.rate_limited++;
+        return 0;
+    }
+
+    memcpy(out, original, header_len);
+    out[1] = static_cast<uint8_t>((original[1] & 0x80) | (config_.payload_type & 0x7F));
+    out[2] = static_cast<uint8_t>(seq_ >> 8);
+    out[3] = static_cast<uint8_t>(seq_);
+    seq_++;
+    out[8] = static_cast<uint8_t>(ssrc_ >> 24);
+    out[9] = static_cast<uint8_t>(ssrc_ >> 16);
+    out[10] = static_cast<uint8_t>(ssrc_ >> 8);
+    out[11] = static_cast<uint8_t>(ssrc_);
+    out[header_len] = static_cast<uint8_t>(seq >> 8);
+    out[header_len + 1] = static_cast<uint8_t>(seq);
+    memcpy(out + header_len + RTX_HEADER_SIZE, original + header_len, entry.len - header_len);
+
+    stats_.retransmitted++;
+    stats_.bytes += size;
+    return size;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+constexpr uint8_t RTX_DEFAULT_PAYLOAD_TYPE = 112;  // Dynamic, clear of the codec types
+constexpr size_t RTX_HEADER_SIZE = 2;              // Original sequence number (RFC 4588)
+constexpr size_t RTX_MAX_HISTORY = 4096;           // Packets, whatever the frame duration
+}  // namespace
+
+struct RtpRtxConfig {
+    uint32_t history_ms{0};  // How long sent packets stay available; 0 disables
+    uint8_t payload_type{RTX_DEFAULT_PAYLOAD_TYPE};
+    uint32_t max_bitrate{64000};  // Retransmission budget in bits per second
+};
+
+struct RtpRtxStats {
+    uint64_t requested{0};      // Sequence numbers asked for by NACKs
+    uint64_t retransmitted{0};  // RTX packets sent
+    uint64_t bytes{0};          // Their size including headers
+    uint64_t missing{0};        // Requests for packets no longer (or never) in the history
+    uint64_t rate_limited{0};   // Requests dropped to stay within max_bitrate
+};
+
+//
+// Keeps the packets sent in the last history_ms, indexed by sequence number, and turns NACKed
+// ones into RTX packets (RFC 4588): a separate SSRC and sequence space, the same timestamp,
+// and the original sequence number ahead of the original payload. A token bucket holds
+// retransmissions to max_bitrate so repairs can't pile onto a congested link. Not thread safe.
+//
+class RtpRetransmitter {
+public:
+    RtpRetransmitter();
+
+    // frame_us is the duration of one packet, which with history_ms sizes the history. Fails if
+    // the packets would not fit in max_packet bytes with the RTX header.
+    bool configure(const RtpRtxConfig& config, uint32_t frame_us, size_t max_packet);
+    bool enabled() const {
+        return config_.history_ms > 0;
+    }
+
+    // Remember a media packet sent at now_us, passed as header and payload
+    void store(const uint8_t* header, size_t header_len, const uint8_t* payload,
+               size_t payload_len, uint64_t now_us);
+
+    // Write the RTX packet for seq into out and return its length; 0 if the packet is gone,
+    // older than history_ms, doesn't fit in capacity or the bitrate budget is spent
+    size_t retransmit(uint16_t seq, uint64_t now_us, uint8_t* out, size_t capacity);
+
+    void reset();
+
+    uint32_t ssrc() const {
+        return ssrc_;
+    }
+
+    const RtpRtxStats& stats() const {
+        return stats_;
+    }
+
+private:
+    struct Entry {
+        bool valid = false;
+        uint16_t seq = 0;
+        uint64_t sent_us = 0;
+        size_t len = 0;
+        std::vector<uint8_t> data;
+    };
+
+    bool take_tokens(size_t bytes, uint64_t now_us);
+
+    RtpRtxConfig config_;
+    std::vector<Entry> history_;
+    size_t max_packet_ = 0;
+    uint32_t ssrc_;
+    uint16_t seq_;
+
+    double tokens_ = 0.0;  // Bytes the bucket can spend right now
+    uint64_t refilled_us_ = 0;
+
+    RtpRtxStats stats_;
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#include "rtcp_packet.hpp"
+
+//
+// Reception statistics of one RTP source as defined by RFC 3550 appendix A: extended highest
+// sequence number (A.1), cumulative and interval loss (A.3) and interarrival jitter (A.8).
+//
+// One thread calls update() for every received packet; a second thread may call report()
+// to build reception report blocks. The counters are published through a sequence lock, so
+// neither side ever blocks.
+//
+class RtpSourceStats {
+public:
+    explicit RtpSourceStats(uint32_t clock_rate = 48000) : clock_rate_(clock_rate) {}
+
+    // Forget the source. Call from the updating thread, or before it starts.
+    void reset(uint32_t clock_rate) {
+        clock_rate_ = clock_rate;
+        have_source_ = false;
+        publish();
+    }
+
+    // Record a packet. arrival_us is the local arrival time on any monotonic clock.
+    void update(uint32_t ssrc, uint16_t seq, uint32_t timestamp, uint64_t arrival_us) {
+        if (!have_source_ || ssrc != ssrc_) {
+            start_source(ssrc, seq);
+        } else {
+            const uint16_t delta = static_cast<uint16_t>(seq - max_seq_);
+            if (delta < MAX_DROPOUT) {
+                if (seq < max_seq_) {
+                    cycles_ += 1u << 16;  // Sequence number wrapped
+                }
+                max_seq_ = seq;
+            } else if (delta <= (1u << 16) - MAX_MISORDER) {
+                if (seq != bad_seq_) {
+                    // A stray or very late packet, unless the next one continues from it
+                    bad_seq_ = static_cast<uint16_t>(seq + 1);
+                    return;
+                }
+                // Two sequential packets after a jump: the sender restarted its numbering
+                start_source(ssrc, seq);
+            }
+            // Otherwise a duplicate or reordered packet: counted below, max unchanged
+        }
+        received_++;
+
+        // Arrival time in timestamp units; only differences matter, so wrapping is harmless
+        const uint32_t arrival = static_cast<uint32_t>(arrival_us * clock_rate_ / 1000000);
+        const int32_t transit = static_cast<int32_t>(arrival - timestamp);
+        if (have_transit_) {
+            const int32_t d = std::abs(transit - transit_);
+            jitter_q4_ += d - static_cast<int32_t>((jitter_q4_ + 8) >> 4);
+        }
+        transit_ = transit;
+        have_transit_ = true;
+
+        publish();
+    }
+
+    // Build a report block for the current source and start a new reporting interval.
+    // Returns false before the first packet. Call from a single reporting thread.
+    bool report(RtcpReportBlock& block) {
+        Snapshot s;
+        if (!read(s)) {
+            return false;
+        }
+
+        if (s.ssrc != reported_ssrc_ || s.base_seq != reported_base_) {
+            // New source or restarted sequence: the previous interval doesn't apply
+            reported_ssrc_ = s.ssrc;
+            reported_base_ = s.base_seq;
+            expected_prior_ = 0;
+            received_prior_ = 0;
+        }
+
+        const int64_t expected = static_cast<int64_t>(s.extended_max) - s.base_seq + 1;
+        const int64_t lost = expected - static_cast<int64_t>(s.received);
+
+        const int64_t expected_interval = expected - expected_prior_;
+        const int64_t received_interval = static_cast<int64_t>(s.received) - received_prior_;
+        const int64_t lost_interval = expected_interval - received_interval;
+        expected_prior_ = expected;
+        received_prior_ = static_cast<int64_t>(s.received);
+
+        block = RtcpReportBlock();
+        block.ssrc = s.ssrc;
+        block.fraction_lost =
+            expected_interval <= 0 || lost_interval <= 0
+                ? 0
+                : static_cast<uint8_t>(std::min<int64_t>((lost_interval << 8) / expected_interval,
+                                                         255));
+        block.cumulative_lost = static_cast<int32_t>(std::max<int64_t>(
+            std::min<int64_t>(lost, 0x7FFFFF), -0x800000));
+        block.highest_seq = s.extended_max;
+        block.jitter = s.jitter;
+        return true;
+    }
+
+    uint32_t clock_rate() const {
+        return clock_rate_;
+    }
+
+private:
+    static constexpr uint16_t MAX_DROPOUT = 3000;     // Ahead by more: stray, or a restart
+    static constexpr uint16_t MAX_MISORDER = 100;     // Behind by less: a reordered packet
+    static constexpr uint32_t NO_BAD_SEQ = 1u << 16;  // Matches no sequence number
+
+    struct Snapshot {
+        uint32_t ssrc;
+        uint32_t base_seq;
+        uint32_t extended_max;
+        uint64_t received;
+        uint32_t jitter;
+    };
+
+    void start_source(uint32_t ssrc, uint16_t seq) {
+        have_source_ = true;
+        ssrc_ = ssrc;
+        base_seq_ = seq;
+        max_seq_ = seq;
+        cycles_ = 0;
+        bad_seq_ = NO_BAD_SEQ;
+        received_ = 0;
+        have_transit_ = false;
+        jitter_q4_ = 0;
+    }
+
+    // Writer side of the sequence lock: odd while the fields are being changed
+    void publish() {
+        const uint32_t version = version_.load(std::memory_order_relaxed);
+        version_.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        valid_.store(have_source_, std::memory_order_relaxed);
+        ssrc_out_.store(ssrc_, std::memory_order_relaxed);
+        base_out_.store(base_seq_, std::memory_order_relaxed);
+        max_out_.store(cycles_ + max_seq_, std::memory_order_relaxed);
+        received_out_.store(received_, std::memory_order_relaxed);
+        jitter_out_.store(static_cast<uint32_t>(jitter_q4_ >> 4), std::memory_order_relaxed);
+
+        version_.store(version + 2, std::memory_order_release);
+    }
+
+    bool read(Snapshot& s) const {
+        for (;;) {
+            const uint32_t before = version_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+
+            const bool valid = valid_.load(std::memory_order_relaxed);
+            s.ssrc = ssrc_out_.load(std::memory_order_relaxed);
+            s.base_seq = base_out_.load(std::memory_order_relaxed);
+            s.extended_max = max_out_.load(std::memory_order_relaxed);
+            s.received = received_out_.load(std::memory_order_relaxed);
+            s.jitter = jitter_out_.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version_.load(std::memory_order_relaxed) == before) {
+                return valid;
+            }
+        }
+    }
+
+    uint32_t clock_rate_;
+
+    // Updating thread only
+    bool have_source_ = false;
+    uint32_t ssrc_ = 0;
+    uint32_t base_seq_ = 0;
+    uint16_t max_seq_ = 0;
+    uint32_t cycles_ = 0;
+    uint32_t bad_seq_ = NO_BAD_SEQ;  // Sequence number that would confirm a restart
+    uint64_t received_ = 0;
+    bool have_transit_ = false;
+    int32_t transit_ = 0;
+    int32_t jitter_q4_ = 0;  // Jitter scaled by 16, as in A.8
+
+    // Published snapshot
+    std::atomic<uint32_t> version_{0};
+    std::atomic<bool> valid_{false};
+    std::atomic<uint32_t> ssrc_out_{0};
+    std::atomic<uint32_t> base_out_{0};
+    std::atomic<uint32_t> max_out_{0};
+    std::atomic<uint64_t> received_out_{0};
+    std::atomic<uint32_t> jitter_out_{0};
+
+    // Reporting thread only
+    uint32_t reported_ssrc_ = 0;
+    uint32_t reported_base_ = 0;
+    int64_t expected_prior_ = 0;
+    int64_t received_prior_ = 0;
+};
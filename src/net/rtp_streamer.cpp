@@ -3,18 +3,33 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstring>
+#include <mutex>
 #include <thread>
 
+#include "audio/audio_codec.hpp"
+#include "rtp_fec.hpp"
 #include "rtp_packet.hpp"
+#include "rtp_packetizer.hpp"
+#include "rtp_retransmitter.hpp"
+
+namespace {
+constexpr size_t MAX_PENDING_NACKS = 256;  // Requests beyond this wait for the next NACK
+}  // namespace
 
 class EdgeVoxRtpStreamer::Impl {
 public:
     Impl() : socket_(-1), active_(false) {
         packet_ = std::make_unique<RtpPacket>();
+        packet_buffer_.resize(mtu_);
+        codec_ = create_audio_codec(codec_type_, sample_rate_);
+        packet_->setPayloadType(codec_->payload_type());
     }
 
     bool init(const std::string& host, uint16_t port, uint32_t payload_size) {
@@ -26,6 +41,10 @@ public:
         port_ = port;
         payload_size_ = payload_size;
 
+        if (!configure_packetizer(sample_rate_, ptime_ms_, mtu_, *codec_)) {
+            return false;
+        }
+
         socket_ = socket(AF_INET, SOCK_DGRAM, 0);
         if (socket_ < 0) {
             return false;
@@ -67,8 +86,105 @@ public:
         return true;
     }
 
+    bool set_packetization(uint32_t sample_rate, uint32_t ptime_ms, uint32_t mtu) {
+        // A new rate needs a new codec instance, which may not support it (Opus)
+        std::unique_ptr<AudioCodec> instance;
+        if (sample_rate != sample_rate_) {
+            instance = create_audio_codec(codec_type_, sample_rate, opus_config_);
+            if (!instance) {
+                return false;
+            }
+        }
+        if (!configure_packetizer(sample_rate, ptime_ms, mtu, instance ? *instance : *codec_)) {
+            return false;
+        }
+
+        if (instance) {
+            sample_rate_ = sample_rate;
+            set_codec_instance(std::move(instance));
+        }
+        ptime_ms_ = ptime_ms;
+        mtu_ = mtu;
+        packet_buffer_.resize(mtu_);
+        batch_.configure(batch_packets_, mtu_, batch_gso_);
+        rtx_.configure(rtx_config_, frame_us(), mtu_);
+        return true;
+    }
+
+    bool set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus) {
+        auto instance = create_audio_codec(codec, sample_rate_, opus);
+        if (!instance || !configure_packetizer(sample_rate_, ptime_ms_, mtu_, *instance)) {
+            return false;
+        }
+
+        codec_type_ = codec;
+        opus_config_ = opus;
+        set_codec_instance(std::move(instance));
+        return true;
+    }
+
+    bool set_fec(const RtpFecConfig& config) {
+        const RtpFecConfig previous = fec_config_;
+        if (!fec_.configure(config)) {
+            return false;
+        }
+
+        // Media packets shrink to leave room for the FEC headers in the parity packets
+        fec_config_ = config;
+        if (!configure_packetizer(sample_rate_, ptime_ms_, mtu_, *codec_)) {
+            fec_config_ = previous;
+            fec_.configure(previous);
+            return false;
+        }
+        return true;
+    }
+
+    bool set_retransmission(const RtpRtxConfig& config) {
+        const RtpRtxConfig previous = rtx_config_;
+        rtx_config_ = config;
+        if (!configure_packetizer(sample_rate_, ptime_ms_, mtu_, *codec_) ||
+            !rtx_.configure(config, frame_us(), mtu_)) {
+            rtx_config_ = previous;
+            configure_packetizer(sample_rate_, ptime_ms_, mtu_, *codec_);
+            return false;
+        }
+        return true;
+    }
+
+    // Any thread: the requests are served by the next send_audio() or send_encoded() call
+    void handle_nack(uint32_t media_ssrc, const uint16_t* seqs, size_t count) {
+        if (media_ssrc != packet_->getHeader().ssrc || count == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(nack_mutex_);
+        count = std::min(count, MAX_PENDING_NACKS - pending_nacks_.size());
+        pending_nacks_.insert(pending_nacks_.end(), seqs, seqs + count);
+        nacks_pending_.store(!pending_nacks_.empty(), std::memory_order_release);
+    }
+
+    bool set_batching(size_t max_packets, bool use_gso) {
+        if (max_packets > UdpBatchSender::MAX_BATCH) {
+            return false;
+        }
+
+        batch_packets_ = max_packets;
+        batch_gso_ = use_gso;
+        batch_.configure(batch_packets_, mtu_, batch_gso_);
+        return true;
+    }
+
     void stop() {
         active_ = false;
+        packetizer_.reset();
+        fec_.reset();
+        rtx_.reset();
+        batch_.clear();
+        {
+            std::lock_guard<std::mutex> lock(nack_mutex_);
+            pending_nacks_.clear();
+            nacks_pending_ = false;
+        }
         if (socket_ >= 0) {
             shutdown(socket_, SHUT_RDWR);
             close(socket_);
@@ -76,55 +192,345 @@ public:
         }
     }
 
-    bool send_audio(const std::vector<float>& samples) {
+    bool send_audio(const float* samples, size_t n_samples) {
         if (!active_ || socket_ < 0) {
             return false;
         }
 
-        // Convert float samples to network bytes
-        std::vector<uint8_t> audio_data;
-        audio_data.reserve(samples.size() * sizeof(int16_t));
+        bool success = serve_nacks();
+        packetizer_.push(samples, n_samples, [&](const float* frame, size_t count) {
+            success = send_frame(frame, count) && success;
+        });
 
-        for (float sample : samples) {
-            int16_t pcm = static_cast<int16_t>(sample * 32767.0f);
-            audio_data.push_back((pcm >> 8) & 0xFF);
-            audio_data.push_back(pcm & 0xFF);
+        // Don't hold packets back across calls; batching only merges what one call produced
+        if (batch_.queued() > 0) {
+            success = flush_batch() && success;
         }
 
-        // Set the payload
-        packet_->setPayload(audio_data);
+        return success;
+    }
 
-        // Set marker bit if this is the first packet in a talkspurt
-        if (samples_sent_ == 0) {
-            packet_->setMarker(true);
-        } else {
-            packet_->setMarker(false);
+    bool send_encoded(const uint8_t* payload, size_t frame_bytes, size_t frames,
+                      uint32_t samples_per_frame) {
+        if (!active_ || socket_ < 0) {
+            return false;
+        }
+        if (frame_bytes == 0 || frame_bytes + RTP_OVERHEAD_BYTES + repair_overhead() > mtu_) {
+            drop_frames(frames, static_cast<uint32_t>(frames) * samples_per_frame);
+            return false;
+        }
+
+        bool success = serve_nacks();
+        for (size_t i = 0; i < frames; i++) {
+            success = send_gather(payload + i * frame_bytes, frame_bytes, samples_per_frame) &&
+                      success;
         }
 
-        // Update timestamp based on number of samples
-        packet_->incrementTimestamp(samples.size());
+        // The payload belongs to the caller, so nothing may stay queued past this call
+        if (batch_.queued() > 0) {
+            success = flush_batch() && success;
+        }
 
-        // Serialize the packet
-        auto packet_data = packet_->serialize();
+        return success;
+    }
 
-        // Send the packet
-        ssize_t sent = sendto(socket_, packet_data.data(), packet_data.size(), 0,
-                              (struct sockaddr*)&dest_addr_, sizeof(dest_addr_));
+    void set_dither(bool enabled) {
+        dither_ = enabled;
+        codec_->set_dither(enabled);
+    }
 
-        if (sent == static_cast<ssize_t>(packet_data.size())) {
-            packet_->incrementSequenceNumber();
-            samples_sent_ += samples.size();
-            return true;
+    void skip_samples(uint32_t count) {
+        // A partial frame goes out padded with silence rather than waiting to be completed by
+        // audio from after the gap, which would be sent with the wrong timestamp
+        const size_t pending = packetizer_.pending();
+        if (pending > 0 && active_ && socket_ >= 0) {
+            const size_t pad = std::min<size_t>(count, packetizer_.frame_samples() - pending);
+            packetizer_.push(silence_.data(), pad,
+                             [&](const float* frame, size_t n) { send_frame(frame, n); });
+            if (batch_.queued() > 0) {
+                flush_batch();
+            }
+            count -= static_cast<uint32_t>(pad);
         }
+        packet_->incrementTimestamp(count * timestamp_scale_);
+    }
 
-        return false;
+    void start_talkspurt() {
+        talkspurt_start_ = true;
     }
 
     bool is_active() const {
         return active_;
     }
 
+    UdpBatchStats get_batch_stats() const {
+        return batch_.stats();
+    }
+
+    RtpFecStats get_fec_stats() const {
+        return fec_.stats();
+    }
+
+    RtpRtxStats get_rtx_stats() const {
+        return rtx_.stats();
+    }
+
+    uint64_t get_dropped_frames() const {
+        return frames_dropped_.load(std::memory_order_relaxed);
+    }
+
+    bool get_sender_info(RtcpSenderInfo& info) const {
+        info.ssrc = packet_->getHeader().ssrc;
+
+        const uint64_t last_sent = last_sent_.load(std::memory_order_acquire);
+        if (last_sent == 0) {
+            return false;
+        }
+
+        // Extrapolate the RTP clock from the newest packet to now. The send time is kept
+        // modulo 2^32 us, which is plenty between two reports.
+        const uint32_t elapsed_us = now_us32() - static_cast<uint32_t>(last_sent);
+        info.ntp_timestamp = rtcpNtpNow();
+        info.rtp_timestamp =
+            static_cast<uint32_t>(last_sent >> 32) +
+            static_cast<uint32_t>(uint64_t{elapsed_us} * rtp_clock_rate_ / 1000000);
+        info.packet_count = static_cast<uint32_t>(packets_sent_.load(std::memory_order_relaxed));
+        info.octet_count = static_cast<uint32_t>(octets_sent_.load(std::memory_order_relaxed));
+        return true;
+    }
+
 private:
+    // Frame size for the codec's bytes per sample, which must also be one the codec can code
+    bool configure_packetizer(uint32_t sample_rate, uint32_t ptime_ms, uint32_t mtu,
+                              const AudioCodec& codec) {
+        const auto bytes_per_sample =
+            static_cast<uint32_t>(audio_codec_bytes_per_sample(codec.type()));
+        const uint32_t media_mtu = mtu - std::min(mtu, repair_overhead());
+        if (!packetizer_.configure(sample_rate, ptime_ms, payload_size_, media_mtu,
+                                   bytes_per_sample)) {
+            return false;
+        }
+        silence_.assign(packetizer_.frame_samples(), 0.0f);
+        return codec.supports_frame(packetizer_.frame_samples());
+    }
+
+    // Parity and RTX packets are larger than the media they carry
+    uint32_t repair_overhead() const {
+        const size_t fec = fec_config_.group_size > 0 ? FEC_OVERHEAD_BYTES : 0;
+        const size_t rtx = rtx_config_.history_ms > 0 ? RTX_HEADER_SIZE : 0;
+        return static_cast<uint32_t>(fec + rtx);
+    }
+
+    uint32_t frame_us() const {
+        return static_cast<uint32_t>(uint64_t{packetizer_.frame_samples()} * 1000000 /
+                                     sample_rate_);
+    }
+
+    void set_codec_instance(std::unique_ptr<AudioCodec> codec) {
+        codec_ = std::move(codec);
+        codec_->set_dither(dither_);
+        packet_->setPayloadType(codec_->payload_type());
+        rtp_clock_rate_ = codec_->rtp_clock_rate();
+        timestamp_scale_ = rtp_clock_rate_ / codec_->clock_rate();
+    }
+
+    static uint64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static uint32_t now_us32() {
+        return static_cast<uint32_t>(now_us());
+    }
+
+    // RTP timestamp and send time of the newest packet in one word, so RTCP reads a pair
+    // that belongs together
+    void record_sent(uint32_t timestamp, size_t payload_bytes) {
+        packets_sent_.fetch_add(1, std::memory_order_relaxed);
+        octets_sent_.fetch_add(payload_bytes, std::memory_order_relaxed);
+        // The low bit keeps the word non-zero; one microsecond doesn't matter here
+        last_sent_.store(static_cast<uint64_t>(timestamp) << 32 | now_us32() | 1,
+                         std::memory_order_release);
+    }
+
+    // A frame that can't be sent still takes its time on the RTP clock, so the receiver sees
+    // a gap rather than the following audio arriving early
+    void drop_frames(size_t frames, uint32_t rtp_ticks) {
+        packet_->incrementTimestamp(rtp_ticks);
+        frames_dropped_.fetch_add(frames, std::memory_order_relaxed);
+    }
+
+    bool send_frame(const float* samples, size_t count) {
+        // Build the packet in place: in the next batch slot, or in the reusable packet buffer
+        bool success = true;
+        if (batching() && batch_.full()) {
+            success = flush_batch();
+        }
+
+        uint8_t* buffer = batching() ? batch_.slot() : packet_buffer_.data();
+        const size_t capacity = batching() ? batch_.max_packet_size() : packet_buffer_.size();
+        const size_t header_size = packet_->headerSize();
+        if (header_size >= capacity) {
+            drop_frames(1, static_cast<uint32_t>(count) * timestamp_scale_);
+            return false;
+        }
+
+        // Encode the samples right after the header
+        const size_t payload_size =
+            codec_->encode(samples, count, buffer + header_size, capacity - header_size);
+        if (payload_size == 0) {
+            drop_frames(1, static_cast<uint32_t>(count) * timestamp_scale_);
+            return false;
+        }
+
+        // DTX: silence is not sent, but the clock runs on so the receiver sees the gap
+        if (codec_->is_silence(payload_size)) {
+            packet_->incrementTimestamp(static_cast<uint32_t>(count) * timestamp_scale_);
+            talkspurt_start_ = true;
+            return success;
+        }
+        const size_t size = header_size + payload_size;
+
+        // Set marker bit if this is the first packet in a talkspurt
+        packet_->setMarker(talkspurt_start_);
+        talkspurt_start_ = false;
+        packet_->writeHeader(buffer);
+        const uint32_t timestamp = packet_->getHeader().timestamp;
+
+        // The RTP clock advances even if the packet is lost; the timestamp of a packet is
+        // that of its first sample
+        packet_->incrementTimestamp(static_cast<uint32_t>(count) * timestamp_scale_);
+
+        // Sequence numbers are assigned when a packet is queued, so a failed flush shows up as
+        // loss at the receiver rather than as reused sequence numbers
+        if (batching()) {
+            packet_->incrementSequenceNumber();
+            record_sent(timestamp, size - header_size);
+            success = batch_.commit(size) && success;
+            return track_sent(buffer, header_size, buffer + header_size, payload_size) &&
+                   success;
+        }
+
+        ssize_t sent = sendto(socket_, buffer, size, 0, (struct sockaddr*)&dest_addr_,
+                              sizeof(dest_addr_));
+        if (sent == static_cast<ssize_t>(size)) {
+            packet_->incrementSequenceNumber();
+            record_sent(timestamp, size - header_size);
+            return track_sent(buffer, header_size, buffer + header_size, payload_size);
+        }
+
+        frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Header from a scratch buffer, payload from the caller: sendmsg/sendmmsg gather both
+    bool send_gather(const uint8_t* payload, size_t len, uint32_t samples) {
+        bool success = true;
+        if (batching() && batch_.full()) {
+            success = flush_batch();
+        }
+
+        uint8_t header[RTP_HEADER_SIZE + 15 * sizeof(uint32_t)];
+        packet_->setMarker(talkspurt_start_);
+        talkspurt_start_ = false;
+        const size_t header_size = packet_->writeHeader(header);
+        const uint32_t timestamp = packet_->getHeader().timestamp;
+
+        packet_->incrementTimestamp(samples);
+
+        if (batching()) {
+            packet_->incrementSequenceNumber();
+            record_sent(timestamp, len);
+            success = batch_.queue_gather(header, header_size, payload, len) && success;
+            return track_sent(header, header_size, payload, len) && success;
+        }
+
+        struct iovec iov[2];
+        iov[0].iov_base = header;
+        iov[0].iov_len = header_size;
+        iov[1].iov_base = const_cast<uint8_t*>(payload);
+        iov[1].iov_len = len;
+
+        struct msghdr msg {};
+        msg.msg_name = &dest_addr_;
+        msg.msg_namelen = sizeof(dest_addr_);
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+
+        ssize_t sent = sendmsg(socket_, &msg, 0);
+        if (sent == static_cast<ssize_t>(header_size + len)) {
+            packet_->incrementSequenceNumber();
+            record_sent(timestamp, len);
+            return track_sent(header, header_size, payload, len);
+        }
+
+        frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Keep a sent media packet for retransmission, add it to its FEC group and send the parity
+    // packet it completes
+    bool track_sent(const uint8_t* header, size_t header_len, const uint8_t* payload,
+                    size_t len) {
+        if (rtx_.enabled()) {
+            rtx_.store(header, header_len, payload, len, now_us());
+        }
+
+        const size_t size = fec_.add(header, header_len, payload, len);
+        return size == 0 || send_repair(fec_.parity(), size);
+    }
+
+    // Resend what the NACKs since the last call asked for, ahead of new media
+    bool serve_nacks() {
+        if (!nacks_pending_.load(std::memory_order_acquire)) {
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(nack_mutex_);
+            serving_nacks_.swap(pending_nacks_);
+            pending_nacks_.clear();
+            nacks_pending_.store(false, std::memory_order_relaxed);
+        }
+
+        bool success = true;
+        const uint64_t now = now_us();
+        rtx_buffer_.resize(mtu_);
+        for (uint16_t seq : serving_nacks_) {
+            const size_t size = rtx_.retransmit(seq, now, rtx_buffer_.data(), rtx_buffer_.size());
+            if (size > 0) {
+                success = send_repair(rtx_buffer_.data(), size) && success;
+            }
+        }
+        return success;
+    }
+
+    // Send a parity or RTX packet. They aren't media, so they stay out of the sender report
+    // counts.
+    bool send_repair(const uint8_t* data, size_t size) {
+        if (batching()) {
+            bool success = true;
+            if (batch_.full()) {
+                success = flush_batch();
+            }
+            return batch_.queue(data, size) && success;
+        }
+
+        ssize_t sent =
+            sendto(socket_, data, size, 0, (struct sockaddr*)&dest_addr_, sizeof(dest_addr_));
+        return sent == static_cast<ssize_t>(size);
+    }
+
+    bool batching() const {
+        return batch_packets_ > 1;
+    }
+
+    bool flush_batch() {
+        const size_t queued = batch_.queued();
+        return batch_.flush(socket_, (struct sockaddr*)&dest_addr_, sizeof(dest_addr_)) == queued;
+    }
+
     std::string host_;
     uint16_t port_;
     uint32_t payload_size_;
@@ -132,7 +538,43 @@ private:
     struct sockaddr_in dest_addr_;
     std::atomic<bool> active_;
     std::unique_ptr<RtpPacket> packet_;
-    uint64_t samples_sent_{0};
+    bool talkspurt_start_{true};  // Marker on the first packet and the first after DTX silence
+
+    // Read by RTCP from its own thread
+    std::atomic<uint64_t> packets_sent_{0};
+    std::atomic<uint64_t> octets_sent_{0};
+    std::atomic<uint64_t> frames_dropped_{0};
+    std::atomic<uint64_t> last_sent_{0};  // RTP timestamp << 32 | send time in us, 0 if none
+
+    RtpPacketizer packetizer_;
+    std::vector<float> silence_;  // One frame, to pad the last partial frame before a gap
+    uint32_t sample_rate_{SAMPLING_RATE};
+    uint32_t ptime_ms_{0};
+    uint32_t mtu_{1500};
+
+    AudioCodecType codec_type_{AudioCodecType::L16};
+    EdgeVoxOpusConfig opus_config_;
+    std::unique_ptr<AudioCodec> codec_;
+    uint32_t rtp_clock_rate_{SAMPLING_RATE};
+    uint32_t timestamp_scale_{1};  // RTP clock ticks per sample
+    bool dither_{false};
+
+    RtpFecEncoder fec_;
+    RtpFecConfig fec_config_;
+    RtpRetransmitter rtx_;
+    RtpRtxConfig rtx_config_;
+    std::vector<uint8_t> rtx_buffer_;
+
+    // NACKed sequence numbers, queued by the RTCP thread for the sending thread
+    std::mutex nack_mutex_;
+    std::vector<uint16_t> pending_nacks_;
+    std::vector<uint16_t> serving_nacks_;  // Sending thread only
+    std::atomic<bool> nacks_pending_{false};
+
+    std::vector<uint8_t> packet_buffer_;  // One datagram, reused for every unbatched send
+    UdpBatchSender batch_;
+    size_t batch_packets_{0};
+    bool batch_gso_{false};
 };
 
 EdgeVoxRtpStreamer::EdgeVoxRtpStreamer() : pimpl_(std::make_unique<Impl>()) {}
@@ -142,6 +584,26 @@ bool EdgeVoxRtpStreamer::init(const std::string& host, uint16_t port, uint32_t p
     return pimpl_->init(host, port, payload_size);
 }
 
+bool EdgeVoxRtpStreamer::set_packetization(uint32_t sample_rate, uint32_t ptime_ms, uint32_t mtu) {
+    return pimpl_->set_packetization(sample_rate, ptime_ms, mtu);
+}
+
+bool EdgeVoxRtpStreamer::set_batching(size_t max_packets, bool use_gso) {
+    return pimpl_->set_batching(max_packets, use_gso);
+}
+
+bool EdgeVoxRtpStreamer::set_fec(const RtpFecConfig& config) {
+    return pimpl_->set_fec(config);
+}
+
+bool EdgeVoxRtpStreamer::set_retransmission(const RtpRtxConfig& config) {
+    return pimpl_->set_retransmission(config);
+}
+
+void EdgeVoxRtpStreamer::handle_nack(uint32_t media_ssrc, const uint16_t* seqs, size_t count) {
+    pimpl_->handle_nack(media_ssrc, seqs, count);
+}
+
 bool EdgeVoxRtpStreamer::start() {
     return pimpl_->start();
 }
@@ -151,9 +613,54 @@ void EdgeVoxRtpStreamer::stop() {
 }
 
 bool EdgeVoxRtpStreamer::send_audio(const std::vector<float>& samples) {
-    return pimpl_->send_audio(samples);
+    return pimpl_->send_audio(samples.data(), samples.size());
+}
+
+bool EdgeVoxRtpStreamer::send_audio(const float* samples, size_t count) {
+    return pimpl_->send_audio(samples, count);
+}
+
+bool EdgeVoxRtpStreamer::send_encoded(const uint8_t* payload, size_t frame_bytes, size_t frames,
+                                      uint32_t samples_per_frame) {
+    return pimpl_->send_encoded(payload, frame_bytes, frames, samples_per_frame);
+}
+
+bool EdgeVoxRtpStreamer::set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus) {
+    return pimpl_->set_codec(codec, opus);
+}
+
+void EdgeVoxRtpStreamer::set_dither(bool enabled) {
+    pimpl_->set_dither(enabled);
+}
+
+void EdgeVoxRtpStreamer::skip_samples(uint32_t count) {
+    pimpl_->skip_samples(count);
+}
+
+void EdgeVoxRtpStreamer::start_talkspurt() {
+    pimpl_->start_talkspurt();
 }
 
 bool EdgeVoxRtpStreamer::is_active() const {
     return pimpl_->is_active();
 }
+
+UdpBatchStats EdgeVoxRtpStreamer::get_batch_stats() const {
+    return pimpl_->get_batch_stats();
+}
+
+RtpFecStats EdgeVoxRtpStreamer::get_fec_stats() const {
+    return pimpl_->get_fec_stats();
+}
+
+RtpRtxStats EdgeVoxRtpStreamer::get_rtx_stats() const {
+    return pimpl_->get_rtx_stats();
+}
+
+uint64_t EdgeVoxRtpStreamer::get_dropped_frames() const {
+    return pimpl_->get_dropped_frames();
+}
+
+bool EdgeVoxRtpStreamer::get_sender_info(RtcpSenderInfo& info) const {
+    return pimpl_->get_sender_info(info);
+}
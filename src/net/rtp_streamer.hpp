@@ -3,16 +3,66 @@
 #include <string>
 #include <vector>
 
+#include "edge_vox/audio/audio_config.hpp"
+#include "rtcp_packet.hpp"
+#include "rtp_fec.hpp"
+#include "rtp_retransmitter.hpp"
+#include "udp_batch_sender.hpp"
+
 class EdgeVoxRtpStreamer {
 public:
     EdgeVoxRtpStreamer();
     ~EdgeVoxRtpStreamer();
 
     bool init(const std::string& host, uint16_t port, uint32_t payload_size);
+
+    // Emit fixed-duration frames of ptime_ms (or payload_size bytes when ptime_ms is 0),
+    // never exceeding mtu bytes per datagram. Defaults: 48 kHz, payload_size budget, 1500.
+    bool set_packetization(uint32_t sample_rate, uint32_t ptime_ms, uint32_t mtu);
+    // Queue up to max_packets datagrams per send_audio() call and send them with one syscall
+    // (sendmmsg, or UDP GSO if use_gso and the kernel supports it). 0 or 1 disables batching.
+    bool set_batching(size_t max_packets, bool use_gso);
+    // Payload format of send_audio() frames and the RTP payload type; L16 by default. Fails if
+    // the codec isn't built in or the current frame size doesn't suit it (ADPCM needs an even
+    // sample count, Opus frames of 2.5, 5, 10, 20, 40 or 60 ms). Opus settings are ignored by
+    // the other codecs.
+    bool set_codec(AudioCodecType codec, const EdgeVoxOpusConfig& opus = {});
+    // Send an XOR parity packet per config.group_size media packets (RFC 5109, on an SSRC of
+    // its own), so the receiver can rebuild one lost packet per group. Media frames shrink by
+    // the 14 bytes of FEC headers to keep parity packets within the MTU. group_size 0
+    // disables it.
+    bool set_fec(const RtpFecConfig& config);
+    // Keep the packets of the last config.history_ms so handle_nack() can resend them as RTX
+    // (RFC 4588) within config.max_bitrate. Media frames shrink by the 2-byte RTX header.
+    bool set_retransmission(const RtpRtxConfig& config);
     bool start();
     void stop();
-    bool send_audio(const std::vector<float>& samples);
+    bool send_audio(const std::vector<float>& samples);  // Queues leftovers for the next call
+    bool send_audio(const float* samples, size_t count);
+
+    // Send frames already encoded by the caller, frame_bytes each and back to back in payload,
+    // each covering samples_per_frame samples of the RTP clock. The payload is handed to the
+    // kernel through an iovec next to the header and never copied.
+    bool send_encoded(const uint8_t* payload, size_t frame_bytes, size_t frames,
+                      uint32_t samples_per_frame);
+    void set_dither(bool enabled);      // TPDF dither before quantizing to 16 bits or G.711
+    void skip_samples(uint32_t count);  // Advance the RTP clock over samples lost before sending
+    void start_talkspurt();             // Set the marker bit on the next packet, e.g. after VAD
+    // Generic NACK from RTCP, safe to call from any thread. The packets go out ahead of the
+    // next frame sent; requests about other SSRCs are ignored.
+    void handle_nack(uint32_t media_ssrc, const uint16_t* seqs, size_t count);
     bool is_active() const;
+    UdpBatchStats get_batch_stats() const;  // Call from the sending thread
+    RtpFecStats get_fec_stats() const;      // Parity overhead; call from the sending thread
+    RtpRtxStats get_rtx_stats() const;      // Retransmissions; call from the sending thread
+
+    // Frames that never went out because they couldn't be encoded, didn't fit a datagram or
+    // the socket refused them; their time still passes on the RTP clock. Any thread.
+    uint64_t get_dropped_frames() const;
+
+    // Sender report fields for the current instant, safe to call from any thread. Returns
+    // false (with only ssrc set) until the first packet has been sent.
+    bool get_sender_info(RtcpSenderInfo& info) const;
 
 private:
     class Impl;
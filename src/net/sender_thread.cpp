@@ -0,0 +1,355 @@
+#include "net/sender_thread.hpp"
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "net/packet_buffer.hpp"
+
+namespace {
+constexpr size_t CHUNK_SAMPLES = 256;  // Per queue slot; larger pushes take several
+constexpr size_t MIN_PUSH = 128;       // Smallest push the queue has enough slots for
+constexpr int POLL_TIMEOUT_MS = 100;   // How quickly the thread notices stop() on its own
+
+// Leads every queued chunk
+struct ChunkHeader {
+    uint64_t index;     // Of the first sample, counting everything ever pushed
+    int64_t queued_ns;  // Steady clock when it was pushed
+    bool talkspurt;     // First audio after a silence
+};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Histogram bucket n holds [2^(n-1), 2^n) us, bucket 0 everything under 1 us
+size_t latency_bucket(uint64_t us) {
+    size_t bucket = 0;
+    while (us > 0 && bucket < EdgeVoxSenderStats::HISTOGRAM_SIZE - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+}  // namespace
+
+class EdgeVoxSenderThread::Impl {
+public:
+    Impl() : event_fd_(-1), active_(false), running_(false) {}
+
+    ~Impl() {
+        stop();
+        if (event_fd_ >= 0) {
+            close(event_fd_);
+        }
+    }
+
+    bool start(const SenderThreadConfig& config, SendFunction send) {
+        if (active_) {
+            return true;
+        }
+        if (!send || config.sample_rate == 0) {
+            return false;
+        }
+
+        config_ = config;
+        send_ = std::move(send);
+        max_queued_ = static_cast<uint64_t>(config.sample_rate) * config.queue_ms / 1000;
+        if (max_queued_ < CHUNK_SAMPLES) {
+            max_queued_ = CHUNK_SAMPLES;
+        }
+
+        // Slots for the whole bound even in small pushes. Dropping the oldest happens on the
+        // consumer side, so then the queue must hold more than the bound to have anything to trim.
+        const uint64_t slots = (max_queued_ + MIN_PUSH - 1) / MIN_PUSH *
+                                   (config.drop_policy == SenderDropPolicy::Oldest ? 2 : 1) +
+                               1;
+        queue_ = std::make_unique<PacketSlotBuffer>(
+            static_cast<size_t>(slots), sizeof(ChunkHeader) + CHUNK_SAMPLES * sizeof(float));
+
+        // Kept open across restarts, so a late push() never writes to a closed descriptor
+        if (event_fd_ < 0) {
+            event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (event_fd_ < 0) {
+                return false;
+            }
+        }
+
+        produced_ = 0;
+        consumed_ = 0;
+        next_index_ = 0;
+        dropped_chunks_ = 0;
+        dropped_samples_ = 0;
+        pending_talkspurt_ = false;
+        expected_index_ = 0;
+        trimmed_talkspurt_ = false;
+        chunks_ = 0;
+        samples_ = 0;
+        wakeups_ = 0;
+        max_queued_seen_ = 0;
+        max_latency_us_ = 0;
+        for (auto& bucket : latency_us_) {
+            bucket = 0;
+        }
+        realtime_ = false;
+        pinned_ = false;
+
+        running_ = true;
+        thread_ = std::thread(&Impl::run, this);
+        active_ = true;
+        return true;
+    }
+
+    void stop() {
+        active_ = false;
+        running_ = false;
+        if (thread_.joinable()) {
+            wake();
+            thread_.join();
+        }
+    }
+
+    bool is_active() const {
+        return active_;
+    }
+
+    bool push(const float* samples, size_t count, uint64_t skipped, bool talkspurt) {
+        if (!active_ || count == 0) {
+            return false;
+        }
+        next_index_ += skipped;
+
+        // A talkspurt start that gets dropped moves on to the first audio that doesn't
+        bool mark = talkspurt || pending_talkspurt_;
+        pending_talkspurt_ = false;
+
+        // Refusing the newest: the whole push goes, or none of it
+        if (config_.drop_policy == SenderDropPolicy::Newest &&
+            produced_.load(std::memory_order_relaxed) - consumed_.load(std::memory_order_acquire) +
+                    count >
+                max_queued_) {
+            drop(count);
+            next_index_ += count;
+            pending_talkspurt_ = mark;
+            return false;
+        }
+
+        bool queued_all = true;
+        while (count > 0) {
+            const size_t n = count < CHUNK_SAMPLES ? count : CHUNK_SAMPLES;
+            const ChunkHeader header{next_index_, now_ns(), mark};
+            const bool queued = queue_->emplace([&](uint8_t* slot, size_t) {
+                std::memcpy(slot, &header, sizeof(header));
+                std::memcpy(slot + sizeof(header), samples, n * sizeof(float));
+                return sizeof(header) + n * sizeof(float);
+            });
+
+            // Out of slots is a drop under either policy: only the consumer may free one
+            if (queued) {
+                produced_.fetch_add(n, std::memory_order_release);
+                mark = false;
+            } else {
+                drop(n);
+                queued_all = false;
+            }
+            next_index_ += n;
+            samples += n;
+            count -= n;
+        }
+        pending_talkspurt_ = mark;
+
+        wake();
+        return queued_all;
+    }
+
+    // Lock-free, so polling never holds up a real-time sender thread
+    EdgeVoxSenderStats get_stats() const {
+        EdgeVoxSenderStats stats;
+        stats.chunks = chunks_.load(std::memory_order_relaxed);
+        stats.samples = samples_.load(std::memory_order_relaxed);
+        stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+        stats.dropped_chunks = dropped_chunks_.load(std::memory_order_relaxed);
+        stats.dropped_samples = dropped_samples_.load(std::memory_order_relaxed);
+        stats.max_queued = max_queued_seen_.load(std::memory_order_relaxed);
+        stats.max_latency_us = max_latency_us_.load(std::memory_order_relaxed);
+        stats.realtime = realtime_.load(std::memory_order_relaxed);
+        stats.pinned = pinned_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < stats.latency_us.size(); i++) {
+            stats.latency_us[i] = latency_us_[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    // Either side: account for samples that never reach the send function
+    void drop(size_t count) {
+        dropped_chunks_.fetch_add(1, std::memory_order_relaxed);
+        dropped_samples_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void wake() {
+        const uint64_t one = 1;
+        if (event_fd_ >= 0) {
+            [[maybe_unused]] const ssize_t written = write(event_fd_, &one, sizeof(one));
+        }
+    }
+
+    void run() {
+        set_scheduling();
+
+        while (running_) {
+            pollfd fd{event_fd_, POLLIN, 0};
+            if (poll(&fd, 1, POLL_TIMEOUT_MS) <= 0 || !(fd.revents & POLLIN)) {
+                continue;
+            }
+
+            uint64_t events = 0;
+            [[maybe_unused]] const ssize_t size = read(event_fd_, &events, sizeof(events));
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+            drain();
+        }
+
+        // Whatever is left is dropped; the next start() begins with an empty queue
+        queue_->clear();
+    }
+
+    void drain() {
+        const uint64_t queued = produced_.load(std::memory_order_acquire) - consumed_;
+        if (queued > max_queued_seen_.load(std::memory_order_relaxed)) {
+            max_queued_seen_.store(queued, std::memory_order_relaxed);
+        }
+
+        size_t len = 0;
+        while (running_) {
+            const uint8_t* slot = queue_->front(len);
+            if (slot == nullptr) {
+                break;
+            }
+
+            ChunkHeader header;
+            std::memcpy(&header, slot, sizeof(header));
+            const auto* samples = reinterpret_cast<const float*>(slot + sizeof(header));
+            const size_t count = (len - sizeof(header)) / sizeof(float);
+
+            // Dropping the oldest: skip queued audio until what remains fits the bound
+            const bool trim = config_.drop_policy == SenderDropPolicy::Oldest &&
+                              produced_.load(std::memory_order_acquire) - consumed_ > max_queued_;
+            if (trim) {
+                trimmed_talkspurt_ = trimmed_talkspurt_ || header.talkspurt;
+            } else {
+                send_(samples, count, header.index - expected_index_,
+                      header.talkspurt || trimmed_talkspurt_);
+                expected_index_ = header.index + count;
+                trimmed_talkspurt_ = false;
+            }
+
+            queue_->release();
+            consumed_.fetch_add(count, std::memory_order_release);
+
+            if (trim) {
+                drop(count);
+                continue;
+            }
+
+            const int64_t latency_ns = now_ns() - header.queued_ns;
+            const uint64_t latency_us = latency_ns > 0 ? static_cast<uint64_t>(latency_ns) / 1000
+                                                       : 0;
+            chunks_.fetch_add(1, std::memory_order_relaxed);
+            samples_.fetch_add(count, std::memory_order_relaxed);
+            if (latency_us > max_latency_us_.load(std::memory_order_relaxed)) {
+                max_latency_us_.store(latency_us, std::memory_order_relaxed);
+            }
+            latency_us_[latency_bucket(latency_us)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Best effort: without the privileges the thread just runs as it was created
+    void set_scheduling() {
+        bool realtime = false;
+        if (config_.priority > 0) {
+            sched_param param{};
+            param.sched_priority = config_.priority;
+            realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+        }
+
+        bool pinned = false;
+        if (config_.cpu >= 0 && config_.cpu < CPU_SETSIZE) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(config_.cpu, &cpus);
+            pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+        }
+
+        realtime_.store(realtime, std::memory_order_relaxed);
+        pinned_.store(pinned, std::memory_order_relaxed);
+    }
+
+    SenderThreadConfig config_;
+    SendFunction send_;
+    uint64_t max_queued_{0};  // In samples
+    std::unique_ptr<PacketSlotBuffer> queue_;
+    int event_fd_;
+    std::atomic<bool> active_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    // Samples queued and taken off the queue; the difference is the backlog
+    std::atomic<uint64_t> produced_{0};
+    std::atomic<uint64_t> consumed_{0};
+
+    // Producer only
+    uint64_t next_index_{0};
+    bool pending_talkspurt_{false};
+
+    // Dropped by push() or trimmed by the sender thread
+    std::atomic<uint64_t> dropped_chunks_{0};
+    std::atomic<uint64_t> dropped_samples_{0};
+
+    // Sender thread only
+    uint64_t expected_index_{0};
+    bool trimmed_talkspurt_{false};
+
+    // Written by the sender thread alone, read by get_stats() from any thread
+    std::atomic<uint64_t> chunks_{0};
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> max_queued_seen_{0};
+    std::atomic<uint64_t> max_latency_us_{0};
+    std::array<std::atomic<uint64_t>, EdgeVoxSenderStats::HISTOGRAM_SIZE> latency_us_{};
+    std::atomic<bool> realtime_{false};
+    std::atomic<bool> pinned_{false};
+};
+
+EdgeVoxSenderThread::EdgeVoxSenderThread() : pimpl_(std::make_unique<Impl>()) {}
+EdgeVoxSenderThread::~EdgeVoxSenderThread() = default;
+
+bool EdgeVoxSenderThread::start(const SenderThreadConfig& config, SendFunction send) {
+    return pimpl_->start(config, std::move(send));
+}
+
+void EdgeVoxSenderThread::stop() {
+    pimpl_->stop();
+}
+
+bool EdgeVoxSenderThread::is_active() const {
+    return pimpl_->is_active();
+}
+
+bool EdgeVoxSenderThread::push(const float* samples, size_t count, uint64_t skipped,
+                               bool talkspurt) {
+    return pimpl_->push(samples, count, skipped, talkspurt);
+}
+
+EdgeVoxSenderStats EdgeVoxSenderThread::get_stats() const {
+    return pimpl_->get_stats();
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "edge_vox/net/rtp_stats.hpp"
+
+// What to give up when the network can't keep up with capture
+enum class SenderDropPolicy {
+    Newest,  // Refuse new audio: what was queued goes out intact, but late
+    Oldest,  // Discard queued audio: the stream stays close to real time
+};
+
+struct SenderThreadConfig {
+    uint32_t sample_rate{48000};
+    uint32_t queue_ms{200};  // Audio that may wait before the drop policy applies
+    SenderDropPolicy drop_policy{SenderDropPolicy::Oldest};
+    int priority{0};  // SCHED_FIFO priority (1-99); 0 keeps the normal scheduler
+    int cpu{-1};      // CPU to pin the thread to; -1 lets it run anywhere
+};
+
+//
+// Moves captured audio off the audio device thread onto a thread of its own that does the
+// sending, so a slow sendto never stalls capture or anything else sharing a thread with it.
+// push() copies samples into a preallocated single-producer queue and signals an eventfd;
+// the thread wakes on it and hands each chunk to the send function in order.
+//
+class EdgeVoxSenderThread {
+public:
+    // Runs on the sender thread. gap is the number of samples dropped just before these, for
+    // the RTP clock to skip; talkspurt marks the first audio after a silence.
+    using SendFunction =
+        std::function<void(const float* samples, size_t count, uint64_t gap, bool talkspurt)>;
+
+    EdgeVoxSenderThread();
+    ~EdgeVoxSenderThread();
+
+    // Fails if the eventfd or thread can't be created. Priority and affinity are best effort
+    // (SCHED_FIFO usually needs CAP_SYS_NICE); get_stats() says whether they took.
+    bool start(const SenderThreadConfig& config, SendFunction send);
+    void stop();  // Drops whatever is still queued
+    bool is_active() const;
+
+    // Capture side, one thread only: queue samples and wake the sender. Never blocks, locks or
+    // allocates. Returns false if (part of) the samples were dropped. skipped counts samples
+    // dropped upstream just before these; it is added to the gap the send function sees.
+    // talkspurt is passed on with the first of these samples that gets sent.
+    bool push(const float* samples, size_t count, uint64_t skipped = 0, bool talkspurt = false);
+
+    EdgeVoxSenderStats get_stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
@@ -0,0 +1,205 @@
+#include "net/udp_batch_sender.hpp"
+
+#include <netinet/udp.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace {
+// Largest UDP payload a single GSO send may carry
+constexpr size_t GSO_MAX_BYTES = 65507;
+}  // namespace
+
+UdpBatchSender::UdpBatchSender() {
+    configure(1, 1500, false);
+}
+
+void UdpBatchSender::configure(size_t max_packets, size_t max_packet_size, bool use_gso) {
+    max_packets_ = std::min(std::max<size_t>(max_packets, 1), MAX_BATCH);
+    max_packet_size_ = max_packet_size;
+    use_gso_ = use_gso;
+
+    count_ = 0;
+    slab_.assign(max_packets_ * max_packet_size_, 0);
+    lengths_.assign(max_packets_, 0);
+    iovecs_.assign(max_packets_ * 2, iovec{});
+    iovec_counts_.assign(max_packets_, 0);
+    gso_iovecs_.assign(max_packets_ * 2, iovec{});
+    messages_.assign(max_packets_, mmsghdr{});
+}
+
+bool UdpBatchSender::queue(const uint8_t* data, size_t len) {
+    uint8_t* next = slot();
+    if (!next || len > max_packet_size_) {
+        return false;
+    }
+
+    memcpy(next, data, len);
+    return commit(len);
+}
+
+uint8_t* UdpBatchSender::slot() {
+    return full() ? nullptr : &slab_[count_ * max_packet_size_];
+}
+
+bool UdpBatchSender::commit(size_t len) {
+    if (full() || len > max_packet_size_) {
+        return false;
+    }
+
+    lengths_[count_] = len;
+    iovecs_[count_ * 2].iov_base = &slab_[count_ * max_packet_size_];
+    iovecs_[count_ * 2].iov_len = len;
+    iovec_counts_[count_] = 1;
+    count_++;
+    return true;
+}
+
+bool UdpBatchSender::queue_gather(const uint8_t* header, size_t header_len, const uint8_t* payload,
+                                  size_t payload_len) {
+    uint8_t* next = slot();
+    if (!next || header_len + payload_len > max_packet_size_) {
+        return false;
+    }
+
+    memcpy(next, header, header_len);
+    lengths_[count_] = header_len + payload_len;
+    iovecs_[count_ * 2].iov_base = next;
+    iovecs_[count_ * 2].iov_len = header_len;
+    iovecs_[count_ * 2 + 1].iov_base = const_cast<uint8_t*>(payload);
+    iovecs_[count_ * 2 + 1].iov_len = payload_len;
+    iovec_counts_[count_] = 2;
+    count_++;
+    return true;
+}
+
+size_t UdpBatchSender::flush(int fd, const struct sockaddr* addr, socklen_t addr_len) {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    stats_.flushes++;
+
+    size_t sent = 0;
+    if (use_gso_ && can_segment()) {
+        sent = send_segmented(fd, addr, addr_len);
+    }
+    if (sent == 0) {
+        sent = send_multiple(fd, addr, addr_len);
+    }
+
+    stats_.packets += sent;
+    count_ = 0;
+    return sent;
+}
+
+bool UdpBatchSender::can_segment() const {
+    if (count_ < 2) {
+        return false;
+    }
+
+    // Every segment but the last must be exactly gso_size bytes
+    const size_t segment = lengths_[0];
+    size_t total = 0;
+    for (size_t i = 0; i < count_; i++) {
+        if ((i + 1 < count_ && lengths_[i] != segment) || lengths_[i] > segment) {
+            return false;
+        }
+        total += lengths_[i];
+    }
+
+    return total <= GSO_MAX_BYTES;
+}
+
+size_t UdpBatchSender::send_segmented(int fd, const struct sockaddr* addr, socklen_t addr_len) {
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+
+    // The kernel concatenates the iovecs and cuts the result into gso_size segments
+    size_t iovec_count = 0;
+    for (size_t i = 0; i < count_; i++) {
+        for (size_t j = 0; j < iovec_counts_[i]; j++) {
+            gso_iovecs_[iovec_count++] = iovecs_[i * 2 + j];
+        }
+    }
+
+    struct msghdr msg {};
+    msg.msg_name = const_cast<struct sockaddr*>(addr);
+    msg.msg_namelen = addr_len;
+    msg.msg_iov = gso_iovecs_.data();
+    msg.msg_iovlen = iovec_count;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t gso_size = static_cast<uint16_t>(lengths_[0]);
+    memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+    ssize_t result = sendmsg(fd, &msg, 0);
+    if (result < 0) {
+        // Kernel or device without UDP GSO: stop trying and use sendmmsg from now on
+        if (errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP || errno == EIO) {
+            use_gso_ = false;
+        } else {
+            stats_.errors++;
+        }
+        return 0;
+    }
+
+    record_syscall(count_, true);
+    return count_;
+}
+
+size_t UdpBatchSender::send_multiple(int fd, const struct sockaddr* addr, socklen_t addr_len) {
+    for (size_t i = 0; i < count_; i++) {
+        struct msghdr& hdr = messages_[i].msg_hdr;
+        hdr = msghdr{};
+        hdr.msg_name = const_cast<struct sockaddr*>(addr);
+        hdr.msg_namelen = addr_len;
+        hdr.msg_iov = &iovecs_[i * 2];
+        hdr.msg_iovlen = iovec_counts_[i];
+        messages_[i].msg_len = 0;
+    }
+
+    // sendmmsg may accept only part of the batch; keep going until done or an error
+    size_t sent = 0;
+    while (sent < count_) {
+        int result = sendmmsg(fd, &messages_[sent], count_ - sent, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            stats_.errors++;
+            break;
+        }
+
+        record_syscall(result, false);
+        sent += result;
+        if (result == 0) {
+            break;
+        }
+    }
+
+    return sent;
+}
+
+void UdpBatchSender::record_syscall(size_t packets, bool gso) {
+    stats_.syscalls++;
+    if (gso) {
+        stats_.gso_syscalls++;
+    }
+    stats_.last_packets_per_syscall = static_cast<uint32_t>(packets);
+    stats_.packets_per_syscall[std::min(packets, UdpBatchStats::HISTOGRAM_SIZE - 1)]++;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct UdpBatchStats {
+    static constexpr size_t HISTOGRAM_SIZE = 65;
+
+    uint64_t flushes = 0;
+    uint64_t syscalls = 0;
+    uint64_t packets = 0;
+    uint64_t gso_syscalls = 0;  // Syscalls that used UDP_SEGMENT
+    uint64_t errors = 0;
+    uint32_t last_packets_per_syscall = 0;
+    // packets_per_syscall[n]: number of syscalls that carried n packets
+    std::array<uint64_t, HISTOGRAM_SIZE> packets_per_syscall{};
+};
+
+//
+// Queues datagrams for one destination and sends them with as few syscalls as possible: one
+// sendmsg with UDP generic segmentation offload when all packets but the last share a size,
+// otherwise sendmmsg. Packets are either built in preallocated slots or gathered from a header
+// and an external payload without copying the payload. Not thread safe.
+//
+class UdpBatchSender {
+public:
+    static constexpr size_t MAX_BATCH = 64;  // Kernel limit for UDP GSO segments
+
+    UdpBatchSender();
+
+    // Drops anything queued. max_packets is clamped to [1, MAX_BATCH].
+    void configure(size_t max_packets, size_t max_packet_size, bool use_gso);
+
+    // Copy a datagram into the batch; false if the batch is full or the packet too large
+    bool queue(const uint8_t* data, size_t len);
+
+    // Build a datagram in place: slot() returns the next free max_packet_size() bytes (nullptr
+    // when full) and commit() appends the first len bytes of it to the batch
+    uint8_t* slot();
+    bool commit(size_t len);
+
+    // Queue a datagram as two iovec entries: the header is copied into the next slot, the
+    // payload is only referenced and must stay valid until flush()
+    bool queue_gather(const uint8_t* header, size_t header_len, const uint8_t* payload,
+                      size_t payload_len);
+
+    size_t max_packet_size() const {
+        return max_packet_size_;
+    }
+
+    size_t queued() const {
+        return count_;
+    }
+
+    bool full() const {
+        return count_ >= max_packets_;
+    }
+
+    // Drop queued packets without sending them
+    void clear() {
+        count_ = 0;
+    }
+
+    // Send everything queued to addr. Returns the number of packets the kernel accepted;
+    // the batch is emptied either way.
+    size_t flush(int fd, const struct sockaddr* addr, socklen_t addr_len);
+
+    bool gso_enabled() const {
+        return use_gso_;
+    }
+
+    const UdpBatchStats& stats() const {
+        return stats_;
+    }
+
+private:
+    bool can_segment() const;
+    size_t send_segmented(int fd, const struct sockaddr* addr, socklen_t addr_len);
+    size_t send_multiple(int fd, const struct sockaddr* addr, socklen_t addr_len);
+    void record_syscall(size_t packets, bool gso);
+
+    size_t max_packets_ = 1;
+    size_t max_packet_size_ = 0;
+    bool use_gso_ = false;
+
+    size_t count_ = 0;
+    std::vector<uint8_t> slab_;  // max_packets_ slots of max_packet_size_ bytes
+    std::vector<size_t> lengths_;
+    std::vector<struct iovec> iovecs_;  // Two entries per packet, the second unused if in-slot
+    std::vector<size_t> iovec_counts_;
+    std::vector<struct iovec> gso_iovecs_;  // iovecs_ compacted for a single sendmsg
+    std::vector<struct mmsghdr> messages_;
+
+    UdpBatchStats stats_;
+};
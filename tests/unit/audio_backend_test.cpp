@@ -0,0 +1,374 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <edge_vox/audio/audio_async.hpp>
+#include <edge_vox/audio/file_audio_backend.hpp>
+#include <edge_vox/audio/synthetic_audio_backend.hpp>
+#include <fstream>
+#include <thread>
+
+#define AUDIO_SAMPLE_RATE 16000
+
+class AudioBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        wav_path = testing::TempDir() + "edge_vox_backend_test.wav";
+        raw_path = testing::TempDir() + "edge_vox_backend_test.raw";
+    }
+
+    void TearDown() override {
+        std::remove(wav_path.c_str());
+        std::remove(raw_path.c_str());
+    }
+
+    static void write_le(std::ofstream& out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    // Write a 16-bit PCM WAV file with the given interleaved samples
+    void write_wav(const std::string& path, const std::vector<int16_t>& samples, int sample_rate,
+                   int channels) {
+        std::ofstream out(path, std::ios::binary);
+        const uint32_t data_size = samples.size() * 2;
+
+        out.write("RIFF", 4);
+        write_le(out, 36 + data_size, 4);
+        out.write("WAVE", 4);
+        out.write("fmt ", 4);
+        write_le(out, 16, 4);
+        write_le(out, 1, 2);  // PCM
+        write_le(out, channels, 2);
+        write_le(out, sample_rate, 4);
+        write_le(out, sample_rate * channels * 2, 4);
+        write_le(out, channels * 2, 2);
+        write_le(out, 16, 2);
+        out.write("data", 4);
+        write_le(out, data_size, 4);
+        for (int16_t s : samples) {
+            write_le(out, static_cast<uint16_t>(s), 2);
+        }
+    }
+
+    // Wait until the capture buffer holds at least count samples
+    static bool wait_for_samples(audio_async& audio, size_t count) {
+        auto start = std::chrono::steady_clock::now();
+        while (audio.get_available() < count) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    std::string wav_path;
+    std::string raw_path;
+};
+
+TEST_F(AudioBackendTest, SyntheticSineCapture) {
+    SyntheticAudioConfig config;
+    config.frequency = 1000.0f;
+    config.amplitude = 0.5f;
+    config.pacing = AudioPacing::RealTime;
+
+    audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+    ASSERT_TRUE(audio.resume());
+    ASSERT_TRUE(wait_for_samples(audio, 1600));
+
+    std::vector<float> samples(1600);
+    ASSERT_EQ(audio.read_new(samples.size(), samples.data()), samples.size());
+
+    // 1 kHz at 16 kHz: 16 samples per period, first sample at phase 0
+    EXPECT_NEAR(samples[0], 0.0f, 1e-6);
+    EXPECT_NEAR(samples[4], 0.5f, 1e-4);
+    EXPECT_NEAR(samples[20], 0.5f, 1e-4);
+
+    float peak = 0.0f;
+    for (float s : samples) {
+        peak = std::max(peak, std::abs(s));
+    }
+    EXPECT_NEAR(peak, 0.5f, 1e-4);
+
+    EXPECT_TRUE(audio.pause());
+    EXPECT_TRUE(audio.close());
+}
+
+TEST_F(AudioBackendTest, DestroyedWhileCapturing) {
+    // The worker must be stopped before the derived backend it calls into goes away
+    for (int i = 0; i < 20; i++) {
+        SyntheticAudioConfig config;
+        config.pacing = AudioPacing::AsFastAsPossible;
+        auto backend = std::make_unique<SyntheticAudioBackend>(config);
+
+        std::atomic<int> callbacks{0};
+        AudioBackendSpec requested;
+        requested.sample_rate = AUDIO_SAMPLE_RATE;
+        requested.frames_per_buffer = 64;
+        AudioBackendSpec obtained;
+        ASSERT_TRUE(backend->open(
+            AudioDirection::Capture, -1, requested, obtained,
+            [](void* userdata, uint8_t*, int) { ++*static_cast<std::atomic<int>*>(userdata); },
+            &callbacks));
+        backend->pause(AudioDirection::Capture, false);
+        while (callbacks == 0) {
+            std::this_thread::yield();
+        }
+        backend.reset();
+    }
+}
+
+TEST_F(AudioBackendTest, SyntheticNoiseIsReproducible) {
+    SyntheticAudioConfig config;
+    config.waveform = SyntheticAudioConfig::Waveform::WhiteNoise;
+    config.seed = 42;
+    config.pacing = AudioPacing::RealTime;  // Keep the 1s history from wrapping
+
+    std::vector<float> runs[2];
+    for (auto& run : runs) {
+        audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+        ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+        ASSERT_TRUE(audio.resume());
+        ASSERT_TRUE(wait_for_samples(audio, 1024));
+
+        run.resize(1024);
+        ASSERT_EQ(audio.read_new(run.size(), run.data()), run.size());
+        audio.pause();
+        audio.close();
+    }
+
+    EXPECT_EQ(runs[0], runs[1]);
+}
+
+TEST_F(AudioBackendTest, WavFileReplaysExactly) {
+    std::vector<int16_t> pcm(5000);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = static_cast<int16_t>((i * 37) % 20000 - 10000);
+    }
+    write_wav(wav_path, pcm, 8000, 1);
+
+    FileAudioConfig config;
+    config.path = wav_path;
+    config.pacing = AudioPacing::AsFastAsPossible;
+    auto backend = std::make_unique<FileAudioBackend>(config);
+    auto* file_backend = backend.get();
+
+    // The stream runs at the file's rate, not the requested one
+    audio_async audio(2000, std::move(backend));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+    ASSERT_TRUE(audio.resume());
+    ASSERT_TRUE(wait_for_samples(audio, pcm.size()));
+    EXPECT_TRUE(file_backend->source_exhausted());
+    EXPECT_EQ(file_backend->captured_frames(), pcm.size());
+
+    std::vector<float> samples(pcm.size() + 100);
+    ASSERT_EQ(audio.read_new(samples.size(), samples.data()), pcm.size());
+    for (size_t i = 0; i < pcm.size(); i++) {
+        ASSERT_FLOAT_EQ(samples[i], pcm[i] / 32768.0f) << "at sample " << i;
+    }
+
+    audio.pause();
+    audio.close();
+}
+
+TEST_F(AudioBackendTest, StereoWavDownmixedToMono) {
+    std::vector<int16_t> pcm = {1000, 3000, -2000, -4000, 0, 0};
+    write_wav(wav_path, pcm, AUDIO_SAMPLE_RATE, 2);
+
+    FileAudioConfig config;
+    config.path = wav_path;
+    std::vector<float> samples;
+    int sample_rate = 0;
+    int channels = 0;
+    ASSERT_TRUE(FileAudioBackend::load(config, samples, sample_rate, channels));
+    EXPECT_EQ(sample_rate, AUDIO_SAMPLE_RATE);
+    EXPECT_EQ(channels, 2);
+    EXPECT_EQ(samples.size(), 6u);
+
+    config.pacing = AudioPacing::AsFastAsPossible;
+    audio_async audio(1000, std::make_unique<FileAudioBackend>(config));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+    ASSERT_TRUE(audio.resume());
+    ASSERT_TRUE(wait_for_samples(audio, 3));
+
+    std::vector<float> mono(3);
+    ASSERT_EQ(audio.read_new(mono.size(), mono.data()), 3u);
+    EXPECT_FLOAT_EQ(mono[0], 2000 / 32768.0f);
+    EXPECT_FLOAT_EQ(mono[1], -3000 / 32768.0f);
+    EXPECT_FLOAT_EQ(mono[2], 0.0f);
+
+    audio.pause();
+    audio.close();
+}
+
+TEST_F(AudioBackendTest, FourChannelWavKeepsEveryChannel) {
+    // Frame i holds 100 * (c + 1) + i on channel c
+    const size_t frames = 200;
+    std::vector<int16_t> pcm(frames * 4);
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < 4; c++) {
+            pcm[i * 4 + c] = static_cast<int16_t>(100 * (c + 1) + i);
+        }
+    }
+    write_wav(wav_path, pcm, AUDIO_SAMPLE_RATE, 4);
+
+    FileAudioConfig config;
+    config.path = wav_path;
+    config.pacing = AudioPacing::AsFastAsPossible;
+
+    // The mono ring averages the channels; every channel has its own view; the listener
+    // sees the interleaved blocks as delivered
+    std::vector<float> interleaved;
+    {
+        audio_async audio(1000, std::make_unique<FileAudioBackend>(config));
+        ASSERT_TRUE(audio.init(-1, -1, AUDIO_SAMPLE_RATE, 1));
+        EXPECT_EQ(audio.get_channels(), 4);
+        audio.set_capture_listener(
+            [&interleaved](const float* samples, size_t n) {
+                interleaved.insert(interleaved.end(), samples, samples + n);
+            },
+            true);
+        ASSERT_TRUE(audio.resume());
+        ASSERT_TRUE(wait_for_samples(audio, frames));
+
+        std::vector<float> mono(frames);
+        ASSERT_EQ(audio.read_new(mono.size(), mono.data()), frames);
+        for (size_t i = 0; i < frames; i++) {
+            ASSERT_FLOAT_EQ(mono[i], (250.0f + i) / 32768.0f) << "at frame " << i;
+        }
+
+        for (int c = 0; c < 4; c++) {
+            const CaptureView view = audio.get_channel_view(c, 1000);
+            ASSERT_EQ(view.size(), frames);
+            const float* plane = view.first;
+            ASSERT_EQ(view.first_len, frames);
+            EXPECT_FLOAT_EQ(plane[0], 100.0f * (c + 1) / 32768.0f);
+            EXPECT_FLOAT_EQ(plane[frames - 1], (100.0f * (c + 1) + frames - 1) / 32768.0f);
+            EXPECT_TRUE(audio.is_channel_view_valid(view));
+        }
+        audio.pause();
+        audio.close();
+    }
+    ASSERT_EQ(interleaved.size(), pcm.size());
+    for (size_t i = 0; i < pcm.size(); i++) {
+        ASSERT_FLOAT_EQ(interleaved[i], pcm[i] / 32768.0f) << "at sample " << i;
+    }
+
+    // One channel selected as the mono signal
+    audio_async audio(1000, std::make_unique<FileAudioBackend>(config));
+    ASSERT_TRUE(audio.init(-1, -1, AUDIO_SAMPLE_RATE, 4));
+    audio.set_capture_mix(2);
+    ASSERT_TRUE(audio.resume());
+    ASSERT_TRUE(wait_for_samples(audio, frames));
+
+    std::vector<float> mono(frames);
+    ASSERT_EQ(audio.read_new(mono.size(), mono.data()), frames);
+    for (size_t i = 0; i < frames; i++) {
+        ASSERT_FLOAT_EQ(mono[i], (300.0f + i) / 32768.0f) << "at frame " << i;
+    }
+
+    audio.pause();
+    audio.close();
+}
+
+TEST_F(AudioBackendTest, RawPcmLoad) {
+    {
+        std::ofstream out(raw_path, std::ios::binary);
+        const int16_t values[] = {0, 16384, -32768};
+        for (int16_t v : values) {
+            out.put(static_cast<char>(v & 0xFF));
+            out.put(static_cast<char>((v >> 8) & 0xFF));
+        }
+    }
+
+    FileAudioConfig config;
+    config.path = raw_path;
+    config.format = FileAudioConfig::Format::RawS16LE;
+    config.sample_rate = 48000;
+
+    std::vector<float> samples;
+    int sample_rate = 0;
+    int channels = 0;
+    ASSERT_TRUE(FileAudioBackend::load(config, samples, sample_rate, channels));
+    EXPECT_EQ(sample_rate, 48000);
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_FLOAT_EQ(samples[1], 0.5f);
+    EXPECT_FLOAT_EQ(samples[2], -1.0f);
+}
+
+TEST_F(AudioBackendTest, InvalidFilesRejected) {
+    FileAudioConfig config;
+    config.path = wav_path + ".missing";
+    audio_async audio(1000, std::make_unique<FileAudioBackend>(config));
+    EXPECT_FALSE(audio.init(-1, AUDIO_SAMPLE_RATE));
+
+    {
+        std::ofstream out(wav_path, std::ios::binary);
+        out << "definitely not a wave file";
+    }
+    config.path = wav_path;
+    std::vector<float> samples;
+    int sample_rate = 0;
+    int channels = 0;
+    EXPECT_FALSE(FileAudioBackend::load(config, samples, sample_rate, channels));
+}
+
+TEST_F(AudioBackendTest, RealTimePacing) {
+    SyntheticAudioConfig config;
+    config.pacing = AudioPacing::RealTime;
+    auto backend = std::make_unique<SyntheticAudioBackend>(config);
+    auto* synthetic = backend.get();
+
+    audio_async audio(1000, std::move(backend));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+    ASSERT_TRUE(audio.resume());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    audio.pause();
+
+    // ~4800 frames in 300ms, delivered in 1024-frame buffers
+    EXPECT_GE(synthetic->captured_frames(), 2048u);
+    EXPECT_LE(synthetic->captured_frames(), 8192u);
+    EXPECT_GT(synthetic->played_frames(), 0u);
+
+    audio.close();
+}
+
+TEST_F(AudioBackendTest, BackendSwapRequiresClosedDevices) {
+    SyntheticAudioConfig config;
+    audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+    EXPECT_FALSE(audio.set_backend(std::make_unique<SyntheticAudioBackend>(config)));
+
+    audio.close();
+    EXPECT_TRUE(audio.set_backend(std::make_unique<SyntheticAudioBackend>(config)));
+}
+
+TEST_F(AudioBackendTest, PlaybackRunsWithoutCapture) {
+    SyntheticAudioConfig config;
+    config.pacing = AudioPacing::RealTime;
+
+    audio_async audio(1000, std::make_unique<SyntheticAudioBackend>(config));
+    ASSERT_TRUE(audio.init(-1, AUDIO_SAMPLE_RATE));
+
+    std::vector<float> samples(1600, 0.25f);
+    ASSERT_TRUE(audio.play_audio(samples.data(), samples.size()));
+    EXPECT_EQ(audio.get_playback_buffer_size(), samples.size());
+
+    // start_playback() alone must drain the queue, capture stays paused
+    ASSERT_TRUE(audio.start_playback());
+    auto start = std::chrono::steady_clock::now();
+    while (audio.get_playback_buffer_size() > 0 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(audio.get_playback_buffer_size(), 0u);
+    EXPECT_EQ(audio.get_available(), 0u);
+
+    audio.stop_playback();
+    audio.close();
+}
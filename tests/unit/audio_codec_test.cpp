@@ -0,0 +1,229 @@
+#include "audio/audio_codec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+std::vector<float> create_tone(size_t count, float frequency, uint32_t rate) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * frequency * i / rate);
+    }
+    return samples;
+}
+
+double rms_error(const std::vector<float>& a, const std::vector<float>& b, size_t from) {
+    double sum = 0.0;
+    for (size_t i = from; i < a.size(); i++) {
+        sum += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return std::sqrt(sum / (a.size() - from));
+}
+}  // namespace
+
+TEST(AudioCodecTest, PayloadTypes) {
+    EXPECT_EQ(create_audio_codec(AudioCodecType::L16, 48000)->payload_type(), 11);
+    EXPECT_EQ(create_audio_codec(AudioCodecType::Pcmu, 8000)->payload_type(), 0);
+    EXPECT_EQ(create_audio_codec(AudioCodecType::Pcma, 8000)->payload_type(), 8);
+    EXPECT_EQ(create_audio_codec(AudioCodecType::ImaAdpcm, 8000)->payload_type(), 5);
+    EXPECT_EQ(create_audio_codec(AudioCodecType::ImaAdpcm, 16000)->payload_type(), 6);
+
+    // No static type at other rates
+    EXPECT_GE(create_audio_codec(AudioCodecType::Pcmu, 16000)->payload_type(), 96);
+    EXPECT_GE(create_audio_codec(AudioCodecType::ImaAdpcm, 48000)->payload_type(), 96);
+    EXPECT_EQ(create_audio_codec(AudioCodecType::L16, 0), nullptr);
+}
+
+TEST(AudioCodecTest, L16MatchesPcmConvert) {
+    auto codec = create_audio_codec(AudioCodecType::L16, 48000);
+    const std::vector<float> samples = {0.0f, 1.0f, -1.0f, 0.5f};
+
+    uint8_t payload[8];
+    ASSERT_EQ(codec->encode(samples.data(), samples.size(), payload, sizeof(payload)), 8u);
+    EXPECT_EQ(payload[2], 0x7F);
+    EXPECT_EQ(payload[3], 0xFF);
+    EXPECT_EQ(codec->encode(samples.data(), samples.size(), payload, 7), 0u);
+
+    float decoded[4];
+    ASSERT_EQ(codec->decode(payload, 8, decoded, 4), 4u);
+    EXPECT_FLOAT_EQ(decoded[0], 0.0f);
+    EXPECT_NEAR(decoded[3], 0.5f, 1.0f / 32768);
+    EXPECT_EQ(codec->decode(payload, 7, decoded, 4), 0u);  // Odd payload
+    EXPECT_EQ(codec->decode(payload, 8, decoded, 3), 0u);  // Output too small
+}
+
+// Every code decodes to a value that encodes back to the same code. mu-law 0x7F (-0) is the
+// one exception: it decodes to 0, which encodes as +0 (0xFF).
+TEST(AudioCodecTest, G711CodesRoundTrip) {
+    for (AudioCodecType type : {AudioCodecType::Pcmu, AudioCodecType::Pcma}) {
+        auto codec = create_audio_codec(type, 8000);
+
+        uint8_t codes[256];
+        for (int c = 0; c < 256; c++) {
+            codes[c] = static_cast<uint8_t>(c);
+        }
+        std::vector<float> decoded(256);
+        ASSERT_EQ(codec->decode(codes, 256, decoded.data(), decoded.size()), 256u);
+
+        uint8_t encoded[256];
+        ASSERT_EQ(codec->encode(decoded.data(), 256, encoded, sizeof(encoded)), 256u);
+        for (int c = 0; c < 256; c++) {
+            if (type == AudioCodecType::Pcmu && c == 0x7F) {
+                EXPECT_EQ(encoded[c], 0xFF);
+                continue;
+            }
+            EXPECT_EQ(encoded[c], codes[c]) << codec->name() << " code " << c;
+        }
+    }
+}
+
+TEST(AudioCodecTest, G711KnownValues) {
+    auto ulaw = create_audio_codec(AudioCodecType::Pcmu, 8000);
+    auto alaw = create_audio_codec(AudioCodecType::Pcma, 8000);
+    const float samples[] = {0.0f, 1.0f, -1.0f};
+
+    uint8_t out[3];
+    ASSERT_EQ(ulaw->encode(samples, 3, out, sizeof(out)), 3u);
+    EXPECT_EQ(out[0], 0xFF);
+    EXPECT_EQ(out[1], 0x80);
+    EXPECT_EQ(out[2], 0x00);
+
+    ASSERT_EQ(alaw->encode(samples, 3, out, sizeof(out)), 3u);
+    EXPECT_EQ(out[0], 0xD5);
+    EXPECT_EQ(out[1], 0xAA);
+    EXPECT_EQ(out[2], 0x2A);
+}
+
+TEST(AudioCodecTest, G711SignalToNoise) {
+    const auto tone = create_tone(8000, 440.0f, 8000);
+    for (AudioCodecType type : {AudioCodecType::Pcmu, AudioCodecType::Pcma}) {
+        auto codec = create_audio_codec(type, 8000);
+        std::vector<uint8_t> payload(tone.size());
+        std::vector<float> decoded(tone.size());
+        ASSERT_EQ(codec->encode(tone.data(), tone.size(), payload.data(), payload.size()),
+                  tone.size());
+        ASSERT_EQ(codec->decode(payload.data(), payload.size(), decoded.data(), decoded.size()),
+                  tone.size());
+
+        // G.711 gives about 38 dB SNR for a loud tone; 0.5 amplitude is ~0.35 RMS
+        EXPECT_LT(rms_error(tone, decoded, 0), 0.35 / std::pow(10.0, 35.0 / 20.0));
+    }
+}
+
+TEST(AudioCodecTest, AdpcmPacketsDecodeIndependently) {
+    auto encoder = create_audio_codec(AudioCodecType::ImaAdpcm, 16000);
+    auto decoder = create_audio_codec(AudioCodecType::ImaAdpcm, 16000);
+    EXPECT_TRUE(encoder->supports_frame(160));
+    EXPECT_FALSE(encoder->supports_frame(161));
+
+    const size_t frame = 160;
+    const auto tone = create_tone(frame * 20, 500.0f, 16000);
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t i = 0; i < tone.size(); i += frame) {
+        std::vector<uint8_t> payload(encoder->max_encoded_size(frame));
+        ASSERT_EQ(encoder->encode(tone.data() + i, frame, payload.data(), payload.size()),
+                  4 + frame / 2);
+        packets.push_back(payload);
+    }
+
+    // Decode every packet but the third: the header carries the predictor state, so the
+    // packets after the gap decode as if nothing was lost
+    std::vector<float> decoded(tone.size(), 0.0f);
+    for (size_t p = 0; p < packets.size(); p++) {
+        if (p == 2) {
+            continue;
+        }
+        ASSERT_EQ(decoder->decode(packets[p].data(), packets[p].size(), &decoded[p * frame],
+                                  frame),
+                  frame);
+    }
+
+    std::vector<float> reference = tone;
+    std::fill(reference.begin() + 2 * frame, reference.begin() + 3 * frame, 0.0f);
+    EXPECT_LT(rms_error(reference, decoded, 3 * frame), 0.02);
+
+    // Odd frames, short or corrupt payloads are rejected
+    uint8_t payload[128];
+    EXPECT_EQ(encoder->encode(tone.data(), 3, payload, sizeof(payload)), 0u);
+    EXPECT_EQ(decoder->decode(payload, 4, decoded.data(), decoded.size()), 0u);
+    packets[0][2] = 89;  // Step index out of range
+    EXPECT_EQ(decoder->decode(packets[0].data(), packets[0].size(), decoded.data(), frame), 0u);
+}
+
+#ifdef EDGE_VOX_HAVE_OPUS
+TEST(AudioCodecTest, OpusRoundTrip) {
+    EdgeVoxOpusConfig config;
+    config.bitrate = 32000;
+    auto encoder = create_audio_codec(AudioCodecType::Opus, 16000, config);
+    auto decoder = create_audio_codec(AudioCodecType::Opus, 16000, config);
+    ASSERT_NE(encoder, nullptr);
+    EXPECT_EQ(encoder->rtp_clock_rate(), 48000u);
+    EXPECT_TRUE(encoder->supports_frame(160));   // 10 ms
+    EXPECT_TRUE(encoder->supports_frame(320));   // 20 ms
+    EXPECT_FALSE(encoder->supports_frame(200));  // 12.5 ms
+    EXPECT_EQ(create_audio_codec(AudioCodecType::Opus, 44100), nullptr);
+
+    const size_t frame = 320;
+    const auto tone = create_tone(frame * 50, 440.0f, 16000);
+    std::vector<float> decoded(tone.size());
+    size_t bytes = 0;
+    for (size_t i = 0; i < tone.size(); i += frame) {
+        uint8_t payload[1500];
+        const size_t size = encoder->encode(tone.data() + i, frame, payload, sizeof(payload));
+        ASSERT_GT(size, 0u);
+        bytes += size;
+        ASSERT_EQ(decoder->decode(payload, size, &decoded[i], frame), frame);
+    }
+
+    // About 32 kbit/s instead of 256 for L16, and the tone comes through at its level. The
+    // codec delays the signal, so compare energy rather than samples.
+    EXPECT_LT(bytes * 8 / (tone.size() / 16000.0), 40000.0);
+    double energy_in = 0.0;
+    double energy_out = 0.0;
+    for (size_t i = frame * 10; i < tone.size(); i++) {
+        energy_in += tone[i] * tone[i];
+        energy_out += decoded[i] * decoded[i];
+    }
+    EXPECT_NEAR(energy_out / energy_in, 1.0, 0.2);
+}
+
+TEST(AudioCodecTest, OpusDtxAndFec) {
+    EdgeVoxOpusConfig config;
+    config.dtx = true;
+    config.fec = true;
+    config.expected_loss = 20;
+    auto encoder = create_audio_codec(AudioCodecType::Opus, 16000, config);
+    auto decoder = create_audio_codec(AudioCodecType::Opus, 16000, config);
+    ASSERT_NE(encoder, nullptr);
+
+    const size_t frame = 320;
+    uint8_t payload[1500];
+
+    // Silence collapses to DTX frames after a short hangover
+    const std::vector<float> silence(frame, 0.0f);
+    bool silent = false;
+    for (int i = 0; i < 50 && !silent; i++) {
+        const size_t size = encoder->encode(silence.data(), frame, payload, sizeof(payload));
+        ASSERT_GT(size, 0u);
+        silent = encoder->is_silence(size);
+    }
+    EXPECT_TRUE(silent);
+
+    // A speech-like signal carries FEC for the previous frame
+    const auto tone = create_tone(frame * 20, 300.0f, 16000);
+    size_t size = 0;
+    for (size_t i = 0; i < tone.size(); i += frame) {
+        size = encoder->encode(tone.data() + i, frame, payload, sizeof(payload));
+        ASSERT_GT(size, 0u);
+    }
+    std::vector<float> recovered(frame);
+    EXPECT_EQ(decoder->decode_fec(payload, size, recovered.data(), frame), frame);
+}
+#else
+TEST(AudioCodecTest, OpusNeedsLibopus) {
+    EXPECT_EQ(create_audio_codec(AudioCodecType::Opus, 48000), nullptr);
+    EXPECT_EQ(audio_codec_rtp_clock_rate(AudioCodecType::Opus, 16000), 48000u);
+}
+#endif
@@ -0,0 +1,183 @@
+#include "edge_vox/audio/beamformer_stage.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "core/pipeline.hpp"
+
+namespace {
+constexpr float PI = 3.14159265f;
+constexpr float SPACING = 0.05f;  // Default config
+constexpr float SOUND_SPEED = 343.0f;
+
+AudioFormat array_format(uint32_t rate, uint16_t channels) {
+    AudioFormat format;
+    format.sample_rate = rate;
+    format.channels = channels;
+    format.frame_samples = rate / 100;  // 10 ms
+    return format;
+}
+
+// Broadband talker from angle_deg as a linear array hears it: a sum of tones in the speech
+// band, each microphone delayed by its exact (fractional) arrival time. Interleaved.
+class Talker {
+public:
+    explicit Talker(uint32_t rate) : rate_(rate) {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> freq(200.0f, 3800.0f);
+        std::uniform_real_distribution<float> phase(0.0f, 2.0f * PI);
+        for (size_t q = 0; q < 40; q++) {
+            tones_.push_back({freq(gen), phase(gen)});
+        }
+    }
+
+    std::vector<float> render(size_t samples, uint16_t channels, float angle_deg) {
+        const float per_mic = std::sin(angle_deg * PI / 180.0f) * SPACING / SOUND_SPEED;
+        std::vector<float> out(samples * channels);
+        for (size_t i = 0; i < samples; i++) {
+            for (uint16_t m = 0; m < channels; m++) {
+                out[i * channels + m] = at((start_ + i) / static_cast<double>(rate_) - m * per_mic);
+            }
+        }
+        start_ += samples;
+        return out;
+    }
+
+    // Level of the source itself
+    float rms() const {
+        return AMPLITUDE * std::sqrt(tones_.size() / 2.0f);
+    }
+
+private:
+    static constexpr float AMPLITUDE = 0.02f;
+
+    float at(double t) const {
+        double sum = 0.0;
+        for (const auto& tone : tones_) {
+            sum += std::sin(2.0 * PI * tone.first * t + tone.second);
+        }
+        return static_cast<float>(AMPLITUDE * sum);
+    }
+
+    uint32_t rate_;
+    uint64_t start_ = 0;
+    std::vector<std::pair<float, float>> tones_;  // Frequency and phase
+};
+
+struct Sink {
+    std::vector<float> samples;
+    uint16_t channels = 0;
+
+    EdgeVoxPipeline::FrameSink function() {
+        return [this](const AudioFrame& frame, uint64_t) {
+            samples.insert(samples.end(), frame.channel(0), frame.channel(0) + frame.samples);
+            channels = frame.channels;
+        };
+    }
+};
+
+float rms(const float* samples, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sum += samples[i] * samples[i];
+    }
+    return static_cast<float>(std::sqrt(sum / n));
+}
+}  // namespace
+
+TEST(BeamformerStageTest, MonoPassesThrough) {
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<BeamformerStage>()));
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(array_format(16000, 1), sink.function()));
+    EXPECT_EQ(pipeline.output_format().channels, 1u);
+    std::vector<float> input(480);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = 0.001f * i;
+    }
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+    EXPECT_EQ(sink.samples, input);
+}
+
+TEST(BeamformerStageTest, RefusesArraysWiderThanItsWindow) {
+    EdgeVoxBeamformerConfig config;
+    config.mic_spacing_m = 2.0f;
+    BeamformerStage stage(config);
+    AudioFormat format = array_format(48000, 4);
+    EXPECT_FALSE(stage.configure(format));
+}
+
+TEST(BeamformerStageTest, FindsTalkerDirection) {
+    for (uint32_t rate : {16000u, 48000u}) {
+        for (uint16_t channels : {2, 3, 4}) {
+            for (float angle : {-50.0f, 0.0f, 30.0f}) {
+                EdgeVoxPipeline pipeline;
+                auto owned = std::make_unique<BeamformerStage>();
+                BeamformerStage* beamformer = owned.get();
+                ASSERT_TRUE(pipeline.add_stage(std::move(owned)));
+
+                Sink sink;
+                const AudioFormat format = array_format(rate, channels);
+                ASSERT_TRUE(pipeline.start(format, sink.function()));
+                EXPECT_EQ(pipeline.output_format().channels, 1u);
+
+                Talker talker(rate);
+                const auto input = talker.render(30 * format.frame_samples, channels, angle);
+                pipeline.push(input.data(), input.size());
+                pipeline.stop();
+
+                const EdgeVoxBeamformerStats stats = beamformer->get_stats();
+                EXPECT_EQ(stats.updates, 30u);
+                EXPECT_NEAR(stats.direction_deg, angle, 4.0f)
+                    << rate << " Hz, " << channels << " microphones";
+                EXPECT_EQ(sink.channels, 1u);
+                EXPECT_EQ(sink.samples.size(), 30 * format.frame_samples);
+            }
+        }
+    }
+}
+
+TEST(BeamformerStageTest, KeepsTalkerAndAveragesOutNoise) {
+    const uint16_t channels = 4;
+    const AudioFormat format = array_format(48000, channels);
+    const size_t frame = format.frame_samples;
+
+    EdgeVoxPipeline pipeline;
+    auto owned = std::make_unique<BeamformerStage>();
+    BeamformerStage* beamformer = owned.get();
+    ASSERT_TRUE(pipeline.add_stage(std::move(owned)));
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(format, sink.function()));
+
+    // Steered at the talker, it comes through whole
+    Talker talker(format.sample_rate);
+    const auto speech = talker.render(40 * frame, channels, 40.0f);
+    pipeline.push(speech.data(), speech.size());
+    ASSERT_NEAR(beamformer->get_stats().direction_deg, 40.0f, 5.0f);
+    const float talker_gain = rms(&sink.samples[20 * frame], 20 * frame) / talker.rms();
+    EXPECT_NEAR(talker_gain, 1.0f, 0.1f);
+
+    // Independent noise on each microphone, too quiet to move the beam, adds up in power
+    // only: half the level with four microphones
+    std::mt19937 gen(3);
+    std::normal_distribution<float> dis(0.0f, 1e-3f);
+    std::vector<float> noise(40 * frame * channels);
+    for (auto& s : noise) {
+        s = dis(gen);
+    }
+    const uint64_t updates = beamformer->get_stats().updates;
+    sink.samples.clear();
+    pipeline.push(noise.data(), noise.size());
+    pipeline.stop();
+
+    EXPECT_EQ(beamformer->get_stats().updates, updates);
+    const float noise_gain =
+        rms(&sink.samples[frame], 39 * frame) / rms(noise.data(), noise.size());
+    EXPECT_GT(noise_gain, 0.4f);
+    EXPECT_LT(noise_gain, 0.55f);
+}
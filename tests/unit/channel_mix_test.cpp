@@ -0,0 +1,80 @@
+#include "audio/channel_mix.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "kernel_test.hpp"
+
+class ChannelMixTest : public KernelTest {};
+
+// Frame counts around the vector widths, for the tails
+static const size_t FRAME_COUNTS[] = {0, 1, 3, 4, 7, 8, 9, 17, 480, 1001};
+
+TEST_P(ChannelMixTest, DeinterleaveMatchesScalar) {
+    for (size_t channels : {1, 2, 3, 4, 6}) {
+        const auto in = random_samples(1001 * channels, 99);
+        for (size_t frames : FRAME_COUNTS) {
+            const size_t stride = frames + 5;  // Planes needn't be packed
+            std::vector<float> expected(channels * stride, -9.0f);
+            std::vector<float> actual(channels * stride, -9.0f);
+            deinterleave(in.data(), frames, channels, expected.data(), stride, PcmKernel::Scalar);
+            deinterleave(in.data(), frames, channels, actual.data(), stride, GetParam());
+            ASSERT_EQ(actual, expected) << channels << " channels, " << frames << " frames";
+        }
+    }
+
+    // Exact positions for one small block
+    const float in[] = {0, 10, 20, 1, 11, 21};
+    float out[6];
+    deinterleave(in, 2, 3, out, 2, GetParam());
+    EXPECT_EQ(std::vector<float>(out, out + 6), (std::vector<float>{0, 1, 10, 11, 20, 21}));
+}
+
+TEST_P(ChannelMixTest, DownmixMatchesScalar) {
+    for (size_t channels : {1, 2, 3, 4, 6}) {
+        const auto in = random_samples(1001 * channels, 99);
+        std::vector<float> weights(channels);
+        for (size_t c = 0; c < channels; c++) {
+            weights[c] = 0.1f * (c + 1);
+        }
+        for (size_t frames : FRAME_COUNTS) {
+            std::vector<float> expected(frames + 1, -9.0f);
+            std::vector<float> actual(frames + 1, -9.0f);
+            downmix(in.data(), frames, channels, weights.data(), expected.data(),
+                    PcmKernel::Scalar);
+            downmix(in.data(), frames, channels, weights.data(), actual.data(), GetParam());
+            for (size_t i = 0; i < frames; i++) {
+                ASSERT_NEAR(actual[i], expected[i], 1e-6f)
+                    << channels << " channels, frame " << i << " of " << frames;
+            }
+            EXPECT_EQ(actual[frames], -9.0f) << "wrote past the end";
+        }
+    }
+
+    // Average of a stereo pair
+    const float in[] = {1.0f, 3.0f, -2.0f, -4.0f};
+    const float half[] = {0.5f, 0.5f};
+    float out[2];
+    downmix(in, 2, 2, half, out, GetParam());
+    EXPECT_FLOAT_EQ(out[0], 2.0f);
+    EXPECT_FLOAT_EQ(out[1], -3.0f);
+}
+
+TEST_P(ChannelMixTest, SelectChannelMatchesScalar) {
+    for (size_t channels : {1, 2, 3, 4, 6}) {
+        const auto in = random_samples(1001 * channels, 99);
+        for (size_t channel = 0; channel < channels; channel++) {
+            for (size_t frames : FRAME_COUNTS) {
+                std::vector<float> actual(frames);
+                select_channel(in.data(), frames, channels, channel, actual.data(), GetParam());
+                for (size_t i = 0; i < frames; i++) {
+                    ASSERT_EQ(actual[i], in[i * channels + channel])
+                        << channels << " channels, channel " << channel << ", frame " << i;
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_KERNEL_TESTS(ChannelMixTest);
@@ -0,0 +1,97 @@
+#include "audio/fft.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "kernel_test.hpp"
+
+class FftTest : public KernelTest {};
+
+TEST(FftConfigTest, RejectsSizesThatArentPowersOfTwo) {
+    Fft fft;
+    EXPECT_FALSE(fft.configure(0));
+    EXPECT_FALSE(fft.configure(1));
+    EXPECT_FALSE(fft.configure(96));
+    EXPECT_TRUE(fft.configure(2));
+    EXPECT_TRUE(fft.configure(1024));
+    EXPECT_EQ(fft.size(), 1024u);
+}
+
+TEST_P(FftTest, MatchesDirectDft) {
+    const double pi = 3.14159265358979323846;
+    for (size_t n : {2, 4, 8, 16, 64, 512}) {
+        Fft fft;
+        ASSERT_TRUE(fft.configure(n, GetParam()));
+        auto re = random_samples(n, 1);
+        auto im = random_samples(n, 2);
+
+        std::vector<double> expected_re(n, 0.0), expected_im(n, 0.0);
+        for (size_t k = 0; k < n; k++) {
+            for (size_t t = 0; t < n; t++) {
+                const double angle = -2.0 * pi * static_cast<double>(k * t % n) / n;
+                expected_re[k] += re[t] * std::cos(angle) - im[t] * std::sin(angle);
+                expected_im[k] += re[t] * std::sin(angle) + im[t] * std::cos(angle);
+            }
+        }
+
+        fft.forward(re.data(), im.data());
+        const double tolerance = 1e-5 * n;
+        for (size_t k = 0; k < n; k++) {
+            ASSERT_NEAR(re[k], expected_re[k], tolerance) << "size " << n << ", bin " << k;
+            ASSERT_NEAR(im[k], expected_im[k], tolerance) << "size " << n << ", bin " << k;
+        }
+    }
+}
+
+TEST_P(FftTest, InverseRestoresScaledInput) {
+    Fft fft;
+    ASSERT_TRUE(fft.configure(1024, GetParam()));
+    const auto original_re = random_samples(1024, 3);
+    const auto original_im = random_samples(1024, 4);
+    auto re = original_re;
+    auto im = original_im;
+
+    fft.forward(re.data(), im.data());
+    fft.inverse(re.data(), im.data());
+    for (size_t i = 0; i < re.size(); i++) {
+        ASSERT_NEAR(re[i] / 1024.0f, original_re[i], 1e-5f) << i;
+        ASSERT_NEAR(im[i] / 1024.0f, original_im[i], 1e-5f) << i;
+    }
+}
+
+TEST_P(FftTest, RealPairMatchesComplexTransforms) {
+    const size_t n = 256;
+    Fft fft;
+    ASSERT_TRUE(fft.configure(n, GetParam()));
+    const auto x = random_samples(n, 5);
+    const auto y = random_samples(n, 6);
+
+    std::vector<float> x_re(n / 2 + 1), x_im(n / 2 + 1), y_re(n / 2 + 1), y_im(n / 2 + 1);
+    fft.forward_real_pair(x.data(), y.data(), x_re.data(), x_im.data(), y_re.data(),
+                          y_im.data());
+
+    // Each on its own, with a zero imaginary part
+    auto xr = x, yr = y;
+    std::vector<float> xi(n, 0.0f), yi(n, 0.0f);
+    fft.forward(xr.data(), xi.data());
+    fft.forward(yr.data(), yi.data());
+    for (size_t k = 0; k <= n / 2; k++) {
+        ASSERT_NEAR(x_re[k], xr[k], 1e-3f) << k;
+        ASSERT_NEAR(x_im[k], xi[k], 1e-3f) << k;
+        ASSERT_NEAR(y_re[k], yr[k], 1e-3f) << k;
+        ASSERT_NEAR(y_im[k], yi[k], 1e-3f) << k;
+    }
+
+    // And back
+    std::vector<float> a(n), b(n);
+    fft.inverse_real_pair(x_re.data(), x_im.data(), y_re.data(), y_im.data(), a.data(),
+                          b.data());
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_NEAR(a[i] / n, x[i], 1e-5f) << i;
+        ASSERT_NEAR(b[i] / n, y[i], 1e-5f) << i;
+    }
+}
+
+INSTANTIATE_KERNEL_TESTS(FftTest);
@@ -0,0 +1,49 @@
+#include "audio/frame_features.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "kernel_test.hpp"
+
+class FrameFeaturesTest : public KernelTest {};
+
+TEST_P(FrameFeaturesTest, MatchesScalarReference) {
+    const std::vector<float> samples = random_samples(1001, 1234);
+
+    // Every length up to a few vectors, for the tails
+    for (size_t n : {0, 1, 2, 3, 5, 8, 15, 16, 17, 33, 480, 1001}) {
+        const FrameFeatures expected = frame_features(samples.data(), n, PcmKernel::Scalar);
+        const FrameFeatures actual = frame_features(samples.data(), n, GetParam());
+        EXPECT_NEAR(actual.energy, expected.energy, 1e-5f) << n;
+        EXPECT_EQ(actual.crossings, expected.crossings) << n;
+    }
+}
+
+TEST_P(FrameFeaturesTest, MeasuresKnownSignals) {
+    // Square wave at full scale flipping every 4 samples
+    std::vector<float> square(160);
+    for (size_t i = 0; i < square.size(); i++) {
+        square[i] = (i / 4) % 2 ? -1.0f : 1.0f;
+    }
+    FrameFeatures features = frame_features(square.data(), square.size(), GetParam());
+    EXPECT_FLOAT_EQ(features.energy, 1.0f);
+    EXPECT_EQ(features.crossings, 39u);
+
+    // Sine: half the squared amplitude, two crossings per period
+    std::vector<float> sine(1600);
+    for (size_t i = 0; i < sine.size(); i++) {
+        sine[i] = 0.5f * std::sin(2.0f * 3.14159265f * 100.0f * (i + 0.5f) / 16000.0f);
+    }
+    features = frame_features(sine.data(), sine.size(), GetParam());
+    EXPECT_NEAR(features.energy, 0.125f, 1e-4f);
+    EXPECT_EQ(features.crossings, 19u);
+
+    const std::vector<float> silence(100, 0.0f);
+    features = frame_features(silence.data(), silence.size(), GetParam());
+    EXPECT_EQ(features.energy, 0.0f);
+    EXPECT_EQ(features.crossings, 0u);
+}
+
+INSTANTIATE_KERNEL_TESTS(FrameFeaturesTest);
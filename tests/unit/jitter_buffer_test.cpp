@@ -0,0 +1,316 @@
+#include "net/jitter_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "audio/audio_codec.hpp"
+
+namespace {
+// A payload is a value byte and a 16-bit sample count; it decodes to that many copies of the
+// value, and its FEC to the value before. Records the values in the order it produced them.
+class RecordingCodec : public AudioCodec {
+public:
+    RecordingCodec() : AudioCodec(16000) {}
+
+    static std::vector<uint8_t> payload(uint8_t value, size_t samples) {
+        return {value, static_cast<uint8_t>(samples >> 8), static_cast<uint8_t>(samples)};
+    }
+
+    const char* name() const override {
+        return "recording";
+    }
+    AudioCodecType type() const override {
+        return AudioCodecType::L16;
+    }
+    uint8_t payload_type() const override {
+        return 96;
+    }
+    size_t max_encoded_size(size_t) const override {
+        return 3;
+    }
+    size_t max_decoded_samples(size_t) const override {
+        return 0xFFFF;
+    }
+    size_t payload_samples(const uint8_t* in, size_t bytes) const override {
+        return bytes == 3 ? static_cast<size_t>(in[1] << 8 | in[2]) : 0;
+    }
+    size_t encode(const float*, size_t, uint8_t*, size_t) override {
+        return 0;
+    }
+
+    size_t decode(const uint8_t* in, size_t bytes, float* out, size_t capacity) override {
+        const size_t samples = payload_samples(in, bytes);
+        if (samples == 0 || samples > capacity) {
+            return 0;
+        }
+        std::fill(out, out + samples, static_cast<float>(in[0]));
+        decoded.push_back(in[0]);
+        return samples;
+    }
+
+    size_t decode_fec(const uint8_t* in, size_t bytes, float* out, size_t samples) override {
+        if (!fec || bytes != 3) {
+            return 0;
+        }
+        std::fill(out, out + samples, static_cast<float>(in[0] - 1));
+        decoded.push_back(in[0] - 1);
+        return samples;
+    }
+
+    bool fec = false;
+    std::vector<int> decoded;
+};
+}  // namespace
+
+class JitterBufferTest : public ::testing::Test {
+protected:
+    static constexpr size_t FRAME = 160;  // 10 ms at 16 kHz
+
+    void SetUp() override {
+        config.sample_rate = 16000;
+        config.min_delay_ms = 20;
+        config.max_delay_ms = 200;
+        config.capacity = 32;
+        jb = std::make_unique<JitterBuffer>(codec, config);
+    }
+
+    // Frame n decodes to the value n, sent at n * 10 ms and arriving on time
+    bool insert(uint16_t n, int64_t arrival_offset_us = 0) {
+        const auto frame = RecordingCodec::payload(static_cast<uint8_t>(n), FRAME);
+        const uint64_t arrival = 1000000 + n * 10000 + arrival_offset_us;
+        return jb->insert(1000 + n, 5000 + n * FRAME, frame.data(), frame.size(), arrival);
+    }
+
+    // Pop one frame; returns its first sample, or -1 while buffering
+    float pop() {
+        out.assign(FRAME, -2.0f);
+        size_t n = jb->pop(out.data(), out.size());
+        return n == 0 ? -1.0f : out[0];
+    }
+
+    RecordingCodec codec;
+    JitterBufferConfig config;
+    std::unique_ptr<JitterBuffer> jb;
+    std::vector<float> out;
+};
+
+TEST_F(JitterBufferTest, BuffersToTargetThenPlaysInOrder) {
+    EXPECT_EQ(pop(), -1.0f);  // Empty
+
+    ASSERT_TRUE(insert(1));
+    EXPECT_EQ(jb->frame_samples(), FRAME);
+    EXPECT_EQ(pop(), -1.0f);  // 10 ms buffered, target 20 ms
+
+    ASSERT_TRUE(insert(2));
+    EXPECT_EQ(pop(), 1.0f);
+    EXPECT_EQ(pop(), 2.0f);
+    EXPECT_EQ(jb->stats().played, 2u);
+}
+
+TEST_F(JitterBufferTest, ReordersBySequenceNumber) {
+    insert(1);
+    insert(3);
+    insert(2);
+    insert(4);
+
+    EXPECT_EQ(pop(), 1.0f);
+    EXPECT_EQ(pop(), 2.0f);
+    EXPECT_EQ(pop(), 3.0f);
+    EXPECT_EQ(pop(), 4.0f);
+    EXPECT_EQ(jb->stats().lost, 0u);
+}
+
+TEST_F(JitterBufferTest, DecodesInSequenceOrderWhateverTheArrival) {
+    for (uint16_t n : {2, 1, 4, 3, 6, 5, 7, 8}) {
+        insert(n);
+    }
+    for (int i = 0; i < 8; i++) {
+        pop();
+    }
+
+    // The decoder only ever saw the packets in order, whatever was skipped to shrink the delay
+    ASSERT_GE(codec.decoded.size(), 4u);
+    EXPECT_TRUE(std::is_sorted(codec.decoded.begin(), codec.decoded.end()));
+    EXPECT_EQ(std::adjacent_find(codec.decoded.begin(), codec.decoded.end()),
+              codec.decoded.end());
+}
+
+TEST_F(JitterBufferTest, RecoversLostFrameFromFecAtPlayout) {
+    codec.fec = true;
+
+    // Frame 3 never arrives; 4 comes before 2
+    insert(1);
+    insert(4);
+    insert(2);
+    EXPECT_EQ(pop(), 1.0f);
+    insert(5);
+    EXPECT_EQ(pop(), 2.0f);
+    EXPECT_EQ(pop(), 3.0f);  // From the FEC in frame 4, decoded right before frame 4 itself
+    EXPECT_EQ(pop(), 4.0f);
+    EXPECT_EQ(codec.decoded, std::vector<int>({1, 2, 3, 4}));
+
+    auto stats = jb->stats();
+    EXPECT_EQ(stats.fec_recovered, 1u);
+    EXPECT_EQ(stats.lost, 0u);
+    EXPECT_EQ(stats.concealed, 0u);
+}
+
+TEST_F(JitterBufferTest, ReorderedStartIsNotLate) {
+    insert(2);
+    insert(1);
+    EXPECT_EQ(pop(), 1.0f);
+    EXPECT_EQ(jb->stats().late, 0u);
+}
+
+TEST_F(JitterBufferTest, SequenceWrapWithOddCapacity) {
+    config.capacity = 50;
+    config.min_delay_ms = 440;
+    config.max_delay_ms = 1000;
+    jb = std::make_unique<JitterBuffer>(codec, config);
+
+    // 45 frames buffered across 65535 -> 0; with 50 slots taken modulo, 65510 and 10 collide
+    const uint16_t first = 65510;
+    for (uint16_t n = 0; n < 45; n++) {
+        const auto frame = RecordingCodec::payload(static_cast<uint8_t>(n), FRAME);
+        ASSERT_TRUE(jb->insert(static_cast<uint16_t>(first + n), n * FRAME, frame.data(),
+                               frame.size(), 1000000 + n * 10000));
+    }
+
+    for (int n = 0; n < 45; n++) {
+        EXPECT_EQ(pop(), static_cast<float>(n));
+    }
+    EXPECT_EQ(jb->stats().lost, 0u);
+    EXPECT_EQ(jb->stats().played, 45u);
+}
+
+TEST_F(JitterBufferTest, ConcealsLostPacket) {
+    insert(1);
+    insert(2);
+    EXPECT_EQ(pop(), 1.0f);
+    insert(4);
+    EXPECT_EQ(pop(), 2.0f);
+    insert(5);
+
+    // Frame 3 is repeated from frame 2, fading out
+    pop();
+    EXPECT_FLOAT_EQ(out[0], 2.0f);
+    EXPECT_LT(out[FRAME - 1], 2.0f);
+    EXPECT_GT(out[FRAME - 1], 0.0f);
+
+    // Frame 4 fades back in from the concealment gain
+    pop();
+    EXPECT_FLOAT_EQ(out[0], 4.0f * 0.5f);
+    EXPECT_NEAR(out[FRAME - 1], 4.0f, 0.05f);
+    EXPECT_EQ(pop(), 5.0f);
+
+    auto stats = jb->stats();
+    EXPECT_EQ(stats.lost, 1u);
+    EXPECT_EQ(stats.concealed, 1u);
+}
+
+TEST_F(JitterBufferTest, LatePacketDroppedAndDelayGrows) {
+    insert(1);
+    insert(2);
+    insert(4);
+    const uint32_t target = jb->stats().target_delay_ms;
+
+    pop();
+    pop();
+    pop();  // 3 concealed
+
+    EXPECT_FALSE(insert(3));
+    auto stats = jb->stats();
+    EXPECT_EQ(stats.late, 1u);
+    EXPECT_GT(stats.target_delay_ms, target);
+}
+
+TEST_F(JitterBufferTest, JitterRaisesTargetDelay) {
+    // Arrivals alternate 15 ms early/late around the sending clock
+    for (uint16_t n = 1; n <= 50; n++) {
+        insert(n, (n % 2) ? 15000 : -15000);
+        pop();
+    }
+
+    auto stats = jb->stats();
+    EXPECT_GT(stats.jitter_ms, 10.0);
+    EXPECT_GT(stats.target_delay_ms, config.min_delay_ms);
+    EXPECT_LE(stats.target_delay_ms, config.max_delay_ms);
+}
+
+TEST_F(JitterBufferTest, TimestampGapPlaysSilence) {
+    const auto frame = RecordingCodec::payload(1, FRAME);
+    jb->insert(10, 0, frame.data(), frame.size(), 0);
+    jb->insert(11, FRAME, frame.data(), frame.size(), 10000);
+    // Next talkspurt starts three frames later on the RTP clock
+    jb->insert(12, 5 * FRAME, frame.data(), frame.size(), 50000);
+
+    EXPECT_EQ(pop(), 1.0f);
+    EXPECT_EQ(pop(), 1.0f);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(jb->pop(out.data(), out.size()), FRAME);
+        EXPECT_EQ(out[0], 0.0f);
+    }
+    EXPECT_EQ(pop(), 1.0f);
+
+    auto stats = jb->stats();
+    EXPECT_EQ(stats.lost, 0u);
+    EXPECT_EQ(stats.concealed, 0u);
+}
+
+TEST_F(JitterBufferTest, UnderrunConcealsThenRebuffers) {
+    insert(1);
+    insert(2);
+    EXPECT_EQ(pop(), 1.0f);
+    EXPECT_EQ(pop(), 2.0f);
+
+    // Nothing arrives: a few concealed frames, then silence until the buffer refills
+    int concealed = 0;
+    while (pop() != -1.0f) {
+        ASSERT_LT(++concealed, 10);
+    }
+    EXPECT_EQ(jb->stats().concealed, static_cast<uint64_t>(concealed));
+    EXPECT_EQ(jb->stats().lost, 0u);
+
+    insert(3);
+    insert(4);
+    EXPECT_EQ(pop(), 3.0f);
+}
+
+TEST_F(JitterBufferTest, ShrinksWhenRunningDeep) {
+    for (uint16_t n = 1; n <= 20; n++) {
+        insert(n);
+    }
+
+    for (int i = 0; i < 20; i++) {
+        pop();
+    }
+
+    auto stats = jb->stats();
+    EXPECT_GT(stats.discarded, 0u);
+    EXPECT_EQ(stats.played + stats.discarded, 20u);
+}
+
+TEST_F(JitterBufferTest, ResyncsAfterSequenceJump) {
+    insert(1);
+    insert(2);
+    pop();
+
+    const auto frame = RecordingCodec::payload(9, FRAME);
+    EXPECT_TRUE(jb->insert(40000, 123456, frame.data(), frame.size(), 2000000));
+    EXPECT_TRUE(jb->insert(40001, 123456 + FRAME, frame.data(), frame.size(), 2010000));
+    EXPECT_EQ(jb->stats().overflow, 1u);
+    EXPECT_EQ(pop(), 9.0f);
+}
+
+TEST_F(JitterBufferTest, RejectsOversizedFrames) {
+    const auto frame = RecordingCodec::payload(1, config.max_frame_samples + 1);
+    EXPECT_FALSE(jb->insert(1, 0, frame.data(), frame.size(), 0));
+    EXPECT_FALSE(jb->insert(1, 0, frame.data(), 0, 0));
+
+    // Malformed for the codec, or longer than a slot
+    EXPECT_FALSE(jb->insert(1, 0, frame.data(), 2, 0));
+    std::vector<uint8_t> huge(config.max_payload_size + 1);
+    EXPECT_FALSE(jb->insert(1, 0, huge.data(), huge.size(), 0));
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "audio/pcm_convert.hpp"
+
+// Fixture for the tests of a SIMD routine, run once per PcmKernel; kernels the CPU lacks are
+// skipped
+class KernelTest : public ::testing::TestWithParam<PcmKernel> {
+protected:
+    void SetUp() override {
+        if (!pcm_kernel_supported(GetParam())) {
+            GTEST_SKIP() << pcm_kernel_name(GetParam()) << " not supported on this CPU";
+        }
+    }
+};
+
+// Uniform noise in [-amplitude, amplitude], the same for a given seed
+inline std::vector<float> random_samples(size_t count, unsigned seed, float amplitude = 1.0f) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(-amplitude, amplitude);
+    std::vector<float> samples(count);
+    for (auto& s : samples) {
+        s = dis(gen);
+    }
+    return samples;
+}
+
+// Runs the TEST_P cases of fixture with every kernel, named after it
+#define INSTANTIATE_KERNEL_TESTS(fixture)                                          \
+    INSTANTIATE_TEST_SUITE_P(Kernels, fixture,                                     \
+                             ::testing::Values(PcmKernel::Scalar, PcmKernel::Sse2, \
+                                               PcmKernel::Avx2, PcmKernel::Neon),  \
+                             [](const ::testing::TestParamInfo<PcmKernel>& info) { \
+                                 return std::string(pcm_kernel_name(info.param));  \
+                             })
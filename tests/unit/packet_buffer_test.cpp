@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <random>
 #include <thread>
 
@@ -159,4 +160,132 @@ TEST_F(PacketBufferTest, ThreadSafety) {
     EXPECT_EQ(pushCount.load(), numIterations) << "Failed to push expected number of packets";
     EXPECT_EQ(popCount.load(), numIterations) << "Failed to pop expected number of packets";
     EXPECT_TRUE(buffer->empty()) << "Buffer not empty, size: " << buffer->size();
-}
\ No newline at end of file
+}
+
+class PacketSlotBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        buffer = std::make_unique<PacketSlotBuffer>(4, 64);
+    }
+
+    std::unique_ptr<PacketSlotBuffer> buffer;
+};
+
+TEST_F(PacketSlotBufferTest, PushPopAcrossWrap) {
+    std::vector<uint8_t> outPacket;
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            EXPECT_TRUE(buffer->push(std::vector<uint8_t>(i + 1, round * 4 + i)));
+        }
+        EXPECT_TRUE(buffer->full());
+        EXPECT_FALSE(buffer->push(std::vector<uint8_t>(1, 99)));
+
+        for (int i = 0; i < 4; i++) {
+            ASSERT_TRUE(buffer->pop(outPacket));
+            EXPECT_EQ(outPacket, std::vector<uint8_t>(i + 1, round * 4 + i));
+        }
+        EXPECT_TRUE(buffer->empty());
+        EXPECT_FALSE(buffer->pop(outPacket));
+    }
+}
+
+TEST_F(PacketSlotBufferTest, OversizedPacketRejected) {
+    EXPECT_EQ(buffer->max_packet_size(), 64u);
+    EXPECT_FALSE(buffer->push(std::vector<uint8_t>(65, 1)));
+    EXPECT_TRUE(buffer->push(std::vector<uint8_t>(64, 1)));
+    EXPECT_EQ(buffer->size(), 1u);
+}
+
+TEST_F(PacketSlotBufferTest, BorrowAndCommitInPlace) {
+    uint8_t* slot = buffer->prepare();
+    ASSERT_NE(slot, nullptr);
+    slot[0] = 7;
+    slot[1] = 8;
+    EXPECT_TRUE(buffer->empty());  // Not visible before commit()
+    ASSERT_TRUE(buffer->commit(2));
+
+    EXPECT_TRUE(buffer->emplace([](uint8_t* data, size_t max) {
+        EXPECT_EQ(max, 64u);
+        data[0] = 9;
+        return size_t{1};
+    }));
+    EXPECT_FALSE(buffer->emplace([](uint8_t*, size_t) { return size_t{0}; }));
+    EXPECT_EQ(buffer->size(), 2u);
+
+    // The consumer reads in place; the slot is the one the producer wrote
+    size_t len = 0;
+    const uint8_t* data = buffer->front(len);
+    ASSERT_EQ(data, slot);
+    ASSERT_EQ(len, 2u);
+    EXPECT_EQ(data[1], 8);
+    buffer->release();
+
+    data = buffer->front(len);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(len, 1u);
+    EXPECT_EQ(data[0], 9);
+    buffer->release();
+    EXPECT_EQ(buffer->front(len), nullptr);
+}
+
+TEST_F(PacketSlotBufferTest, ClearKeepsSlots) {
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(buffer->push(std::vector<uint8_t>(8, i)));
+    }
+    buffer->clear();
+    EXPECT_TRUE(buffer->empty());
+
+    size_t len = 0;
+    EXPECT_EQ(buffer->front(len), nullptr);
+    EXPECT_TRUE(buffer->push(std::vector<uint8_t>(8, 5)));
+
+    std::vector<uint8_t> outPacket;
+    ASSERT_TRUE(buffer->pop(outPacket));
+    EXPECT_EQ(outPacket[0], 5);
+}
+
+TEST_F(PacketSlotBufferTest, ConcurrentProducerConsumer) {
+    const int numPackets = 100000;
+    std::atomic<bool> shouldStop{false};
+
+    auto producer = std::thread([&]() {
+        for (int i = 0; i < numPackets && !shouldStop;) {
+            const bool pushed = buffer->emplace([i](uint8_t* data, size_t) {
+                std::memcpy(data, &i, sizeof(i));
+                return sizeof(i) + i % 8;
+            });
+            if (pushed) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < numPackets) {
+        size_t len = 0;
+        const uint8_t* data = buffer->front(len);
+        if (data == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int value;
+        std::memcpy(&value, data, sizeof(value));
+        if (value != expected || len != sizeof(value) + expected % 8) {
+            // Leave the loop rather than return: the producer must be joined first
+            EXPECT_EQ(value, expected);
+            EXPECT_EQ(len, sizeof(value) + expected % 8);
+            break;
+        }
+        buffer->release();
+        expected++;
+    }
+
+    shouldStop = true;  // Unblocks the producer if the consumer gave up early
+    producer.join();
+    ASSERT_EQ(expected, numPackets);
+    EXPECT_TRUE(buffer->empty());
+}
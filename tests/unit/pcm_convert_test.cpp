@@ -0,0 +1,109 @@
+#include "audio/pcm_convert.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "kernel_test.hpp"
+
+class PcmConvertTest : public KernelTest {
+protected:
+    static int16_t sample_at(const std::vector<uint8_t>& bytes, size_t i) {
+        return static_cast<int16_t>((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+    }
+
+    // Random samples in [-1.5, 1.5] so that both rails get exercised; odd length for the tails
+    static std::vector<float> createNoise(size_t count) {
+        return random_samples(count, 1234, 1.5f);
+    }
+};
+
+TEST_P(PcmConvertTest, MatchesScalarReference) {
+    auto samples = createNoise(1001);
+
+    std::vector<uint8_t> expected(samples.size() * 2);
+    std::vector<uint8_t> actual(samples.size() * 2);
+    float_to_pcm16be(samples.data(), expected.data(), samples.size(), nullptr, PcmKernel::Scalar);
+    float_to_pcm16be(samples.data(), actual.data(), samples.size(), nullptr, GetParam());
+    EXPECT_EQ(actual, expected);
+
+    std::vector<float> decoded_expected(samples.size());
+    std::vector<float> decoded_actual(samples.size());
+    pcm16be_to_float(expected.data(), decoded_expected.data(), samples.size(), PcmKernel::Scalar);
+    pcm16be_to_float(expected.data(), decoded_actual.data(), samples.size(), GetParam());
+    EXPECT_EQ(decoded_actual, decoded_expected);
+}
+
+TEST_P(PcmConvertTest, SaturatesAndStoresBigEndian) {
+    std::vector<float> samples = {0.0f, 1.0f,  -1.0f, 2.0f,   -2.0f, 0.5f,  -0.25f, 1e9f,
+                                  -1e9f, 0.0f, 1.0f,  -1.0f,  2.0f,  -2.0f, 0.5f,   -0.25f,
+                                  std::numeric_limits<float>::infinity()};
+    std::vector<uint8_t> bytes(samples.size() * 2);
+    float_to_pcm16be(samples.data(), bytes.data(), samples.size(), nullptr, GetParam());
+
+    EXPECT_EQ(sample_at(bytes, 0), 0);
+    EXPECT_EQ(sample_at(bytes, 1), 32767);
+    EXPECT_EQ(sample_at(bytes, 2), -32767);
+    EXPECT_EQ(sample_at(bytes, 3), 32767);   // No wrap-around above full scale
+    EXPECT_EQ(sample_at(bytes, 4), -32768);
+    EXPECT_EQ(sample_at(bytes, 5), 16384);   // 16383.5 rounds to even
+    EXPECT_EQ(sample_at(bytes, 6), -8192);
+    EXPECT_EQ(sample_at(bytes, 7), 32767);
+    EXPECT_EQ(sample_at(bytes, 8), -32768);
+    EXPECT_EQ(sample_at(bytes, 16), 32767);
+
+    // Network byte order
+    EXPECT_EQ(bytes[2], 0x7F);
+    EXPECT_EQ(bytes[3], 0xFF);
+}
+
+TEST_P(PcmConvertTest, RoundTripWithinOneStep) {
+    std::vector<float> samples(100);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = std::sin(i * 0.1f) * 0.9f;
+    }
+
+    std::vector<uint8_t> bytes(samples.size() * 2);
+    std::vector<float> decoded(samples.size());
+    float_to_pcm16be(samples.data(), bytes.data(), samples.size(), nullptr, GetParam());
+    pcm16be_to_float(bytes.data(), decoded.data(), samples.size(), GetParam());
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_NEAR(decoded[i], samples[i], 2.0f / 32768.0f);
+    }
+
+    // Decoding covers the full int16 range
+    const uint8_t extremes[] = {0x80, 0x00, 0x7F, 0xFF};
+    float out[2];
+    pcm16be_to_float(extremes, out, 2, GetParam());
+    EXPECT_EQ(out[0], -1.0f);
+    EXPECT_FLOAT_EQ(out[1], 32767.0f / 32768.0f);
+}
+
+TEST_P(PcmConvertTest, DitherStaysWithinOneLsb) {
+    std::vector<float> samples(1000, 0.25f);
+    std::vector<uint8_t> plain(samples.size() * 2);
+    std::vector<uint8_t> dithered(samples.size() * 2);
+    float_to_pcm16be(samples.data(), plain.data(), samples.size(), nullptr, GetParam());
+
+    TpdfDither dither(7);
+    float_to_pcm16be(samples.data(), dithered.data(), samples.size(), &dither, GetParam());
+
+    bool changed = false;
+    for (size_t i = 0; i < samples.size(); i++) {
+        const int diff = sample_at(dithered, i) - sample_at(plain, i);
+        EXPECT_LE(std::abs(diff), 1);
+        changed |= diff != 0;
+    }
+    EXPECT_TRUE(changed);
+
+    // Same seed, same output
+    std::vector<uint8_t> again(samples.size() * 2);
+    TpdfDither replay(7);
+    float_to_pcm16be(samples.data(), again.data(), samples.size(), &replay, GetParam());
+    EXPECT_EQ(again, dithered);
+}
+
+INSTANTIATE_KERNEL_TESTS(PcmConvertTest);
@@ -0,0 +1,227 @@
+#include "core/pipeline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+// Multiplies every sample; optionally drops every n-th frame or stalls
+class GainStage : public AudioStage {
+public:
+    GainStage(float gain, uint64_t drop_every = 0) : gain_(gain), drop_every_(drop_every) {}
+
+    const char* name() const override {
+        return "gain";
+    }
+
+    bool process(AudioFrame& frame) override {
+        while (hold) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        thread = std::this_thread::get_id();
+        if (drop_every_ > 0 && frame.sequence % drop_every_ == drop_every_ - 1) {
+            return false;
+        }
+        for (size_t c = 0; c < frame.channels; c++) {
+            for (size_t i = 0; i < frame.samples; i++) {
+                frame.channel(c)[i] *= gain_;
+            }
+        }
+        return true;
+    }
+
+    std::atomic<bool> hold{false};
+    std::thread::id thread;
+
+private:
+    float gain_;
+    uint64_t drop_every_;
+};
+
+// Keeps the first channel only
+class FirstChannelStage : public AudioStage {
+public:
+    const char* name() const override {
+        return "first-channel";
+    }
+
+    bool configure(AudioFormat& format) override {
+        format.channels = 1;
+        return true;
+    }
+
+    bool process(AudioFrame& frame) override {
+        frame.channels = 1;
+        return true;
+    }
+};
+
+struct Sink {
+    std::mutex mutex;
+    std::vector<float> samples;
+    std::vector<uint64_t> sequences;
+    uint64_t skipped = 0;
+    std::thread::id thread;
+
+    EdgeVoxPipeline::FrameSink function() {
+        return [this](const AudioFrame& frame, uint64_t skip) {
+            std::lock_guard<std::mutex> lock(mutex);
+            samples.insert(samples.end(), frame.channel(0), frame.channel(0) + frame.samples);
+            sequences.push_back(frame.sequence);
+            skipped += skip;
+            thread = std::this_thread::get_id();
+        };
+    }
+
+    size_t frames() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sequences.size();
+    }
+};
+
+bool wait_for(Sink& sink, size_t frames) {
+    for (int i = 0; i < 200 && sink.frames() < frames; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return sink.frames() >= frames;
+}
+
+AudioFormat mono(size_t frame_samples) {
+    AudioFormat format;
+    format.sample_rate = 16000;
+    format.channels = 1;
+    format.frame_samples = frame_samples;
+    return format;
+}
+
+std::vector<float> ramp(size_t count) {
+    std::vector<float> samples(count);
+    std::iota(samples.begin(), samples.end(), 0.0f);
+    return samples;
+}
+}  // namespace
+
+TEST(PipelineTest, SourceCutsFixedFrames) {
+    Sink sink;
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.start(mono(160), sink.function()));
+
+    // Blocks of any size come out as whole frames; the remainder waits for more
+    const std::vector<float> input = ramp(500);
+    pipeline.push(input.data(), 100);
+    pipeline.push(input.data() + 100, 400);
+    pipeline.stop();
+
+    ASSERT_EQ(sink.sequences, (std::vector<uint64_t>{0, 1, 2}));
+    EXPECT_EQ(sink.samples, std::vector<float>(input.begin(), input.begin() + 480));
+    EXPECT_EQ(sink.thread, std::this_thread::get_id());  // No stages: all on the caller
+
+    const EdgeVoxPipelineStats stats = pipeline.get_stats();
+    EXPECT_EQ(stats.frames, 3u);
+    EXPECT_EQ(stats.delivered, 3u);
+    EXPECT_TRUE(stats.stages.empty());
+}
+
+TEST(PipelineTest, StagesRunInOrderOnTheirThreads) {
+    auto inline_gain = std::make_unique<GainStage>(2.0f);
+    auto worker_gain = std::make_unique<GainStage>(3.0f);
+    GainStage* first = inline_gain.get();
+    GainStage* second = worker_gain.get();
+
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::move(inline_gain)));
+    ASSERT_TRUE(pipeline.add_stage(std::move(worker_gain), {true, 16}));
+    EXPECT_EQ(pipeline.stage_count(), 2u);
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(80), sink.function()));
+    EXPECT_FALSE(pipeline.add_stage(std::make_unique<GainStage>(1.0f)));  // Not while running
+
+    const std::vector<float> input = ramp(800);
+    pipeline.push(input.data(), input.size());
+    ASSERT_TRUE(wait_for(sink, 10));
+    pipeline.stop();
+
+    ASSERT_EQ(sink.samples.size(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        EXPECT_FLOAT_EQ(sink.samples[i], input[i] * 6.0f);
+    }
+    EXPECT_EQ(first->thread, std::this_thread::get_id());
+    EXPECT_NE(second->thread, std::this_thread::get_id());
+    EXPECT_EQ(sink.thread, second->thread);
+    EXPECT_EQ(sink.skipped, 0u);
+
+    const EdgeVoxPipelineStats stats = pipeline.get_stats();
+    ASSERT_EQ(stats.stages.size(), 2u);
+    EXPECT_EQ(stats.stages[0].name, "gain");
+    EXPECT_EQ(stats.stages[0].frames, 10u);
+    EXPECT_EQ(stats.stages[1].frames, 10u);
+    EXPECT_GE(stats.stages[1].max_queue_depth, 1u);
+    EXPECT_GE(stats.stages[1].max_process_us, stats.stages[1].avg_process_us);
+}
+
+TEST(PipelineTest, DroppedFramesAreSkipped) {
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<GainStage>(1.0f, 3)));
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(100), sink.function()));
+    const std::vector<float> input = ramp(1000);
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+
+    // Every third frame dropped: frames 2, 5 and 8, each 100 samples of gap
+    EXPECT_EQ(sink.sequences, (std::vector<uint64_t>{0, 1, 3, 4, 6, 7, 9}));
+    EXPECT_EQ(sink.skipped, 300u);
+    EXPECT_EQ(pipeline.get_stats().stages[0].dropped, 3u);
+}
+
+TEST(PipelineTest, FullQueueOverflows) {
+    auto stage = std::make_unique<GainStage>(1.0f);
+    GainStage* slow = stage.get();
+    slow->hold = true;
+
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::move(stage), {true, 4}));
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(10), sink.function()));
+
+    // The frame stuck in process() keeps its slot: three queue behind it, the rest overflow
+    const std::vector<float> input = ramp(100);
+    for (size_t i = 0; i < 10; i++) {
+        pipeline.push(input.data() + i * 10, 10);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const EdgeVoxPipelineStats held = pipeline.get_stats();
+    EXPECT_GE(held.stages[0].overflows, 5u);
+    EXPECT_EQ(held.stages[0].max_queue_depth, 4u);
+
+    slow->hold = false;
+    ASSERT_TRUE(wait_for(sink, 10 - held.stages[0].overflows));
+    pipeline.stop();
+    EXPECT_EQ(sink.frames() + pipeline.get_stats().stages[0].overflows, 10u);
+}
+
+TEST(PipelineTest, StagesMayChangeTheFormat) {
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<FirstChannelStage>()));
+
+    AudioFormat stereo = mono(4);
+    stereo.channels = 2;
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(stereo, sink.function()));
+    EXPECT_EQ(pipeline.output_format().channels, 1);
+
+    // Interleaved in, planar through the stages
+    const std::vector<float> input = {0, 10, 1, 11, 2, 12, 3, 13};
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+    EXPECT_EQ(sink.samples, (std::vector<float>{0, 1, 2, 3}));
+
+    EXPECT_FALSE(pipeline.start(mono(0), sink.function()));
+}
@@ -0,0 +1,160 @@
+#include "audio/resampler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "core/pipeline.hpp"
+#include "edge_vox/audio/resampler_stage.hpp"
+#include "kernel_test.hpp"
+
+namespace {
+std::vector<float> tone(size_t count, float freq, uint32_t rate, float amplitude = 0.5f) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = amplitude * std::sin(2.0f * 3.14159265f * freq * i / rate);
+    }
+    return samples;
+}
+
+std::vector<float> resample(PolyphaseResampler& resampler, const std::vector<float>& in,
+                            size_t block) {
+    std::vector<float> out;
+    std::vector<float> buffer(resampler.max_output(block));
+    for (size_t i = 0; i < in.size(); i += block) {
+        const size_t n = std::min(block, in.size() - i);
+        const size_t count = resampler.process(0, in.data() + i, n, buffer.data());
+        out.insert(out.end(), buffer.begin(), buffer.begin() + count);
+    }
+    return out;
+}
+
+double rms(const float* samples, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        sum += samples[i] * samples[i];
+    }
+    return std::sqrt(sum / count);
+}
+}  // namespace
+
+class ResamplerTest : public KernelTest {};
+
+TEST_P(ResamplerTest, MatchesScalarReference) {
+    const std::vector<float> input = random_samples(4410, 1234);
+    for (auto [in_rate, out_rate] : {std::pair{48000u, 16000u}, std::pair{16000u, 48000u},
+                                     std::pair{44100u, 16000u}}) {
+        PolyphaseResampler expected;
+        PolyphaseResampler actual;
+        ASSERT_TRUE(expected.configure(in_rate, out_rate, ResamplerQuality::Best, 1, 441,
+                                       PcmKernel::Scalar));
+        ASSERT_TRUE(actual.configure(in_rate, out_rate, ResamplerQuality::Best, 1, 441,
+                                     GetParam()));
+
+        const std::vector<float> a = resample(expected, input, 441);
+        const std::vector<float> b = resample(actual, input, 441);
+        ASSERT_EQ(a.size(), b.size());
+        EXPECT_EQ(a.size(), static_cast<size_t>(4410) * out_rate / in_rate);
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_NEAR(a[i], b[i], 1e-5f) << in_rate << " -> " << out_rate << " at " << i;
+        }
+    }
+}
+
+TEST_P(ResamplerTest, BlockSizeDoesNotMatter) {
+    const std::vector<float> input = random_samples(4800, 1234);
+    PolyphaseResampler whole;
+    PolyphaseResampler pieces;
+    ASSERT_TRUE(whole.configure(44100, 16000, ResamplerQuality::Medium, 1, 4800, GetParam()));
+    ASSERT_TRUE(pieces.configure(44100, 16000, ResamplerQuality::Medium, 1, 4800, GetParam()));
+
+    // Blocks that cut the 441:160 cycle anywhere
+    std::vector<float> expected = resample(whole, input, 4800);
+    std::vector<float> actual;
+    std::vector<float> buffer(pieces.max_output(4800));
+    size_t offset = 0;
+    for (size_t n : {1, 7, 100, 441, 443, 2000, 1808}) {
+        const size_t count = pieces.process(0, input.data() + offset, n, buffer.data());
+        actual.insert(actual.end(), buffer.begin(), buffer.begin() + count);
+        offset += n;
+    }
+    ASSERT_EQ(offset, input.size());
+    EXPECT_EQ(actual, expected);
+
+    // And after a reset it starts over
+    whole.reset();
+    EXPECT_EQ(resample(whole, input, 4800), expected);
+}
+
+TEST_P(ResamplerTest, KeepsTheBandAndRejectsAliases) {
+    for (ResamplerQuality quality :
+         {ResamplerQuality::Fast, ResamplerQuality::Medium, ResamplerQuality::Best}) {
+        PolyphaseResampler resampler;
+        ASSERT_TRUE(resampler.configure(48000, 16000, quality, 1, 48000, GetParam()));
+
+        // 1 kHz comes through at its level, delayed by half the filter
+        const std::vector<float> in_band = resample(resampler, tone(48000, 1000.0f, 48000), 480);
+        ASSERT_EQ(in_band.size(), 16000u);
+        EXPECT_NEAR(rms(in_band.data() + 8000, 8000), 0.5 / std::sqrt(2.0), 0.01);
+
+        // 12 kHz would fold onto 4 kHz; it must be gone (-45 dB even for Fast)
+        resampler.reset();
+        const std::vector<float> alias = resample(resampler, tone(48000, 12000.0f, 48000), 480);
+        EXPECT_LT(rms(alias.data() + 8000, 8000), 0.5 / std::sqrt(2.0) * 0.0056);
+    }
+}
+
+TEST_P(ResamplerTest, UpsamplesATone) {
+    PolyphaseResampler resampler;
+    ASSERT_TRUE(resampler.configure(16000, 48000, ResamplerQuality::Medium, 1, 160, GetParam()));
+    const std::vector<float> out = resample(resampler, tone(16000, 440.0f, 16000), 160);
+    ASSERT_EQ(out.size(), 48000u);
+
+    // Against the same tone at 48 kHz, delayed by the centre of the 3 x taps() filter
+    const double delay = (resampler.taps() * 3 - 1) / 2.0;
+    double error = 0.0;
+    for (size_t i = 24000; i < 48000; i++) {
+        const double expected = 0.5 * std::sin(2.0 * 3.14159265358979 * 440.0 * (i - delay) /
+                                                48000.0);
+        error = std::max(error, std::abs(out[i] - expected));
+    }
+    EXPECT_LT(error, 0.005);
+}
+
+INSTANTIATE_KERNEL_TESTS(ResamplerTest);
+
+TEST(ResamplerStageTest, ConvertsPipelineFrames) {
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.set_output_stage(std::make_unique<ResamplerStage>(16000)));
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<ResamplerStage>(48000)));  // No-op
+
+    AudioFormat format;
+    format.sample_rate = 48000;
+    format.frame_samples = 480;
+    std::vector<size_t> sizes;
+    ASSERT_TRUE(pipeline.start(format, [&](const AudioFrame& frame, uint64_t) {
+        EXPECT_EQ(frame.sample_rate, 16000u);
+        sizes.push_back(frame.samples);
+    }));
+    EXPECT_EQ(pipeline.output_format().sample_rate, 16000u);
+    EXPECT_EQ(pipeline.output_format().frame_samples, 160u);
+
+    const std::vector<float> input = tone(4800, 1000.0f, 48000);
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+    EXPECT_EQ(sizes, std::vector<size_t>(10, 160));
+
+    // The output stage stays last
+    const EdgeVoxPipelineStats stats = pipeline.get_stats();
+    ASSERT_EQ(stats.stages.size(), 2u);
+    EXPECT_EQ(stats.stages[1].frames, 10u);
+
+    // 100-sample frames can't be cut into thirds; without the stage they pass as they are
+    format.frame_samples = 100;
+    EXPECT_FALSE(pipeline.start(format, [](const AudioFrame&, uint64_t) {}));
+    ASSERT_TRUE(pipeline.set_output_stage(nullptr));
+    ASSERT_TRUE(pipeline.start(format, [](const AudioFrame&, uint64_t) {}));
+    EXPECT_EQ(pipeline.output_format().sample_rate, 48000u);
+    pipeline.stop();
+}
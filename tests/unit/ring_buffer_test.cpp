@@ -0,0 +1,377 @@
+#include "edge_vox/audio/ring_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class CaptureRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ring = std::make_unique<CaptureRingBuffer>(1000);
+    }
+
+    std::vector<float> createRamp(size_t count, float start) {
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = start + static_cast<float>(i);
+        }
+        return samples;
+    }
+
+    std::unique_ptr<CaptureRingBuffer> ring;
+};
+
+TEST_F(CaptureRingBufferTest, CapacityIsPowerOfTwo) {
+    EXPECT_EQ(ring->capacity(), 1024u);
+    EXPECT_EQ(ring->size(), 0u);
+
+    CaptureRingBuffer exact(512);
+    EXPECT_EQ(exact.capacity(), 512u);
+}
+
+TEST_F(CaptureRingBufferTest, ReadLatestReturnsMostRecent) {
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+
+    std::vector<float> out(10);
+    ASSERT_EQ(ring->read_latest(10, out.data()), 10u);
+    for (size_t i = 0; i < 10; i++) {
+        EXPECT_EQ(out[i], 90.0f + i);
+    }
+
+    // Asking for more than available returns what is retained
+    out.resize(500);
+    EXPECT_EQ(ring->read_latest(500, out.data()), 100u);
+    EXPECT_EQ(out[0], 0.0f);
+}
+
+TEST_F(CaptureRingBufferTest, WrapAroundKeepsOrder) {
+    for (int block = 0; block < 5; block++) {
+        auto samples = createRamp(300, block * 300.0f);
+        ring->write(samples.data(), samples.size());
+    }
+
+    EXPECT_EQ(ring->write_index(), 1500u);
+    EXPECT_EQ(ring->size(), ring->capacity());
+
+    std::vector<float> out(ring->capacity());
+    ASSERT_EQ(ring->read_latest(out.size(), out.data()), ring->capacity());
+    for (size_t i = 0; i < out.size(); i++) {
+        EXPECT_EQ(out[i], static_cast<float>(1500 - ring->capacity() + i));
+    }
+}
+
+TEST_F(CaptureRingBufferTest, OversizedWriteKeepsTail) {
+    auto samples = createRamp(3000, 0.0f);
+    ring->write(samples.data(), samples.size());
+
+    EXPECT_EQ(ring->write_index(), 3000u);
+
+    std::vector<float> out(1);
+    ASSERT_EQ(ring->read_latest(1, out.data()), 1u);
+    EXPECT_EQ(out[0], 2999.0f);
+}
+
+TEST_F(CaptureRingBufferTest, ClearDropsRetainedSamples) {
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+    ring->clear();
+
+    EXPECT_EQ(ring->size(), 0u);
+
+    std::vector<float> out(10);
+    EXPECT_EQ(ring->read_latest(10, out.data()), 0u);
+
+    ring->write(samples.data(), 5);
+    EXPECT_EQ(ring->size(), 5u);
+}
+
+TEST_F(CaptureRingBufferTest, ReadNewDeliversEachSampleOnce) {
+    std::vector<float> out(64);
+    uint64_t index = 0;
+    uint64_t overrun = 0;
+
+    EXPECT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 0u);
+
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+    EXPECT_EQ(ring->available(), 100u);
+
+    ASSERT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 64u);
+    EXPECT_EQ(index, 0u);
+    EXPECT_EQ(overrun, 0u);
+    EXPECT_EQ(out[63], 63.0f);
+
+    ASSERT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 36u);
+    EXPECT_EQ(index, 64u);
+    EXPECT_EQ(out[0], 64.0f);
+    EXPECT_EQ(ring->available(), 0u);
+}
+
+TEST_F(CaptureRingBufferTest, ReadNewReportsOverrun) {
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+
+    std::vector<float> out(100);
+    ring->read_new(out.size(), out.data());
+
+    // Lap the reader by 200 samples
+    auto more = createRamp(ring->capacity() + 200, 100.0f);
+    ring->write(more.data(), more.size());
+
+    uint64_t index = 0;
+    uint64_t overrun = 0;
+    ASSERT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 100u);
+    EXPECT_EQ(overrun, 200u);
+    EXPECT_EQ(index, 300u);
+    EXPECT_EQ(out[0], 300.0f);
+    EXPECT_EQ(ring->overrun_count(), 200u);
+}
+
+TEST_F(CaptureRingBufferTest, ReadNewSkipsClearedSamples) {
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+    ring->clear();
+    ring->write(samples.data(), 10);
+
+    std::vector<float> out(100);
+    uint64_t index = 0;
+    uint64_t overrun = 0;
+    ASSERT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 10u);
+    EXPECT_EQ(index, 100u);
+    EXPECT_EQ(overrun, 0u);
+}
+
+TEST_F(CaptureRingBufferTest, OverrunAfterClearCountsFromTheClear) {
+    auto samples = createRamp(100, 0.0f);
+    ring->write(samples.data(), samples.size());
+
+    std::vector<float> out(100);
+    ring->read_new(out.size(), out.data());
+
+    // Clear at 1000, then lap the reader: only what was written after the clear is lost
+    auto more = createRamp(900, 100.0f);
+    ring->write(more.data(), more.size());
+    ring->clear();
+    auto after = createRamp(ring->capacity() + 76, 1000.0f);
+    ring->write(after.data(), after.size());
+
+    uint64_t index = 0;
+    uint64_t overrun = 0;
+    ASSERT_EQ(ring->read_new(out.size(), out.data(), &index, &overrun), 100u);
+    EXPECT_EQ(overrun, 76u);
+    EXPECT_EQ(index, 1076u);
+    EXPECT_EQ(out[0], 1076.0f);
+    EXPECT_EQ(ring->overrun_count(), 76u);
+}
+
+TEST_F(CaptureRingBufferTest, ViewLatestSplitsAtWrap) {
+    auto samples = createRamp(1000, 0.0f);
+    ring->write(samples.data(), samples.size());
+    ring->write(samples.data(), 100);  // Head is now at 1100, wrapped past 1024
+
+    CaptureView view = ring->view_latest(200);
+    ASSERT_EQ(view.size(), 200u);
+    EXPECT_EQ(view.sample_index, 900u);
+    EXPECT_EQ(view.first_len, 124u);
+    EXPECT_EQ(view.second_len, 76u);
+    EXPECT_EQ(view.first[0], 900.0f);
+    EXPECT_EQ(view.second[0], 24.0f);  // Index 1024 holds samples[24] of the second write
+    EXPECT_TRUE(ring->validate(view));
+}
+
+TEST_F(CaptureRingBufferTest, ViewInvalidatedWhenOverwritten) {
+    auto samples = createRamp(1024, 0.0f);
+    ring->write(samples.data(), samples.size());
+
+    CaptureView view = ring->view_latest(1024);
+    ASSERT_EQ(view.size(), 1024u);
+    EXPECT_TRUE(ring->validate(view));
+
+    ring->write(samples.data(), 1);
+    EXPECT_FALSE(ring->validate(view));
+
+    // A view over only the newest samples survives a small write
+    CaptureView recent = ring->view_latest(100);
+    ring->write(samples.data(), 10);
+    EXPECT_TRUE(ring->validate(recent));
+}
+
+TEST_F(CaptureRingBufferTest, ViewOfEmptyRing) {
+    CaptureView view = ring->view_latest(100);
+    EXPECT_TRUE(view.empty());
+}
+
+TEST_F(CaptureRingBufferTest, PlanarChannelsShareOneIndex) {
+    CaptureRingBuffer planar;
+    planar.reset(16, 3);
+    EXPECT_EQ(planar.channels(), 3u);
+
+    // Interleaved blocks of 3 channels, channel c of frame i holding 100 * c + i, written
+    // across the wrap
+    uint64_t frame = 0;
+    for (size_t block : {10, 12}) {
+        std::vector<float> in(block * 3);
+        for (size_t i = 0; i < block; i++) {
+            for (size_t c = 0; c < 3; c++) {
+                in[i * 3 + c] = 100.0f * c + frame + i;
+            }
+        }
+        planar.write_with(block, [&in](float* dst, size_t stride, size_t offset, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                for (size_t c = 0; c < 3; c++) {
+                    dst[c * stride + i] = in[(offset + i) * 3 + c];
+                }
+            }
+        });
+        frame += block;
+    }
+    EXPECT_EQ(planar.write_index(), 22u);
+    EXPECT_EQ(planar.size(), 16u);
+
+    std::vector<float> out(5);
+    for (size_t c = 0; c < 3; c++) {
+        ASSERT_EQ(planar.read_latest(out.size(), out.data(), c), 5u);
+        for (size_t i = 0; i < out.size(); i++) {
+            EXPECT_EQ(out[i], 100.0f * c + 17 + i) << "channel " << c;
+        }
+
+        const CaptureView view = planar.view_latest(16, c);
+        ASSERT_EQ(view.size(), 16u);
+        EXPECT_EQ(view.sample_index, 6u);
+        EXPECT_EQ(view.first_len, 10u);
+        EXPECT_EQ(view.first[0], 100.0f * c + 6);
+        EXPECT_EQ(view.second[view.second_len - 1], 100.0f * c + 21);
+        EXPECT_TRUE(planar.validate(view));
+    }
+}
+
+TEST_F(CaptureRingBufferTest, ConcurrentProducerConsumer) {
+    const size_t block = 256;
+    const int numBlocks = 2000;
+    std::atomic<bool> done{false};
+
+    // Producer writes a monotonically increasing ramp; any contiguous read must also be one
+    auto producer = std::thread([&]() {
+        std::vector<float> samples(block);
+        float next = 0.0f;
+        for (int b = 0; b < numBlocks; b++) {
+            for (auto& s : samples) {
+                s = next++;
+            }
+            ring->write(samples.data(), samples.size());
+        }
+        done = true;
+    });
+
+    std::vector<float> out(512);
+    size_t reads = 0;
+    while (!done) {
+        size_t n = ring->read_latest(out.size(), out.data());
+        for (size_t i = 1; i < n; i++) {
+            ASSERT_EQ(out[i], out[i - 1] + 1.0f) << "Torn read at " << i;
+        }
+        reads++;
+    }
+
+    producer.join();
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(ring->write_index(), block * numBlocks);
+}
+
+class PlaybackRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        queue = std::make_unique<PlaybackRingBuffer>(1000);
+    }
+
+    std::unique_ptr<PlaybackRingBuffer> queue;
+};
+
+TEST_F(PlaybackRingBufferTest, FifoOrderAcrossWrap) {
+    std::vector<float> in(300);
+    std::vector<float> out(300);
+    float next_in = 0.0f;
+    float next_out = 0.0f;
+
+    for (int round = 0; round < 10; round++) {
+        for (auto& s : in) {
+            s = next_in++;
+        }
+        ASSERT_TRUE(queue->write(in.data(), in.size()));
+        ASSERT_EQ(queue->read(out.data(), out.size()), out.size());
+        for (float s : out) {
+            EXPECT_EQ(s, next_out++);
+        }
+    }
+
+    EXPECT_EQ(queue->size(), 0u);
+}
+
+TEST_F(PlaybackRingBufferTest, PartialRead) {
+    std::vector<float> in(100, 1.0f);
+    ASSERT_TRUE(queue->write(in.data(), in.size()));
+
+    std::vector<float> out(256, 0.0f);
+    EXPECT_EQ(queue->read(out.data(), out.size()), 100u);
+    EXPECT_EQ(queue->read(out.data(), out.size()), 0u);
+}
+
+TEST_F(PlaybackRingBufferTest, HighWaterMarkRejectsOverflow) {
+    EXPECT_EQ(queue->high_water(), queue->capacity());
+
+    queue->set_high_water(500);
+    std::vector<float> in(300, 0.5f);
+    EXPECT_TRUE(queue->write(in.data(), in.size()));
+    EXPECT_FALSE(queue->write(in.data(), in.size()));  // 600 > 500, nothing queued
+    EXPECT_EQ(queue->size(), 300u);
+
+    // High-water mark never exceeds the storage
+    queue->set_high_water(1 << 20);
+    EXPECT_EQ(queue->high_water(), queue->capacity());
+}
+
+TEST_F(PlaybackRingBufferTest, ClearEmptiesQueue) {
+    std::vector<float> in(300, 0.5f);
+    ASSERT_TRUE(queue->write(in.data(), in.size()));
+    queue->clear();
+    EXPECT_EQ(queue->size(), 0u);
+
+    std::vector<float> out(10);
+    EXPECT_EQ(queue->read(out.data(), out.size()), 0u);
+}
+
+TEST_F(PlaybackRingBufferTest, ConcurrentProducerConsumer) {
+    const int total = 200000;
+    auto producer = std::thread([&]() {
+        std::vector<float> block(128);
+        int next = 0;
+        while (next < total) {
+            for (auto& s : block) {
+                s = static_cast<float>(next + (&s - block.data()));
+            }
+            if (queue->write(block.data(), block.size())) {
+                next += block.size();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<float> out(1024);
+    int expected = 0;
+    while (expected < total) {
+        size_t n = queue->read(out.data(), out.size());
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_EQ(out[i], static_cast<float>(expected++));
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(queue->size(), 0u);
+}
@@ -0,0 +1,396 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "net/rtcp_packet.hpp"
+#include "net/rtcp_session.hpp"
+#include "net/rtp_source_stats.hpp"
+
+namespace {
+// Generic NACK (RFC 4585 section 6.2.1) as the server sends it, one FCI entry per PID/BLP
+// pair. Returns the bytes written.
+size_t writeNack(uint8_t* out, uint32_t ssrc, uint32_t media_ssrc,
+                 const std::vector<std::pair<uint16_t, uint16_t>>& fci) {
+    auto put32 = [](uint8_t* p, uint32_t value) {
+        p[0] = static_cast<uint8_t>(value >> 24);
+        p[1] = static_cast<uint8_t>(value >> 16);
+        p[2] = static_cast<uint8_t>(value >> 8);
+        p[3] = static_cast<uint8_t>(value);
+    };
+
+    const size_t size = RTCP_HEADER_SIZE + 8 + fci.size() * 4;
+    out[0] = 0x80 | RTCP_FMT_NACK;
+    out[1] = RTCP_RTPFB;
+    out[2] = static_cast<uint8_t>((size / 4 - 1) >> 8);
+    out[3] = static_cast<uint8_t>(size / 4 - 1);
+    put32(out + 4, ssrc);
+    put32(out + 8, media_ssrc);
+    for (size_t i = 0; i < fci.size(); i++) {
+        put32(out + 12 + i * 4, static_cast<uint32_t>(fci[i].first) << 16 | fci[i].second);
+    }
+    return size;
+}
+}  // namespace
+
+TEST(RtcpPacketTest, SenderReportRoundTrip) {
+    RtcpSenderInfo info;
+    info.ssrc = 0x11223344;
+    info.ntp_timestamp = 0xE1234567'89ABCDEFULL;
+    info.rtp_timestamp = 160000;
+    info.packet_count = 1000;
+    info.octet_count = 320000;
+
+    RtcpReportBlock block;
+    block.ssrc = 0x55667788;
+    block.fraction_lost = 64;
+    block.cumulative_lost = -3;
+    block.highest_seq = 0x0001FFFF;
+    block.jitter = 42;
+    block.lsr = 0x456789AB;
+    block.dlsr = 0x00010000;
+
+    uint8_t buffer[256];
+    RtcpWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(writer.addSenderReport(info, &block, 1));
+    ASSERT_TRUE(writer.addCname(info.ssrc, "edge-vox@test"));
+    EXPECT_EQ(writer.size() % 4, 0u);
+    EXPECT_EQ(buffer[0], 0x81);  // Version 2, one report block
+    EXPECT_EQ(buffer[1], RTCP_SR);
+
+    std::vector<RtcpReport> reports;
+    ASSERT_TRUE(rtcpParseCompound(buffer, writer.size(),
+                                  [&](const RtcpReport& report) { reports.push_back(report); }));
+    ASSERT_EQ(reports.size(), 1u);  // SDES is skipped
+
+    const RtcpReport& report = reports[0];
+    EXPECT_TRUE(report.has_sender_info);
+    EXPECT_EQ(report.ssrc, info.ssrc);
+    EXPECT_EQ(report.sender.ntp_timestamp, info.ntp_timestamp);
+    EXPECT_EQ(report.sender.rtp_timestamp, info.rtp_timestamp);
+    EXPECT_EQ(report.sender.packet_count, info.packet_count);
+    EXPECT_EQ(report.sender.octet_count, info.octet_count);
+
+    ASSERT_EQ(report.block_count, 1u);
+    EXPECT_EQ(report.blocks[0].ssrc, block.ssrc);
+    EXPECT_EQ(report.blocks[0].fraction_lost, 64);
+    EXPECT_EQ(report.blocks[0].cumulative_lost, -3);
+    EXPECT_EQ(report.blocks[0].highest_seq, block.highest_seq);
+    EXPECT_EQ(report.blocks[0].jitter, 42u);
+    EXPECT_EQ(report.blocks[0].lsr, block.lsr);
+    EXPECT_EQ(report.blocks[0].dlsr, block.dlsr);
+}
+
+TEST(RtcpPacketTest, RejectsMalformedCompound) {
+    uint8_t buffer[64];
+    RtcpWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(writer.addReceiverReport(1, nullptr, 0));
+    ASSERT_TRUE(writer.addBye(1));
+
+    auto ignore = [](const RtcpReport&) {};
+    EXPECT_TRUE(rtcpParseCompound(buffer, writer.size(), ignore));
+    EXPECT_FALSE(rtcpParseCompound(buffer, writer.size() - 2, ignore));  // Truncated BYE
+
+    buffer[0] = 0x40;  // Version 1
+    EXPECT_FALSE(rtcpParseCompound(buffer, writer.size(), ignore));
+
+    // Nothing is written past the capacity
+    RtcpWriter small(buffer, 8);
+    EXPECT_FALSE(small.addReceiverReport(1, nullptr, 1));
+    EXPECT_TRUE(small.addReceiverReport(1, nullptr, 0));
+    EXPECT_FALSE(small.addBye(1));
+    EXPECT_EQ(small.size(), 8u);
+}
+
+TEST(RtcpPacketTest, NackParse) {
+    // 100..102 and 116 share one PID/BLP entry, 117 and 65535 have one each
+    const uint16_t seqs[] = {100, 101, 102, 116, 117, 65535};
+    uint8_t buffer[64];
+    const size_t size = writeNack(buffer, 0x1111, 0xABCD, {{100, 0x8003}, {117, 0}, {65535, 0}});
+
+    std::vector<uint16_t> parsed;
+    ASSERT_TRUE(rtcpParseCompound(
+        buffer, size, [](const RtcpReport&) {},
+        [&](uint32_t media_ssrc, uint16_t seq) {
+            EXPECT_EQ(media_ssrc, 0xABCDu);
+            parsed.push_back(seq);
+        }));
+    EXPECT_EQ(parsed, std::vector<uint16_t>(std::begin(seqs), std::end(seqs)));
+
+    // A NACK without the media SSRC is malformed
+    buffer[3] = 1;
+    EXPECT_FALSE(rtcpParseCompound(buffer, 8, [](const RtcpReport&) {}));
+}
+
+TEST(RtpSourceStatsTest, LossAndFractionPerInterval) {
+    RtpSourceStats stats(8000);
+    RtcpReportBlock block;
+    EXPECT_FALSE(stats.report(block));
+
+    // 0..9 with 3 and 7 missing, then 10..19 complete; sequence numbers wrap at 65536
+    const uint16_t base = 65530;
+    for (uint16_t i = 0; i < 10; i++) {
+        if (i != 3 && i != 7) {
+            stats.update(1234, base + i, i * 80, i * 10000);
+        }
+    }
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.ssrc, 1234u);
+    EXPECT_EQ(block.cumulative_lost, 2);
+    EXPECT_EQ(block.fraction_lost, 2 * 256 / 10);
+    EXPECT_EQ(block.highest_seq, 65536u + 3);  // One wrap, max seq 3
+    EXPECT_EQ(block.jitter, 0u);               // Perfectly paced
+
+    for (uint16_t i = 10; i < 20; i++) {
+        stats.update(1234, base + i, i * 80, i * 10000);
+    }
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.cumulative_lost, 2);
+    EXPECT_EQ(block.fraction_lost, 0);
+}
+
+TEST(RtpSourceStatsTest, JitterTracksArrivalVariation) {
+    RtpSourceStats stats(8000);
+
+    // 10ms packets arriving alternately on time and 2ms late: |D| is 2ms = 16 units
+    for (uint16_t i = 0; i < 500; i++) {
+        const uint64_t arrival = i * 10000 + (i % 2 ? 2000 : 0);
+        stats.update(1, i, i * 80, arrival);
+    }
+
+    RtcpReportBlock block;
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_NEAR(block.jitter, 16u, 1u);
+}
+
+TEST(RtpSourceStatsTest, NewSsrcRestartsStatistics) {
+    RtpSourceStats stats(8000);
+    stats.update(1, 100, 0, 0);
+    stats.update(1, 105, 400, 50000);
+
+    RtcpReportBlock block;
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.cumulative_lost, 4);
+
+    stats.update(2, 7, 0, 60000);
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.ssrc, 2u);
+    EXPECT_EQ(block.cumulative_lost, 0);
+    EXPECT_EQ(block.highest_seq, 7u);
+}
+
+TEST(RtpSourceStatsTest, IsolatedJumpKeepsStatistics) {
+    RtpSourceStats stats(8000);
+    for (uint16_t i = 0; i < 10; i++) {
+        stats.update(1, 1000 + i, i * 80, i * 10000);
+    }
+
+    // A stray packet far ahead and a stale one far behind are left out of the counts
+    stats.update(1, 20000, 0, 100000);
+    stats.update(1, 500, 0, 110000);
+    stats.update(1, 1010, 800, 120000);
+
+    RtcpReportBlock block;
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.cumulative_lost, 0);
+    EXPECT_EQ(block.highest_seq, 1010u);
+
+    // Two in a row after a jump restart the source
+    stats.update(1, 40000, 0, 130000);
+    stats.update(1, 40001, 80, 140000);
+    ASSERT_TRUE(stats.report(block));
+    EXPECT_EQ(block.cumulative_lost, 0);
+    EXPECT_EQ(block.highest_seq, 40001u);
+}
+
+// The test body plays the server on a plain UDP socket
+class RtcpSessionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(bind(server, (struct sockaddr*)&addr, sizeof(addr)), 0);
+        socklen_t len = sizeof(addr);
+        getsockname(server, (struct sockaddr*)&addr, &len);
+        server_port = ntohs(addr.sin_port);
+    }
+
+    void TearDown() override {
+        session.stop();
+        close(server);
+    }
+
+    // Wait for one compound packet from the session; returns its source address
+    bool receive_report(RtcpReport& out, sockaddr_in& from) {
+        pollfd fd{server, POLLIN, 0};
+        if (poll(&fd, 1, 2000) <= 0) {
+            return false;
+        }
+
+        uint8_t buffer[1500];
+        socklen_t len = sizeof(from);
+        const ssize_t size =
+            recvfrom(server, buffer, sizeof(buffer), 0, (struct sockaddr*)&from, &len);
+        bool found = false;
+        const bool valid = size > 0 && rtcpParseCompound(buffer, size, [&](const RtcpReport& r) {
+            out = r;
+            found = true;
+        });
+        return valid && found;
+    }
+
+    EdgeVoxRtcpSession session;
+    int server = -1;
+    uint16_t server_port = 0;
+};
+
+TEST_F(RtcpSessionTest, SendsReportsAndMeasuresRtt) {
+    ASSERT_TRUE(session.init("127.0.0.1", server_port));
+    session.set_interval(20);
+    session.set_send_clock_rate(8000);
+    session.set_receive_clock_rate(16000);
+    session.set_sender_source([](RtcpSenderInfo& info) {
+        info.ssrc = 0xABCD;
+        info.ntp_timestamp = rtcpNtpNow();
+        info.rtp_timestamp = 8000;
+        info.packet_count = 50;
+        info.octet_count = 8000;
+        return true;
+    });
+    session.set_report_source([](RtcpReportBlock& block) {
+        block = RtcpReportBlock();
+        block.ssrc = 0x1111;
+        block.fraction_lost = 128;
+        block.cumulative_lost = 7;
+        block.jitter = 80;
+        return true;
+    });
+    ASSERT_TRUE(session.start());
+
+    RtcpReport sr;
+    sockaddr_in from{};
+    ASSERT_TRUE(receive_report(sr, from));
+    ASSERT_TRUE(sr.has_sender_info);
+    EXPECT_EQ(sr.ssrc, 0xABCDu);
+    EXPECT_EQ(sr.sender.packet_count, 50u);
+    ASSERT_EQ(sr.block_count, 1u);
+    EXPECT_EQ(sr.blocks[0].ssrc, 0x1111u);
+    EXPECT_EQ(sr.blocks[0].lsr, 0u);  // No SR from the server yet
+
+    // Answer right away (DLSR 0) with an SR carrying a report block about the session
+    RtcpReportBlock block;
+    block.ssrc = sr.ssrc;
+    block.fraction_lost = 64;
+    block.cumulative_lost = 12;
+    block.jitter = 16;
+    block.lsr = rtcpNtpMiddle(sr.sender.ntp_timestamp);
+    block.dlsr = 0;
+
+    RtcpSenderInfo server_info;
+    server_info.ssrc = 0x1111;
+    server_info.ntp_timestamp = rtcpNtpNow();
+
+    uint8_t buffer[256];
+    RtcpWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(writer.addSenderReport(server_info, &block, 1));
+    ASSERT_EQ(sendto(server, buffer, writer.size(), 0, (struct sockaddr*)&from, sizeof(from)),
+              static_cast<ssize_t>(writer.size()));
+
+    // The next reports echo the server's SR for its own RTT
+    auto start = std::chrono::steady_clock::now();
+    EdgeVoxRtcpStats stats;
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        stats = session.get_stats();
+        if (stats.reports_received > 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    EXPECT_EQ(stats.reports_received, 1u);
+    EXPECT_EQ(stats.invalid, 0u);
+    EXPECT_GE(stats.reports_sent, 1u);
+    EXPECT_DOUBLE_EQ(stats.remote_fraction_lost, 0.25);
+    EXPECT_EQ(stats.remote_cumulative_lost, 12);
+    EXPECT_DOUBLE_EQ(stats.remote_jitter_ms, 2.0);
+    EXPECT_LT(stats.rtt_ms, 100.0);
+    EXPECT_DOUBLE_EQ(stats.fraction_lost, 0.5);
+    EXPECT_EQ(stats.cumulative_lost, 7);
+    EXPECT_DOUBLE_EQ(stats.jitter_ms, 5.0);  // On the 16 kHz clock of the inbound stream
+
+    RtcpReport rr;
+    do {
+        ASSERT_TRUE(receive_report(rr, from));
+    } while (rr.blocks[0].lsr == 0);
+    EXPECT_EQ(rr.blocks[0].lsr, rtcpNtpMiddle(server_info.ntp_timestamp));
+    EXPECT_LT(rr.blocks[0].dlsr, 65536u);  // Less than a second since the server's SR
+}
+
+TEST_F(RtcpSessionTest, ReceiverReportWhileNotSending) {
+    ASSERT_TRUE(session.init("127.0.0.1", server_port));
+    session.set_interval(20);
+    session.set_sender_source([](RtcpSenderInfo& info) {
+        info.ssrc = 0x42;
+        return false;
+    });
+    ASSERT_TRUE(session.start());
+
+    RtcpReport report;
+    sockaddr_in from{};
+    ASSERT_TRUE(receive_report(report, from));
+    EXPECT_FALSE(report.has_sender_info);
+    EXPECT_EQ(report.ssrc, 0x42u);
+    EXPECT_EQ(report.block_count, 0u);
+}
+
+TEST_F(RtcpSessionTest, DeliversNacks) {
+    ASSERT_TRUE(session.init("127.0.0.1", server_port));
+    session.set_interval(20);
+    session.set_sender_source([](RtcpSenderInfo& info) {
+        info.ssrc = 0x42;
+        return false;
+    });
+
+    std::mutex mutex;
+    std::vector<uint16_t> nacked;
+    session.set_nack_handler([&](uint32_t media_ssrc, const uint16_t* seqs, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(media_ssrc, 0x42u);
+        nacked.insert(nacked.end(), seqs, seqs + count);
+    });
+    ASSERT_TRUE(session.start());
+
+    RtcpReport report;
+    sockaddr_in from{};
+    ASSERT_TRUE(receive_report(report, from));
+
+    // RTCP feedback still starts with a report (RFC 4585 section 3.1); 7 and 9 in one entry
+    uint8_t buffer[128];
+    RtcpWriter writer(buffer, sizeof(buffer));
+    ASSERT_TRUE(writer.addReceiverReport(0x1111, nullptr, 0));
+    const size_t size =
+        writer.size() + writeNack(buffer + writer.size(), 0x1111, 0x42, {{7, 0x0002}});
+    ASSERT_EQ(sendto(server, buffer, size, 0, (struct sockaddr*)&from, sizeof(from)),
+              static_cast<ssize_t>(size));
+
+    auto start = std::chrono::steady_clock::now();
+    while (session.get_stats().nack_requests < 2 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    EXPECT_EQ(session.get_stats().nack_requests, 2u);
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(nacked, std::vector<uint16_t>({7, 9}));
+}
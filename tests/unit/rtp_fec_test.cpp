@@ -0,0 +1,172 @@
+#include "net/rtp_fec.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "net/rtp_packet.hpp"
+
+namespace {
+// Packets of different lengths and contents, so the recovered length and payload both count
+std::vector<std::vector<uint8_t>> create_packets(size_t count) {
+    RtpPacket packet;
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t i = 0; i < count; i++) {
+        std::vector<uint8_t> payload(40 + (i * 7) % 23);
+        for (size_t j = 0; j < payload.size(); j++) {
+            payload[j] = static_cast<uint8_t>(i * 31 + j);
+        }
+        packet.setPayload(payload);
+        packet.setMarker(i == 0);
+        packets.push_back(packet.serialize());
+        packet.incrementSequenceNumber();
+        packet.incrementTimestamp(160);
+    }
+    return packets;
+}
+
+// Run packets through an encoder; returns the parity packets in the order they were emitted
+std::vector<std::vector<uint8_t>> protect(RtpFecEncoder& encoder,
+                                          const std::vector<std::vector<uint8_t>>& packets) {
+    std::vector<std::vector<uint8_t>> parity;
+    for (const auto& packet : packets) {
+        const size_t size = encoder.add(packet.data(), RTP_HEADER_SIZE,
+                                        packet.data() + RTP_HEADER_SIZE,
+                                        packet.size() - RTP_HEADER_SIZE);
+        if (size > 0) {
+            parity.emplace_back(encoder.parity(), encoder.parity() + size);
+        }
+    }
+    return parity;
+}
+}  // namespace
+
+TEST(RtpFecTest, RejectsGroupsBeyondTheMask) {
+    RtpFecEncoder encoder;
+    EXPECT_FALSE(encoder.enabled());
+    EXPECT_TRUE(encoder.configure({16, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+    EXPECT_TRUE(encoder.configure({4, 5, FEC_DEFAULT_PAYLOAD_TYPE}));
+    EXPECT_FALSE(encoder.configure({17, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+    EXPECT_FALSE(encoder.configure({4, 6, FEC_DEFAULT_PAYLOAD_TYPE}));
+    EXPECT_FALSE(encoder.configure({4, 0, FEC_DEFAULT_PAYLOAD_TYPE}));
+    EXPECT_TRUE(encoder.configure({}));
+    EXPECT_FALSE(encoder.enabled());
+}
+
+TEST(RtpFecTest, ParityPacketLayout) {
+    RtpFecEncoder encoder;
+    ASSERT_TRUE(encoder.configure({4, 1, 120}));
+    const auto packets = create_packets(8);
+    const auto parity = protect(encoder, packets);
+    ASSERT_EQ(parity.size(), 2u);
+
+    // A stream of its own: payload type, SSRC and consecutive sequence numbers, on the media
+    // clock. SN base and mask cover the first four.
+    const auto& first = parity[0];
+    EXPECT_EQ(first[0] >> 6, RTP_VERSION);
+    EXPECT_EQ(first[1] & 0x7F, 120);
+    const auto read32 = [](const std::vector<uint8_t>& p, size_t at) {
+        return static_cast<uint32_t>(p[at] << 24 | p[at + 1] << 16 | p[at + 2] << 8 | p[at + 3]);
+    };
+    EXPECT_EQ(read32(first, 8), encoder.ssrc());
+    EXPECT_NE(read32(first, 8), read32(packets[0], 8));
+    EXPECT_EQ(read32(first, 4), read32(packets[3], 4));
+    EXPECT_EQ(static_cast<uint16_t>(parity[1][2] << 8 | parity[1][3]),
+              static_cast<uint16_t>((first[2] << 8 | first[3]) + 1));
+    EXPECT_EQ(first[12 + 2], packets[0][2]);
+    EXPECT_EQ(first[12 + 3], packets[0][3]);
+    EXPECT_EQ(first[12 + FEC_HEADER_SIZE + 2], 0xF0);
+    EXPECT_EQ(first[12 + FEC_HEADER_SIZE + 3], 0x00);
+
+    // As long as the longest packet plus the FEC headers
+    size_t longest = 0;
+    for (size_t i = 0; i < 4; i++) {
+        longest = std::max(longest, packets[i].size());
+    }
+    EXPECT_EQ(first.size(), longest + FEC_OVERHEAD_BYTES);
+
+    const RtpFecStats& stats = encoder.stats();
+    EXPECT_EQ(stats.media_packets, 8u);
+    EXPECT_EQ(stats.parity_packets, 2u);
+    EXPECT_EQ(stats.parity_bytes, parity[0].size() + parity[1].size());
+}
+
+TEST(RtpFecTest, RecoversAnySingleLossInAGroup) {
+    const auto packets = create_packets(4);
+    for (size_t lost = 0; lost < packets.size(); lost++) {
+        RtpFecEncoder encoder;
+        ASSERT_TRUE(encoder.configure({4, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+        const auto parity = protect(encoder, packets);
+        ASSERT_EQ(parity.size(), 1u);
+
+        RtpFecDecoder decoder;
+        for (size_t i = 0; i < packets.size(); i++) {
+            if (i != lost) {
+                EXPECT_EQ(decoder.add_media(packets[i].data(), packets[i].size()), 0u);
+            }
+        }
+
+        const size_t size = decoder.add_parity(parity[0].data(), parity[0].size());
+        ASSERT_EQ(size, packets[lost].size()) << "lost packet " << lost;
+        EXPECT_EQ(std::vector<uint8_t>(decoder.recovered(), decoder.recovered() + size),
+                  packets[lost]);
+        EXPECT_EQ(decoder.stats().recovered, 1u);
+    }
+}
+
+TEST(RtpFecTest, RecoversWhenMediaArrivesAfterParity) {
+    RtpFecEncoder encoder;
+    ASSERT_TRUE(encoder.configure({3, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+    const auto packets = create_packets(3);
+    const auto parity = protect(encoder, packets);
+    ASSERT_EQ(parity.size(), 1u);
+
+    // Two missing when the parity arrives, then a late packet leaves just one
+    RtpFecDecoder decoder;
+    EXPECT_EQ(decoder.add_media(packets[0].data(), packets[0].size()), 0u);
+    EXPECT_EQ(decoder.add_parity(parity[0].data(), parity[0].size()), 0u);
+    const size_t size = decoder.add_media(packets[2].data(), packets[2].size());
+    ASSERT_EQ(size, packets[1].size());
+    EXPECT_EQ(std::vector<uint8_t>(decoder.recovered(), decoder.recovered() + size), packets[1]);
+
+    // Nothing is left to recover once the parity is used
+    EXPECT_EQ(decoder.add_media(packets[1].data(), packets[1].size()), 0u);
+}
+
+TEST(RtpFecTest, InterleavingSurvivesBurstLoss) {
+    RtpFecEncoder encoder;
+    ASSERT_TRUE(encoder.configure({4, 2, FEC_DEFAULT_PAYLOAD_TYPE}));
+    const auto packets = create_packets(8);
+    const auto parity = protect(encoder, packets);
+    ASSERT_EQ(parity.size(), 2u);
+
+    // Packets 2 and 3 are lost back to back; each is alone in its group
+    RtpFecDecoder decoder;
+    for (size_t i : {0, 1, 4, 5, 6, 7}) {
+        decoder.add_media(packets[i].data(), packets[i].size());
+    }
+    for (const auto& p : parity) {
+        const size_t size = decoder.add_parity(p.data(), p.size());
+        ASSERT_GT(size, 0u);
+        const std::vector<uint8_t> recovered(decoder.recovered(), decoder.recovered() + size);
+        EXPECT_TRUE(recovered == packets[2] || recovered == packets[3]);
+    }
+    EXPECT_EQ(decoder.stats().recovered, 2u);
+}
+
+TEST(RtpFecTest, TwoLossesInAGroupAreNotRecovered) {
+    RtpFecEncoder encoder;
+    ASSERT_TRUE(encoder.configure({4, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+    const auto packets = create_packets(4);
+    const auto parity = protect(encoder, packets);
+
+    RtpFecDecoder decoder;
+    decoder.add_media(packets[0].data(), packets[0].size());
+    decoder.add_media(packets[3].data(), packets[3].size());
+    EXPECT_EQ(decoder.add_parity(parity[0].data(), parity[0].size()), 0u);
+    EXPECT_EQ(decoder.stats().recovered, 0u);
+
+    // Truncated parity is ignored
+    EXPECT_EQ(decoder.add_parity(parity[0].data(), RTP_HEADER_SIZE + FEC_HEADER_SIZE), 0u);
+}
@@ -243,4 +243,44 @@ TEST_F(RtpPacketTest, NetworkByteOrder) {
     EXPECT_EQ(serialized[5], 0x34);
     EXPECT_EQ(serialized[6], 0x56);
     EXPECT_EQ(serialized[7], 0x78);
-}
\ No newline at end of file
+}
+
+TEST_F(RtpPacketTest, SerializeIntoMatchesSerialize) {
+    packet->addCsrc(0xCAFEBABE);
+    packet->setMarker(true);
+    packet->incrementTimestamp(0xDEADBEEF);
+    packet->setPayload({1, 2, 3, 4, 5});
+
+    auto expected = packet->serialize();
+    EXPECT_EQ(expected.size(), packet->headerSize() + 5u);
+
+    std::vector<uint8_t> buffer(1500, 0xFF);
+    ASSERT_EQ(packet->serializeInto(buffer.data(), buffer.size()), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+    EXPECT_EQ(buffer[expected.size()], 0xFF);  // Nothing written past the packet
+}
+
+TEST_F(RtpPacketTest, SerializeIntoRejectsShortBuffer) {
+    packet->setPayload(std::vector<uint8_t>(100, 0xAB));
+
+    std::vector<uint8_t> buffer(12 + 99);
+    EXPECT_EQ(packet->serializeInto(buffer.data(), buffer.size()), 0u);
+}
+
+TEST_F(RtpPacketTest, WriteHeaderWithCsrcs) {
+    packet->addCsrc(0x01020304);
+    packet->addCsrc(0x05060708);
+
+    uint8_t buffer[12 + 8];
+    ASSERT_EQ(packet->writeHeader(buffer), sizeof(buffer));
+    EXPECT_EQ(packet->headerSize(), sizeof(buffer));
+
+    std::vector<uint8_t> data(buffer, buffer + sizeof(buffer));
+    auto header = parsePacketHeader(data);
+    EXPECT_EQ(header.version, 2);
+    EXPECT_EQ(header.csrcCount, 2);
+    EXPECT_EQ(header.payloadType, packet->getHeader().payloadType);
+    EXPECT_EQ(header.sequenceNumber, packet->getHeader().sequenceNumber);
+    EXPECT_EQ(header.ssrc, packet->getHeader().ssrc);
+    EXPECT_EQ(header.csrcList[1], 0x05060708u);
+}
@@ -0,0 +1,154 @@
+#include "net/rtp_packet_view.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "net/rtp_packet.hpp"
+
+class RtpPacketViewTest : public ::testing::Test {
+protected:
+    // Fixed header with the given first byte, seq 0x1234, ts 0x01020304, SSRC 0xAABBCCDD
+    std::vector<uint8_t> createHeader(uint8_t first_byte) {
+        return {first_byte, 0x80 | 96, 0x12, 0x34, 0x01, 0x02, 0x03, 0x04, 0xAA, 0xBB, 0xCC, 0xDD};
+    }
+};
+
+TEST_F(RtpPacketViewTest, ParsesSerializedPacket) {
+    RtpPacket packet;
+    packet.setMarker(true);
+    packet.incrementTimestamp(4800);
+    packet.setPayload({1, 2, 3, 4, 5, 6});
+    auto data = packet.serialize();
+
+    RtpPacketView view(data.data(), data.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.version(), 2);
+    EXPECT_TRUE(view.marker());
+    EXPECT_EQ(view.payloadType(), packet.getHeader().payloadType);
+    EXPECT_EQ(view.sequenceNumber(), packet.getHeader().sequenceNumber);
+    EXPECT_EQ(view.timestamp(), 4800u);
+    EXPECT_EQ(view.ssrc(), packet.getHeader().ssrc);
+    EXPECT_EQ(view.csrcCount(), 0);
+
+    // Payload points into the original buffer
+    EXPECT_EQ(view.payload(), data.data() + 12);
+    ASSERT_EQ(view.payloadSize(), 6u);
+    EXPECT_EQ(view.payload()[5], 6);
+}
+
+TEST_F(RtpPacketViewTest, ParsesCsrcList) {
+    RtpPacket packet;
+    packet.addCsrc(0x11111111);
+    packet.addCsrc(0x22222222);
+    packet.setPayload({9, 9});
+    auto data = packet.serialize();
+
+    RtpPacketView view(data.data(), data.size());
+    ASSERT_TRUE(view.valid());
+    ASSERT_EQ(view.csrcCount(), 2);
+    EXPECT_EQ(view.csrc(0), 0x11111111u);
+    EXPECT_EQ(view.csrc(1), 0x22222222u);
+    EXPECT_EQ(view.payloadSize(), 2u);
+    EXPECT_EQ(view.payload(), data.data() + 20);
+}
+
+TEST_F(RtpPacketViewTest, ParsesExtensionAndPadding) {
+    auto data = createHeader(0x80 | 0x20 | 0x10);  // Padding and extension
+    // Extension: profile 0xBEDE, one word of data
+    data.insert(data.end(), {0xBE, 0xDE, 0x00, 0x01, 0x10, 0x20, 0x30, 0x40});
+    data.insert(data.end(), {7, 8, 9});  // Payload
+    data.insert(data.end(), {0, 0, 3});  // Three octets of padding
+
+    RtpPacketView view(data.data(), data.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_TRUE(view.extension());
+    EXPECT_EQ(view.extensionProfile(), 0xBEDE);
+    ASSERT_EQ(view.extensionSize(), 4u);
+    EXPECT_EQ(view.extensionData()[3], 0x40);
+    EXPECT_EQ(view.paddingSize(), 3u);
+    ASSERT_EQ(view.payloadSize(), 3u);
+    EXPECT_EQ(view.payload()[0], 7);
+    EXPECT_EQ(view.sequenceNumber(), 0x1234);
+    EXPECT_EQ(view.timestamp(), 0x01020304u);
+    EXPECT_EQ(view.ssrc(), 0xAABBCCDDu);
+}
+
+TEST_F(RtpPacketViewTest, EmptyPayloadIsValid) {
+    auto data = createHeader(0x80);
+    RtpPacketView view(data.data(), data.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.payloadSize(), 0u);
+}
+
+TEST_F(RtpPacketViewTest, RejectsMalformedPackets) {
+    RtpPacketView view;
+
+    EXPECT_FALSE(view.parse(nullptr, 0));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::TooShort);
+
+    auto header = createHeader(0x80);
+    EXPECT_FALSE(view.parse(header.data(), 11));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::TooShort);
+
+    auto v1 = createHeader(0x40);
+    EXPECT_FALSE(view.parse(v1.data(), v1.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::BadVersion);
+
+    // Claims 3 CSRCs, carries one
+    auto csrc = createHeader(0x83);
+    csrc.insert(csrc.end(), {1, 2, 3, 4});
+    EXPECT_FALSE(view.parse(csrc.data(), csrc.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::CsrcTruncated);
+
+    // Extension header cut short, then extension length past the end
+    auto ext = createHeader(0x90);
+    ext.insert(ext.end(), {0xBE, 0xDE});
+    EXPECT_FALSE(view.parse(ext.data(), ext.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::ExtensionTruncated);
+    ext.insert(ext.end(), {0x00, 0x04, 1, 2, 3, 4});
+    EXPECT_FALSE(view.parse(ext.data(), ext.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::ExtensionTruncated);
+
+    // Padding count of zero, and larger than the packet body
+    auto pad = createHeader(0xA0);
+    pad.insert(pad.end(), {1, 2, 0});
+    EXPECT_FALSE(view.parse(pad.data(), pad.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::BadPadding);
+    pad.back() = 4;
+    EXPECT_FALSE(view.parse(pad.data(), pad.size()));
+    EXPECT_EQ(view.error(), RtpPacketView::Error::BadPadding);
+
+    // A failed parse leaves no stale state behind
+    EXPECT_FALSE(view.valid());
+    EXPECT_EQ(view.payloadSize(), 0u);
+}
+
+TEST_F(RtpPacketViewTest, RandomInputStaysInBounds) {
+    std::mt19937 gen(99);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<size_t> length(0, 64);
+
+    for (int i = 0; i < 20000; i++) {
+        std::vector<uint8_t> data(length(gen));
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(byte(gen));
+        }
+        if (!data.empty() && i % 2 == 0) {
+            data[0] = 0x80 | (data[0] & 0x3F);  // Make half of them version 2
+        }
+
+        RtpPacketView view(data.data(), data.size());
+        if (!view.valid()) {
+            continue;
+        }
+
+        const uint8_t* end = data.data() + data.size();
+        ASSERT_GE(view.payload(), data.data() + 12);
+        ASSERT_LE(view.payload() + view.payloadSize() + view.paddingSize(), end);
+        if (view.extensionData()) {
+            ASSERT_LE(view.extensionData() + view.extensionSize(), view.payload());
+        }
+    }
+}
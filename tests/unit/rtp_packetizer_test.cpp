@@ -0,0 +1,95 @@
+#include "net/rtp_packetizer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+class RtpPacketizerTest : public ::testing::Test {
+protected:
+    std::vector<float> createRamp(size_t count, float start) {
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = start + static_cast<float>(i);
+        }
+        return samples;
+    }
+
+    // Push samples and collect the emitted frames
+    std::vector<std::vector<float>> push(const std::vector<float>& samples) {
+        std::vector<std::vector<float>> frames;
+        packetizer.push(samples.data(), samples.size(), [&](const float* frame, size_t count) {
+            frames.emplace_back(frame, frame + count);
+        });
+        return frames;
+    }
+
+    RtpPacketizer packetizer;
+};
+
+TEST_F(RtpPacketizerTest, FrameSizeFromPtime) {
+    ASSERT_TRUE(packetizer.configure(48000, 10, 512, 1500));
+    EXPECT_EQ(packetizer.frame_samples(), 480u);
+
+    ASSERT_TRUE(packetizer.configure(16000, 20, 512, 1500));
+    EXPECT_EQ(packetizer.frame_samples(), 320u);
+
+    ASSERT_TRUE(packetizer.configure(16000, 40, 512, 1500));
+    EXPECT_EQ(packetizer.frame_samples(), 640u);
+    EXPECT_FALSE(packetizer.mtu_limited());
+}
+
+TEST_F(RtpPacketizerTest, FrameSizeFromByteBudget) {
+    ASSERT_TRUE(packetizer.configure(48000, 0, 512, 1500));
+    EXPECT_EQ(packetizer.frame_samples(), 256u);
+}
+
+TEST_F(RtpPacketizerTest, MtuCapsFrameSize) {
+    // 20 ms at 48 kHz L16 is 1920 bytes, more than fits in 1500
+    ASSERT_TRUE(packetizer.configure(48000, 20, 512, 1500));
+    EXPECT_TRUE(packetizer.mtu_limited());
+    EXPECT_EQ(packetizer.frame_samples(), (1500u - 40u) / 2u);
+}
+
+TEST_F(RtpPacketizerTest, InvalidConfigurations) {
+    EXPECT_FALSE(packetizer.configure(0, 10, 512, 1500));
+    EXPECT_FALSE(packetizer.configure(48000, 0, 1, 1500));
+    EXPECT_FALSE(packetizer.configure(48000, 10, 512, 40));
+}
+
+TEST_F(RtpPacketizerTest, LeftoversCarryAcrossCalls) {
+    ASSERT_TRUE(packetizer.configure(16000, 10, 512, 1500));  // 160 samples
+
+    auto frames = push(createRamp(100, 0.0f));
+    EXPECT_TRUE(frames.empty());
+    EXPECT_EQ(packetizer.pending(), 100u);
+
+    frames = push(createRamp(400, 100.0f));
+    ASSERT_EQ(frames.size(), 3u);
+    EXPECT_EQ(packetizer.pending(), 20u);
+
+    // Frames are contiguous and in order
+    float expected = 0.0f;
+    for (const auto& frame : frames) {
+        ASSERT_EQ(frame.size(), 160u);
+        for (float s : frame) {
+            EXPECT_EQ(s, expected++);
+        }
+    }
+
+    frames = push(createRamp(140, 500.0f));
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].front(), 480.0f);
+    EXPECT_EQ(frames[0].back(), 639.0f);
+    EXPECT_EQ(packetizer.pending(), 0u);
+}
+
+TEST_F(RtpPacketizerTest, ResetDropsPartialFrame) {
+    ASSERT_TRUE(packetizer.configure(16000, 10, 512, 1500));
+    push(createRamp(100, 0.0f));
+    packetizer.reset();
+    EXPECT_EQ(packetizer.pending(), 0u);
+
+    auto frames = push(createRamp(160, 1000.0f));
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].front(), 1000.0f);
+}
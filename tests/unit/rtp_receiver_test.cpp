@@ -0,0 +1,292 @@
+#include "net/rtp_receiver.hpp"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "net/rtp_fec.hpp"
+#include "net/rtp_packet.hpp"
+#include "net/rtp_streamer.hpp"
+
+class EdgeVoxRtpReceiverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(receiver.init(0, "127.0.0.1"));
+        ASSERT_NE(receiver.port(), 0);
+
+        receiver.set_audio_callback([this](const float* samples, size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames++;
+            received.insert(received.end(), samples, samples + count);
+            return true;
+        });
+
+        sender = socket(AF_INET, SOCK_DGRAM, 0);
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(receiver.port());
+        dest.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+
+    void TearDown() override {
+        receiver.stop();
+        close(sender);
+    }
+
+    void send_raw(const std::vector<uint8_t>& data) {
+        sendto(sender, data.data(), data.size(), 0, (struct sockaddr*)&dest, sizeof(dest));
+    }
+
+    // Wait until the receiver has seen count packets in total
+    bool wait_for_packets(uint64_t count) {
+        auto start = std::chrono::steady_clock::now();
+        auto seen = [this] {
+            const auto stats = receiver.get_stats();
+            return stats.packets + stats.invalid + stats.foreign;
+        };
+        while (seen() < count) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(2)) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return true;
+    }
+
+    EdgeVoxRtpReceiver receiver;
+    int sender = -1;
+    sockaddr_in dest{};
+
+    std::mutex mutex;
+    std::vector<float> received;
+    size_t frames = 0;
+};
+
+TEST_F(EdgeVoxRtpReceiverTest, StartStop) {
+    EXPECT_FALSE(receiver.is_active());
+    EXPECT_TRUE(receiver.start());
+    EXPECT_TRUE(receiver.is_active());
+    receiver.stop();
+    EXPECT_FALSE(receiver.is_active());
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, InitFailsOnBadAddress) {
+    EdgeVoxRtpReceiver other;
+    EXPECT_FALSE(other.init(0, "not an address"));
+    EXPECT_FALSE(other.start());
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, ReceivesFromStreamer) {
+    ASSERT_TRUE(receiver.start());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", receiver.port(), 512));
+    ASSERT_TRUE(streamer.set_packetization(16000, 10, 1500));
+    ASSERT_TRUE(streamer.set_batching(8, false));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<float> samples(160 * 5);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = (static_cast<int>(i % 200) - 100) / 128.0f;
+    }
+    ASSERT_TRUE(streamer.send_audio(samples));
+    ASSERT_TRUE(wait_for_packets(5));
+
+    auto stats = receiver.get_stats();
+    EXPECT_EQ(stats.packets, 5u);
+    EXPECT_EQ(stats.bytes, 5u * (12 + 320));
+    EXPECT_EQ(stats.samples, samples.size());
+    EXPECT_EQ(stats.lost, 0u);
+    EXPECT_GE(stats.syscalls, 1u);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(received.size(), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_NEAR(received[i], samples[i], 1.0f / 32768.0f);
+    }
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, ReceivesAdpcmFromStreamer) {
+    receiver.set_clock_rate(16000);
+    receiver.set_codec(AudioCodecType::ImaAdpcm);
+    ASSERT_TRUE(receiver.start());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", receiver.port(), 512));
+    ASSERT_TRUE(streamer.set_packetization(16000, 10, 1500));
+    ASSERT_TRUE(streamer.set_codec(AudioCodecType::ImaAdpcm));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<float> samples(160 * 5);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 0.5f * std::sin(i * 0.2f);
+    }
+    ASSERT_TRUE(streamer.send_audio(samples));
+    ASSERT_TRUE(wait_for_packets(5));
+
+    auto stats = receiver.get_stats();
+    EXPECT_EQ(stats.bytes, 5u * (12 + 4 + 80));  // Header plus four bits per sample
+    EXPECT_EQ(stats.samples, samples.size());
+    EXPECT_EQ(stats.invalid, 0u);
+
+    // ADPCM needs a few samples to lock on to the signal
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(received.size(), samples.size());
+    for (size_t i = 32; i < samples.size(); i++) {
+        EXPECT_NEAR(received[i], samples[i], 0.05f);
+    }
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, CountsLossReorderingAndGarbage) {
+    ASSERT_TRUE(receiver.start());
+
+    RtpPacket packet;
+    packet.setPayload({0x40, 0x00, 0xC0, 0x00});  // 0.5, -0.5
+
+    auto send_next = [&](int advance) {
+        for (int i = 0; i < advance; i++) {
+            packet.incrementSequenceNumber();
+        }
+        send_raw(packet.serialize());
+    };
+
+    send_next(0);
+    send_next(1);
+    send_next(3);   // Two lost
+    send_next(-1);  // Behind the newest: dropped
+    // Not RTP, then an L16 payload with an odd byte count
+    send_raw({0x00, 0x01, 0x02});
+    send_raw({0x80, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01});
+    // Valid RTP, but parity without FEC enabled and PCMU: neither is played as L16
+    packet.setPayloadType(FEC_DEFAULT_PAYLOAD_TYPE);
+    send_next(1);
+    packet.setPayloadType(0);
+    send_next(1);
+    ASSERT_TRUE(wait_for_packets(8));
+
+    auto stats = receiver.get_stats();
+    EXPECT_EQ(stats.packets, 4u);
+    EXPECT_EQ(stats.lost, 2u);
+    EXPECT_EQ(stats.out_of_order, 1u);
+    EXPECT_EQ(stats.invalid, 2u);
+    EXPECT_EQ(stats.foreign, 2u);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(frames, 3u);
+    ASSERT_EQ(received.size(), 6u);
+    EXPECT_FLOAT_EQ(received[0], 0.5f);
+    EXPECT_FLOAT_EQ(received[1], -0.5f);
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, CountsPlaybackDrops) {
+    receiver.set_audio_callback([](const float*, size_t) { return false; });
+    ASSERT_TRUE(receiver.start());
+
+    RtpPacket packet;
+    packet.setPayload({0, 0});
+    send_raw(packet.serialize());
+    ASSERT_TRUE(wait_for_packets(1));
+
+    EXPECT_EQ(receiver.get_stats().playback_drops, 1u);
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, JitterBufferReordersAndConceals) {
+    JitterBufferConfig config;
+    config.sample_rate = 8000;
+    config.min_delay_ms = 20;
+    receiver.set_jitter_buffer(true, config);
+    ASSERT_TRUE(receiver.start());
+
+    // 10ms frames of a constant level; frame 3 is lost and 4 arrives before 2
+    RtpPacket packet;
+    packet.setPayload(std::vector<uint8_t>(160, 0x20));
+    std::vector<std::vector<uint8_t>> datagrams;
+    for (int i = 0; i < 9; i++) {
+        datagrams.push_back(packet.serialize());
+        packet.incrementSequenceNumber();
+        packet.incrementTimestamp(80);
+    }
+    for (int i : {0, 1, 4, 2, 5, 6, 7, 8}) {
+        send_raw(datagrams[i]);
+    }
+    ASSERT_TRUE(wait_for_packets(8));
+
+    // The burst plays out (less any frame skipped to shrink the delay), then underruns
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (frames >= 9) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto stats = receiver.get_stats();
+    EXPECT_EQ(stats.packets, 8u);
+    EXPECT_EQ(stats.lost, 1u);
+    EXPECT_EQ(stats.out_of_order, 0u);
+    EXPECT_GE(stats.concealed, 1u);
+    EXPECT_GE(stats.target_delay_ms, 20u);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_GE(frames, 9u);
+    EXPECT_EQ(received.size(), frames * 80);
+}
+
+TEST_F(EdgeVoxRtpReceiverTest, JitterBufferRepairsLossFromParity) {
+    JitterBufferConfig config;
+    config.sample_rate = 8000;
+    config.min_delay_ms = 40;
+    receiver.set_jitter_buffer(true, config);
+    receiver.set_fec(true);
+    ASSERT_TRUE(receiver.start());
+
+    RtpFecEncoder encoder;
+    ASSERT_TRUE(encoder.configure({4, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+
+    // Two groups of 10 ms frames with their parity; frame 2 never arrives
+    RtpPacket packet;
+    packet.setPayload(std::vector<uint8_t>(160, 0x20));
+    for (int i = 0; i < 8; i++) {
+        const auto datagram = packet.serialize();
+        const size_t parity = encoder.add(datagram.data(), RTP_HEADER_SIZE,
+                                          datagram.data() + RTP_HEADER_SIZE,
+                                          datagram.size() - RTP_HEADER_SIZE);
+        if (i != 2) {
+            send_raw(datagram);
+        }
+        if (parity > 0) {
+            send_raw(std::vector<uint8_t>(encoder.parity(), encoder.parity() + parity));
+        }
+        packet.incrementSequenceNumber();
+        packet.incrementTimestamp(80);
+    }
+    ASSERT_TRUE(wait_for_packets(7));
+
+    auto start = std::chrono::steady_clock::now();
+    while (receiver.get_stats().parity_packets < 2 &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    // Parity is overhead, not media; RTCP still sees the loss, the listener doesn't
+    auto stats = receiver.get_stats();
+    EXPECT_EQ(stats.packets, 7u);
+    EXPECT_EQ(stats.parity_packets, 2u);
+    EXPECT_EQ(stats.parity_recovered, 1u);
+    EXPECT_EQ(stats.lost, 0u);
+    EXPECT_EQ(stats.concealed, 0u);
+
+    RtcpReportBlock block;
+    ASSERT_TRUE(receiver.get_report_block(block));
+    EXPECT_EQ(block.cumulative_lost, 1);
+}
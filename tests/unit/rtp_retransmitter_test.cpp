@@ -0,0 +1,134 @@
+#include "net/rtp_retransmitter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "net/rtp_packet.hpp"
+
+namespace {
+constexpr uint32_t FRAME_US = 10000;  // 10 ms packets
+
+struct Sent {
+    std::vector<uint8_t> data;
+    uint16_t seq;
+};
+
+// Send count packets of payload_size through the history, one per FRAME_US from time 0
+std::vector<Sent> send_packets(RtpRetransmitter& rtx, size_t count, size_t payload_size) {
+    RtpPacket packet;
+    std::vector<Sent> sent;
+    for (size_t i = 0; i < count; i++) {
+        packet.setPayload(std::vector<uint8_t>(payload_size, static_cast<uint8_t>(i)));
+        packet.setMarker(i == 0);
+        const auto data = packet.serialize();
+        rtx.store(data.data(), RTP_HEADER_SIZE, data.data() + RTP_HEADER_SIZE,
+                  data.size() - RTP_HEADER_SIZE, i * FRAME_US);
+        sent.push_back({data, packet.getHeader().sequenceNumber});
+        packet.incrementSequenceNumber();
+        packet.incrementTimestamp(160);
+    }
+    return sent;
+}
+}  // namespace
+
+TEST(RtpRetransmitterTest, BuildsRtxPackets) {
+    RtpRetransmitter rtx;
+    EXPECT_FALSE(rtx.enabled());
+    ASSERT_TRUE(rtx.configure({200, 100, 64000}, FRAME_US, 1500));
+    const auto sent = send_packets(rtx, 5, 160);
+
+    uint8_t out[1500];
+    const size_t size = rtx.retransmit(sent[0].seq, 5 * FRAME_US, out, sizeof(out));
+    ASSERT_EQ(size, sent[0].data.size() + RTX_HEADER_SIZE);
+
+    // Marker and timestamp of the original, our payload type and SSRC, then the original
+    // sequence number ahead of the payload
+    const std::vector<uint8_t>& original = sent[0].data;
+    EXPECT_EQ(out[0], original[0]);
+    EXPECT_EQ(out[1], 0x80 | 100);
+    EXPECT_TRUE(std::equal(out + 4, out + 8, original.begin() + 4));
+    EXPECT_EQ(static_cast<uint32_t>(out[8] << 24 | out[9] << 16 | out[10] << 8 | out[11]),
+              rtx.ssrc());
+    EXPECT_EQ(out[12], original[2]);
+    EXPECT_EQ(out[13], original[3]);
+    EXPECT_TRUE(std::equal(out + 14, out + size, original.begin() + RTP_HEADER_SIZE));
+
+    // RTX sequence numbers run on by one per packet
+    const auto first_seq = static_cast<uint16_t>(out[2] << 8 | out[3]);
+    ASSERT_GT(rtx.retransmit(sent[1].seq, 5 * FRAME_US, out, sizeof(out)), 0u);
+    EXPECT_EQ(static_cast<uint16_t>(out[2] << 8 | out[3]), static_cast<uint16_t>(first_seq + 1));
+    EXPECT_EQ(rtx.stats().retransmitted, 2u);
+    EXPECT_EQ(rtx.stats().bytes, 2 * size);
+}
+
+TEST(RtpRetransmitterTest, KeepsHeaderExtensionAheadOfOsn) {
+    RtpRetransmitter rtx;
+    ASSERT_TRUE(rtx.configure({200, 100, 64000}, FRAME_US, 1500));
+
+    // X bit set, one CSRC, then a one-word extension
+    std::vector<uint8_t> packet = {0x91, 0x0B, 0x12, 0x34, 0, 0, 0x03, 0x20, 0xAA, 0xBB, 0xCC,
+                                   0xDD, 0x01, 0x02, 0x03, 0x04, 0xBE, 0xDE, 0x00, 0x01, 0x10,
+                                   0x20, 0x30, 0x40, 0x55, 0x66, 0x77};
+    const size_t header_len = RTP_HEADER_SIZE + 4 + 8;
+    rtx.store(packet.data(), header_len, packet.data() + header_len, packet.size() - header_len,
+              0);
+
+    uint8_t out[64];
+    const size_t size = rtx.retransmit(0x1234, FRAME_US, out, sizeof(out));
+    ASSERT_EQ(size, packet.size() + RTX_HEADER_SIZE);
+    EXPECT_TRUE(std::equal(out + RTP_HEADER_SIZE, out + header_len,
+                           packet.begin() + RTP_HEADER_SIZE));
+    EXPECT_EQ(out[header_len], 0x12);
+    EXPECT_EQ(out[header_len + 1], 0x34);
+    EXPECT_TRUE(std::equal(out + header_len + RTX_HEADER_SIZE, out + size,
+                           packet.begin() + header_len));
+}
+
+TEST(RtpRetransmitterTest, HistoryIsBoundedByTime) {
+    RtpRetransmitter rtx;
+    ASSERT_TRUE(rtx.configure({50, RTX_DEFAULT_PAYLOAD_TYPE, 1000000}, FRAME_US, 1500));
+    const auto sent = send_packets(rtx, 20, 100);
+
+    // Five slots for 50 ms: the early packets were overwritten
+    uint8_t out[1500];
+    const uint64_t now = 20 * FRAME_US;
+    EXPECT_EQ(rtx.retransmit(sent[2].seq, now, out, sizeof(out)), 0u);
+    EXPECT_GT(rtx.retransmit(sent[16].seq, now, out, sizeof(out)), 0u);
+
+    // And held packets expire once they are older than history_ms
+    EXPECT_EQ(rtx.retransmit(sent[19].seq, 19 * FRAME_US + 60000, out, sizeof(out)), 0u);
+    EXPECT_EQ(rtx.retransmit(sent[18].seq, now, out, 10), 0u);  // Doesn't fit
+    EXPECT_EQ(rtx.stats().requested, 4u);
+    EXPECT_EQ(rtx.stats().missing, 3u);
+}
+
+TEST(RtpRetransmitterTest, RateCapDropsExcessRequests) {
+    // 80 kbit/s is 1000 bytes per 100 ms: a burst of that, then one packet per 10 ms
+    RtpRetransmitter rtx;
+    ASSERT_TRUE(rtx.configure({1000, RTX_DEFAULT_PAYLOAD_TYPE, 80000}, FRAME_US, 1500));
+    const auto sent = send_packets(rtx, 50, 86);  // 100-byte RTX packets
+
+    uint8_t out[1500];
+    size_t sent_now = 0;
+    for (size_t i = 0; i < 20; i++) {
+        sent_now += rtx.retransmit(sent[i].seq, 50 * FRAME_US, out, sizeof(out)) > 0;
+    }
+    EXPECT_EQ(sent_now, 15u);  // 1500 bytes: the bucket holds at least one full packet
+    EXPECT_EQ(rtx.stats().rate_limited, 5u);
+
+    EXPECT_EQ(rtx.retransmit(sent[20].seq, 50 * FRAME_US + 5000, out, sizeof(out)), 0u);
+    EXPECT_GT(rtx.retransmit(sent[20].seq, 50 * FRAME_US + 10000, out, sizeof(out)), 0u);
+}
+
+TEST(RtpRetransmitterTest, RejectsBadConfig) {
+    RtpRetransmitter rtx;
+    EXPECT_FALSE(rtx.configure({100, RTX_DEFAULT_PAYLOAD_TYPE, 64000}, 0, 1500));
+    EXPECT_FALSE(rtx.configure({100, RTX_DEFAULT_PAYLOAD_TYPE, 0}, FRAME_US, 1500));
+    EXPECT_TRUE(rtx.configure({0, RTX_DEFAULT_PAYLOAD_TYPE, 0}, 0, 0));
+    EXPECT_FALSE(rtx.enabled());
+
+    uint8_t out[64];
+    EXPECT_EQ(rtx.retransmit(1, 0, out, sizeof(out)), 0u);
+}
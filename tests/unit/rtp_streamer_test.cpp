@@ -1,7 +1,12 @@
 #include "net/rtp_streamer.hpp"
 
+#include <arpa/inet.h>
 #include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <vector>
@@ -124,6 +129,433 @@ TEST_F(EdgeVoxRtpStreamerTest, DifferentPayloadSizesTest) {
     EXPECT_TRUE(large_streamer.send_audio(samples));
 }
 
+// Local UDP socket collecting what the streamer sends
+class LoopbackReceiver {
+public:
+    explicit LoopbackReceiver(uint16_t port) {
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bound_ = bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+
+        timeval timeout{0, 200000};
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~LoopbackReceiver() {
+        close(fd_);
+    }
+
+    bool bound() const {
+        return bound_;
+    }
+
+    // Returns the datagrams received until the socket times out
+    std::vector<std::vector<uint8_t>> receive_packets() {
+        std::vector<std::vector<uint8_t>> packets;
+        uint8_t buffer[65536];
+        ssize_t n;
+        while ((n = recv(fd_, buffer, sizeof(buffer), 0)) > 0) {
+            packets.emplace_back(buffer, buffer + n);
+        }
+        return packets;
+    }
+
+    std::vector<size_t> receive_all() {
+        std::vector<size_t> sizes;
+        for (const auto& packet : receive_packets()) {
+            sizes.push_back(packet.size());
+        }
+        return sizes;
+    }
+
+private:
+    int fd_;
+    bool bound_ = false;
+};
+
+TEST_F(EdgeVoxRtpStreamerTest, PacketizationTest) {
+    LoopbackReceiver receiver(5110);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5110, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 10, 1500));  // 480 samples per packet
+    ASSERT_TRUE(streamer.start());
+
+    // 1000 samples: two full packets, 40 samples held back
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(1000)));
+    // 440 more complete the third packet
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(440)));
+
+    auto sizes = receiver.receive_all();
+    ASSERT_EQ(sizes.size(), 3u);
+    for (size_t size : sizes) {
+        EXPECT_EQ(size, 12u + 480u * 2u);
+    }
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, SenderInfoTest) {
+    LoopbackReceiver receiver(5118);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5118, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 10, 1500));
+    ASSERT_TRUE(streamer.start());
+
+    RtcpSenderInfo info;
+    EXPECT_FALSE(streamer.get_sender_info(info));  // Nothing sent yet
+    const uint32_t ssrc = info.ssrc;
+
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(960)));
+    ASSERT_TRUE(streamer.get_sender_info(info));
+    EXPECT_EQ(info.ssrc, ssrc);
+    EXPECT_EQ(info.packet_count, 2u);
+    EXPECT_EQ(info.octet_count, 2u * 480 * 2);
+    EXPECT_NE(info.ntp_timestamp, 0u);
+    EXPECT_EQ(receiver.receive_all().size(), 2u);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, PacketsNeverExceedMtuTest) {
+    LoopbackReceiver receiver(5111);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5111, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 60, 576));
+    ASSERT_TRUE(streamer.start());
+
+    // A 1 s burst must be split into datagrams that fit the path MTU
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(48000)));
+
+    auto sizes = receiver.receive_all();
+    ASSERT_FALSE(sizes.empty());
+    for (size_t size : sizes) {
+        EXPECT_LE(size + 28u, 576u);  // Plus IPv4 and UDP headers
+    }
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, BatchedSendTest) {
+    LoopbackReceiver receiver(5112);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5112, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 10, 1500));
+    ASSERT_TRUE(streamer.set_batching(8, false));
+    ASSERT_TRUE(streamer.start());
+
+    // Five packets from one call go out in a single sendmmsg
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(480 * 5)));
+
+    auto sizes = receiver.receive_all();
+    ASSERT_EQ(sizes.size(), 5u);
+    for (size_t size : sizes) {
+        EXPECT_EQ(size, 12u + 480u * 2u);
+    }
+
+    UdpBatchStats stats = streamer.get_batch_stats();
+    EXPECT_EQ(stats.flushes, 1u);
+    EXPECT_EQ(stats.syscalls, 1u);
+    EXPECT_EQ(stats.packets, 5u);
+    EXPECT_EQ(stats.last_packets_per_syscall, 5u);
+    EXPECT_EQ(stats.packets_per_syscall[5], 1u);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, BatchFlushesWhenFullTest) {
+    LoopbackReceiver receiver(5113);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5113, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 10, 1500));
+    ASSERT_TRUE(streamer.set_batching(2, false));
+    ASSERT_TRUE(streamer.start());
+
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(480 * 5)));
+    EXPECT_EQ(receiver.receive_all().size(), 5u);
+
+    // 2 + 2 + 1
+    UdpBatchStats stats = streamer.get_batch_stats();
+    EXPECT_EQ(stats.syscalls, 3u);
+    EXPECT_EQ(stats.packets_per_syscall[2], 2u);
+    EXPECT_EQ(stats.packets_per_syscall[1], 1u);
+
+    EXPECT_FALSE(streamer.set_batching(UdpBatchSender::MAX_BATCH + 1, false));
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, GsoBatchTest) {
+    LoopbackReceiver receiver(5114);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5114, 512));
+    ASSERT_TRUE(streamer.set_packetization(48000, 10, 1500));
+    ASSERT_TRUE(streamer.set_batching(8, true));
+    ASSERT_TRUE(streamer.start());
+
+    // With GSO the kernel splits one send into datagrams; without it we fall back to sendmmsg.
+    // Either way the receiver sees separate, equally sized packets.
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(480 * 4)));
+
+    auto sizes = receiver.receive_all();
+    ASSERT_EQ(sizes.size(), 4u);
+    for (size_t size : sizes) {
+        EXPECT_EQ(size, 12u + 480u * 2u);
+    }
+
+    UdpBatchStats stats = streamer.get_batch_stats();
+    EXPECT_EQ(stats.packets, 4u);
+    EXPECT_LE(stats.syscalls, 2u);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, PacketContentTest) {
+    LoopbackReceiver receiver(5115);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5115, 512));
+    ASSERT_TRUE(streamer.set_packetization(16000, 10, 1500));  // 160 samples per packet
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<float> samples(320);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = (i % 2 == 0) ? 0.5f : -0.25f;
+    }
+    EXPECT_TRUE(streamer.send_audio(samples));
+
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 2u);
+
+    // Consecutive sequence numbers, timestamps one frame apart, marker on the first only
+    const auto& first = packets[0];
+    const auto& second = packets[1];
+    EXPECT_EQ(first[0] >> 6, 2);
+    EXPECT_EQ(first[1] >> 7, 1);
+    EXPECT_EQ(second[1] >> 7, 0);
+    EXPECT_EQ(static_cast<uint16_t>(((second[2] << 8) | second[3]) - ((first[2] << 8) | first[3])),
+              1u);
+    uint32_t ts1 = (first[4] << 24) | (first[5] << 16) | (first[6] << 8) | first[7];
+    uint32_t ts2 = (second[4] << 24) | (second[5] << 16) | (second[6] << 8) | second[7];
+    EXPECT_EQ(ts2 - ts1, 160u);
+
+    // Big-endian PCM16 straight after the 12-byte header, rounded to nearest
+    int16_t s0 = static_cast<int16_t>((first[12] << 8) | first[13]);
+    int16_t s1 = static_cast<int16_t>((first[14] << 8) | first[15]);
+    EXPECT_EQ(s0, 16384);
+    EXPECT_EQ(s1, -8192);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, TalkspurtAfterGapTest) {
+    LoopbackReceiver receiver(5122);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5122, 512));
+    ASSERT_TRUE(streamer.set_packetization(16000, 10, 1500));  // 160 samples per packet
+    ASSERT_TRUE(streamer.start());
+
+    // The 80 samples left over go out padded with silence before the clock skips the gap
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(240)));
+    streamer.skip_samples(1000);
+    streamer.start_talkspurt();
+    EXPECT_TRUE(streamer.send_audio(createTestSamples(160)));
+
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 3u);
+    auto timestamp = [](const std::vector<uint8_t>& packet) {
+        return static_cast<uint32_t>((packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) |
+                                     packet[7]);
+    };
+    EXPECT_EQ(timestamp(packets[1]) - timestamp(packets[0]), 160u);
+    EXPECT_EQ(timestamp(packets[2]) - timestamp(packets[0]), 240u + 1000u);
+    EXPECT_EQ(packets[1][12 + 2 * 80], 0);  // Padding
+    EXPECT_EQ(packets[1][1] >> 7, 0);
+    EXPECT_EQ(packets[2][1] >> 7, 1);  // New talkspurt
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, CodecTest) {
+    LoopbackReceiver receiver(5119);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5119, 512));
+    ASSERT_TRUE(streamer.set_packetization(8000, 20, 1500));  // 160 samples per packet
+    ASSERT_TRUE(streamer.set_codec(AudioCodecType::Pcmu));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<float> samples(320, 0.0f);
+    EXPECT_TRUE(streamer.send_audio(samples));
+
+    // One mu-law byte per sample with the static payload type; silence is 0xFF
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 2u);
+    EXPECT_EQ(packets[0].size(), 12u + 160u);
+    EXPECT_EQ(packets[0][1] & 0x7F, 0);
+    EXPECT_EQ(packets[0][12], 0xFF);
+
+    // ADPCM packs two samples per byte, so it can't use an odd frame size
+    ASSERT_TRUE(streamer.set_packetization(11025, 10, 1500));  // 110 samples
+    EXPECT_TRUE(streamer.set_codec(AudioCodecType::ImaAdpcm));
+    EXPECT_FALSE(streamer.set_packetization(11025, 1, 1500));  // 11 samples
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, FecTest) {
+    LoopbackReceiver receiver(5120);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5120, 512));
+    ASSERT_TRUE(streamer.set_packetization(8000, 10, 1500));  // 80 samples per packet
+    EXPECT_FALSE(streamer.set_fec({9, 2, FEC_DEFAULT_PAYLOAD_TYPE}));  // Beyond the mask
+    ASSERT_TRUE(streamer.set_fec({4, 1, FEC_DEFAULT_PAYLOAD_TYPE}));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<float> samples(8 * 80, 0.25f);
+    EXPECT_TRUE(streamer.send_audio(samples));
+
+    // A parity packet after every fourth media packet, on an SSRC of its own
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 10u);
+    for (size_t p = 0; p < packets.size(); p++) {
+        const bool parity = p % 5 == 4;
+        EXPECT_EQ(packets[p][1] & 0x7F, parity ? FEC_DEFAULT_PAYLOAD_TYPE : 11) << p;
+        EXPECT_EQ(std::equal(packets[p].begin() + 8, packets[p].begin() + 12,
+                             packets[0].begin() + 8),
+                  !parity)
+            << p;
+    }
+    EXPECT_EQ(packets[4].size(), packets[0].size() + FEC_OVERHEAD_BYTES);
+
+    const RtpFecStats stats = streamer.get_fec_stats();
+    EXPECT_EQ(stats.media_packets, 8u);
+    EXPECT_EQ(stats.parity_packets, 2u);
+    EXPECT_EQ(stats.parity_bytes, 2 * packets[4].size());
+
+    // Full-size frames leave room for the FEC headers in the parity packet
+    ASSERT_TRUE(streamer.set_packetization(48000, 0, 576));
+    EXPECT_TRUE(streamer.send_audio(std::vector<float>(2000, 0.25f)));
+    for (const auto& packet : receiver.receive_packets()) {
+        EXPECT_LE(packet.size() + 28, 576u);
+    }
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, RetransmitTest) {
+    LoopbackReceiver receiver(5121);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5121, 512));
+    ASSERT_TRUE(streamer.set_packetization(8000, 10, 1500));
+    ASSERT_TRUE(streamer.set_retransmission({1000, RTX_DEFAULT_PAYLOAD_TYPE, 64000}));
+    ASSERT_TRUE(streamer.start());
+
+    EXPECT_TRUE(streamer.send_audio(std::vector<float>(4 * 80, 0.25f)));
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 4u);
+
+    // NACKs about another SSRC are ignored; ours are served ahead of the next frame
+    RtcpSenderInfo info;
+    ASSERT_TRUE(streamer.get_sender_info(info));
+    const uint16_t seqs[] = {static_cast<uint16_t>(packets[1][2] << 8 | packets[1][3])};
+    streamer.handle_nack(info.ssrc + 1, seqs, 1);
+    streamer.handle_nack(info.ssrc, seqs, 1);
+    EXPECT_TRUE(streamer.send_audio(std::vector<float>(80, 0.25f)));
+
+    auto resent = receiver.receive_packets();
+    ASSERT_EQ(resent.size(), 2u);
+    ASSERT_EQ(resent[0].size(), packets[1].size() + RTX_HEADER_SIZE);
+    EXPECT_EQ(resent[0][1] & 0x7F, RTX_DEFAULT_PAYLOAD_TYPE);
+    EXPECT_EQ(resent[0][12], packets[1][2]);  // Original sequence number
+    EXPECT_EQ(resent[0][13], packets[1][3]);
+    EXPECT_EQ(resent[1][1] & 0x7F, 11);
+
+    const RtpRtxStats stats = streamer.get_rtx_stats();
+    EXPECT_EQ(stats.requested, 1u);
+    EXPECT_EQ(stats.retransmitted, 1u);
+
+    // RTX isn't media: the sender report counts only the five frames
+    ASSERT_TRUE(streamer.get_sender_info(info));
+    EXPECT_EQ(info.packet_count, 5u);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, SendEncodedTest) {
+    LoopbackReceiver receiver(5116);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5116, 512));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<uint8_t> payload(3 * 100);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+
+    // Three 100-byte frames, header and payload gathered by sendmsg
+    EXPECT_TRUE(streamer.send_encoded(payload.data(), 100, 3, 160));
+
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 3u);
+    for (size_t p = 0; p < packets.size(); p++) {
+        ASSERT_EQ(packets[p].size(), 12u + 100u);
+        EXPECT_TRUE(std::equal(packets[p].begin() + 12, packets[p].end(),
+                               payload.begin() + p * 100));
+    }
+
+    // Frames that can't fit the MTU are rejected, but their time passes on the RTP clock
+    std::vector<uint8_t> huge(1500);
+    EXPECT_FALSE(streamer.send_encoded(huge.data(), huge.size(), 1, 160));
+    EXPECT_EQ(streamer.get_dropped_frames(), 1u);
+
+    EXPECT_TRUE(streamer.send_encoded(payload.data(), 100, 1, 160));
+    auto next = receiver.receive_packets();
+    ASSERT_EQ(next.size(), 1u);
+    auto timestamp = [](const std::vector<uint8_t>& packet) {
+        return static_cast<uint32_t>((packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) |
+                                     packet[7]);
+    };
+    EXPECT_EQ(timestamp(next[0]) - timestamp(packets[0]), 4u * 160u);
+}
+
+TEST_F(EdgeVoxRtpStreamerTest, SendEncodedBatchedTest) {
+    LoopbackReceiver receiver(5117);
+    ASSERT_TRUE(receiver.bound());
+
+    EdgeVoxRtpStreamer streamer;
+    ASSERT_TRUE(streamer.init("127.0.0.1", 5117, 512));
+    ASSERT_TRUE(streamer.set_batching(4, true));
+    ASSERT_TRUE(streamer.start());
+
+    std::vector<uint8_t> payload(6 * 80);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+    EXPECT_TRUE(streamer.send_encoded(payload.data(), 80, 6, 80));
+
+    auto packets = receiver.receive_packets();
+    ASSERT_EQ(packets.size(), 6u);
+
+    auto timestamp = [](const std::vector<uint8_t>& packet) {
+        return static_cast<uint32_t>((packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) |
+                                     packet[7]);
+    };
+    for (size_t p = 0; p < packets.size(); p++) {
+        ASSERT_EQ(packets[p].size(), 12u + 80u);
+        EXPECT_TRUE(
+            std::equal(packets[p].begin() + 12, packets[p].end(), payload.begin() + p * 80));
+        EXPECT_EQ(timestamp(packets[p]) - timestamp(packets[0]), p * 80u);
+    }
+
+    // 4 + 2
+    UdpBatchStats stats = streamer.get_batch_stats();
+    EXPECT_EQ(stats.packets, 6u);
+    EXPECT_EQ(stats.flushes, 2u);
+}
+
 // TEST_F(EdgeVoxRtpStreamerTest, BufferCapacityTest) {
 //     ASSERT_TRUE(streamer->init("127.0.0.1", 5004, 512));
 //     ASSERT_TRUE(streamer->start());
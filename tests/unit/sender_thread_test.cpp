@@ -0,0 +1,201 @@
+#include "net/sender_thread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+// Collects what the sender thread hands over
+struct Sink {
+    std::mutex mutex;
+    std::vector<float> samples;
+    uint64_t gaps = 0;
+    std::vector<size_t> talkspurts;  // Offsets of the chunks that start one
+    bool hold = false;  // Stall the sender thread, as a blocked sendto would
+
+    EdgeVoxSenderThread::SendFunction function() {
+        return [this](const float* data, size_t count, uint64_t gap, bool talkspurt) {
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!hold) {
+                        if (talkspurt) {
+                            talkspurts.push_back(samples.size());
+                        }
+                        samples.insert(samples.end(), data, data + count);
+                        gaps += gap;
+                        return;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        };
+    }
+
+    void set_hold(bool value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        hold = value;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return samples.size();
+    }
+};
+
+// Wait for the sender thread to catch up with count samples
+bool wait_for(Sink& sink, size_t count) {
+    for (int i = 0; i < 200 && sink.size() < count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return sink.size() >= count;
+}
+
+std::vector<float> ramp(size_t count, float start) {
+    std::vector<float> samples(count);
+    std::iota(samples.begin(), samples.end(), start);
+    return samples;
+}
+
+// 100 ms of queue at 16 kHz: 1600 samples
+SenderThreadConfig small_queue(SenderDropPolicy policy) {
+    SenderThreadConfig config;
+    config.sample_rate = 16000;
+    config.queue_ms = 100;
+    config.drop_policy = policy;
+    return config;
+}
+}  // namespace
+
+TEST(SenderThreadTest, DeliversEverySampleInOrder) {
+    Sink sink;
+    EdgeVoxSenderThread sender;
+    EXPECT_FALSE(sender.push(ramp(10, 0).data(), 10));  // Not started
+    ASSERT_TRUE(sender.start(SenderThreadConfig(), sink.function()));
+    EXPECT_TRUE(sender.is_active());
+
+    // Odd sizes, and one push bigger than a queue slot
+    const std::vector<float> input = ramp(3000, 0);
+    size_t offset = 0;
+    for (size_t count : {160, 7, 2500, 333}) {
+        ASSERT_TRUE(sender.push(input.data() + offset, count));
+        offset += count;
+    }
+    ASSERT_TRUE(wait_for(sink, input.size()));
+    sender.stop();
+    EXPECT_FALSE(sender.is_active());
+
+    EXPECT_EQ(sink.samples, input);
+    EXPECT_EQ(sink.gaps, 0u);
+
+    const EdgeVoxSenderStats stats = sender.get_stats();
+    EXPECT_EQ(stats.samples, input.size());
+    EXPECT_GE(stats.chunks, 5u);
+    EXPECT_GE(stats.wakeups, 1u);
+    EXPECT_EQ(stats.dropped_chunks, 0u);
+    EXPECT_FALSE(stats.realtime);
+    EXPECT_FALSE(stats.pinned);
+
+    // Every chunk sent lands in exactly one latency bucket
+    uint64_t histogram = 0;
+    for (uint64_t count : stats.latency_us) {
+        histogram += count;
+    }
+    EXPECT_EQ(histogram, stats.chunks);
+}
+
+TEST(SenderThreadTest, DropNewestKeepsQueuedAudio) {
+    Sink sink;
+    sink.set_hold(true);
+    EdgeVoxSenderThread sender;
+    ASSERT_TRUE(sender.start(small_queue(SenderDropPolicy::Newest), sink.function()));
+
+    // 16 pushes of 160 against a bound of 1600: the last six don't fit
+    for (size_t i = 0; i < 16; i++) {
+        sender.push(ramp(160, i * 160.0f).data(), 160);
+    }
+    const EdgeVoxSenderStats held = sender.get_stats();
+    EXPECT_EQ(held.dropped_chunks, 6u);
+    EXPECT_EQ(held.dropped_samples, 960u);
+
+    // Once the thread gets going the first ten arrive intact; the next push reports the gap
+    sink.set_hold(false);
+    ASSERT_TRUE(wait_for(sink, 1600));
+    ASSERT_TRUE(sender.push(ramp(160, 16 * 160.0f).data(), 160));
+    ASSERT_TRUE(wait_for(sink, 1760));
+    sender.stop();
+
+    EXPECT_EQ(std::vector<float>(sink.samples.begin(), sink.samples.begin() + 1600),
+              ramp(1600, 0));
+    EXPECT_EQ(sink.samples[1600], 16 * 160.0f);
+    EXPECT_EQ(sink.gaps, 960u);
+}
+
+TEST(SenderThreadTest, DropOldestStaysCloseToRealTime) {
+    Sink sink;
+    sink.set_hold(true);
+    EdgeVoxSenderThread sender;
+    ASSERT_TRUE(sender.start(small_queue(SenderDropPolicy::Oldest), sink.function()));
+
+    // 20 pushes of 100 while the thread is stuck on the first
+    for (size_t i = 0; i < 20; i++) {
+        EXPECT_TRUE(sender.push(ramp(100, i * 100.0f).data(), 100));
+    }
+    sink.set_hold(false);
+    ASSERT_TRUE(wait_for(sink, 1600));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sender.stop();
+
+    // The newest audio always makes it; what was skipped shows up as the gap
+    ASSERT_GE(sink.samples.size(), 1600u);
+    EXPECT_EQ(sink.samples.back(), 1999.0f);
+    EXPECT_EQ(sink.samples.size() + sink.gaps, 2000u);
+    EXPECT_GT(sink.gaps, 0u);
+    EXPECT_EQ(sender.get_stats().dropped_samples, sink.gaps);
+}
+
+TEST(SenderThreadTest, Restarts) {
+    Sink sink;
+    EdgeVoxSenderThread sender;
+    EXPECT_FALSE(sender.start(SenderThreadConfig(), nullptr));
+    ASSERT_TRUE(sender.start(SenderThreadConfig(), sink.function()));
+    sender.stop();
+    sender.stop();
+
+    ASSERT_TRUE(sender.start(SenderThreadConfig(), sink.function()));
+    ASSERT_TRUE(sender.push(ramp(480, 0).data(), 480));
+    ASSERT_TRUE(wait_for(sink, 480));
+    sender.stop();
+    EXPECT_EQ(sender.get_stats().samples, 480u);
+    EXPECT_EQ(sink.gaps, 0u);
+}
+
+TEST(SenderThreadTest, TalkspurtSurvivesDrops) {
+    Sink sink;
+    EdgeVoxSenderThread sender;
+    ASSERT_TRUE(sender.start(small_queue(SenderDropPolicy::Newest), sink.function()));
+
+    // Marks only the first chunk of a push that spans several
+    ASSERT_TRUE(sender.push(ramp(600, 0).data(), 600, 0, true));
+    ASSERT_TRUE(wait_for(sink, 600));
+    sender.stop();
+
+    // A dropped talkspurt start moves on to the next push that gets through
+    ASSERT_TRUE(sender.start(small_queue(SenderDropPolicy::Newest), sink.function()));
+    sink.set_hold(true);
+    for (size_t i = 0; i < 10; i++) {
+        sender.push(ramp(160, 0).data(), 160);
+    }
+    EXPECT_FALSE(sender.push(ramp(160, 0).data(), 160, 0, true));
+    sink.set_hold(false);
+    ASSERT_TRUE(wait_for(sink, 2200));
+    ASSERT_TRUE(sender.push(ramp(160, 0).data(), 160));
+    ASSERT_TRUE(wait_for(sink, 2360));
+    sender.stop();
+
+    EXPECT_EQ(sink.talkspurts, (std::vector<size_t>{0, 2200}));
+}
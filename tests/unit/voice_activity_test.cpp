@@ -0,0 +1,176 @@
+#include "edge_vox/audio/voice_activity.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "core/pipeline.hpp"
+
+namespace {
+constexpr uint32_t RATE = 16000;
+constexpr size_t FRAME = 160;  // 10 ms
+
+// What comes out of a pipeline running only the detector
+struct Sink {
+    std::vector<float> samples;
+    std::vector<uint64_t> sequences;
+    std::vector<size_t> sizes;
+    std::vector<bool> talkspurts;
+    uint64_t skipped = 0;
+
+    EdgeVoxPipeline::FrameSink function() {
+        return [this](const AudioFrame& frame, uint64_t skip) {
+            samples.insert(samples.end(), frame.channel(0), frame.channel(0) + frame.samples);
+            sequences.push_back(frame.sequence);
+            sizes.push_back(frame.samples);
+            talkspurts.push_back(frame.talkspurt_start);
+            skipped += skip;
+        };
+    }
+};
+
+// Short hangover and pre-roll: three frames and two
+EdgeVoxVadConfig short_config() {
+    EdgeVoxVadConfig config;
+    config.hangover_ms = 30;
+    config.preroll_ms = 20;
+    return config;
+}
+
+AudioFormat mono() {
+    AudioFormat format;
+    format.sample_rate = RATE;
+    format.channels = 1;
+    format.frame_samples = FRAME;
+    return format;
+}
+
+void append_tone(std::vector<float>& out, size_t frames, float freq, float amplitude) {
+    const size_t start = out.size();
+    for (size_t i = 0; i < frames * FRAME; i++) {
+        out.push_back(amplitude * std::sin(2.0f * 3.14159265f * freq * (start + i) / RATE));
+    }
+}
+
+void append_noise(std::vector<float>& out, size_t frames, float amplitude) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(-amplitude, amplitude);
+    for (size_t i = 0; i < frames * FRAME; i++) {
+        out.push_back(dis(gen));
+    }
+}
+}  // namespace
+
+TEST(VoiceActivityTest, SendsTalkspurtsWithPrerollAndHangover) {
+    EdgeVoxPipeline pipeline;
+    auto owned = std::make_unique<VoiceActivityStage>(short_config());
+    VoiceActivityStage* vad = owned.get();
+    ASSERT_TRUE(pipeline.add_stage(std::move(owned)));
+
+    // Far below the threshold, then speech-like tone, then quiet again
+    std::vector<float> input;
+    append_noise(input, 10, 1e-4f);
+    append_tone(input, 5, 440.0f, 0.5f);
+    append_noise(input, 10, 1e-4f);
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(), sink.function()));
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+    EXPECT_FALSE(vad->is_speech());
+
+    // The onset frame carries the two frames before it; three frames of hangover follow the
+    // last speech frame
+    ASSERT_EQ(sink.sequences, (std::vector<uint64_t>{10, 11, 12, 13, 14, 15, 16, 17}));
+    EXPECT_EQ(sink.sizes.front(), 3 * FRAME);
+    EXPECT_EQ(sink.talkspurts.front(), true);
+    EXPECT_EQ(std::count(sink.talkspurts.begin(), sink.talkspurts.end(), true), 1);
+    EXPECT_EQ(sink.samples, std::vector<float>(input.begin() + 8 * FRAME,
+                                               input.begin() + 18 * FRAME));
+
+    // The audio before the pre-roll is the gap
+    EXPECT_EQ(sink.skipped, 8 * FRAME);
+
+    const EdgeVoxVadStats stats = vad->get_stats();
+    EXPECT_EQ(stats.talkspurts, 1u);
+    EXPECT_EQ(stats.speech_frames, 10u);
+    EXPECT_EQ(stats.silent_frames, 17u);
+    EXPECT_EQ(pipeline.get_stats().stages[0].dropped, 17u);
+}
+
+TEST(VoiceActivityTest, SteadyNoiseBecomesTheFloor) {
+    EdgeVoxPipeline pipeline;
+    auto owned = std::make_unique<VoiceActivityStage>(short_config());
+    VoiceActivityStage* vad = owned.get();
+    ASSERT_TRUE(pipeline.add_stage(std::move(owned)));
+
+    // A hum well above the threshold is never speech, a louder tone on top of it is
+    std::vector<float> input;
+    append_tone(input, 50, 100.0f, 0.03f);
+    append_tone(input, 5, 440.0f, 0.5f);
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(), sink.function()));
+    pipeline.push(input.data(), 50 * FRAME);
+    EXPECT_NEAR(vad->get_stats().noise_floor_db, 10.0f * std::log10(0.03f * 0.03f / 2), 1.0f);
+    pipeline.push(input.data() + 50 * FRAME, 5 * FRAME);
+    pipeline.stop();
+
+    ASSERT_FALSE(sink.sequences.empty());
+    EXPECT_EQ(sink.sequences.front(), 50u);
+    EXPECT_EQ(vad->get_stats().talkspurts, 1u);
+}
+
+TEST(VoiceActivityTest, WhiteNoiseIsNotSpeech) {
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<VoiceActivityStage>(short_config())));
+
+    // Loud, but with a zero-crossing rate no voice has
+    std::vector<float> input(5 * FRAME, 0.0f);
+    append_noise(input, 20, 0.5f);
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(), sink.function()));
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+    EXPECT_TRUE(sink.sequences.empty());
+}
+
+TEST(VoiceActivityTest, BandEnergyRejectsHum) {
+    EdgeVoxVadConfig config = short_config();
+    config.band_energy = true;
+    config.preroll_ms = 0;
+    EdgeVoxPipeline pipeline;
+    ASSERT_TRUE(pipeline.add_stage(std::make_unique<VoiceActivityStage>(config)));
+
+    // After silence, a loud 60 Hz hum has almost nothing in the speech band; a 1 kHz tone does
+    std::vector<float> input(5 * FRAME, 0.0f);
+    append_tone(input, 10, 60.0f, 0.5f);
+    std::vector<float> quiet(10 * FRAME, 0.0f);
+    input.insert(input.end(), quiet.begin(), quiet.end());
+    append_tone(input, 5, 1000.0f, 0.5f);
+
+    Sink sink;
+    ASSERT_TRUE(pipeline.start(mono(), sink.function()));
+    pipeline.push(input.data(), input.size());
+    pipeline.stop();
+
+    ASSERT_FALSE(sink.sequences.empty());
+    EXPECT_EQ(sink.sequences.front(), 25u);
+    EXPECT_EQ(sink.sizes.front(), FRAME);
+}
+
+TEST(VoiceActivityTest, BandEnergyNeedsTheBand) {
+    EdgeVoxVadConfig config;
+    config.band_energy = true;
+    VoiceActivityStage vad(config);
+
+    AudioFormat format = mono();
+    format.sample_rate = 6000;  // Nyquist below the top of the speech band
+    EXPECT_FALSE(vad.configure(format));
+    format.sample_rate = RATE;
+    EXPECT_TRUE(vad.configure(format));
+}